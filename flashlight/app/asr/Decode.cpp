@@ -5,12 +5,16 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
+#include <exception>
 #include <fstream>
 #include <future>
 #include <iomanip>
 #include <mutex>
+#include <numeric>
 #include <string>
 #include <thread>
 #include <vector>
@@ -360,45 +364,97 @@ int main(int argc, char** argv) {
   LOG(INFO) << "[Dataset] Dataset loaded, with " << nSamples << " samples.";
 
   /* ===================== AM Forwarding ===================== */
-  using EmissionQueue = fl::lib::ProducerConsumerQueue<EmissionTargetPair>;
+  if (FLAGS_s2s_batch_beam &&
+      (!isSeq2seqCrit || !FLAGS_lm.empty() || FLAGS_uselexicon ||
+       !FLAGS_emission_dir.empty())) {
+    LOG(FATAL) << "FLAGS_s2s_batch_beam needs a seq2seq criterion and can't "
+               << "be used with an LM, a lexicon or saved emissions";
+  }
+
+  // An utterance to decode, with the tokens already found by the AM threads
+  // with FLAGS_s2s_batch_beam
+  struct DecoderInput {
+    EmissionUnit emissionUnit;
+    TargetUnit targetUnit;
+    std::vector<int> tokens;
+  };
+  using EmissionQueue = fl::lib::ProducerConsumerQueue<DecoderInput>;
   EmissionQueue emissionQueue(FLAGS_emission_queue_size);
 
-  auto runAmForward = [&network,
-                       &usePlugin,
-                       &criterion,
-                       &nSamples,
-                       &ds,
-                       &tokenDict,
-                       &wordDict,
-                       &emissionQueue,
-                       &isSeq2seqCrit](int tid) {
-    // Initialize AM
-    fl::setDevice(tid);
-    std::shared_ptr<fl::Module> localNetwork = network;
-    std::shared_ptr<SequenceCriterion> localCriterion = criterion;
-    if (tid != 0) {
-      std::unordered_map<std::string, std::string> dummyCfg;
-      std::string dummyVersion;
-      Serializer::load(
-          FLAGS_am, dummyVersion, dummyCfg, localNetwork, localCriterion);
-      localNetwork->eval();
-      localCriterion->eval();
-    }
+  // An utterance waiting for the AM forward pass
+  struct AmUtterance {
+    std::string sampleId;
+    TargetUnit targetUnit;
+    // Column-major T x C features; empty when emissions are read from disk
+    std::vector<float> input;
+    int nFrames{0};
+    int nChannels{0};
+    float duration{0};
+  };
+  using AmBatch = std::vector<AmUtterance>;
+  fl::lib::ProducerConsumerQueue<AmBatch> amBatchQueue(
+      2 * FLAGS_nthread_decoder_am_forward);
 
-    std::vector<int64_t> selectedIds;
-    for (int64_t i = tid; i < nSamples; i += FLAGS_nthread_decoder_am_forward) {
-      selectedIds.emplace_back(i);
-    }
+  if (FLAGS_am_forward_batchsize <= 0) {
+    LOG(FATAL) << "FLAGS_am_forward_batchsize (" << FLAGS_am_forward_batchsize
+               << ") need to be positive ";
+  }
+  const size_t amBatchSize =
+      FLAGS_emission_dir.empty() ? FLAGS_am_forward_batchsize : 1;
+  // Utterances are sorted by length within windows of this many batches, so
+  // that batches need little padding
+  constexpr size_t kAmSortWindowBatches = 8;
+
+  // Workers on the same device share one copy of the AM; the copy on device 0
+  // is the network loaded above, others are loaded on first use
+  const int nAmDevices = FLAGS_emission_dir.empty()
+      ? std::max(
+            1, std::min(FLAGS_nthread_decoder_am_forward, fl::getDeviceCount()))
+      : 1;
+  std::vector<std::shared_ptr<fl::Module>> amNetworks(nAmDevices);
+  amNetworks[0] = network;
+  std::vector<std::shared_ptr<SequenceCriterion>> amCriteria(nAmDevices);
+  amCriteria[0] = criterion;
+  std::vector<std::once_flag> amNetworksLoaded(nAmDevices);
+
+  // Reads the utterances and their targets, and groups them into
+  // length-sorted batches
+  auto loadAmBatches = [&nSamples,
+                      &ds,
+                      &tokenDict,
+                      &wordDict,
+                      &amBatchQueue,
+                      &amBatchSize,
+                      &isSeq2seqCrit]() {
+    std::vector<int64_t> selectedIds(nSamples);
+    std::iota(selectedIds.begin(), selectedIds.end(), 0);
     std::shared_ptr<fl::Dataset> localDs =
         std::make_shared<fl::ResampleDataset>(ds, selectedIds);
     localDs = std::make_shared<fl::PrefetchDataset>(
         localDs, FLAGS_nthread, FLAGS_nthread);
 
+    std::vector<AmUtterance> window;
+    auto addBatches = [&window, &amBatchQueue, &amBatchSize]() {
+      std::stable_sort(
+          window.begin(),
+          window.end(),
+          [](const AmUtterance& a, const AmUtterance& b) {
+            return a.nFrames < b.nFrames;
+          });
+      for (size_t i = 0; i < window.size(); i += amBatchSize) {
+        auto end = std::min(window.size(), i + amBatchSize);
+        amBatchQueue.add(AmBatch(
+            std::make_move_iterator(window.begin() + i),
+            std::make_move_iterator(window.begin() + end)));
+      }
+      window.clear();
+    };
+
     for (auto& sample : *localDs) {
-      auto sampleId = readSampleIds(sample[kSampleIdx]).front();
+      AmUtterance utterance;
+      utterance.sampleId = readSampleIds(sample[kSampleIdx]).front();
 
       /* 2. Load Targets */
-      TargetUnit targetUnit;
       auto tokenTarget = sample[kTargetIdx].toHostVector<int>();
       auto wordTarget = sample[kWordIdx].toHostVector<int>();
       // TODO: we will reform the dataset so that the loaded word
@@ -419,42 +475,178 @@ int main(int argc, char** argv) {
         wordTargetStr = tkn2Wrd(letterTarget, FLAGS_wordseparator);
       }
 
-      targetUnit.wordTargetStr = wordTargetStr;
-      targetUnit.tokenTarget = tokenTarget;
+      utterance.targetUnit.wordTargetStr = wordTargetStr;
+      utterance.targetUnit.tokenTarget = tokenTarget;
 
-      /* 3. Load Emissions */
-      EmissionUnit emissionUnit;
       if (FLAGS_emission_dir.empty()) {
-        fl::Variable rawEmission;
-        if (usePlugin) {
-          rawEmission = localNetwork
-                            ->forward(
-                                {fl::input(sample[kInputIdx]),
-                                 fl::noGrad(sample[kDurationIdx])})
-                            .front();
-        } else {
-          rawEmission = fl::pkg::runtime::forwardSequentialModuleWithPadMask(
-              fl::input(sample[kInputIdx]), localNetwork, sample[kDurationIdx]);
+        const auto& input = sample[kInputIdx];
+        utterance.input = input.astype(fl::dtype::f32).toHostVector<float>();
+        utterance.nFrames = input.dim(0);
+        utterance.nChannels = input.elements() / input.dim(0);
+        utterance.duration = sample[kDurationIdx].asScalar<float>();
+      }
+      window.push_back(std::move(utterance));
+      if (window.size() >= amBatchSize * kAmSortWindowBatches) {
+        addBatches();
+      }
+    }
+    addBatches();
+  };
+  auto runAmLoader = [&loadAmBatches, &amBatchQueue]() {
+    // Release the AM threads even if loading fails; the error is passed on to
+    // the main thread by the future
+    try {
+      loadAmBatches();
+    } catch (...) {
+      amBatchQueue.finishAdding();
+      throw;
+    }
+    amBatchQueue.finishAdding();
+  };
+
+  // Beam search of a seq2seq criterion over a batch of encoder outputs
+  auto batchBeamPath = [](const std::shared_ptr<SequenceCriterion>& crit,
+                          const fl::Tensor& encoded,
+                          const fl::Tensor& encodedSizes)
+      -> std::vector<std::vector<int>> {
+    if (auto s2s = std::dynamic_pointer_cast<Seq2SeqCriterion>(crit)) {
+      return s2s->batchBeamPath(encoded, encodedSizes, FLAGS_beamsize);
+    }
+    if (auto transformer =
+            std::dynamic_pointer_cast<TransformerCriterion>(crit)) {
+      return transformer->batchBeamPath(encoded, encodedSizes, FLAGS_beamsize);
+    }
+    LOG(FATAL) << "Batched beam search is not supported by the criterion "
+               << crit->prettyString();
+    return {};
+  };
+
+  // Runs the AM on batches and scatters the emissions of their utterances
+  // into the emission queue
+  auto runAmForward = [&usePlugin,
+                       &amNetworks,
+                       &amCriteria,
+                       &amNetworksLoaded,
+                       &amBatchQueue,
+                       &batchBeamPath,
+                       &emissionQueue](int tid) {
+    /* 3. Load Emissions */
+    if (!FLAGS_emission_dir.empty()) {
+      auto cleanTestPath = cleanFilepath(FLAGS_test);
+      fs::path emissionDir = fs::path(FLAGS_emission_dir) / cleanTestPath;
+      AmBatch batch;
+      while (amBatchQueue.get(batch)) {
+        for (auto& utterance : batch) {
+          fs::path savePath = emissionDir / (utterance.sampleId + ".bin");
+          EmissionUnit emissionUnit;
+          std::string eVersion;
+          Serializer::load(savePath, eVersion, emissionUnit);
+          emissionQueue.add(
+              {std::move(emissionUnit), std::move(utterance.targetUnit)});
         }
-        emissionUnit = EmissionUnit(
-            rawEmission.tensor().toHostVector<float>(),
-            sampleId,
-            rawEmission.dim(1),
-            rawEmission.dim(0));
+      }
+      return;
+    }
+
+    // Initialize AM
+    const int device = tid % amNetworks.size();
+    fl::setDevice(device);
+    std::call_once(
+        amNetworksLoaded[device], [&amNetworks, &amCriteria, device]() {
+          if (amNetworks[device]) {
+            return;
+          }
+          std::unordered_map<std::string, std::string> dummyCfg;
+          std::string dummyVersion;
+          Serializer::load(
+              FLAGS_am,
+              dummyVersion,
+              dummyCfg,
+              amNetworks[device],
+              amCriteria[device]);
+          amNetworks[device]->eval();
+          amCriteria[device]->eval();
+        });
+    auto localNetwork = amNetworks[device];
+    auto localCriterion = amCriteria[device];
+
+    AmBatch batch;
+    while (amBatchQueue.get(batch)) {
+      // Pad the utterances with zeros into a T x C x 1 x B input
+      const int batchSize = batch.size();
+      const int nChannels = batch.front().nChannels;
+      int maxFrames = 0;
+      for (const auto& utterance : batch) {
+        maxFrames = std::max(maxFrames, utterance.nFrames);
+      }
+      std::vector<float> input(
+          static_cast<size_t>(maxFrames) * nChannels * batchSize, 0);
+      std::vector<float> durations(batchSize);
+      for (int b = 0; b < batchSize; ++b) {
+        const auto& utterance = batch[b];
+        for (int c = 0; c < nChannels; ++c) {
+          std::copy_n(
+              utterance.input.begin() +
+                  static_cast<size_t>(c) * utterance.nFrames,
+              utterance.nFrames,
+              input.begin() +
+                  static_cast<size_t>(b * nChannels + c) * maxFrames);
+        }
+        durations[b] = utterance.duration;
+      }
+      auto inputTensor =
+          fl::Tensor::fromVector({maxFrames, nChannels, 1, batchSize}, input);
+      auto durationTensor = fl::Tensor::fromVector({1, batchSize}, durations);
+
+      fl::Variable rawEmission;
+      if (usePlugin) {
+        rawEmission =
+            localNetwork
+                ->forward({fl::input(inputTensor), fl::noGrad(durationTensor)})
+                .front();
       } else {
-        auto cleanTestPath = cleanFilepath(FLAGS_test);
-        fs::path emissionDir = fs::path(FLAGS_emission_dir) / cleanTestPath;
-        fs::path savePath = emissionDir / (sampleId + ".bin");
-        std::string eVersion;
-        Serializer::load(savePath, eVersion, emissionUnit);
+        rawEmission = fl::pkg::runtime::forwardSequentialModuleWithPadMask(
+            fl::input(inputTensor), localNetwork, durationTensor);
       }
 
-      emissionQueue.add({emissionUnit, targetUnit});
-    }
+      if (FLAGS_s2s_batch_beam) {
+        // The AM outputs are the encoder outputs of the batch, H x T' x B
+        auto paths =
+            batchBeamPath(localCriterion, rawEmission.tensor(), durationTensor);
+        for (int b = 0; b < batchSize; ++b) {
+          auto& utterance = batch[b];
+          EmissionUnit emissionUnit;
+          emissionUnit.sampleId = utterance.sampleId;
+          emissionQueue.add(
+              {std::move(emissionUnit),
+               std::move(utterance.targetUnit),
+               std::move(paths[b])});
+        }
+        continue;
+      }
 
-    localNetwork.reset(); // AM is only used in running forward pass. So we will
-    // free the space of it on GPU or memory.
-    // localNetwork.use_count() will be 0 after this call.
+      // Emissions are N x T' x B; each utterance keeps the frames covering
+      // its unpadded input
+      const int nTokens = rawEmission.dim(0);
+      const int nFrames = rawEmission.dim(1);
+      auto emissions = rawEmission.tensor().toHostVector<float>();
+      for (int b = 0; b < batchSize; ++b) {
+        auto& utterance = batch[b];
+        const int utteranceFrames = std::min<int>(
+            nFrames,
+            std::ceil(
+                static_cast<double>(utterance.nFrames) * nFrames / maxFrames));
+        auto begin =
+            emissions.begin() + static_cast<size_t>(b) * nTokens * nFrames;
+        EmissionUnit emissionUnit(
+            std::vector<float>(begin, begin + nTokens * utteranceFrames),
+            utterance.sampleId,
+            utteranceFrames,
+            nTokens);
+        emissionQueue.add(
+            {std::move(emissionUnit), std::move(utterance.targetUnit)});
+      }
+    }
   };
 
   /* ===================== Decode ===================== */
@@ -488,7 +680,10 @@ int main(int argc, char** argv) {
     // the number of GPUs.
     std::shared_ptr<SequenceCriterion> localCriterion = criterion;
     std::shared_ptr<fl::lib::text::LM> localLm = lm;
-    if (FLAGS_lmtype == "convlm" || criterionType == CriterionType::S2S) {
+    // With FLAGS_s2s_batch_beam, the criterion is run by the AM threads
+    const bool runsCriterion =
+        criterionType == CriterionType::S2S && !FLAGS_s2s_batch_beam;
+    if (FLAGS_lmtype == "convlm" || runsCriterion) {
       if (tid >= fl::getDeviceCount()) {
         LOG(FATAL)
             << "FLAGS_nthread_decoder exceeds the number of visible GPUs";
@@ -514,7 +709,7 @@ int main(int argc, char** argv) {
             FLAGS_beamsize);
       }
 
-      if (criterionType == CriterionType::S2S) {
+      if (runsCriterion) {
         std::shared_ptr<fl::Module> dummyNetwork;
         std::unordered_map<std::string, std::string> dummyCfg;
         Serializer::load(FLAGS_am, dummyCfg, dummyNetwork, localCriterion);
@@ -621,10 +816,10 @@ int main(int argc, char** argv) {
     }
     /* 3. Get data and run decoder */
     TestMeters meters;
-    EmissionTargetPair emissionTargetPair;
-    while (emissionQueue.get(emissionTargetPair)) {
-      const auto& emissionUnit = emissionTargetPair.first;
-      const auto& targetUnit = emissionTargetPair.second;
+    DecoderInput decoderInput;
+    while (emissionQueue.get(decoderInput)) {
+      const auto& emissionUnit = decoderInput.emissionUnit;
+      const auto& targetUnit = decoderInput.targetUnit;
 
       const auto& nFrames = emissionUnit.nFrames;
       const auto& nTokens = emissionUnit.nTokens;
@@ -635,7 +830,13 @@ int main(int argc, char** argv) {
       // DecodeResult
       meters.timer.reset();
       meters.timer.resume();
-      const auto& results = decoder->decode(emission.data(), nFrames, nTokens);
+      std::vector<fl::lib::text::DecodeResult> results;
+      if (FLAGS_s2s_batch_beam) {
+        results.emplace_back();
+        results.back().tokens = decoderInput.tokens;
+      } else {
+        results = decoder->decode(emission.data(), nFrames, nTokens);
+      }
       meters.timer.stop();
 
       int nTopHyps = FLAGS_isbeamdump ? results.size() : 1;
@@ -751,25 +952,43 @@ int main(int argc, char** argv) {
                << ") need to be positive ";
   }
 
-  auto startThreadsAndJoin = [&runAmForward, &runDecoder, &emissionQueue](
+  auto startThreadsAndJoin = [&runAmLoader,
+                              &runAmForward,
+                              &runDecoder,
+                              &amNetworks,
+                              &emissionQueue](
                                  int nAmThreads, int nDecoderThreads) {
-    // TODO possibly try catch for futures to proper logging of all errors
-    // https://github.com/facebookresearch/gtn/blob/master/gtn/parallel/parallel_map.h#L154
+    // Waits for every thread, so that queues are always finished and the
+    // thread pools can be joined, and rethrows the first error afterwards
+    std::exception_ptr error;
+    auto wait = [&error](std::future<void>& fut) {
+      try {
+        fut.get();
+      } catch (...) {
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    };
 
     // We have to run AM forwarding and decoding in sequential to avoid GPU
     // OOM with two large neural nets.
     if (FLAGS_lmtype == "convlm") {
       // 1. AM forwarding
       {
-        std::vector<std::future<void>> futs(nAmThreads);
-        fl::ThreadPool threadPool(nAmThreads);
+        std::vector<std::future<void>> futs(nAmThreads + 1);
+        fl::ThreadPool threadPool(nAmThreads + 1);
+        futs[nAmThreads] = threadPool.enqueue(runAmLoader);
         for (int i = 0; i < nAmThreads; i++) {
           futs[i] = threadPool.enqueue(runAmForward, i);
         }
-        for (int i = 0; i < nAmThreads; i++) {
-          futs[i].get();
+        for (int i = 0; i < nAmThreads + 1; i++) {
+          wait(futs[i]);
         }
         emissionQueue.finishAdding();
+        // AM is only used in running forward pass. Free the copies of it on
+        // other devices.
+        amNetworks.clear();
       }
       // 2. Decoding
       {
@@ -779,14 +998,14 @@ int main(int argc, char** argv) {
           futs[i] = threadPool.enqueue(runDecoder, i);
         }
         for (int i = 0; i < nDecoderThreads; i++) {
-          futs[i].get();
+          wait(futs[i]);
         }
       }
     }
     // Non-convLM decoding. AM forwarding and decoding can be run in parallel.
     else {
-      std::vector<std::future<void>> futs(nAmThreads + nDecoderThreads);
-      fl::ThreadPool threadPool(nAmThreads + nDecoderThreads);
+      std::vector<std::future<void>> futs(nAmThreads + nDecoderThreads + 1);
+      fl::ThreadPool threadPool(nAmThreads + nDecoderThreads + 1);
       // AM forwarding threads
       for (int i = 0; i < nAmThreads; i++) {
         futs[i] = threadPool.enqueue(runAmForward, i);
@@ -795,15 +1014,23 @@ int main(int argc, char** argv) {
       for (int i = 0; i < nDecoderThreads; i++) {
         futs[i + nAmThreads] = threadPool.enqueue(runDecoder, i);
       }
+      // Loading thread
+      const int loaderIdx = nAmThreads + nDecoderThreads;
+      futs[loaderIdx] = threadPool.enqueue(runAmLoader);
 
+      wait(futs[loaderIdx]);
       for (int i = 0; i < nAmThreads; i++) {
-        futs[i].get();
+        wait(futs[i]);
       }
       emissionQueue.finishAdding();
+      amNetworks.clear();
       for (int i = nAmThreads; i < nAmThreads + nDecoderThreads; i++) {
-        futs[i].get();
+        wait(futs[i]);
       }
     }
+    if (error) {
+      std::rethrow_exception(error);
+    }
   };
   auto timer = fl::TimeMeter();
   timer.resume();
@@ -179,14 +179,12 @@ int main(int argc, char** argv) {
   fl::setSeed(FLAGS_seed);
   fl::DynamicBenchmark::setBenchmarkMode(FLAGS_fl_benchmark_mode);
 
-  std::shared_ptr<fl::Reducer> reducer;
   if (FLAGS_enable_distributed) {
     fl::pkg::runtime::initDistributed(
         FLAGS_world_rank,
         FLAGS_world_size,
         FLAGS_max_devices_per_node,
         FLAGS_rndv_filepath);
-    reducer = std::make_shared<fl::CoalescingReducer>(1.0, true, true);
   }
 
   int worldRank = fl::getWorldRank();
@@ -658,6 +656,30 @@ int main(int argc, char** argv) {
         }
       };
 
+  auto saveModel = [&](const std::string& filename) {
+    if (FLAGS_save_mapped) {
+      Serializer::saveMapped(
+          filename,
+          FL_APP_ASR_VERSION,
+          config,
+          network,
+          criterion,
+          dynamicScaler,
+          netoptim,
+          critoptim);
+    } else {
+      Serializer::save(
+          filename,
+          FL_APP_ASR_VERSION,
+          config,
+          network,
+          criterion,
+          dynamicScaler,
+          netoptim,
+          critoptim);
+    }
+  };
+
   auto saveModels = [&](int iter, int totalUpdates) {
     if (isMaster) {
       // Save last epoch
@@ -668,28 +690,12 @@ int main(int argc, char** argv) {
       if (FLAGS_itersave) {
         filename =
             getRunFile(format("model_iter_%03d.bin", iter), runIdx, runPath);
-        Serializer::save(
-            filename,
-            FL_APP_ASR_VERSION,
-            config,
-            network,
-            criterion,
-            dynamicScaler,
-            netoptim,
-            critoptim);
+        saveModel(filename);
       }
 
       // save last model
       filename = getRunFile("model_last.bin", runIdx, runPath);
-      Serializer::save(
-          filename,
-          FL_APP_ASR_VERSION,
-          config,
-          network,
-          criterion,
-          dynamicScaler,
-          netoptim,
-          critoptim);
+      saveModel(filename);
 
       // save if better than ever for one valid
       for (const auto& v : validminerrs) {
@@ -699,15 +705,7 @@ int main(int argc, char** argv) {
           std::string cleaned_v = cleanFilepath(v.first);
           std::string vfname =
               getRunFile("model_" + cleaned_v + ".bin", runIdx, runPath);
-          Serializer::save(
-              vfname,
-              FL_APP_ASR_VERSION,
-              config,
-              network,
-              criterion,
-              dynamicScaler,
-              netoptim,
-              critoptim);
+          saveModel(vfname);
         }
       }
 
@@ -719,15 +717,7 @@ int main(int argc, char** argv) {
           std::string cleaned_v = cleanFilepath(v.first);
           std::string vfname = getRunFile(
               "model_" + cleaned_v + "_decoder.bin", runIdx, runPath);
-          Serializer::save(
-              vfname,
-              FL_APP_ASR_VERSION,
-              config,
-              network,
-              criterion,
-              dynamicScaler,
-              netoptim,
-              critoptim);
+          saveModel(vfname);
         }
       }
       // print brief stats on memory allocation (so far)
@@ -927,7 +917,6 @@ int main(int argc, char** argv) {
                 &plGenerator,
                 &usePlugin,
                 &isSeq2seqCrit,
-                reducer,
                 dynamicScaler](
                    std::shared_ptr<fl::Module> ntwrk,
                    std::shared_ptr<SequenceCriterion> crit,
@@ -938,10 +927,6 @@ int main(int argc, char** argv) {
                    double initcritlr,
                    bool clampCrit,
                    int64_t nbatches) {
-    if (reducer) {
-      fl::distributeModuleGrads(ntwrk, reducer);
-      fl::distributeModuleGrads(crit, reducer);
-    }
 
     meters.train.loss.reset();
     meters.train.tknEdit.reset();
@@ -1029,6 +1014,12 @@ int main(int argc, char** argv) {
     auto critparams = crit->params();
     params.insert(params.end(), critparams.begin(), critparams.end());
 
+    // Gradients are synchronized in buckets while backward is still running
+    std::shared_ptr<fl::Reducer> reducer;
+    if (FLAGS_enable_distributed) {
+      reducer = std::make_shared<fl::BucketedReducer>(params, 1.0);
+    }
+
     int64_t curBatch = startUpdate;
     while (curBatch < nbatches) {
       ++curEpoch; // counts partial epochs too!
@@ -1101,7 +1092,9 @@ int main(int argc, char** argv) {
             output = fl::pkg::runtime::forwardSequentialModuleWithPadMask(
                 input, ntwrk, batch[kDurationIdx]);
           }
-          fl::sync();
+          if (FLAGS_synctimers) {
+            fl::sync();
+          }
 
           // forward crit
           meters.critfwdtimer.resume();
@@ -1112,12 +1105,15 @@ int main(int argc, char** argv) {
             critArgs.emplace_back(batch[kTargetSizeIdx], false);
           }
           auto loss = crit->forward(critArgs).front();
-          fl::sync();
+          if (FLAGS_synctimers) {
+            fl::sync();
+          }
           meters.fwdtimer.stopAndIncUnit();
           meters.critfwdtimer.stopAndIncUnit();
 
-          if (fl::any(fl::isnan(loss.tensor())).asScalar<bool>() ||
-              fl::any(fl::isinf(loss.tensor())).asScalar<bool>()) {
+          // Single device round trip for both checks
+          if (fl::any(fl::isnan(loss.tensor()) || fl::isinf(loss.tensor()))
+                  .asScalar<bool>()) {
             LOG(FATAL) << "Loss has NaN values. Samples - "
                        << join(",", readSampleIds(batch[kSampleIdx]));
           }
@@ -1136,23 +1132,25 @@ int main(int argc, char** argv) {
           netopt->zeroGrad();
           critopt->zeroGrad();
 
-          float totalBatchSize = batch[kInputIdx].dim(3);
-          // TODO{fl::Tensor} -- change me to use a scalar tensor?
+          // The global batch size stays on device
           fl::Tensor totalBatchSizeArr =
               fl::full({1}, batch[kInputIdx].dim(3), fl::dtype::f32);
           if (reducer) {
             fl::allReduce(totalBatchSizeArr);
           }
-          totalBatchSize = totalBatchSizeArr.scalar<float>();
-          auto scaledLoss = loss / totalBatchSize;
+          auto scaledLoss =
+              loss / fl::Variable(totalBatchSizeArr.astype(loss.type()), false);
           bool scaleIsValid = fl::pkg::runtime::backwardWithScaling(
               scaledLoss, params, dynamicScaler, reducer);
-          fl::sync();
+          if (FLAGS_synctimers) {
+            fl::sync();
+          }
           meters.bwdtimer.stopAndIncUnit();
           if (!scaleIsValid) {
             continue;
           }
 
+          // Deferred: read back when the meters are reported
           meters.train.loss.add(loss.tensor());
           break;
         }
@@ -1161,16 +1159,18 @@ int main(int argc, char** argv) {
         meters.optimtimer.resume();
         if (FLAGS_maxgradnorm > 0) {
           if (clampCrit) {
-            fl::clipGradNorm(params, FLAGS_maxgradnorm);
+            fl::clipGradNormAsync(params, FLAGS_maxgradnorm);
           } else {
-            fl::clipGradNorm(ntwrk->params(), FLAGS_maxgradnorm);
+            fl::clipGradNormAsync(ntwrk->params(), FLAGS_maxgradnorm);
           }
         }
 
         // update weights
         critopt->step();
         netopt->step();
-        fl::sync();
+        if (FLAGS_synctimers) {
+          fl::sync();
+        }
         meters.optimtimer.stopAndIncUnit();
 
         if (FLAGS_reportiters > 0 && curBatch % FLAGS_reportiters == 0) {
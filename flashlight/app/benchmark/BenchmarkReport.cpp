@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/app/benchmark/BenchmarkReport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include "flashlight/fl/common/Histogram.h"
+#include "flashlight/fl/common/Utils.h"
+#include "flashlight/fl/flashlight.h"
+
+namespace fl {
+namespace app {
+namespace benchmark {
+
+namespace {
+
+constexpr size_t kLatencyHistogramBuckets = 10;
+
+/**
+ * Returns the nearest-rank percentile of sorted values.
+ */
+double percentile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const auto rank = static_cast<size_t>(std::ceil(p / 100 * sorted.size()));
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+void writeConfig(std::ostream& os, const RunConfig& config) {
+  os << "\"model\":\"" << fl::jsonEscape(config.model) << "\",\"backend\":\""
+     << fl::jsonEscape(config.backend) << "\",\"precision\":\""
+     << fl::jsonEscape(config.precision) << "\",\"optimizer\":\""
+     << fl::jsonEscape(config.options.optimizer) << "\",\"reducer\":\""
+     << fl::jsonEscape(config.options.reducer) << "\"";
+}
+
+} // namespace
+
+void BenchmarkReport::add(
+    const RunConfig& config,
+    const ModelBenchmarker& benchmarker,
+    int batchSize,
+    int numUnits,
+    const std::string& unit) {
+  std::ostringstream os;
+  os << std::fixed << std::setprecision(3) << "{";
+  writeConfig(os, config);
+  os << ",\"batchSize\":" << batchSize << ",\"throughput\":"
+     << numUnits * benchmarker.getOptions().worldSize /
+          benchmarker.getBatchTime()
+     << ",\"throughputUnit\":\"" << fl::jsonEscape(unit) << "\"";
+
+  // Update latencies
+  std::vector<double> latencies;
+  for (auto seconds : benchmarker.getBatchTimes()) {
+    latencies.push_back(seconds * 1000);
+  }
+  std::sort(latencies.begin(), latencies.end());
+  os << ",\"latencyMs\":{";
+  if (!latencies.empty()) {
+    // microseconds, as the histogram is computed on integers
+    std::vector<int64_t> latenciesUs;
+    for (auto ms : latencies) {
+      latenciesUs.push_back(std::llround(ms * 1000));
+    }
+    auto stats = fl::FixedBucketSizeHistogram<int64_t>(
+        latenciesUs.begin(), latenciesUs.end(), kLatencyHistogramBuckets);
+    os << "\"mean\":" << stats.mean / 1000 << ",\"min\":" << latencies.front()
+       << ",\"p50\":" << percentile(latencies, 50)
+       << ",\"p90\":" << percentile(latencies, 90)
+       << ",\"p99\":" << percentile(latencies, 99)
+       << ",\"max\":" << latencies.back() << "},\"latencyHistogram\":[";
+    for (size_t i = 0; i < stats.buckets.size(); ++i) {
+      const auto& bucket = stats.buckets[i];
+      os << (i ? "," : "") << "{\"startMs\":" << bucket.startInclusive / 1000.
+         << ",\"endMs\":" << bucket.endExclusive / 1000.
+         << ",\"count\":" << bucket.count << "}";
+    }
+    os << "]";
+  } else {
+    os << "},\"latencyHistogram\":[]";
+  }
+
+  os << ",\"phasesMs\":{\"forward\":" << benchmarker.getForwardTime() * 1000
+     << ",\"criterion\":" << benchmarker.getCriterionTime() * 1000
+     << ",\"backward\":" << benchmarker.getBackwardTime() * 1000
+     << ",\"reduce\":" << benchmarker.getReduceTime() * 1000
+     << ",\"optimizer\":" << benchmarker.getOptimizationTime() * 1000 << "}";
+
+  os << ",\"peakMemoryBytes\":";
+  if (benchmarker.getPeakMemory() >= 0) {
+    os << benchmarker.getPeakMemory();
+  } else {
+    os << "null";
+  }
+  os << "}";
+  results_.push_back(os.str());
+}
+
+void BenchmarkReport::addFailure(
+    const RunConfig& config,
+    const std::string& error) {
+  std::ostringstream os;
+  os << "{";
+  writeConfig(os, config);
+  os << ",\"batchSize\":" << config.batchSize << ",\"error\":\""
+     << fl::jsonEscape(error) << "\"}";
+  results_.push_back(os.str());
+}
+
+void BenchmarkReport::save(const fs::path& filepath) const {
+  std::ofstream file(filepath, std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::runtime_error(
+        "BenchmarkReport::save - failed to open file for writing: " +
+        filepath.string());
+  }
+  file << "{\"worldSize\":" << fl::getWorldSize() << ",\"results\":[\n";
+  for (size_t i = 0; i < results_.size(); ++i) {
+    file << (i ? ",\n" : "") << results_[i];
+  }
+  file << "\n]}\n";
+  file.close();
+  if (!file) {
+    throw std::runtime_error(
+        "BenchmarkReport::save - failed to write file: " + filepath.string());
+  }
+}
+
+} // namespace benchmark
+} // namespace app
+} // namespace fl
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "flashlight/app/benchmark/ModelBenchmarker.h"
+#include "flashlight/fl/common/Filesystem.h"
+
+namespace fl {
+namespace app {
+namespace benchmark {
+
+/**
+ * Setup of a benchmark run, recorded in its results.
+ */
+struct RunConfig {
+  // model name, as given to the `models` flag
+  std::string model;
+  // see `setBackend`
+  std::string backend;
+  // `fp32` or `amp`, which casts the inputs to fp16 without loss scaling
+  std::string precision{"fp32"};
+  // 0 uses the batch size of the model
+  int batchSize{0};
+  BenchmarkOptions options;
+
+  bool fp16() const {
+    return precision == "amp";
+  }
+};
+
+/**
+ * Collects the results of benchmark runs and saves them as JSON, to compare
+ * throughput, latency and memory across hardware and revisions:
+ *
+ * \code
+   {"worldSize": 1, "results": [
+     {"model": "resnet34", "backend": "arrayfire", "precision": "fp32",
+      "optimizer": "sgd", "reducer": "coalescing", "batchSize": 192,
+      "throughput": 676.1, "throughputUnit": "images/sec",
+      "latencyMs": {"mean": ..., "min": ..., "p50": ..., "p90": ...,
+                    "p99": ..., "max": ...},
+      "latencyHistogram": [{"startMs": ..., "endMs": ..., "count": ...}],
+      "phasesMs": {"forward": ..., "criterion": ..., "backward": ...,
+                   "reduce": ..., "optimizer": ...},
+      "peakMemoryBytes": 12440027136},
+     {"model": "detr", "backend": "onednn", ..., "error": "..."}]}
+   \endcode
+ *
+ * Latencies are those of each update on the first process; the throughput
+ * and phase times are averaged over all processes. The peak memory is null
+ * when the backend does not report it.
+ */
+class BenchmarkReport {
+ public:
+  void add(
+      const RunConfig& config,
+      const ModelBenchmarker& benchmarker,
+      int batchSize,
+      int numUnits,
+      const std::string& unit);
+
+  void addFailure(const RunConfig& config, const std::string& error);
+
+  void save(const fs::path& filepath) const;
+
+ private:
+  // JSON objects
+  std::vector<std::string> results_;
+};
+
+} // namespace benchmark
+} // namespace app
+} // namespace fl
@@ -7,30 +7,71 @@
 
 #include "flashlight/app/benchmark/ModelBenchmarker.h"
 
-#include "flashlight/pkg/runtime/common/DistributedUtils.h"
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
 #include "flashlight/fl/flashlight.h"
+#include "flashlight/fl/tensor/DefaultTensorType.h"
+#include "flashlight/pkg/runtime/common/DistributedUtils.h"
+#include "flashlight/pkg/speech/runtime/Optimizer.h"
+
+#if FL_USE_ARRAYFIRE
+#include "flashlight/fl/tensor/backend/af/mem/MemoryManagerInstaller.h"
+#endif
 
 namespace fl {
 namespace app {
 namespace benchmark {
 
-constexpr size_t kWarmupUpdates = 50;
-constexpr size_t kRunUpdates = 100;
+namespace {
+
+/**
+ * Returns the bytes reserved by the memory manager of the default tensor
+ * backend, or -1 if unavailable.
+ */
+int64_t reservedMemory() {
+#if FL_USE_ARRAYFIRE
+  if (fl::defaultTensorBackend().backendType() !=
+      fl::TensorBackendType::ArrayFire) {
+    return -1;
+  }
+  auto* manager = fl::MemoryManagerInstaller::currentlyInstalledMemoryManager();
+  if (!manager) {
+    return -1;
+  }
+  return manager->getMemorySnapshot().reservedBytes;
+#else
+  return -1;
+#endif
+}
+
+} // namespace
 
 ModelBenchmarker::ModelBenchmarker(
     std::shared_ptr<fl::Module>& model,
     const Criterion& criterion,
     const int worldSize)
     : model_(model), criterion_(criterion) {
+  options_.worldSize = worldSize;
   createOptimizer();
-  createReducer(worldSize);
+  createReducer();
+}
+
+ModelBenchmarker::ModelBenchmarker(
+    std::shared_ptr<fl::Module>& model,
+    const Criterion& criterion,
+    const BenchmarkOptions& options)
+    : model_(model), criterion_(criterion), options_(options) {
+  createOptimizer();
+  createReducer();
 }
 
 void ModelBenchmarker::runBenchmark(const std::vector<fl::Variable>& input) {
   model_->train();
 
   // Warmup
-  for (int i = 0; i < kWarmupUpdates; i++) {
+  for (int i = 0; i < options_.warmupUpdates; i++) {
     optimizer_->zeroGrad();
     auto output = model_->forward(input);
     auto loss = criterion_(output);
@@ -43,7 +84,14 @@ void ModelBenchmarker::runBenchmark(const std::vector<fl::Variable>& input) {
   fl::sync();
 
   // Benchmark
-  for (int i = 0; i < kRunUpdates; i++) {
+  batchTimes_.clear();
+  batchTimes_.reserve(options_.runUpdates);
+  peakMemory_ = reservedMemory();
+  auto updatePeakMemory = [this]() {
+    peakMemory_ = std::max(peakMemory_, reservedMemory());
+  };
+  for (int i = 0; i < options_.runUpdates; i++) {
+    const auto batchStart = std::chrono::steady_clock::now();
     batchTimerMeter_.resume();
     optimizer_->zeroGrad();
 
@@ -52,29 +100,42 @@ void ModelBenchmarker::runBenchmark(const std::vector<fl::Variable>& input) {
     auto output = model_->forward(input);
     fl::sync();
     fwdTimeMeter_.stopAndIncUnit();
+    updatePeakMemory();
 
     // 2. criterion forward
     critFwdTimeMeter_.resume();
     auto loss = criterion_(output);
     fl::sync();
     critFwdTimeMeter_.stopAndIncUnit();
+    updatePeakMemory();
 
     // 3. backward
     bwdTimeMeter_.resume();
     loss.backward();
+    fl::sync();
+    bwdTimeMeter_.stopAndIncUnit();
+    updatePeakMemory();
+
+    // 4. reduce the gradients left once backward completes
+    reduceTimeMeter_.resume();
     if (reducer_) {
       reducer_->finalize();
     }
     fl::sync();
-    bwdTimeMeter_.stopAndIncUnit();
+    reduceTimeMeter_.stopAndIncUnit();
 
-    // 4. optimize
+    // 5. optimize
     optimTimeMeter_.resume();
     optimizer_->step();
     fl::sync();
     optimTimeMeter_.stopAndIncUnit();
+    updatePeakMemory();
 
     batchTimerMeter_.stopAndIncUnit();
+    batchTimes_.push_back(
+        std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - batchStart)
+            .count());
   }
 
   syncMeters();
@@ -96,36 +157,66 @@ double ModelBenchmarker::getBackwardTime() const {
   return bwdTimeMeter_.value();
 }
 
+double ModelBenchmarker::getReduceTime() const {
+  return reduceTimeMeter_.value();
+}
+
 double ModelBenchmarker::getOptimizationTime() const {
   return optimTimeMeter_.value();
 }
 
+const std::vector<double>& ModelBenchmarker::getBatchTimes() const {
+  return batchTimes_;
+}
+
+int64_t ModelBenchmarker::getPeakMemory() const {
+  return peakMemory_;
+}
+
+const BenchmarkOptions& ModelBenchmarker::getOptions() const {
+  return options_;
+}
+
 void ModelBenchmarker::syncMeters() {
   fl::pkg::runtime::syncMeter(batchTimerMeter_);
   fl::pkg::runtime::syncMeter(fwdTimeMeter_);
   fl::pkg::runtime::syncMeter(critFwdTimeMeter_);
   fl::pkg::runtime::syncMeter(bwdTimeMeter_);
+  fl::pkg::runtime::syncMeter(reduceTimeMeter_);
   fl::pkg::runtime::syncMeter(optimTimeMeter_);
 }
 
 void ModelBenchmarker::createOptimizer() {
-  auto parameters = model_->params();
-  optimizer_ = std::make_shared<fl::SGDOptimizer>(
-      parameters,
+  optimizer_ = fl::pkg::speech::initOptimizer(
+      {model_},
+      options_.optimizer,
       0.1, // lr
       0.9, // momentum
       0.1 // weight_decay
   );
 }
 
-void ModelBenchmarker::createReducer(const int worldSize) {
+void ModelBenchmarker::createReducer() {
+  const int worldSize = options_.worldSize;
   if (worldSize <= 1) {
     return;
   }
 
-  reducer_ =
-      std::make_shared<fl::CoalescingReducer>(1.0 / worldSize, true, true);
-  fl::distributeModuleGrads(model_, reducer_);
+  if (options_.reducer == "coalescing") {
+    reducer_ =
+        std::make_shared<fl::CoalescingReducer>(1.0 / worldSize, true, true);
+    fl::distributeModuleGrads(model_, reducer_);
+  } else if (options_.reducer == "inline") {
+    reducer_ = std::make_shared<fl::InlineReducer>(1.0 / worldSize);
+    fl::distributeModuleGrads(model_, reducer_);
+  } else if (options_.reducer == "bucketed") {
+    // Registers its own gradient hooks
+    reducer_ = std::make_shared<fl::BucketedReducer>(
+        model_->params(), 1.0 / worldSize);
+  } else {
+    throw std::invalid_argument(
+        "ModelBenchmarker - unknown reducer: " + options_.reducer);
+  }
 }
 
 } // namespace benchmark
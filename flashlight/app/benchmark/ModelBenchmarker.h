@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <string>
 #include <vector>
 
 #include "flashlight/fl/flashlight.h"
@@ -17,6 +18,21 @@ namespace benchmark {
 
 using Criterion = std::function<fl::Variable(const std::vector<fl::Variable>&)>;
 
+/**
+ * Training setup of a benchmark run.
+ */
+struct BenchmarkOptions {
+  // one of `sgd`, `adam`, `rmsprop`, `adadelta`, `adagrad`, `amsgrad`,
+  // `novograd`
+  std::string optimizer{"sgd"};
+  // one of `coalescing`, `bucketed`, `inline`. Only used with more than one
+  // process.
+  std::string reducer{"coalescing"};
+  int worldSize{1};
+  int warmupUpdates{50};
+  int runUpdates{100};
+};
+
 class ModelBenchmarker {
  public:
   ModelBenchmarker(
@@ -24,6 +40,11 @@ class ModelBenchmarker {
       const Criterion& criterion,
       const int worldSize = 1);
 
+  ModelBenchmarker(
+      std::shared_ptr<fl::Module>& model,
+      const Criterion& criterion,
+      const BenchmarkOptions& options);
+
   void runBenchmark(const std::vector<fl::Variable>& input);
 
   // Return time splits in seconds
@@ -31,27 +52,40 @@ class ModelBenchmarker {
   double getForwardTime() const;
   double getCriterionTime() const;
   double getBackwardTime() const;
+  double getReduceTime() const;
   double getOptimizationTime() const;
 
+  // Return the time of each benchmarked update in seconds
+  const std::vector<double>& getBatchTimes() const;
+
+  // Return the peak bytes reserved by the memory manager during the
+  // benchmark, or -1 if the tensor backend does not report it
+  int64_t getPeakMemory() const;
+
+  const BenchmarkOptions& getOptions() const;
+
  private:
   std::shared_ptr<fl::Module> model_;
   Criterion criterion_;
+  BenchmarkOptions options_;
   std::shared_ptr<fl::Reducer> reducer_;
 
-  std::shared_ptr<fl::SGDOptimizer> optimizer_;
+  std::shared_ptr<fl::FirstOrderOptimizer> optimizer_;
 
   fl::TimeMeter batchTimerMeter_{true};
   fl::TimeMeter fwdTimeMeter_{true};
   fl::TimeMeter critFwdTimeMeter_{true};
   fl::TimeMeter bwdTimeMeter_{true};
+  fl::TimeMeter reduceTimeMeter_{true};
   fl::TimeMeter optimTimeMeter_{true};
 
+  std::vector<double> batchTimes_;
+  int64_t peakMemory_{-1};
+
   void syncMeters();
 
-  // TODO: support optimizer selection
   void createOptimizer();
-  // TODO: support reducer selection
-  void createReducer(const int worldSize);
+  void createReducer();
 };
 
 } // namespace benchmark
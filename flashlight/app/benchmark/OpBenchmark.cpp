@@ -0,0 +1,640 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+/**
+ * Microbenchmark of the operations of TensorBackend, swept over shapes, data
+ * types and tensor backends. Each op is reported with its throughput in GB/s
+ * and GFLOP/s, and the fraction of the roofline it reaches: the time bound by
+ * the memory bandwidth and compute throughput of the backend, either given
+ * with --peak_gbps and --peak_gflops or calibrated with a large elementwise
+ * add and matmul. Traffic is estimated as reading every input and writing the
+ * output once, which is what a fused op would achieve.
+ *
+ * Results can be saved with --output_path and compared with a previous run
+ * with --baseline_path, ops slower than the baseline by more than
+ * --regression_threshold making the benchmark exit with an error.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+
+#include "flashlight/app/benchmark/Utils.h"
+#include "flashlight/fl/common/Timer.h"
+#include "flashlight/fl/tensor/Compute.h"
+#include "flashlight/fl/tensor/DefaultTensorType.h"
+#include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/Random.h"
+#include "flashlight/fl/tensor/TensorBackend.h"
+#include "flashlight/fl/tensor/TensorBase.h"
+#include "flashlight/lib/text/String.h"
+
+#if FL_USE_JIT
+#include "flashlight/fl/tensor/backend/jit/opt/Optimizer.h"
+#endif
+
+DEFINE_string(
+    backends,
+    "",
+    "Comma-separated tensor backends to benchmark: arrayfire, onednn, jit "
+    "(the JIT backend over oneDNN) and jit_nofusion (the same, without the "
+    "passes of JIT optimizer extensions such as OneDnnOpFusion). If empty, "
+    "uses the default backend.");
+DEFINE_string(
+    ops,
+    "",
+    "Comma-separated ops to benchmark. If empty, benchmarks all ops.");
+DEFINE_string(
+    shapes,
+    "1024x1024,4096x4096",
+    "Comma-separated 2D shapes of the op inputs, e.g. 1024x1024");
+DEFINE_string(dtypes, "f32,f16", "Comma-separated data types, e.g. f32,s32");
+DEFINE_double(min_time_ms, 50, "Minimum time spent timing each op");
+DEFINE_double(
+    peak_gbps,
+    0,
+    "Memory bandwidth of the roofline in GB/s. If 0, calibrated.");
+DEFINE_double(
+    peak_gflops,
+    0,
+    "Compute throughput of the roofline in GFLOP/s. If 0, calibrated.");
+DEFINE_string(output_path, "", "If not empty, path to save the results to");
+DEFINE_string(
+    baseline_path,
+    "",
+    "If not empty, path of the results of a previous run to compare with");
+DEFINE_double(
+    regression_threshold,
+    0.1,
+    "Relative slowdown from the baseline reported as a regression");
+
+namespace {
+
+using Inputs = std::vector<fl::Tensor>;
+
+struct Op {
+  std::string name;
+  std::function<Inputs(const fl::Shape&, fl::dtype)> makeInputs;
+  std::function<fl::Tensor(const Inputs&)> run;
+  // floating point operations as a function of the input shape
+  std::function<double(const fl::Shape&)> flops;
+  // whether the inputs are read by the op, or only carry its parameters
+  bool readsInputs{true};
+};
+
+struct Roofline {
+  double bytesPerSec;
+  double flopsPerSec;
+};
+
+struct Result {
+  std::string op;
+  std::string backend;
+  std::string dtype;
+  std::string shape;
+  double timeUs;
+  double gbps;
+  double gflops;
+  double rooflinePct;
+
+  std::string key() const {
+    return op + "\t" + backend + "\t" + dtype + "\t" + shape;
+  }
+};
+
+fl::Tensor randomTensor(const fl::Shape& shape, fl::dtype type) {
+  // In [0.5, 1.5) so that all ops are defined
+  return (fl::rand(shape) + 0.5).astype(type);
+}
+
+std::function<Inputs(const fl::Shape&, fl::dtype)> randomInputs(int n) {
+  return [n](const fl::Shape& shape, fl::dtype type) {
+    Inputs inputs;
+    for (int i = 0; i < n; ++i) {
+      inputs.push_back(randomTensor(shape, type));
+    }
+    return inputs;
+  };
+}
+
+std::function<double(const fl::Shape&)> flopsPerElement(double flops) {
+  return [flops](const fl::Shape& shape) { return flops * shape.elements(); };
+}
+
+Op unaryOp(
+    const std::string& name,
+    std::function<fl::Tensor(const fl::Tensor&)> func,
+    double flops = 1) {
+  return {
+      name,
+      randomInputs(1),
+      [func](const Inputs& in) { return func(in[0]); },
+      flopsPerElement(flops)};
+}
+
+Op binaryOp(
+    const std::string& name,
+    std::function<fl::Tensor(const fl::Tensor&, const fl::Tensor&)> func,
+    double flops = 1) {
+  return {
+      name,
+      randomInputs(2),
+      [func](const Inputs& in) { return func(in[0], in[1]); },
+      flopsPerElement(flops)};
+}
+
+Op creationOp(
+    const std::string& name,
+    std::function<fl::Tensor(const fl::Shape&, fl::dtype)> func) {
+  return {
+      name,
+      [](const fl::Shape& shape, fl::dtype type) {
+        // Only carries the shape and type
+        return Inputs{fl::full({1}, 0, type), fl::full(shape, 0, type)};
+      },
+      [func](const Inputs& in) {
+        return func(in[1].shape(), in[0].type());
+      },
+      flopsPerElement(0),
+      /* readsInputs = */ false};
+}
+
+std::vector<Op> allOps() {
+  using fl::Tensor;
+  std::vector<Op> ops;
+
+  // Creation
+  ops.push_back(creationOp("full", [](const fl::Shape& s, fl::dtype t) {
+    return fl::full(s, 1, t);
+  }));
+  ops.push_back(creationOp("arange", [](const fl::Shape& s, fl::dtype t) {
+    return fl::arange(s, 0, t);
+  }));
+  ops.push_back(creationOp("iota", [](const fl::Shape& s, fl::dtype t) {
+    return fl::iota(s, {1}, t);
+  }));
+  ops.push_back(creationOp("identity", [](const fl::Shape& s, fl::dtype t) {
+    return fl::identity(s[0], t);
+  }));
+  ops.push_back(creationOp("rand", [](const fl::Shape& s, fl::dtype t) {
+    return fl::rand(s, t);
+  }));
+  ops.push_back(creationOp("randn", [](const fl::Shape& s, fl::dtype t) {
+    return fl::randn(s, t);
+  }));
+
+  // Shape and layout
+  ops.push_back(unaryOp(
+      "reshape", [](const Tensor& a) { return fl::reshape(a, {-1}); }, 0));
+  ops.push_back(unaryOp(
+      "transpose", [](const Tensor& a) { return fl::transpose(a); }, 0));
+  ops.push_back(
+      unaryOp("tile", [](const Tensor& a) { return fl::tile(a, {2}); }, 0));
+  ops.push_back(binaryOp(
+      "concatenate",
+      [](const Tensor& a, const Tensor& b) {
+        return fl::concatenate(0, a, b);
+      },
+      0));
+  ops.push_back(unaryOp(
+      "pad",
+      [](const Tensor& a) { return fl::pad(a, {{1, 1}, {1, 1}}); },
+      0));
+  ops.push_back(
+      unaryOp("nonzero", [](const Tensor& a) { return fl::nonzero(a); }, 0));
+  ops.push_back(
+      unaryOp("flip", [](const Tensor& a) { return fl::flip(a, 0); }, 0));
+  ops.push_back(
+      unaryOp("roll", [](const Tensor& a) { return fl::roll(a, 1, 0); }, 0));
+  ops.push_back(unaryOp("tril", [](const Tensor& a) { return fl::tril(a); }));
+  ops.push_back(unaryOp("triu", [](const Tensor& a) { return fl::triu(a); }));
+  ops.push_back(unaryOp(
+      "astype",
+      [](const Tensor& a) {
+        return a.astype(
+            a.type() == fl::dtype::f32 ? fl::dtype::f16 : fl::dtype::f32);
+      },
+      0));
+
+  // Unary
+  ops.push_back(unaryOp("exp", [](const Tensor& a) { return fl::exp(a); }));
+  ops.push_back(unaryOp("log", [](const Tensor& a) { return fl::log(a); }));
+  ops.push_back(
+      unaryOp("negative", [](const Tensor& a) { return fl::negative(a); }));
+  ops.push_back(unaryOp(
+      "logicalNot", [](const Tensor& a) { return fl::logicalNot(a); }));
+  ops.push_back(
+      unaryOp("log1p", [](const Tensor& a) { return fl::log1p(a); }));
+  ops.push_back(unaryOp("sin", [](const Tensor& a) { return fl::sin(a); }));
+  ops.push_back(unaryOp("cos", [](const Tensor& a) { return fl::cos(a); }));
+  ops.push_back(unaryOp("sqrt", [](const Tensor& a) { return fl::sqrt(a); }));
+  ops.push_back(unaryOp("tanh", [](const Tensor& a) { return fl::tanh(a); }));
+  ops.push_back(
+      unaryOp("floor", [](const Tensor& a) { return fl::floor(a); }));
+  ops.push_back(unaryOp("ceil", [](const Tensor& a) { return fl::ceil(a); }));
+  ops.push_back(unaryOp("rint", [](const Tensor& a) { return fl::rint(a); }));
+  ops.push_back(
+      unaryOp("absolute", [](const Tensor& a) { return fl::absolute(a); }));
+  ops.push_back(
+      unaryOp("sigmoid", [](const Tensor& a) { return fl::sigmoid(a); }));
+  ops.push_back(unaryOp("erf", [](const Tensor& a) { return fl::erf(a); }));
+  ops.push_back(
+      unaryOp("isnan", [](const Tensor& a) { return fl::isnan(a); }));
+  ops.push_back(
+      unaryOp("isinf", [](const Tensor& a) { return fl::isinf(a); }));
+  ops.push_back(unaryOp("sign", [](const Tensor& a) { return fl::sign(a); }));
+  ops.push_back(unaryOp(
+      "clip", [](const Tensor& a) { return fl::clip(a, 0.7, 1.3); }, 2));
+
+  // Binary
+  ops.push_back(binaryOp(
+      "add", [](const Tensor& a, const Tensor& b) { return a + b; }));
+  ops.push_back(binaryOp(
+      "sub", [](const Tensor& a, const Tensor& b) { return a - b; }));
+  ops.push_back(binaryOp(
+      "mul", [](const Tensor& a, const Tensor& b) { return a * b; }));
+  ops.push_back(binaryOp(
+      "div", [](const Tensor& a, const Tensor& b) { return a / b; }));
+  ops.push_back(binaryOp(
+      "eq", [](const Tensor& a, const Tensor& b) { return a == b; }));
+  ops.push_back(binaryOp(
+      "neq", [](const Tensor& a, const Tensor& b) { return a != b; }));
+  ops.push_back(binaryOp(
+      "lt", [](const Tensor& a, const Tensor& b) { return a < b; }));
+  ops.push_back(binaryOp(
+      "lte", [](const Tensor& a, const Tensor& b) { return a <= b; }));
+  ops.push_back(binaryOp(
+      "gt", [](const Tensor& a, const Tensor& b) { return a > b; }));
+  ops.push_back(binaryOp(
+      "gte", [](const Tensor& a, const Tensor& b) { return a >= b; }));
+  ops.push_back(binaryOp(
+      "logicalOr", [](const Tensor& a, const Tensor& b) { return a || b; }));
+  ops.push_back(binaryOp(
+      "logicalAnd", [](const Tensor& a, const Tensor& b) { return a && b; }));
+  ops.push_back(binaryOp(
+      "mod", [](const Tensor& a, const Tensor& b) { return a % b; }));
+  // Bitwise ops are only defined for integral types
+  ops.push_back(binaryOp(
+      "bitwiseAnd", [](const Tensor& a, const Tensor& b) { return a & b; }));
+  ops.push_back(binaryOp(
+      "bitwiseOr", [](const Tensor& a, const Tensor& b) { return a | b; }));
+  ops.push_back(binaryOp(
+      "bitwiseXor", [](const Tensor& a, const Tensor& b) { return a ^ b; }));
+  ops.push_back(binaryOp(
+      "lShift", [](const Tensor& a, const Tensor& b) { return a << b; }));
+  ops.push_back(binaryOp(
+      "rShift", [](const Tensor& a, const Tensor& b) { return a >> b; }));
+  ops.push_back(binaryOp("minimum", [](const Tensor& a, const Tensor& b) {
+    return fl::minimum(a, b);
+  }));
+  ops.push_back(binaryOp("maximum", [](const Tensor& a, const Tensor& b) {
+    return fl::maximum(a, b);
+  }));
+  ops.push_back(binaryOp("power", [](const Tensor& a, const Tensor& b) {
+    return fl::power(a, b);
+  }));
+  ops.push_back(
+      {"where",
+       randomInputs(3),
+       [](const Inputs& in) { return fl::where(in[0] > 1, in[1], in[2]); },
+       flopsPerElement(2)});
+
+  // Matrix multiplication of two square matrices
+  ops.push_back(
+      {"matmul",
+       [](const fl::Shape& shape, fl::dtype type) {
+         return Inputs{
+             randomTensor({shape[0], shape[0]}, type),
+             randomTensor({shape[0], shape[0]}, type)};
+       },
+       [](const Inputs& in) { return fl::matmul(in[0], in[1]); },
+       [](const fl::Shape& shape) {
+         return 2. * shape[0] * shape[0] * shape[0];
+       }});
+
+  // Reductions along the first axis
+  ops.push_back(unaryOp(
+      "amin", [](const Tensor& a) { return fl::amin(a, {0}); }));
+  ops.push_back(unaryOp(
+      "amax", [](const Tensor& a) { return fl::amax(a, {0}); }));
+  ops.push_back(unaryOp("min", [](const Tensor& a) {
+    Tensor values, indices;
+    fl::min(values, indices, a, 0);
+    return values;
+  }));
+  ops.push_back(unaryOp("max", [](const Tensor& a) {
+    Tensor values, indices;
+    fl::max(values, indices, a, 0);
+    return values;
+  }));
+  ops.push_back(
+      unaryOp("sum", [](const Tensor& a) { return fl::sum(a, {0}); }));
+  ops.push_back(
+      unaryOp("cumsum", [](const Tensor& a) { return fl::cumsum(a, 0); }));
+  ops.push_back(
+      unaryOp("argmax", [](const Tensor& a) { return fl::argmax(a, 0); }));
+  ops.push_back(
+      unaryOp("argmin", [](const Tensor& a) { return fl::argmin(a, 0); }));
+  ops.push_back(
+      unaryOp("mean", [](const Tensor& a) { return fl::mean(a, {0}); }));
+  ops.push_back(
+      unaryOp("median", [](const Tensor& a) { return fl::median(a, {0}); }));
+  ops.push_back(
+      unaryOp("var", [](const Tensor& a) { return fl::var(a, {0}); }, 3));
+  ops.push_back(
+      unaryOp("std", [](const Tensor& a) { return fl::std(a, {0}); }, 3));
+  ops.push_back(
+      unaryOp("norm", [](const Tensor& a) { return fl::norm(a, {0}); }, 2));
+  ops.push_back(unaryOp("countNonzero", [](const Tensor& a) {
+    return fl::countNonzero(a, {0});
+  }));
+  ops.push_back(
+      unaryOp("any", [](const Tensor& a) { return fl::any(a, {0}); }));
+  ops.push_back(
+      unaryOp("all", [](const Tensor& a) { return fl::all(a, {0}); }));
+
+  // Sorting along the first axis, at n log(n) comparisons
+  auto sortFlops = [](const fl::Shape& shape) {
+    return shape.elements() * std::log2(std::max<double>(shape[0], 2));
+  };
+  ops.push_back(
+      {"sort",
+       randomInputs(1),
+       [](const Inputs& in) { return fl::sort(in[0], 0); },
+       sortFlops});
+  ops.push_back(
+      {"argsort",
+       randomInputs(1),
+       [](const Inputs& in) { return fl::argsort(in[0], 0); },
+       sortFlops});
+  ops.push_back(
+      {"topk",
+       randomInputs(1),
+       [](const Inputs& in) {
+         Tensor values, indices;
+         fl::topk(values, indices, in[0], 10, 0);
+         return values;
+       },
+       flopsPerElement(1)});
+
+  // Elementwise chains, fused into a single kernel by OneDnnOpFusion on the
+  // JIT backend
+  ops.push_back(binaryOp(
+      "fused_axpby",
+      [](const Tensor& a, const Tensor& b) { return a * 2 + b * 3; },
+      3));
+  ops.push_back(unaryOp(
+      "fused_relu6",
+      [](const Tensor& a) { return fl::minimum(fl::maximum(a, 0.), 6.); },
+      2));
+  ops.push_back(unaryOp(
+      "fused_gelu",
+      [](const Tensor& a) {
+        return a * 0.5 * (fl::tanh((a + a * a * a * 0.044715) * 0.79788) + 1);
+      },
+      9));
+
+  return ops;
+}
+
+/**
+ * Returns the seconds per run of `func`, run at least `--min_time_ms`.
+ */
+double timeit(const std::function<void()>& func) {
+  // Warmup
+  func();
+  fl::sync();
+
+  const double minTime = FLAGS_min_time_ms / 1000;
+  for (int iters = 1;; iters *= 2) {
+    auto start = fl::Timer::start();
+    for (int i = 0; i < iters; ++i) {
+      func();
+    }
+    fl::sync();
+    const auto elapsed = fl::Timer::stop(start);
+    if (elapsed >= minTime || iters >= (1 << 20)) {
+      return elapsed / iters;
+    }
+  }
+}
+
+fl::Shape parseShape(const std::string& str) {
+  std::vector<fl::Dim> dims;
+  for (const auto& dim : fl::lib::split("x", str, true)) {
+    dims.push_back(std::stol(dim));
+  }
+  if (dims.size() != 2) {
+    throw std::invalid_argument("parseShape - expected a 2D shape: " + str);
+  }
+  return fl::Shape(dims);
+}
+
+std::string shapeString(const fl::Shape& shape) {
+  return std::to_string(shape[0]) + "x" + std::to_string(shape[1]);
+}
+
+Roofline calibrate() {
+  Roofline roofline{FLAGS_peak_gbps * 1e9, FLAGS_peak_gflops * 1e9};
+  if (roofline.bytesPerSec <= 0) {
+    auto a = randomTensor({8192, 8192}, fl::dtype::f32);
+    auto b = randomTensor({8192, 8192}, fl::dtype::f32);
+    const auto time = timeit([&]() {
+      auto c = a + b;
+      fl::eval(c);
+    });
+    roofline.bytesPerSec = 3. * a.bytes() / time;
+  }
+  if (roofline.flopsPerSec <= 0) {
+    const fl::Dim n = 4096;
+    auto a = randomTensor({n, n}, fl::dtype::f32);
+    auto b = randomTensor({n, n}, fl::dtype::f32);
+    const auto time = timeit([&]() {
+      auto c = fl::matmul(a, b);
+      fl::eval(c);
+    });
+    roofline.flopsPerSec = 2. * n * n * n / time;
+  }
+  std::cout << "Roofline: " << roofline.bytesPerSec / 1e9 << " GB/s, "
+            << roofline.flopsPerSec / 1e9 << " GFLOP/s" << std::endl;
+  return roofline;
+}
+
+/**
+ * Selects a backend of the `backends` flag.
+ */
+void setBackend(const std::string& backend) {
+  if (backend == "default") {
+    return;
+  }
+  const bool noFusion = backend == "jit_nofusion";
+  fl::app::benchmark::setBackend(noFusion ? "jit" : backend);
+#if FL_USE_JIT
+  fl::Optimizer::setExtensionPassesEnabled(!noFusion);
+#endif
+}
+
+std::unordered_map<std::string, double> loadBaseline(const std::string& path) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    throw std::runtime_error("loadBaseline - failed to open file: " + path);
+  }
+  std::unordered_map<std::string, double> baseline;
+  std::string line;
+  // Skip the header
+  std::getline(file, line);
+  while (std::getline(file, line)) {
+    auto fields = fl::lib::split("\t", line);
+    if (fields.size() < 5) {
+      continue;
+    }
+    Result result{fields[0], fields[1], fields[2], fields[3]};
+    baseline[result.key()] = std::stod(fields[4]);
+  }
+  return baseline;
+}
+
+void saveResults(const std::string& path, const std::vector<Result>& results) {
+  std::ofstream file(path, std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::runtime_error("saveResults - failed to open file: " + path);
+  }
+  file << "op\tbackend\tdtype\tshape\ttime_us\tgb_per_s\tgflop_per_s"
+          "\troofline_pct\n";
+  file << std::fixed << std::setprecision(3);
+  for (const auto& r : results) {
+    file << r.key() << "\t" << r.timeUs << "\t" << r.gbps << "\t" << r.gflops
+         << "\t" << r.rooflinePct << "\n";
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  fl::init();
+  gflags::ParseCommandLineFlags(&argc, &argv, false);
+
+  auto backends = fl::lib::split(",", FLAGS_backends, true);
+  if (backends.empty()) {
+    backends.emplace_back("default");
+  }
+  auto opNames = fl::lib::split(",", FLAGS_ops, true);
+  std::vector<Op> ops;
+  for (auto& op : allOps()) {
+    if (opNames.empty() ||
+        std::find(opNames.begin(), opNames.end(), op.name) != opNames.end()) {
+      ops.push_back(std::move(op));
+    }
+  }
+  std::vector<fl::Shape> shapes;
+  for (const auto& shape : fl::lib::split(",", FLAGS_shapes, true)) {
+    shapes.push_back(parseShape(shape));
+  }
+  std::vector<fl::dtype> dtypes;
+  for (const auto& type : fl::lib::split(",", FLAGS_dtypes, true)) {
+    dtypes.push_back(fl::stringToDtype(type));
+  }
+
+  std::vector<Result> results;
+  for (const auto& backend : backends) {
+    setBackend(backend);
+    const auto roofline = calibrate();
+    std::cout << std::left << std::setw(14) << "op" << std::setw(14)
+              << "backend" << std::setw(6) << "dtype" << std::setw(12)
+              << "shape" << std::right << std::setw(12) << "time(us)"
+              << std::setw(10) << "GB/s" << std::setw(10) << "GFLOP/s"
+              << std::setw(10) << "roofline" << std::endl;
+    for (const auto& op : ops) {
+      for (auto type : dtypes) {
+        if (!fl::defaultTensorBackend().isDataTypeSupported(type)) {
+          continue;
+        }
+        for (const auto& shape : shapes) {
+          Result result{
+              op.name, backend, fl::dtypeToString(type), shapeString(shape)};
+          try {
+            auto inputs = op.makeInputs(shape, type);
+            for (auto& input : inputs) {
+              fl::eval(input);
+            }
+            auto output = op.run(inputs);
+            fl::eval(output);
+            double bytes = output.bytes();
+            for (const auto& input : inputs) {
+              bytes += op.readsInputs ? input.bytes() : 0;
+            }
+            const double flops = op.flops(shape);
+
+            const double time = timeit([&]() {
+              auto out = op.run(inputs);
+              fl::eval(out);
+            });
+            const double rooflineTime = std::max(
+                bytes / roofline.bytesPerSec, flops / roofline.flopsPerSec);
+            result.timeUs = time * 1e6;
+            result.gbps = bytes / time / 1e9;
+            result.gflops = flops / time / 1e9;
+            result.rooflinePct = 100 * rooflineTime / time;
+          } catch (const std::exception& ex) {
+            // Ops or types not supported by a backend
+            LOG(WARNING) << op.name << " (" << result.dtype << ", "
+                         << result.shape << ") failed on " << backend << ": "
+                         << ex.what();
+            continue;
+          }
+          std::cout << std::left << std::setw(14) << result.op
+                    << std::setw(14) << result.backend << std::setw(6)
+                    << result.dtype << std::setw(12) << result.shape
+                    << std::right << std::fixed << std::setprecision(1)
+                    << std::setw(12) << result.timeUs << std::setw(10)
+                    << result.gbps << std::setw(10) << result.gflops
+                    << std::setw(9) << result.rooflinePct << "%"
+                    << std::endl;
+          results.push_back(result);
+        }
+      }
+    }
+  }
+#if FL_USE_JIT
+  fl::Optimizer::setExtensionPassesEnabled(true);
+#endif
+
+  if (!FLAGS_output_path.empty()) {
+    saveResults(FLAGS_output_path, results);
+  }
+
+  if (FLAGS_baseline_path.empty()) {
+    return 0;
+  }
+  const auto baseline = loadBaseline(FLAGS_baseline_path);
+  int numRegressions = 0;
+  std::cout << "\nComparison with " << FLAGS_baseline_path << std::endl;
+  for (const auto& result : results) {
+    auto it = baseline.find(result.key());
+    if (it == baseline.end()) {
+      continue;
+    }
+    const double speedup = it->second / result.timeUs;
+    const bool regression = speedup < 1 / (1 + FLAGS_regression_threshold);
+    numRegressions += regression;
+    std::cout << std::left << std::setw(14) << result.op << std::setw(14)
+              << result.backend << std::setw(6) << result.dtype
+              << std::setw(12) << result.shape << std::right << std::fixed
+              << std::setprecision(2) << std::setw(8) << speedup << "x"
+              << (regression ? "  REGRESSION" : "") << std::endl;
+  }
+  std::cout << numRegressions << " regression(s)" << std::endl;
+  return numRegressions > 0 ? 1 : 0;
+}
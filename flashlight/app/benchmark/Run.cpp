@@ -5,10 +5,17 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <functional>
+#include <map>
+
 #include <gflags/gflags.h>
+#include <glog/logging.h>
 
+#include "flashlight/app/benchmark/BenchmarkReport.h"
 #include "flashlight/app/benchmark/ModelBenchmarker.h"
 #include "flashlight/app/benchmark/Utils.h"
+#include "flashlight/app/benchmark/models/AsrConformer.h"
+#include "flashlight/app/benchmark/models/AsrTds.h"
 #include "flashlight/app/benchmark/models/AsrTransformer.h"
 #include "flashlight/app/benchmark/models/LmTransformer.h"
 #include "flashlight/fl/tensor/Index.h"
@@ -23,6 +30,43 @@
 
 DEFINE_bool(log_verbose, false, "Log out detailed running time benchmark");
 
+DEFINE_string(
+    models,
+    "vit,resnet34,resnet50,detr,lm_transformer,asr_transformer,"
+    "asr_conformer,asr_tds",
+    "Comma-separated models to benchmark");
+DEFINE_string(
+    backends,
+    "",
+    "Comma-separated tensor backends to benchmark: arrayfire, onednn, jit "
+    "(the JIT backend over oneDNN). If empty, uses the default backend.");
+DEFINE_string(
+    precisions,
+    "fp32,amp",
+    "Comma-separated precisions to benchmark: fp32, amp (fp16 inputs, "
+    "without loss scaling)");
+DEFINE_string(
+    batch_sizes,
+    "",
+    "Comma-separated batch sizes to benchmark. If empty, uses the batch size "
+    "of each model.");
+DEFINE_string(
+    optimizers,
+    "sgd",
+    "Comma-separated optimizers to benchmark: sgd, adam, rmsprop, adadelta, "
+    "adagrad, amsgrad, novograd");
+DEFINE_string(
+    reducers,
+    "coalescing",
+    "Comma-separated gradient reducers to benchmark when distributed: "
+    "coalescing, bucketed, inline");
+DEFINE_int64(warmup_updates, 50, "Number of updates before benchmarking");
+DEFINE_int64(run_updates, 100, "Number of benchmarked updates");
+DEFINE_string(
+    report_path,
+    "",
+    "If not empty, path of a JSON report of all benchmark runs");
+
 DEFINE_bool(distributed_enable, false, "Enable distributed training");
 DEFINE_int64(
     distributed_max_devices_per_node,
@@ -42,12 +86,18 @@ DEFINE_string(
     "Shared file path used for setting up rendezvous."
     "If empty, uses MPI to initialize.");
 
+using fl::app::benchmark::BenchmarkReport;
+using fl::app::benchmark::RunConfig;
+using Runner = std::function<void(const RunConfig&, BenchmarkReport&)>;
+
 /* ------------------------------- ViTBase ------------------------------- */
-void runViTBase(bool fp16 = false) {
+void runViTBase(const RunConfig& config, BenchmarkReport& report) {
   fl::app::benchmark::init();
+  const bool fp16 = config.fp16();
 
   // Data
-  const int batchsize = 64, imgSize = 224;
+  const int batchsize = config.batchSize > 0 ? config.batchSize : 64;
+  const int imgSize = 224;
   auto input = fl::input(fl::rand({imgSize, imgSize, 3, batchsize}));
   auto target = fl::noGrad(fl::rand({1000, batchsize}));
   if (fp16) {
@@ -75,20 +125,23 @@ void runViTBase(bool fp16 = false) {
 
   // Test
   fl::app::benchmark::ModelBenchmarker benchmarker(
-      model, criterion, fl::getWorldSize());
+      model, criterion, config.options);
   benchmarker.runBenchmark({input});
 
   // Print
   fl::app::benchmark::printInfo(
       "ViTBase", fp16, benchmarker, batchsize, FLAGS_log_verbose);
+  report.add(config, benchmarker, batchsize, batchsize, "images/sec");
 }
 
 /* ------------------------------- ResNet34 ------------------------------- */
-void runResNet34(bool fp16 = false) {
+void runResNet34(const RunConfig& config, BenchmarkReport& report) {
   fl::app::benchmark::init();
+  const bool fp16 = config.fp16();
 
   // Data
-  const int batchsize = 192, imgSize = 224;
+  const int batchsize = config.batchSize > 0 ? config.batchSize : 192;
+  const int imgSize = 224;
   auto input = fl::input(fl::rand({imgSize, imgSize, 3, batchsize}));
   auto target = fl::noGrad(fl::rand({batchsize}) * 1000).astype(fl::dtype::s32);
   if (fp16) {
@@ -105,20 +158,23 @@ void runResNet34(bool fp16 = false) {
 
   // Test
   fl::app::benchmark::ModelBenchmarker benchmarker(
-      model, criterion, fl::getWorldSize());
+      model, criterion, config.options);
   benchmarker.runBenchmark({input});
 
   // Print
   fl::app::benchmark::printInfo(
       "ResNet34", fp16, benchmarker, batchsize, FLAGS_log_verbose);
+  report.add(config, benchmarker, batchsize, batchsize, "images/sec");
 }
 
 /* ------------------------------- ResNet50 ------------------------------- */
-void runResNet50(bool fp16 = false) {
+void runResNet50(const RunConfig& config, BenchmarkReport& report) {
   fl::app::benchmark::init();
+  const bool fp16 = config.fp16();
 
   // Data
-  const int batchsize = 192, imgSize = 224;
+  const int batchsize = config.batchSize > 0 ? config.batchSize : 192;
+  const int imgSize = 224;
   auto input = fl::input(fl::rand({imgSize, imgSize, 3, batchsize}));
   auto target = fl::noGrad(fl::rand({batchsize}) * 1000).astype(fl::dtype::s32);
   if (fp16) {
@@ -135,21 +191,24 @@ void runResNet50(bool fp16 = false) {
 
   // Test
   fl::app::benchmark::ModelBenchmarker benchmarker(
-      model, criterion, fl::getWorldSize());
+      model, criterion, config.options);
   benchmarker.runBenchmark({input});
 
   // Print
   fl::app::benchmark::printInfo(
       "ResNet50", fp16, benchmarker, batchsize, FLAGS_log_verbose);
+  report.add(config, benchmarker, batchsize, batchsize, "images/sec");
 }
 
 /* ------------------------------- Detr ------------------------------- */
-void runDetr(bool fp16 = false) {
+void runDetr(const RunConfig& config, BenchmarkReport& report) {
   fl::app::benchmark::init();
+  const bool fp16 = config.fp16();
 
   // Data
   const auto dataType = fp16 ? fl::dtype::f16 : fl::dtype::f32;
-  const int batchsize = 12, numObjs = 4;
+  const int batchsize = config.batchSize > 0 ? config.batchSize : 12;
+  const int numObjs = 4;
   const int imgSize = 800;
   auto input = fl::input(fl::rand({imgSize, imgSize, 3, batchsize}, dataType));
   auto mask = fl::input(fl::rand({imgSize, imgSize, 1, batchsize}));
@@ -221,20 +280,23 @@ void runDetr(bool fp16 = false) {
 
   // Test
   fl::app::benchmark::ModelBenchmarker benchmarker(
-      model, criterion, fl::getWorldSize());
+      model, criterion, config.options);
   benchmarker.runBenchmark({input, mask});
 
   // Print
   fl::app::benchmark::printInfo(
       "Detr", fp16, benchmarker, batchsize, FLAGS_log_verbose);
+  report.add(config, benchmarker, batchsize, batchsize, "images/sec");
 }
 
 /* ----------------------------- LM Transformer ----------------------------- */
-void runLmTransformer(bool fp16 = false) {
+void runLmTransformer(const RunConfig& config, BenchmarkReport& report) {
   fl::app::benchmark::init();
+  const bool fp16 = config.fp16();
 
   // Data
-  const int batchsize = 2048, numTokens = 150000;
+  const int batchsize = config.batchSize > 0 ? config.batchSize : 2048;
+  const int numTokens = 150000;
   const std::vector<int> cutoff{10000, 50000, numTokens};
   auto rawInput = fl::rand({batchsize}) * cutoff[0];
   auto mask1 = fl::rand({batchsize}) < 0.2;
@@ -263,23 +325,33 @@ void runLmTransformer(bool fp16 = false) {
 
   // Test
   fl::app::benchmark::ModelBenchmarker benchmarker(
-      model, criterion, fl::getWorldSize());
+      model, criterion, config.options);
   benchmarker.runBenchmark({input});
 
   // Print
   fl::app::benchmark::printInfo(
       "LM Transformer", fp16, benchmarker, batchsize, FLAGS_log_verbose);
+  report.add(config, benchmarker, batchsize, batchsize, "tokens/sec");
 }
 
-/* ---------------------------- ASR Transformer ---------------------------- */
-void runAsrTransformer(bool fp16 = false) {
+/* ------------------------------ ASR models ------------------------------ */
+using AsrModelFactory =
+    std::function<std::shared_ptr<fl::Module>(int64_t, int64_t)>;
+
+void runAsrModel(
+    std::string name,
+    const AsrModelFactory& createModel,
+    const RunConfig& config,
+    BenchmarkReport& report) {
   fl::app::benchmark::init();
+  const bool fp16 = config.fp16();
   if (fp16) {
     fl::OptimMode::get().setOptimLevel(fl::OptimLevel::O1);
   }
 
   // Data
-  const int batchsize = 8, numFrames = 1500, numFeatures = 80;
+  const int batchsize = config.batchSize > 0 ? config.batchSize : 8;
+  const int numFrames = 1500, numFeatures = 80;
   const int numTarget = 30, targetLength = 100;
 
   auto input = fl::input(fl::rand({numFrames, 1, numFeatures, batchsize}));
@@ -288,9 +360,7 @@ void runAsrTransformer(bool fp16 = false) {
                     .astype(fl::dtype::s32);
 
   // Model
-  std::shared_ptr<fl::Module> model =
-      std::make_shared<fl::app::benchmark::AsrTransformer>(
-          numFeatures, numTarget);
+  std::shared_ptr<fl::Module> model = createModel(numFeatures, numTarget);
 
   // Criterion
   auto ctc = std::make_shared<fl::pkg::speech::CTCLoss>(
@@ -303,18 +373,55 @@ void runAsrTransformer(bool fp16 = false) {
 
   // Test
   fl::app::benchmark::ModelBenchmarker benchmarker(
-      model, criterion, fl::getWorldSize());
+      model, criterion, config.options);
   benchmarker.runBenchmark({input, lengths});
 
   // Print
+  report.add(
+      config, benchmarker, batchsize, batchsize * numFrames / 100, "sec/sec");
   fl::app::benchmark::printInfo(
-      "ASR Transformer",
+      std::move(name),
       fp16,
       benchmarker,
       batchsize * numFrames / 100,
       FLAGS_log_verbose);
 }
 
+/* ---------------------------- ASR Transformer ---------------------------- */
+void runAsrTransformer(const RunConfig& config, BenchmarkReport& report) {
+  runAsrModel(
+      "ASR Transformer",
+      [](int64_t nFeature, int64_t nLabel) {
+        return std::make_shared<fl::app::benchmark::AsrTransformer>(
+            nFeature, nLabel);
+      },
+      config,
+      report);
+}
+
+/* ----------------------------- ASR Conformer ----------------------------- */
+void runAsrConformer(const RunConfig& config, BenchmarkReport& report) {
+  runAsrModel(
+      "ASR Conformer",
+      [](int64_t nFeature, int64_t nLabel) {
+        return std::make_shared<fl::app::benchmark::AsrConformer>(
+            nFeature, nLabel);
+      },
+      config,
+      report);
+}
+
+/* -------------------------------- ASR TDS -------------------------------- */
+void runAsrTds(const RunConfig& config, BenchmarkReport& report) {
+  runAsrModel(
+      "ASR TDS",
+      [](int64_t nFeature, int64_t nLabel) {
+        return std::make_shared<fl::app::benchmark::AsrTds>(nFeature, nLabel);
+      },
+      config,
+      report);
+}
+
 int main(int argc, char** argv) {
   fl::init();
   gflags::ParseCommandLineFlags(&argc, &argv, false);
@@ -327,21 +434,88 @@ int main(int argc, char** argv) {
         FLAGS_distributed_rndv_filepath);
   }
 
-  runViTBase();
-  runViTBase(true);
-
-  runResNet34();
-  runResNet34(true);
-
-  runResNet50();
-  runResNet50(true);
+  const std::map<std::string, Runner> runners = {
+      {"vit", runViTBase},
+      {"resnet34", runResNet34},
+      {"resnet50", runResNet50},
+      {"detr", runDetr},
+      {"lm_transformer", runLmTransformer},
+      {"asr_transformer", runAsrTransformer},
+      {"asr_conformer", runAsrConformer},
+      {"asr_tds", runAsrTds}};
+
+  auto models = fl::lib::split(",", FLAGS_models, true);
+  for (const auto& model : models) {
+    if (runners.find(model) == runners.end()) {
+      LOG(FATAL) << "Unknown model " << model;
+    }
+  }
+  auto backends = fl::lib::split(",", FLAGS_backends, true);
+  if (backends.empty()) {
+    backends.emplace_back("default");
+  }
+  std::vector<int> batchSizes;
+  for (const auto& batchSize : fl::lib::split(",", FLAGS_batch_sizes, true)) {
+    batchSizes.push_back(std::stoi(batchSize));
+  }
+  if (batchSizes.empty()) {
+    // the batch size of each model
+    batchSizes.push_back(0);
+  }
 
-  runDetr();
-  runDetr(true);
+  const auto precisions = fl::lib::split(",", FLAGS_precisions, true);
+  for (const auto& precision : precisions) {
+    if (precision != "fp32" && precision != "amp") {
+      LOG(FATAL) << "Unknown precision " << precision
+                 << ", expected fp32 or amp";
+    }
+  }
+  const auto optimizers = fl::lib::split(",", FLAGS_optimizers, true);
+  const auto reducers = fl::lib::split(",", FLAGS_reducers, true);
+
+  // Every combination of the setups, run for each model
+  std::vector<RunConfig> configs;
+  for (const auto& backend : backends) {
+    for (const auto& precision : precisions) {
+      for (auto batchSize : batchSizes) {
+        for (const auto& optimizer : optimizers) {
+          for (const auto& reducer : reducers) {
+            RunConfig config;
+            config.backend = backend;
+            config.precision = precision;
+            config.batchSize = batchSize;
+            config.options.optimizer = optimizer;
+            config.options.reducer = reducer;
+            config.options.worldSize = fl::getWorldSize();
+            config.options.warmupUpdates = FLAGS_warmup_updates;
+            config.options.runUpdates = FLAGS_run_updates;
+            configs.push_back(config);
+          }
+        }
+      }
+    }
+  }
 
-  runLmTransformer();
-  runLmTransformer(true);
+  BenchmarkReport report;
+  for (auto& config : configs) {
+    for (const auto& model : models) {
+      config.model = model;
+      try {
+        if (config.backend != "default") {
+          fl::app::benchmark::setBackend(config.backend);
+        }
+        runners.at(model)(config, report);
+      } catch (const std::exception& ex) {
+        // Keep benchmarking the other setups, e.g. with ops missing from a
+        // backend
+        LOG(ERROR) << "Benchmark of " << model << " on " << config.backend
+                   << " failed: " << ex.what();
+        report.addFailure(config, ex.what());
+      }
+    }
+  }
 
-  runAsrTransformer();
-  runAsrTransformer(true);
+  if (!FLAGS_report_path.empty() && fl::getWorldRank() == 0) {
+    report.save(FLAGS_report_path);
+  }
 }
@@ -8,10 +8,22 @@
 #include "flashlight/app/benchmark/Utils.h"
 
 #include <iomanip>
+#include <stdexcept>
 
 #include "flashlight/fl/flashlight.h"
+#include "flashlight/fl/tensor/TensorAdapter.h"
 #include "flashlight/lib/text/String.h"
 
+#if FL_USE_ARRAYFIRE
+#include "flashlight/fl/tensor/backend/af/ArrayFireTensor.h"
+#endif
+#if FL_USE_ONEDNN
+#include "flashlight/fl/tensor/backend/onednn/OneDnnTensor.h"
+#endif
+#if FL_USE_JIT && FL_USE_ONEDNN
+#include "flashlight/fl/tensor/backend/jit/JitTensor.h"
+#endif
+
 namespace fl {
 namespace app {
 namespace benchmark {
@@ -21,6 +33,29 @@ void init() {
   fl::OptimMode::get().setOptimLevel(fl::OptimLevel::DEFAULT);
 }
 
+void setBackend(const std::string& backend) {
+  if (backend == "arrayfire") {
+#if FL_USE_ARRAYFIRE
+    fl::setDefaultTensorType<fl::ArrayFireTensor>();
+    return;
+#endif
+  } else if (backend == "onednn") {
+#if FL_USE_ONEDNN
+    fl::setDefaultTensorType<fl::OneDnnTensor>();
+    return;
+#endif
+  } else if (backend == "jit") {
+#if FL_USE_JIT && FL_USE_ONEDNN
+    fl::setDefaultTensorType<fl::JitTensor<fl::OneDnnTensor>>();
+    return;
+#endif
+  } else {
+    throw std::invalid_argument("setBackend - unknown backend: " + backend);
+  }
+  throw std::invalid_argument(
+      "setBackend - Flashlight was built without the " + backend + " backend");
+}
+
 void printInfo(
     std::string&& name,
     bool fp16,
@@ -46,6 +81,7 @@ void printInfo(
               << benchmarker.getCriterionTime() * 1000;
     std::cout << "\nBackward Time(ms): "
               << benchmarker.getBackwardTime() * 1000;
+    std::cout << "\nReduce Time(ms): " << benchmarker.getReduceTime() * 1000;
     std::cout << "\nOptimization Time(ms): "
               << benchmarker.getOptimizationTime() * 1000;
     std::cout << std::endl;
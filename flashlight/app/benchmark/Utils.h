@@ -20,6 +20,13 @@ namespace benchmark {
  */
 void init();
 
+/**
+ * Sets the tensor type new tensors are created with. Supported backends:
+ * `arrayfire`, `onednn` and `jit` (the JIT backend over oneDNN). Throws if
+ * Flashlight was built without the backend.
+ */
+void setBackend(const std::string& backend);
+
 /**
  * Log out the statistics of the current run. Details will also be logged out
  * when `verbose` is on.
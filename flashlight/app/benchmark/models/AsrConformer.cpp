@@ -0,0 +1,66 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/app/benchmark/models/AsrConformer.h"
+
+namespace fl::app::benchmark {
+
+namespace {
+constexpr int kNumLayers = 16;
+constexpr int kModelDim = 512;
+} // namespace
+
+AsrConformer::AsrConformer(int64_t nFeature, int64_t nLabel) {
+  convFrontend_->add(std::make_shared<fl::View>(Shape({-1, 1, nFeature, 0})));
+  // Time x 1 x nFeature x Batch
+  convFrontend_->add(std::make_shared<fl::Conv2D>(
+      nFeature, 2 * kModelDim, 7, 1, 3, 1, -1, 0, 1, 1));
+  convFrontend_->add(std::make_shared<fl::GatedLinearUnit>(2));
+  convFrontend_->add(std::make_shared<fl::Dropout>(0.1));
+  convFrontend_->add(std::make_shared<fl::Reorder>(Shape({2, 0, 3, 1})));
+  // kModelDim x Time / 3 x Batch x 1
+  add(convFrontend_);
+  for (int i = 0; i < kNumLayers; i++) {
+    auto layer = std::make_shared<fl::Conformer>(
+        kModelDim, 64, 4 * kModelDim, 8, 33, 31, 0.1, 0.);
+    conformers_.push_back(layer);
+    add(layer);
+  }
+  linear_ = std::make_shared<fl::Linear>(kModelDim, nLabel);
+  add(linear_);
+}
+
+std::vector<fl::Variable> AsrConformer::forward(
+    const std::vector<fl::Variable>& input) {
+  auto xSizes = input[1].tensor();
+  auto out = convFrontend_->forward(input[0]);
+  // Conformer expects C x T x B
+  out = fl::moddims(out, {out.dim(0), out.dim(1), out.dim(2)});
+  // the pad mask is computed for the subsampled length
+  int T = out.dim(1), B = out.dim(2);
+  auto inputMaxSize = fl::tile(fl::amax(xSizes, {0}), {1, B});
+  Tensor inputNotPaddedSize = fl::ceil(xSizes * T / inputMaxSize);
+  auto padMask =
+      fl::iota({T, 1}, {1, B}) < fl::tile(inputNotPaddedSize, {T, 1});
+  for (auto& conformer : conformers_) {
+    out = conformer->forward({out, fl::noGrad(padMask)}).front();
+  }
+  out = linear_->forward(out);
+  return {out.astype(input[0].type())};
+}
+
+std::string AsrConformer::prettyString() const {
+  std::ostringstream ss;
+  ss << "Model myModel: ";
+  for (const auto& conformer : conformers_) {
+    ss << conformer->prettyString() << "\n";
+  }
+  ss << linear_->prettyString() << "\n";
+  return ss.str();
+}
+
+} // namespace fl::app::benchmark
@@ -0,0 +1,50 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/app/benchmark/models/AsrTds.h"
+
+namespace fl::app::benchmark {
+
+AsrTds::AsrTds(int64_t nFeature, int64_t nLabel) {
+  const double dropout = 0.1;
+  // {channels, number of TDS blocks}
+  const std::vector<std::pair<int, int>> groups = {{10, 2}, {14, 3}, {18, 6}};
+
+  network_->add(std::make_shared<fl::View>(Shape({-1, nFeature, 1, 0})));
+  // Time x nFeature x 1 x Batch
+  int inChannels = 1;
+  for (const auto& [channels, numBlocks] : groups) {
+    network_->add(std::make_shared<fl::Conv2D>(
+        inChannels, channels, 11, 1, 2, 1, -1, 0, 1, 1));
+    network_->add(std::make_shared<fl::ReLU>());
+    network_->add(std::make_shared<fl::Dropout>(dropout));
+    network_->add(std::make_shared<fl::LayerNorm>(std::vector<int>{0, 1, 2}));
+    for (int i = 0; i < numBlocks; i++) {
+      network_->add(
+          std::make_shared<fl::TDSBlock>(channels, 21, nFeature, dropout));
+    }
+    inChannels = channels;
+  }
+  // Time / 8 x nFeature x channels x Batch
+  network_->add(std::make_shared<fl::View>(Shape({0, -1, 1, 0})));
+  network_->add(std::make_shared<fl::Reorder>(Shape({1, 0, 3, 2})));
+  // nFeature * channels x Time / 8 x Batch x 1
+  network_->add(std::make_shared<fl::Linear>(nFeature * inChannels, nLabel));
+  add(network_);
+}
+
+std::vector<fl::Variable> AsrTds::forward(
+    const std::vector<fl::Variable>& input) {
+  auto out = network_->forward(input[0]);
+  return {out.astype(input[0].type())};
+}
+
+std::string AsrTds::prettyString() const {
+  return "Model myModel: " + network_->prettyString() + "\n";
+}
+
+} // namespace fl::app::benchmark
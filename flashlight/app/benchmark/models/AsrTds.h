@@ -0,0 +1,41 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include "flashlight/fl/contrib/modules/modules.h"
+#include "flashlight/fl/flashlight.h"
+#include "flashlight/fl/nn/modules/modules.h"
+
+namespace fl {
+namespace app {
+namespace benchmark {
+
+/**
+ * This is a [TDS](https://arxiv.org/abs/1904.02619) model with three groups
+ * of TDS blocks, each preceded by a convolution subsampling time by 2,
+ * designed for speech recognition. We use CTC criterion on top of it in this
+ * benchmark.
+ */
+class AsrTds : public fl::Container {
+ public:
+  AsrTds(int64_t nFeature, int64_t nLabel);
+
+  std::vector<fl::Variable> forward(
+      const std::vector<fl::Variable>& input) override;
+
+  std::string prettyString() const override;
+
+ private:
+  AsrTds() = default;
+
+  std::shared_ptr<fl::Sequential> network_{std::make_shared<fl::Sequential>()};
+};
+
+} // namespace benchmark
+} // namespace app
+} // namespace fl
@@ -85,15 +85,16 @@ int main(int argc, char** argv) {
   const int imageSize = 224;
   // Conventional image resize parameter used for evaluation
   const int randomResizeMin = imageSize / .875;
-  ImageTransform testTransforms = compose(
-      {fl::pkg::vision::resizeTransform(randomResizeMin),
-       fl::pkg::vision::centerCropTransform(imageSize),
-       fl::pkg::vision::normalizeImage(
-           fl::app::image::kImageNetMean, fl::app::image::kImageNetStd)});
+  fl::pkg::vision::FusedImageOptions testTransforms;
+  testTransforms.outputSize = imageSize;
+  testTransforms.cropSampler =
+      fl::pkg::vision::centerCropSampler(randomResizeMin, imageSize);
+  testTransforms.mean = fl::app::image::kImageNetMean;
+  testTransforms.std = fl::app::image::kImageNetStd;
 
   auto labelMap = getImagenetLabels(labelPath);
   auto testDataset = fl::pkg::vision::DistributedDataset(
-      imagenetDataset(testList, labelMap, {testTransforms}),
+      fusedImagenetDataset(testList, labelMap, testTransforms),
       worldRank,
       worldSize,
       FLAGS_data_batch_size,
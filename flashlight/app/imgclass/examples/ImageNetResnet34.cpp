@@ -177,31 +177,33 @@ int main(int argc, char** argv) {
   const int randomResizeMin = 256;
   const int randomCropSize = 224;
   const float horizontalFlipProb = 0.5f;
-  // TransformDataset will apply each transform in a vector to the respective
-  // Tensor. Thus, we need to `compose` all of the transforms so are each
-  // applied only to the image
-  ImageTransform trainTransforms = compose(
-      {// randomly resize shortest side of image between 256 to 480 for
-       // scale invariance
-       fl::pkg::vision::randomResizeTransform(randomResizeMin, randomResizeMax),
-       fl::pkg::vision::randomCropTransform(randomCropSize, randomCropSize),
-       fl::pkg::vision::normalizeImage(
-           fl::app::image::kImageNetMean, fl::app::image::kImageNetStd),
-       // Randomly flip image with probability of 0.5
-       fl::pkg::vision::randomHorizontalFlipTransform(horizontalFlipProb)});
-  ImageTransform valTransforms = compose(
-      {// Resize shortest side to 256, then take a center crop
-       fl::pkg::vision::resizeTransform(randomResizeMin),
-       fl::pkg::vision::centerCropTransform(randomCropSize),
-       fl::pkg::vision::normalizeImage(
-           fl::app::image::kImageNetMean, fl::app::image::kImageNetStd)});
+  // Decoding, cropping, resizing, normalization and flipping are fused into
+  // a single host-side pass per image
+  fl::pkg::vision::FusedImageOptions trainTransforms;
+  trainTransforms.outputSize = randomCropSize;
+  // randomly resize shortest side of image between 256 to 480 for scale
+  // invariance, then take a random crop
+  trainTransforms.cropSampler = fl::pkg::vision::randomResizeCropSampler(
+      randomResizeMin, randomResizeMax, randomCropSize);
+  // Randomly flip image with probability of 0.5
+  trainTransforms.flipProb = horizontalFlipProb;
+  trainTransforms.mean = fl::app::image::kImageNetMean;
+  trainTransforms.std = fl::app::image::kImageNetStd;
+
+  // Resize shortest side to 256, then take a center crop
+  fl::pkg::vision::FusedImageOptions valTransforms;
+  valTransforms.outputSize = randomCropSize;
+  valTransforms.cropSampler =
+      fl::pkg::vision::centerCropSampler(randomResizeMin, randomCropSize);
+  valTransforms.mean = fl::app::image::kImageNetMean;
+  valTransforms.std = fl::app::image::kImageNetStd;
 
   const int64_t batchSizePerGpu = FLAGS_data_batch_size;
   const int64_t prefetchThreads = 10;
   const int64_t prefetchSize = FLAGS_data_batch_size;
   auto labelMap = getImagenetLabels(labelPath);
   auto trainDataset = fl::pkg::vision::DistributedDataset(
-      imagenetDataset(trainList, labelMap, {trainTransforms}),
+      fusedImagenetDataset(trainList, labelMap, trainTransforms),
       worldRank,
       worldSize,
       batchSizePerGpu,
@@ -211,7 +213,7 @@ int main(int argc, char** argv) {
       fl::BatchDatasetPolicy::SKIP_LAST);
 
   auto valDataset = fl::pkg::vision::DistributedDataset(
-      imagenetDataset(valList, labelMap, {valTransforms}),
+      fusedImagenetDataset(valList, labelMap, valTransforms),
       worldRank,
       worldSize,
       batchSizePerGpu,
@@ -209,27 +209,30 @@ int main(int argc, char** argv) {
       Tensor::fromVector({1, 1, 3, 1}, fl::app::image::kImageNetMean),
       {imageSize, imageSize});
 
+  // Random resized crop and flip run fused with decoding. The output keeps
+  // the [0, 255] range expected by the augmentations below.
+  fl::pkg::vision::FusedImageOptions trainFusedTransforms;
+  trainFusedTransforms.outputSize = imageSize;
+  trainFusedTransforms.cropSampler = fl::pkg::vision::randomResizedCropSampler(
+      0.08, // scaleLow
+      1.0, // scaleHigh
+      3. / 4., // ratioLow
+      4. / 3. // ratioHigh
+  );
+  trainFusedTransforms.flipProb = 0.5;
   ImageTransform trainTransforms = compose(
-      {fl::pkg::vision::randomResizeCropTransform(
-           imageSize,
-           0.08, // scaleLow
-           1.0, // scaleHigh
-           3. / 4., // ratioLow
-           4. / 3. // ratioHigh
-           ),
-       fl::pkg::vision::randomHorizontalFlipTransform(0.5 // flipping probablity
-                                                      ),
-       fl::pkg::vision::randomAugmentationDeitTransform(
+      {fl::pkg::vision::randomAugmentationDeitTransform(
            FLAGS_train_aug_p_randomeaug, FLAGS_train_aug_n_randomeaug, fillImg),
        fl::pkg::vision::normalizeImage(
            fl::app::image::kImageNetMean, fl::app::image::kImageNetStd),
        fl::pkg::vision::randomEraseTransform(FLAGS_train_aug_p_randomerase)});
 
-  ImageTransform valTransforms = compose(
-      {fl::pkg::vision::resizeTransform(randomResizeMin),
-       fl::pkg::vision::centerCropTransform(imageSize),
-       fl::pkg::vision::normalizeImage(
-           fl::app::image::kImageNetMean, fl::app::image::kImageNetStd)});
+  fl::pkg::vision::FusedImageOptions valTransforms;
+  valTransforms.outputSize = imageSize;
+  valTransforms.cropSampler =
+      fl::pkg::vision::centerCropSampler(randomResizeMin, imageSize);
+  valTransforms.mean = fl::app::image::kImageNetMean;
+  valTransforms.std = fl::app::image::kImageNetStd;
 
   const int64_t prefetchSize = FLAGS_data_batch_size * 10;
   auto labelMap = getImagenetLabels(labelPath);
@@ -239,7 +242,8 @@ int main(int argc, char** argv) {
   }
 
   auto trainDataset = std::make_shared<fl::pkg::vision::DistributedDataset>(
-      imagenetDataset(trainList, labelMap, {trainTransforms}),
+      fusedImagenetDataset(
+          trainList, labelMap, trainFusedTransforms, {trainTransforms}),
       worldRank,
       worldSize,
       FLAGS_data_batch_size,
@@ -250,7 +254,7 @@ int main(int argc, char** argv) {
   FL_LOG_MASTER(INFO) << "[trainDataset size] " << trainDataset->size();
 
   auto valDataset = fl::pkg::vision::DistributedDataset(
-      imagenetDataset(valList, labelMap, {valTransforms}),
+      fusedImagenetDataset(valList, labelMap, valTransforms),
       worldRank,
       worldSize,
       FLAGS_data_batch_size,
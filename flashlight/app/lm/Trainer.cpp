@@ -164,6 +164,13 @@ DEFINE_double(
     0.0,
     "L2 penalty coefficient for the parameters during optimization process.");
 
+DEFINE_bool(
+    train_lazy_sparse_updates,
+    false,
+    "Only update the rows of embedding tables, and their optimizer state, \
+    which are looked up by a batch. Applies to the sgd and adagrad \
+    optimizers; weight decay and momentum then skip rows without a gradient.");
+
 DEFINE_double(
     train_max_grad_norm,
     0.0,
@@ -172,11 +179,22 @@ DEFINE_int64(
     train_save_updates,
     0,
     "Specifies to save model every '--train_save_updates' updates.");
+DEFINE_bool(
+    train_save_sharded,
+    false,
+    "In distributed training, have every process save part of each checkpoint \
+    to its own file instead of the first process saving all of it.");
 DEFINE_int64(
     train_report_updates,
     0,
     "Number of updates after which we will run evaluation and save model, \
     if 0 we only do this at the end of epoch ");
+DEFINE_bool(
+    train_sync_timers,
+    false,
+    "Synchronize with the device after each phase of a training step so that \
+    forward/backward/optimizer timers measure device time. This adds several \
+    host-device round trips to every step.");
 DEFINE_int64(
     train_total_updates,
     std::numeric_limits<int64_t>::max(),
@@ -247,7 +265,15 @@ Trainer::Trainer(const std::string& mode) {
 
   this->init();
   if (FLAGS_distributed_enable) {
-    reducer_ = std::make_shared<fl::CoalescingReducer>(1.0, true, true);
+    // Gradients are synchronized in buckets while backward is still running
+    collectParameters();
+    reducer_ = std::make_shared<fl::BucketedReducer>(parameters_, 1.0);
+  }
+  if (FLAGS_distributed_enable && FLAGS_train_save_sharded) {
+    checkpointer_ = std::make_unique<AsyncCheckpointer>(
+        fl::getWorldRank(), fl::getWorldSize());
+  } else {
+    checkpointer_ = std::make_unique<AsyncCheckpointer>();
   }
 
   if (FLAGS_fl_amp_use_mixed_precision) {
@@ -329,6 +355,7 @@ void Trainer::runTraining() {
       saveCheckpoint(modelPath, "." + std::to_string(batchIdx_));
     }
   }
+  checkpointer_->wait();
 }
 
 void Trainer::trainStep() {
@@ -349,19 +376,24 @@ void Trainer::trainStep() {
     // 2. Forward
     fwdTimeMeter_.resume();
     auto output = network_->forward({input, fl::noGrad(inputSizes)}).front();
-    fl::sync();
+    if (FLAGS_train_sync_timers) {
+      fl::sync();
+    }
     critFwdTimeMeter_.resume();
     auto loss = criterion_->forward({output, target}).front();
-    fl::sync();
+    if (FLAGS_train_sync_timers) {
+      fl::sync();
+    }
     fwdTimeMeter_.stopAndIncUnit();
     critFwdTimeMeter_.stopAndIncUnit();
 
     // 3. Backward
     bwdTimeMeter_.resume();
     optimizer_->zeroGrad();
-    float numTokens =
-        fl::countNonzero(target.tensor() != kPadIdx_).asScalar<float>();
-    Tensor numTokensArr = fl::fromScalar(numTokens);
+    // Token counts stay on device; they are only read back with the meters
+    Tensor numTokens =
+        fl::countNonzero(target.tensor() != kPadIdx_).astype(fl::dtype::f32);
+    Tensor numTokensArr = numTokens.copy();
     if (FLAGS_distributed_enable) {
       fl::allReduce(numTokensArr);
     }
@@ -371,7 +403,9 @@ void Trainer::trainStep() {
     }
     scaledLoss.backward();
     reduceGrads();
-    fl::sync();
+    if (FLAGS_train_sync_timers) {
+      fl::sync();
+    }
     bwdTimeMeter_.stopAndIncUnit();
 
     if (dynamicScaler) {
@@ -381,21 +415,25 @@ void Trainer::trainStep() {
       dynamicScaler->update();
     }
 
-    if (numTokens > 0) {
-      auto weight =
-          numTokens / (FLAGS_data_tokens_per_sample * FLAGS_data_batch_size);
-      trainLossMeter_.add(
-          fl::mean(loss.tensor()).scalar<float>() / numTokens, weight);
-      tokenCountMeter_.add(numTokens);
-    }
+    // Batches without tokens get a zero weight
+    const Tensor hasTokens = (numTokens > 0).astype(fl::dtype::f32);
+    const Tensor weight =
+        numTokens / (FLAGS_data_tokens_per_sample * FLAGS_data_batch_size);
+    trainLossMeter_.add(
+        fl::mean(loss.tensor()) / fl::maximum(numTokens, 1.0), weight);
+    tokenCountMeter_.add(numTokens, hasTokens);
     break;
   }
 
   // 4. Optimization
   optimTimeMeter_.resume();
-  fl::clipGradNorm(parameters_, FLAGS_train_max_grad_norm);
+  if (FLAGS_train_max_grad_norm > 0) {
+    fl::clipGradNormAsync(parameters_, FLAGS_train_max_grad_norm);
+  }
   optimizer_->step();
-  fl::sync();
+  if (FLAGS_train_sync_timers) {
+    fl::sync();
+  }
   optimTimeMeter_.stopAndIncUnit();
 }
 
@@ -451,13 +489,13 @@ void Trainer::initTrain() {
 void Trainer::initContinue() {
   fs::path checkPoint =
       fs::path(FLAGS_exp_rundir) / (FLAGS_exp_model_name + ".bin");
-  if (!fs::exists(checkPoint)) {
+  if (!AsyncCheckpointer::exists(checkPoint)) {
     throw std::invalid_argument(
         "Checkpoint doesn't exist to continue training: " +
         checkPoint.string());
   }
   FL_LOG_MASTER(INFO) << "Continue training from file: " << checkPoint;
-  fl::pkg::runtime::Serializer::load(
+  AsyncCheckpointer::load(
       checkPoint,
       version_,
       network_,
@@ -471,6 +509,9 @@ void Trainer::initContinue() {
   // overwrite flags using the ones from command line
   gflags::ReadFlagsFromString(gflagsStr_, gflags::GetArgv0(), true);
 
+  // Lazy updates aren't part of the saved optimizer
+  optimizer_->setLazySparseUpdates(FLAGS_train_lazy_sparse_updates);
+
   createDictionary();
   createTrainDatasets();
   createValidDatasets();
@@ -478,7 +519,7 @@ void Trainer::initContinue() {
 }
 
 void Trainer::initFork() {
-  if (!fs::exists(FLAGS_exp_init_model_path)) {
+  if (!AsyncCheckpointer::exists(FLAGS_exp_init_model_path)) {
     throw std::invalid_argument(
         "Checkpoint doesn't exist for finetuning: " +
         FLAGS_exp_init_model_path);
@@ -487,7 +528,7 @@ void Trainer::initFork() {
                       << FLAGS_exp_init_model_path;
 
   std::shared_ptr<fl::FirstOrderOptimizer> dummyOptimizer;
-  fl::pkg::runtime::Serializer::load(
+  AsyncCheckpointer::load(
       FLAGS_exp_init_model_path,
       version_,
       network_,
@@ -505,14 +546,14 @@ void Trainer::initFork() {
 }
 
 void Trainer::initEval() {
-  if (!fs::exists(FLAGS_exp_init_model_path)) {
+  if (!AsyncCheckpointer::exists(FLAGS_exp_init_model_path)) {
     throw std::invalid_argument(
         "Checkpoint doesn't exist for evaluation: " +
         FLAGS_exp_init_model_path);
   }
   FL_LOG_MASTER(INFO) << "Evaluate from file: " << FLAGS_exp_init_model_path;
 
-  fl::pkg::runtime::Serializer::load(
+  AsyncCheckpointer::load(
       FLAGS_exp_init_model_path, version_, network_, criterion_);
 
   createDictionary();
@@ -644,6 +685,7 @@ void Trainer::createOptimizer() {
     throw std::runtime_error(
         "Optimizer is not supported, check 'train_optimizer' flag possible values");
   }
+  optimizer_->setLazySparseUpdates(FLAGS_train_lazy_sparse_updates);
 }
 
 /* ============= Stateful training helpers ============= */
@@ -741,14 +783,8 @@ void Trainer::setLr() {
 void Trainer::reduceGrads() {
   collectParameters();
   if (reducer_) {
-    for (auto& p : parameters_) {
-      if (!p.isGradAvailable()) {
-        p.addGrad(fl::constant(0.0, p.shape(), p.type(), false));
-      }
-      auto& grad = p.grad().tensor();
-      p.grad().tensor() = grad;
-      reducer_->add(p.grad());
-    }
+    // Buckets were reduced as their gradients became available during
+    // backward; this reduces unused parameters and waits for the rest.
     reducer_->finalize();
   }
 }
@@ -833,14 +869,19 @@ void Trainer::stopTimers() {
 /* ============= Logging helpers ============= */
 void Trainer::saveCheckpoint(const fs::path& path, const std::string& suffix)
     const {
-  if (!isMaster()) {
+  if (!isMaster() && !checkpointer_->isSharded()) {
     return;
   }
 
   FL_LOG_MASTER(INFO) << "saving model checkpoint (epoch=" << epoch_
                       << " batch=" << batchIdx_ << ") to: " << path;
-  Serializer::save(
-      path,
+  // Tensors are copied to host here; files are written in the background
+  std::vector<fs::path> paths = {path};
+  if (!suffix.empty()) {
+    paths.emplace_back(path.string() + suffix);
+  }
+  checkpointer_->save(
+      paths,
       FL_APP_LM_VERSION,
       network_,
       criterion_,
@@ -849,19 +890,6 @@ void Trainer::saveCheckpoint(const fs::path& path, const std::string& suffix)
       batchIdx_,
       gflagsStr_,
       dynamicScaler);
-
-  if (!suffix.empty()) {
-    Serializer::save(
-        path / suffix,
-        FL_APP_LM_VERSION,
-        network_,
-        criterion_,
-        optimizer_,
-        epoch_,
-        batchIdx_,
-        gflagsStr_,
-        dynamicScaler);
-  }
 }
 
 void Trainer::logMemoryManagerStatus() const {
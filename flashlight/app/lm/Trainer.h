@@ -25,6 +25,7 @@
 #include "flashlight/lib/text/tokenizer/PartialFileReader.h"
 #include "flashlight/lib/text/tokenizer/Tokenizer.h"
 #include "flashlight/pkg/runtime/amp/DynamicScaler.h"
+#include "flashlight/pkg/runtime/common/AsyncCheckpointer.h"
 #include "flashlight/pkg/runtime/common/DistributedUtils.h"
 #include "flashlight/pkg/runtime/common/Serializer.h"
 #include "flashlight/pkg/runtime/plugin/ModulePlugin.h"
@@ -77,9 +78,12 @@ DECLARE_double(train_lr);
 DECLARE_string(train_lr_schedule);
 DECLARE_double(train_momentum);
 DECLARE_double(train_weight_decay);
+DECLARE_bool(train_lazy_sparse_updates);
 DECLARE_double(train_max_grad_norm);
 DECLARE_int64(train_save_updates);
+DECLARE_bool(train_save_sharded);
 DECLARE_int64(train_report_updates);
+DECLARE_bool(train_sync_timers);
 DECLARE_int64(train_total_updates);
 
 /* MASK OPTIONS */
@@ -141,6 +145,7 @@ class Trainer {
   fl::AverageValueMeter tokenCountMeter_;
 
   std::ofstream logWriter_;
+  std::unique_ptr<fl::pkg::runtime::AsyncCheckpointer> checkpointer_;
 
   /* Initializers */
   void initTrain();
@@ -7,7 +7,11 @@
 
 #include <algorithm>
 #include <cmath>
+#include <numeric>
+#include <optional>
+#include <sstream>
 #include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "flashlight/fl/autograd/Functions.h"
@@ -111,6 +115,56 @@ bool areVariableTypesEqual(const Variable& a, const Variable& b) {
 
 } // namespace detail
 
+namespace {
+
+// Key of a conv2d gradient benchmark in the DynamicBenchmarkCache
+std::string conv2dBenchmarkKey(
+    const std::string& op,
+    const Tensor& input,
+    const Tensor& weights,
+    int sx,
+    int sy,
+    int px,
+    int py,
+    int dx,
+    int dy,
+    int groups,
+    const std::string& fingerprint) {
+  std::stringstream ss;
+  ss << op << ";in=" << input.shape() << ";wt=" << weights.shape()
+     << ";s=" << sx << "," << sy << ";p=" << px << "," << py << ";d=" << dx
+     << "," << dy << ";g=" << groups << ";" << input.type() << ";"
+     << fingerprint;
+  return ss.str();
+}
+
+// Softmax with the backend's fused kernel, or std::nullopt if it has none
+std::optional<Variable> fusedSoftmax(
+    const Variable& input,
+    const Tensor& inputArr,
+    const int dim,
+    const bool logSoftmax) {
+  auto payload = detail::createAutogradPayload(input);
+  auto result = detail::softmax(inputArr, dim, logSoftmax, payload);
+  if (!result) {
+    return std::nullopt;
+  }
+  auto gradFunc = [dim, logSoftmax, result = *result, payload](
+                      std::vector<Variable>& inputs,
+                      const Variable& gradOutput) {
+    auto grad = detail::softmaxBackward(
+        gradOutput.tensor().astype(result.type()),
+        result,
+        dim,
+        logSoftmax,
+        payload);
+    inputs[0].addGrad(Variable(grad.astype(inputs[0].type()), false));
+  };
+  return Variable(*result, {input.withoutData()}, gradFunc);
+}
+
+} // namespace
+
 Variable operator+(const Variable& lhs, const Variable& rhs) {
   FL_VARIABLE_DTYPES_MATCH_CHECK(lhs, rhs);
   auto result = lhs.tensor() + rhs.tensor();
@@ -1020,6 +1074,9 @@ Variable moddims(const Variable& input, const Shape& dims) {
 
 Variable softmax(const Variable& input, const int dim) {
   Tensor inputArr = FL_ADJUST_INPUT_TYPE(input.tensor());
+  if (auto result = fusedSoftmax(input, inputArr, dim, false)) {
+    return *result;
+  }
   auto maxvals = amax(inputArr, {dim}, /* keepDims = */ true);
   Shape tiledims(std::vector<Dim>(input.ndim(), 1));
   tiledims[dim] = input.dim(dim);
@@ -1043,6 +1100,9 @@ Variable softmax(const Variable& input, const int dim) {
 
 Variable logSoftmax(const Variable& input, const int dim) {
   Tensor inputArr = FL_ADJUST_INPUT_TYPE(input.tensor());
+  if (auto result = fusedSoftmax(input, inputArr, dim, true)) {
+    return *result;
+  }
   auto maxvals = amax(inputArr, {dim}, /* keepDims = */ true);
   // TODO{fl::Tensor}{rewrite}
   Shape tiledims(std::vector<Dim>(input.ndim(), 1));
@@ -1370,21 +1430,37 @@ Variable conv2d(
         std::shared_ptr<DynamicBenchmark> filterBench;
         std::shared_ptr<DynamicBenchmark> biasBench;
         if (benchmarks && DynamicBenchmark::getBenchmarkMode()) {
+          // Benchmarks are keyed by the shapes of their first use
+          auto create = [&](const std::string& op) {
+            auto bench = autogradExtension.createBenchmarkOptions();
+            if (bench) {
+              bench->setCacheKey(conv2dBenchmarkKey(
+                  op,
+                  inputs[0].tensor(),
+                  inputs[1].tensor(),
+                  sx,
+                  sy,
+                  px,
+                  py,
+                  dx,
+                  dy,
+                  groups,
+                  autogradExtension.benchmarkFingerprint()));
+            }
+            return bench;
+          };
           if (!benchmarks->bwdFilterBenchmark) {
-            benchmarks->bwdFilterBenchmark =
-                autogradExtension.createBenchmarkOptions();
-            filterBench = benchmarks->bwdFilterBenchmark;
+            benchmarks->bwdFilterBenchmark = create("conv2d_bwd_filter");
           }
           if (!benchmarks->bwdDataBenchmark) {
-            benchmarks->bwdDataBenchmark =
-                autogradExtension.createBenchmarkOptions();
-            dataBench = benchmarks->bwdDataBenchmark;
+            benchmarks->bwdDataBenchmark = create("conv2d_bwd_data");
           }
           if (!benchmarks->bwdBiasBenchmark) {
-            benchmarks->bwdBiasBenchmark =
-                autogradExtension.createBenchmarkOptions();
-            biasBench = benchmarks->bwdBiasBenchmark;
+            benchmarks->bwdBiasBenchmark = create("conv2d_bwd_bias");
           }
+          filterBench = benchmarks->bwdFilterBenchmark;
+          dataBench = benchmarks->bwdDataBenchmark;
+          biasBench = benchmarks->bwdBiasBenchmark;
         }
 
         // Bias gradients
@@ -1564,6 +1640,98 @@ Variable batchnorm(
   return Variable(output, {input, weight, bias}, gradFunc);
 }
 
+Variable layerNorm(
+    const Variable& _input,
+    const Variable& weight,
+    const Variable& bias,
+    const std::vector<int>& axes,
+    double epsilon) {
+  if (axes.empty()) {
+    throw std::invalid_argument("layerNorm - no axes to normalize over");
+  }
+  Dim normSize = 1;
+  for (int i = 0; i < static_cast<int>(axes.size()); ++i) {
+    if (axes[i] != i) {
+      throw std::invalid_argument(
+          "layerNorm - axes must be the leading dimensions {0, ..., k - 1}");
+    }
+    normSize *= i < _input.ndim() ? _input.dim(i) : 1;
+  }
+
+  auto payload = detail::createAutogradPayload(_input, weight, bias);
+  auto input = FL_ADJUST_INPUT_TYPE(_input);
+
+  Tensor saveMean, saveVar;
+  auto output = fl::detail::layerNorm(
+      saveMean,
+      saveVar,
+      input.tensor(),
+      weight.tensor(),
+      bias.tensor(),
+      axes,
+      /* train = */ payload != nullptr,
+      epsilon,
+      payload);
+  if (output) {
+    auto gradFunc =
+        [saveMean = std::move(saveMean),
+         saveVar = std::move(saveVar),
+         axes,
+         epsilon,
+         payload](std::vector<Variable>& inputs, const Variable& _gradOutput) {
+          auto& in = inputs[0];
+          auto& wt = inputs[1];
+          auto& bs = inputs[2];
+
+          auto gradOutput = detail::adjustInputType(_gradOutput, "layerNorm");
+
+          auto [gradIn, gradWt, gradBs] = detail::layerNormBackward(
+              gradOutput.tensor(),
+              saveMean,
+              saveVar,
+              detail::adjustInputType(in.tensor(), "layerNorm"),
+              wt.tensor(),
+              axes,
+              epsilon,
+              payload);
+
+          in.addGrad(Variable(gradIn.astype(in.type()), false));
+          if (!wt.isEmpty()) {
+            wt.addGrad(Variable(gradWt.astype(wt.type()), false));
+          }
+          if (!bs.isEmpty()) {
+            bs.addGrad(Variable(gradBs.astype(bs.type()), false));
+          }
+        };
+    return Variable(*output, {input, weight, bias}, gradFunc);
+  }
+
+  // Without a fused kernel, normalize each slice with batchnorm
+  Shape normShape({normSize, input.elements() / normSize});
+  auto paramsType =
+      (input.type() == fl::dtype::f16) ? fl::dtype::f32 : input.type();
+  Variable dummyMean, dummyVar;
+  auto result = batchnorm(
+      moddims(input, normShape),
+      Variable(Tensor(paramsType), false),
+      Variable(Tensor(paramsType), false),
+      dummyMean,
+      dummyVar,
+      {1},
+      true,
+      0.0,
+      epsilon);
+  if (!weight.isEmpty()) {
+    auto wt = moddims(weight.astype(result.type()), {normSize, 1});
+    result = tileAs(wt, result) * result;
+  }
+  if (!bias.isEmpty()) {
+    auto bs = moddims(bias.astype(result.type()), {normSize, 1});
+    result = result + tileAs(bs, result);
+  }
+  return moddims(result, _input.shape());
+}
+
 Variable gatedlinearunit(const Variable& input, const int dim) {
   if (dim >= input.ndim()) {
     throw std::invalid_argument(
@@ -1704,6 +1872,174 @@ std::tuple<Variable, Variable, Variable> rnn(
   return std::make_tuple(yv, hyv, cyv);
 }
 
+std::tuple<Variable, Variable, Variable> rnn(
+    const Variable& input,
+    const Variable& hiddenState,
+    const Variable& cellState,
+    const Variable& weights,
+    int hiddenSize,
+    int numLayers,
+    RnnMode mode,
+    bool bidirectional,
+    float dropProb,
+    const Tensor& lengths) {
+  const Dim inputSize = input.dim(0);
+  const Dim batchSize = input.ndim() < 2 ? 1 : input.dim(1);
+  const Dim seqLength = input.ndim() < 3 ? 1 : input.dim(2);
+  if (lengths.elements() != batchSize) {
+    throw std::invalid_argument(
+        "rnn: lengths must have one element per sample in the batch");
+  }
+  auto lens = lengths.astype(fl::dtype::s32).toHostVector<int>();
+  for (auto len : lens) {
+    if (len < 0 || len > seqLength) {
+      throw std::invalid_argument(
+          "rnn: lengths must be between 0 and the sequence length");
+    }
+  }
+  if (std::all_of(lens.begin(), lens.end(), [seqLength](int len) {
+        return len == seqLength;
+      })) {
+    return rnn(
+        input,
+        hiddenState,
+        cellState,
+        weights,
+        hiddenSize,
+        numLayers,
+        mode,
+        bidirectional,
+        dropProb);
+  }
+
+  const bool hasCellState = mode == RnnMode::LSTM;
+  const Dim totalLayers = numLayers * (bidirectional ? 2 : 1);
+  const Dim outSize = hiddenSize * (bidirectional ? 2 : 1);
+  const Shape stateDims = {hiddenSize, batchSize, totalLayers};
+  auto zeros = [&input](const Shape& dims) {
+    return Variable(fl::full(dims, 0.0, input.type()), false);
+  };
+
+  // Order samples by decreasing length so the active ones are a prefix
+  std::vector<int> order(batchSize);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&lens](int a, int b) {
+    return lens[a] > lens[b];
+  });
+  std::vector<int> inverse(batchSize);
+  std::vector<int> sortedLens(batchSize);
+  for (int i = 0; i < batchSize; ++i) {
+    inverse[order[i]] = i;
+    sortedLens[i] = lens[order[i]];
+  }
+  const auto orderIdx = Tensor::fromVector(order);
+
+  auto x = moddims(input, {inputSize, batchSize, seqLength})(
+      fl::span, orderIdx);
+  auto h = hiddenState.isEmpty()
+      ? zeros(stateDims)
+      : moddims(hiddenState, stateDims)(fl::span, orderIdx);
+  Variable c;
+  if (hasCellState) {
+    c = cellState.isEmpty() ? zeros(stateDims)
+                            : moddims(cellState, stateDims)(fl::span, orderIdx);
+  }
+  auto batchSlice = [](const Variable& v, Dim begin, Dim end) {
+    return v(fl::span, fl::range(begin, end));
+  };
+
+  std::vector<Variable> outputs;
+  if (!bidirectional) {
+    // Steps in [t0, t1) are valid for the first `active` samples; samples past
+    // their length keep their last hidden and cell states
+    Dim active = batchSize;
+    Dim t0 = 0;
+    while (active > 0) {
+      Dim t1 = sortedLens[active - 1];
+      if (t1 > t0) {
+        auto [y, hy, cy] =
+            rnn(x(fl::span, fl::range(0, active), fl::range(t0, t1)),
+                batchSlice(h, 0, active),
+                hasCellState ? batchSlice(c, 0, active) : Variable(),
+                weights,
+                hiddenSize,
+                numLayers,
+                mode,
+                bidirectional,
+                dropProb);
+        if (active < batchSize) {
+          y = concatenate(
+              {y, zeros({outSize, batchSize - active, t1 - t0})}, 1);
+          hy = concatenate({hy, batchSlice(h, active, batchSize)}, 1);
+          if (hasCellState) {
+            cy = concatenate({cy, batchSlice(c, active, batchSize)}, 1);
+          }
+        }
+        outputs.push_back(y);
+        h = hy;
+        c = cy;
+        t0 = t1;
+      }
+      while (active > 0 && sortedLens[active - 1] == t1) {
+        --active;
+      }
+    }
+    if (t0 < seqLength) {
+      outputs.push_back(zeros({outSize, batchSize, seqLength - t0}));
+    }
+    x = concatenate(outputs, 2);
+  } else {
+    // The reverse direction must start at the end of each sequence, so each
+    // group of equal-length samples runs separately over its valid steps
+    std::vector<Variable> hiddenOut, cellOut;
+    Dim begin = 0;
+    while (begin < batchSize) {
+      Dim end = begin;
+      while (end < batchSize && sortedLens[end] == sortedLens[begin]) {
+        ++end;
+      }
+      Dim len = sortedLens[begin];
+      auto hGroup = batchSlice(h, begin, end);
+      auto cGroup = hasCellState ? batchSlice(c, begin, end) : Variable();
+      Variable y;
+      if (len > 0) {
+        std::tie(y, hGroup, cGroup) =
+            rnn(x(fl::span, fl::range(begin, end), fl::range(0, len)),
+                hGroup,
+                cGroup,
+                weights,
+                hiddenSize,
+                numLayers,
+                mode,
+                bidirectional,
+                dropProb);
+        if (len < seqLength) {
+          y = concatenate(
+              {y, zeros({outSize, end - begin, seqLength - len})}, 2);
+        }
+      } else {
+        y = zeros({outSize, end - begin, seqLength});
+      }
+      outputs.push_back(y);
+      hiddenOut.push_back(hGroup);
+      cellOut.push_back(cGroup);
+      begin = end;
+    }
+    x = concatenate(outputs, 1);
+    h = concatenate(hiddenOut, 1);
+    if (hasCellState) {
+      c = concatenate(cellOut, 1);
+    }
+  }
+
+  // Restore the original sample order
+  const auto inverseIdx = Tensor::fromVector(inverse);
+  return std::make_tuple(
+      x(fl::span, inverseIdx),
+      h(fl::span, inverseIdx),
+      hasCellState ? c(fl::span, inverseIdx) : Variable());
+}
+
 Variable embedding(const Variable& input, const Variable& embeddings) {
   // TODO{fl::Tensor}{4-dims} - relax this
   if (input.ndim() >= 4) {
@@ -1728,21 +2064,9 @@ Variable embedding(const Variable& input, const Variable& embeddings) {
     }
 
     auto ip = inputs[0].tensor().flatten();
-    unsigned size = ip.elements();
-    auto deltas = fl::reshape(gradOutput.tensor(), {w.dim(0), size});
-
-    // Sparse Tensor
-    auto sp = Tensor(
-        ip.elements(),
-        w.dim(1),
-        fl::full({size}, 1, deltas.type()),
-        fl::arange({size + 1}, 0, fl::dtype::s32),
-        ip.astype(fl::dtype::s32),
-        fl::StorageType::CSR);
-
-    auto grad = transpose(fl::matmul(
-        sp, transpose(deltas), /* lhsProp = */ MatrixProperty::Transpose));
-    w.addGrad(Variable(grad, false));
+    auto deltas = fl::reshape(gradOutput.tensor(), {w.dim(0), ip.elements()});
+    // Only the looked up embeddings have a gradient: keep just their columns
+    w.addSparseGrad(deltas, ip, 1);
   };
 
   return Variable(result, {input, embeddings}, gradFunc);
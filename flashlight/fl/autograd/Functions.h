@@ -893,7 +893,40 @@ FL_API std::tuple<Variable, Variable, Variable> rnn(
     float dropout);
 
 /**
- * Looks up embeddings in a fixed dictionary and size.
+ * Applies an RNN unit to a batch of packed variable-length sequences: sample
+ * \f$b\f$ only has `lengths[b]` valid time steps and the rest of its input is
+ * padding. Time steps past each length are never computed, so the cost scales
+ * with the total number of valid steps rather than with the longest sequence.
+ *
+ * Unidirectional RNNs run the fused `rnn` over spans of time steps with a
+ * batch that shrinks as sequences end; bidirectional RNNs run it once per
+ * group of equal-length sequences so the reverse direction starts at the end
+ * of each sequence.
+ *
+ * @param lengths tensor with the number of valid time steps of each sample,
+ * in [0, sequence length]
+ *
+ * @return a tuple of three Variables as for `rnn`, where:
+ * - `y` is zero past the length of each sample
+ * - `hiddenState` and `cellState` are the states after the last valid time
+ * step of each sample
+ */
+FL_API std::tuple<Variable, Variable, Variable> rnn(
+    const Variable& input,
+    const Variable& hiddenState,
+    const Variable& cellState,
+    const Variable& weights,
+    int hiddenSize,
+    int numLayers,
+    RnnMode mode,
+    bool bidirectional,
+    float dropout,
+    const Tensor& lengths);
+
+/**
+ * Looks up embeddings in a fixed dictionary and size. The gradient of
+ * `embeddings` is held as the columns looked up; see
+ * `Variable::addSparseGrad`.
  * @param input a Variable of a list of indices with shape [\f$B_1\f$,
  * \f$B_2\f$, \f$B_3\f$]
  * @param embeddings a Variable of an embedding matrix with shape [\f$D\f$,
@@ -943,6 +976,34 @@ FL_API Variable batchnorm(
     double momentum,
     double epsilon);
 
+/**
+ * Applies Layer Normalization as described in the paper
+ * [Layer Normalization] (https://arxiv.org/abs/1607.06450) .
+ * \f[
+ *   y = \frac{x - \mathrm{E}[x]}{ \sqrt{\mathrm{Var}[x] + \epsilon}} * \gamma +
+ * \beta
+ * \f]
+ * The mean and variance are calculated over the leading `axes` of `input`,
+ * separately for each index along the remaining dimensions. Uses a fused
+ * kernel if the backend has one.
+ *
+ * @param input a Variable
+ * @param weight a Variable for \f$\gamma\f$ with one element per normalized
+ * element (the product of the sizes of `axes`), or empty
+ * @param bias a Variable for \f$\beta\f$ with the same size as `weight`, or
+ * empty
+ * @param axes dimensions to normalize over, which must be {0, ..., k - 1}
+ * @param epsilon value of \f$\epsilon\f$
+ *
+ * @return a Variable with same shape as `input`
+ */
+FL_API Variable layerNorm(
+    const Variable& input,
+    const Variable& weight,
+    const Variable& bias,
+    const std::vector<int>& axes,
+    double epsilon);
+
 /**
  * Applies asymmetric padding on a Variable `input`.
  * @param input input Variable
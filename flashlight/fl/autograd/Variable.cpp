@@ -11,7 +11,9 @@
 #include <cassert>
 #include <functional>
 #include <memory>
+#include <numeric>
 #include <stdexcept>
+#include <string>
 #include <unordered_set>
 #include <utility>
 
@@ -19,10 +21,65 @@
 #include "flashlight/fl/common/Utils.h"
 #include "flashlight/fl/tensor/Compute.h"
 #include "flashlight/fl/tensor/Index.h"
+#include "flashlight/fl/tensor/Profile.h"
 #include "flashlight/fl/tensor/Shape.h"
 
 namespace fl {
 
+namespace {
+
+std::vector<Index> sliceIndex(unsigned ndim, int axis, const Tensor& rows) {
+  std::vector<Index> index(ndim, fl::span);
+  index[axis] = rows;
+  return index;
+}
+
+// Sorts the rows of a gradient held as slices and sums the slices of repeated
+// rows. Rows are sorted on the host: there are as many as lookups in a batch,
+// far fewer than rows in a table.
+void coalesce(Variable::SparseGrad& sparse) {
+  const auto rows = sparse.rows.toHostVector<int>();
+  const int numRows = rows.size();
+  std::vector<int> order(numRows);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&rows](int a, int b) {
+    return rows[a] < rows[b];
+  });
+  std::vector<int> unique;
+  std::vector<int> rowPtr;
+  for (int i = 0; i < numRows; ++i) {
+    if (unique.empty() || unique.back() != rows[order[i]]) {
+      unique.push_back(rows[order[i]]);
+      rowPtr.push_back(i);
+    }
+  }
+  rowPtr.push_back(numRows);
+
+  const int axis = sparse.axis;
+  const int numUnique = unique.size();
+  if (numUnique == numRows) {
+    if (!std::is_sorted(rows.begin(), rows.end())) {
+      sparse.values = sparse.values(sliceIndex(
+          sparse.values.ndim(), axis, Tensor::fromVector(order)));
+    }
+  } else {
+    // Sums the slices of each row with a [unique rows, rows] sparse matrix
+    auto sp = Tensor(
+        numUnique,
+        numRows,
+        fl::full({numRows}, 1, sparse.values.type()),
+        Tensor::fromVector(rowPtr),
+        Tensor::fromVector(order),
+        fl::StorageType::CSR);
+    sparse.values = axis == 0
+        ? fl::matmul(sp, sparse.values)
+        : fl::transpose(fl::matmul(sp, fl::transpose(sparse.values)));
+  }
+  sparse.rows = Tensor::fromVector(unique);
+}
+
+} // namespace
+
 Variable::Variable(Tensor data, bool calcGrad) {
   sharedData_->data = std::move(data);
   sharedGrad_->calcGrad = calcGrad;
@@ -39,6 +96,9 @@ Variable::Variable(
     sharedGrad_->calcGrad = true;
     sharedGrad_->inputs = std::move(inputs);
     sharedGrad_->gradFunc = std::move(gradFunc);
+    if (detail::TraceScope::enabled()) {
+      sharedGrad_->traceScope = detail::TraceScope::current();
+    }
   }
 }
 
@@ -100,6 +160,10 @@ Variable& Variable::grad() const {
     throw std::logic_error("gradient calculation disabled for this Variable");
   }
 
+  if (sharedGrad_->sparseGrad) {
+    densifyGrad();
+  }
+
   if (!sharedGrad_->grad) {
     throw std::logic_error("gradient not calculated yet for this Variable");
   }
@@ -119,7 +183,7 @@ bool Variable::isGradAvailable() const {
   if (!sharedGrad_->calcGrad) {
     return false;
   }
-  return sharedGrad_->grad != nullptr;
+  return sharedGrad_->grad != nullptr || sharedGrad_->sparseGrad != nullptr;
 }
 
 Shape Variable::shape() const {
@@ -167,6 +231,7 @@ void Variable::eval() const {
 
 void Variable::zeroGrad() {
   sharedGrad_->grad.reset();
+  sharedGrad_->sparseGrad.reset();
 }
 
 void Variable::setCalcGrad(bool calcGrad) {
@@ -175,6 +240,7 @@ void Variable::setCalcGrad(bool calcGrad) {
     sharedGrad_->gradFunc = nullptr;
     sharedGrad_->inputs.clear();
     sharedGrad_->grad.reset();
+    sharedGrad_->sparseGrad.reset();
   }
 }
 
@@ -198,12 +264,23 @@ void Variable::addGrad(const Variable& childGrad) {
          << childGrad.shape() << std::endl;
       throw std::invalid_argument(ss.str());
     }
+    if (sharedGrad_->sparseGrad) {
+      densifyGrad();
+    }
     if (sharedGrad_->grad) {
       // Prevent increment of array refcount to avoid a copy
       // if getting a device pointer. See
       // https://git.io/fp9oM for more
-      sharedGrad_->grad = std::make_unique<Variable>(
-          sharedGrad_->grad->tensor() + childGrad.tensor(), false);
+      auto& grad = sharedGrad_->grad;
+      auto sum = std::make_unique<Variable>(
+          grad->tensor() + childGrad.tensor(), false);
+      if (grad->isRowSparse() && childGrad.isRowSparse() &&
+          grad->sparseRowAxis() == childGrad.sparseRowAxis()) {
+        sum->setRowSparse(
+            fl::concatenate(0, grad->sparseRows(), childGrad.sparseRows()),
+            grad->sparseRowAxis());
+      }
+      grad = std::move(sum);
     } else {
       // Copy the childGrad Variable so as to share a reference
       // to the underlying childGrad.tensor() rather than copying
@@ -213,6 +290,120 @@ void Variable::addGrad(const Variable& childGrad) {
   }
 }
 
+void Variable::setRowSparse(const Tensor& rows, int axis) {
+  if (axis < 0 || axis >= static_cast<int>(ndim())) {
+    throw std::invalid_argument(
+        "Variable::setRowSparse: invalid axis " + std::to_string(axis) +
+        " for a Variable with " + std::to_string(ndim()) + " dimensions");
+  }
+  // Deduplicate and sort rows on the host rather than through a mask over the
+  // whole axis
+  std::vector<int> hostRows;
+  if (!rows.isEmpty()) {
+    hostRows = rows.flatten().astype(fl::dtype::s32).toHostVector<int>();
+  }
+  std::sort(hostRows.begin(), hostRows.end());
+  hostRows.erase(std::unique(hostRows.begin(), hostRows.end()), hostRows.end());
+  sharedGrad_->sparseRows = Tensor::fromVector(hostRows);
+  sharedGrad_->sparseRowAxis = axis;
+}
+
+void Variable::setDense() {
+  sharedGrad_->sparseRows = Tensor();
+  sharedGrad_->sparseRowAxis = -1;
+}
+
+bool Variable::isRowSparse() const {
+  return sharedGrad_->sparseRowAxis >= 0;
+}
+
+const Tensor& Variable::sparseRows() const {
+  return sharedGrad_->sparseRows;
+}
+
+int Variable::sparseRowAxis() const {
+  return sharedGrad_->sparseRowAxis;
+}
+
+void Variable::addSparseGrad(
+    const Tensor& values,
+    const Tensor& rows,
+    int axis) {
+  if (!sharedGrad_->calcGrad) {
+    return;
+  }
+  if (ndim() != 2 || axis < 0 || axis > 1) {
+    throw std::invalid_argument(
+        "Variable::addSparseGrad: only slices of two-dimensional Variables "
+        "along axis 0 or 1 are supported");
+  }
+  if (values.type() != this->type()) {
+    std::stringstream ss;
+    ss << "Variable::addSparseGrad: attempted to add gradient of type "
+       << values.type() << " to a Variable of type " << this->type();
+    throw std::invalid_argument(ss.str());
+  }
+  Shape expected = shape();
+  expected[axis] = rows.elements();
+  if (values.shape() != expected) {
+    std::stringstream ss;
+    ss << "Variable::addSparseGrad: expected slices of shape " << expected
+       << " for " << rows.elements() << " rows but got shape "
+       << values.shape();
+    throw std::invalid_argument(ss.str());
+  }
+
+  SparseGrad child{rows.flatten().astype(fl::dtype::s32), values, axis};
+  auto& sparse = sharedGrad_->sparseGrad;
+  if (sparse && sparse->axis != axis) {
+    densifyGrad();
+  }
+  if (sharedGrad_->grad) {
+    coalesce(child);
+    addGrad(scatterGrad(child, shape()));
+  } else if (sparse) {
+    sparse->rows = fl::concatenate(0, sparse->rows, child.rows);
+    sparse->values = fl::concatenate(axis, sparse->values, child.values);
+    sharedGrad_->sparseGradCoalesced = false;
+  } else {
+    sparse = std::make_unique<SparseGrad>(std::move(child));
+    sharedGrad_->sparseGradCoalesced = false;
+  }
+}
+
+bool Variable::isGradSparse() const {
+  return sharedGrad_->sparseGrad != nullptr;
+}
+
+Variable::SparseGrad& Variable::sparseGrad() const {
+  if (!sharedGrad_->sparseGrad) {
+    throw std::logic_error("gradient is not held as slices for this Variable");
+  }
+  if (!sharedGrad_->sparseGradCoalesced) {
+    coalesce(*sharedGrad_->sparseGrad);
+    sharedGrad_->sparseGradCoalesced = true;
+  }
+  return *sharedGrad_->sparseGrad;
+}
+
+void Variable::densifyGrad() const {
+  auto grad = scatterGrad(sparseGrad(), shape());
+  sharedGrad_->sparseGrad.reset();
+  sharedGrad_->grad = std::make_unique<Variable>(std::move(grad));
+}
+
+Variable Variable::scatterGrad(const SparseGrad& sparse, const Shape& shape) {
+  auto grad = Variable(fl::full(shape, 0, sparse.values.type()), false);
+  if (!sparse.rows.isEmpty()) {
+    grad.tensor()(sliceIndex(shape.ndim(), sparse.axis, sparse.rows)) =
+        sparse.values;
+  }
+  // Rows are already sorted and unique
+  grad.sharedGrad_->sparseRows = sparse.rows;
+  grad.sharedGrad_->sparseRowAxis = sparse.axis;
+  return grad;
+}
+
 void Variable::registerGradHook(const GradHook& hook) {
   sharedGrad_->onGradAvailable = hook;
 }
@@ -223,6 +414,10 @@ void Variable::clearGradHook() {
 
 void Variable::applyGradHook() {
   if (sharedGrad_->onGradAvailable) {
+    // Hooks, e.g. gradient reduction, expect a dense gradient
+    if (sharedGrad_->sparseGrad) {
+      densifyGrad();
+    }
     assert(sharedGrad_->grad);
     sharedGrad_->onGradAvailable(*sharedGrad_->grad);
   }
@@ -230,10 +425,21 @@ void Variable::applyGradHook() {
 
 void Variable::calcGradInputs(bool retainGraph) {
   if (sharedGrad_->gradFunc) {
+    if (sharedGrad_->sparseGrad) {
+      densifyGrad();
+    }
     if (!sharedGrad_->grad) {
       throw std::logic_error("gradient was not propagated to this Variable");
     }
 
+    // Gradient functions run in the backward of the scope of their Variable,
+    // or in a common scope if it wasn't computed in any
+    static const uint32_t kGradFuncScope =
+        detail::TraceScope::intern("gradFunc");
+    const auto traceScope = sharedGrad_->traceScope;
+    FL_TRACE_SCOPE(
+        traceScope ? traceScope | detail::TraceScope::kBackward
+                   : kGradFuncScope);
     sharedGrad_->gradFunc(sharedGrad_->inputs, *sharedGrad_->grad);
   }
   if (!retainGraph) {
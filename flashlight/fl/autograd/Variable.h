@@ -8,6 +8,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <vector>
@@ -237,6 +238,83 @@ class FL_API Variable {
    */
   void addGrad(const Variable& childGrad);
 
+  /**
+   * Marks the Variable, typically a gradient, as row-sparse: it's only nonzero
+   * for the slices at `rows` along `axis`, e.g. the embeddings looked up by a
+   * batch. The Variable stays dense, but optimizers with lazy sparse updates
+   * enabled then only update those rows - see
+   * `FirstOrderOptimizer::setLazySparseUpdates`. Accumulating row-sparse
+   * gradients along the same axis keeps them row-sparse; any other
+   * accumulation makes the gradient dense.
+   *
+   * @param[in] rows the indices of the nonzero slices, which may repeat
+   * @param[in] axis the axis along which slices are taken
+   */
+  void setRowSparse(const Tensor& rows, int axis);
+
+  /**
+   * Marks the Variable as dense, e.g. after a reduction which may have made
+   * other rows nonzero.
+   */
+  void setDense();
+
+  /**
+   * @return whether the Variable is row-sparse; see `setRowSparse`
+   */
+  bool isRowSparse() const;
+
+  /**
+   * @return the sorted, unique indices of the nonzero slices of a row-sparse
+   * Variable
+   */
+  const Tensor& sparseRows() const;
+
+  /**
+   * @return the axis along which a row-sparse Variable is sliced, or -1 if it
+   * is dense
+   */
+  int sparseRowAxis() const;
+
+  /// A gradient held as the slices it is nonzero for; see `addSparseGrad`
+  struct SparseGrad {
+    /// Indices of the slices along `axis`
+    Tensor rows;
+    /// The slices, stacked along `axis` in the order of `rows`
+    Tensor values;
+    /// Axis along which slices are taken
+    int axis{-1};
+  };
+
+  /**
+   * Adds a gradient which is only nonzero for the slices at `rows` along
+   * `axis`, e.g. the gradient of the embeddings looked up by a batch, without
+   * materializing the rest of it. The slices are scattered into a dense
+   * row-sparse gradient (see `setRowSparse`) once `grad()` is called, a dense
+   * gradient is added or a gradient hook runs; until then, optimizers with
+   * lazy sparse updates read them through `sparseGrad()`. Only
+   * two-dimensional Variables are supported.
+   * No-op if `this->isCalcGrad()` is false.
+   *
+   * @param[in] values the gradient of the slices, shaped like the Variable
+   * except along `axis`, which has one slice per row
+   * @param[in] rows the indices of the slices, which may repeat
+   * @param[in] axis the axis along which slices are taken
+   */
+  void addSparseGrad(const Tensor& values, const Tensor& rows, int axis);
+
+  /**
+   * @return whether the gradient is held as slices; see `addSparseGrad`
+   */
+  bool isGradSparse() const;
+
+  /**
+   * Returns the gradient held as slices, with sorted unique rows: the slices
+   * of repeated rows are summed. The rows are read back to the host to do so.
+   *
+   * @return a reference to the slices of the gradient
+   */
+  SparseGrad& sparseGrad() const;
+
   /**
    * Registers a lambda function `hook` to be applied on the gradient w.r.t
    * Variable after it is computed during backward pass
@@ -301,6 +379,18 @@ class FL_API Variable {
    */
   void applyGradHook();
 
+  /**
+   * Replaces a gradient held as slices with the equivalent dense row-sparse
+   * gradient
+   */
+  void densifyGrad() const;
+
+  /**
+   * Scatters the slices of a coalesced gradient into a dense row-sparse
+   * gradient of the given shape
+   */
+  static Variable scatterGrad(const SparseGrad& sparse, const Shape& shape);
+
   struct SharedData {
     /// Array wrapped by this Variable
     Tensor data;
@@ -319,6 +409,16 @@ class FL_API Variable {
     GradFunc gradFunc{nullptr};
     /// Function applied to gradient after it's computed during bwd pass
     GradHook onGradAvailable{nullptr};
+    /// Profiling scope the Variable was computed in, if scopes are tracked;
+    /// its gradient function runs in the backward of that scope
+    uint32_t traceScope{0};
+    /// If row-sparse, the axis and indices of the nonzero slices
+    int sparseRowAxis{-1};
+    Tensor sparseRows;
+    /// Gradient held as slices instead of `grad`, if any; see `addSparseGrad`
+    std::unique_ptr<SparseGrad> sparseGrad{nullptr};
+    /// Whether the rows of `sparseGrad` are sorted and unique
+    bool sparseGradCoalesced{false};
 
    private:
     FL_SAVE_LOAD(calcGrad);
@@ -7,6 +7,10 @@
 
 #pragma once
 
+#include <optional>
+#include <stdexcept>
+#include <string>
+
 #include "flashlight/fl/autograd/tensor/AutogradOps.h"
 #include "flashlight/fl/common/Defines.h"
 #include "flashlight/fl/tensor/TensorExtension.h"
@@ -54,6 +58,15 @@ class AutogradExtension : public TensorExtension<AutogradExtension> {
     return nullptr;
   }
 
+  /**
+   * Identifies the hardware and libraries benchmarks created by
+   * `createBenchmarkOptions` are timed on. Part of the keys of benchmarks in
+   * the `fl::DynamicBenchmarkCache`.
+   */
+  virtual std::string benchmarkFingerprint() const {
+    return "";
+  }
+
   /**************************** Forward ****************************/
   virtual Tensor conv2d(
       const Tensor& input,
@@ -105,6 +118,86 @@ class AutogradExtension : public TensorExtension<AutogradExtension> {
       const float dropout,
       std::shared_ptr<detail::AutogradPayload> payload) = 0;
 
+  /**
+   * Normalizes `input` over the leading `axes` (which must be {0, ..., k - 1})
+   * and applies the elementwise affine transform given by `weight` and `bias`
+   * (each with one element per normalized element, or empty). When `train`,
+   * sets `saveMean` and `saveVar` to the statistics of each normalized slice.
+   *
+   * Backends without a fused implementation return `std::nullopt`, in which
+   * case callers compose the operation from other ops.
+   */
+  virtual std::optional<Tensor> layerNorm(
+      Tensor& /* saveMean */,
+      Tensor& /* saveVar */,
+      const Tensor& /* input */,
+      const Tensor& /* weight */,
+      const Tensor& /* bias */,
+      const std::vector<int>& /* axes */,
+      const bool /* train */,
+      const double /* epsilon */,
+      std::shared_ptr<detail::AutogradPayload> /* payload */) {
+    return std::nullopt;
+  }
+
+  /**
+   * Computes the softmax, or the log softmax if `logSoftmax`, of `input` along
+   * `axis`.
+   *
+   * Backends without a fused implementation return `std::nullopt`, in which
+   * case callers compose the operation from other ops.
+   */
+  virtual std::optional<Tensor> softmax(
+      const Tensor& /* input */,
+      const int /* axis */,
+      const bool /* logSoftmax */,
+      std::shared_ptr<detail::AutogradPayload> /* payload */) {
+    return std::nullopt;
+  }
+
+  /**
+   * Computes `weight * input` in 8-bit integer arithmetic for a `weight` of
+   * shape [outputSize, inputSize] quantized per output channel by
+   * `quantizePerChannel`, with `weightScales` of shape [outputSize, 1].
+   * `input`, of shape [inputSize, *], is quantized to 8 bits with
+   * `inputScale`, which clips its values to
+   * [-127 * inputScale, 127 * inputScale]. The output is of shape
+   * [outputSize, *] and of the type of `input`.
+   *
+   * Backends without an integer implementation return `std::nullopt`, in
+   * which case callers compute with the dequantized weight.
+   */
+  virtual std::optional<Tensor> quantizedLinear(
+      const Tensor& /* input */,
+      const Tensor& /* weight */,
+      const Tensor& /* weightScales */,
+      const float /* inputScale */) {
+    return std::nullopt;
+  }
+
+  /**
+   * Computes `conv2d` in 8-bit integer arithmetic for `weights` (WHIO)
+   * quantized per output channel by `quantizePerChannel`, with `weightScales`
+   * of shape [1, 1, 1, O]. `input` is quantized as for `quantizedLinear`.
+   *
+   * Backends without an integer implementation return `std::nullopt`, in
+   * which case callers compute with the dequantized weights.
+   */
+  virtual std::optional<Tensor> quantizedConv2d(
+      const Tensor& /* input */,
+      const Tensor& /* weights */,
+      const Tensor& /* weightScales */,
+      const float /* inputScale */,
+      const int /* sx */,
+      const int /* sy */,
+      const int /* px */,
+      const int /* py */,
+      const int /* dx */,
+      const int /* dy */,
+      const int /* groups */) {
+    return std::nullopt;
+  }
+
   /**************************** Backward ****************************/
   // ]----- conv2d
   virtual Tensor conv2dBackwardData(
@@ -177,6 +270,33 @@ class AutogradExtension : public TensorExtension<AutogradExtension> {
       const bool bidirectional,
       const float dropProb,
       std::shared_ptr<detail::AutogradPayload> payload) = 0;
+
+  // ]----- layerNorm
+  // Only called for outputs of `layerNorm` that aren't `std::nullopt`
+  virtual std::tuple<Tensor, Tensor, Tensor> layerNormBackward(
+      const Tensor& /* gradOutput */,
+      const Tensor& /* saveMean */,
+      const Tensor& /* saveVar */,
+      const Tensor& /* input */,
+      const Tensor& /* weight */,
+      const std::vector<int>& /* axes */,
+      const double /* epsilon */,
+      std::shared_ptr<detail::AutogradPayload> /* payload */) {
+    throw std::logic_error(
+        "AutogradExtension::layerNormBackward - not implemented");
+  }
+
+  // ]----- softmax
+  // Only called for outputs of `softmax` that aren't `std::nullopt`
+  virtual Tensor softmaxBackward(
+      const Tensor& /* gradOutput */,
+      const Tensor& /* output */,
+      const int /* axis */,
+      const bool /* logSoftmax */,
+      std::shared_ptr<detail::AutogradPayload> /* payload */) {
+    throw std::logic_error(
+        "AutogradExtension::softmaxBackward - not implemented");
+  }
 };
 
 } // namespace fl
@@ -9,6 +9,7 @@
 #include "flashlight/fl/autograd/tensor/AutogradExtension.h"
 #include "flashlight/fl/autograd/tensor/AutogradExtensionBackends.h"
 #include "flashlight/fl/tensor/TensorBackend.h"
+#include "flashlight/fl/tensor/TensorExtension.h"
 
 namespace fl {
 
@@ -143,6 +144,17 @@ std::tuple<Tensor, Tensor, Tensor> rnn(
 
 namespace detail {
 
+namespace {
+
+// Ops with optional fused implementations fall back to other ops on backends
+// without an autograd extension
+bool hasAutogradExtension(const Tensor& tensor) {
+  return TensorExtensionRegistrar::getInstance().isTensorExtensionRegistered(
+      tensor.backendType(), TensorExtensionType::Autograd);
+}
+
+} // namespace
+
 Tensor conv2d(
     const Tensor& input,
     const Tensor& weights,
@@ -225,6 +237,66 @@ std::tuple<Tensor, Tensor, Tensor> rnn(
       payload);
 }
 
+std::optional<Tensor> layerNorm(
+    Tensor& saveMean,
+    Tensor& saveVar,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    const std::vector<int>& axes,
+    const bool train,
+    const double epsilon,
+    std::shared_ptr<detail::AutogradPayload> payload) {
+  if (!hasAutogradExtension(input)) {
+    return std::nullopt;
+  }
+  return input.backend().getExtension<AutogradExtension>().layerNorm(
+      saveMean, saveVar, input, weight, bias, axes, train, epsilon, payload);
+}
+
+std::optional<Tensor> softmax(
+    const Tensor& input,
+    const int axis,
+    const bool logSoftmax,
+    std::shared_ptr<detail::AutogradPayload> payload) {
+  if (!hasAutogradExtension(input)) {
+    return std::nullopt;
+  }
+  return input.backend().getExtension<AutogradExtension>().softmax(
+      input, axis, logSoftmax, payload);
+}
+
+std::optional<Tensor> quantizedLinear(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& weightScales,
+    const float inputScale) {
+  if (!hasAutogradExtension(input)) {
+    return std::nullopt;
+  }
+  return input.backend().getExtension<AutogradExtension>().quantizedLinear(
+      input, weight, weightScales, inputScale);
+}
+
+std::optional<Tensor> quantizedConv2d(
+    const Tensor& input,
+    const Tensor& weights,
+    const Tensor& weightScales,
+    const float inputScale,
+    const int sx,
+    const int sy,
+    const int px,
+    const int py,
+    const int dx,
+    const int dy,
+    const int groups) {
+  if (!hasAutogradExtension(input)) {
+    return std::nullopt;
+  }
+  return input.backend().getExtension<AutogradExtension>().quantizedConv2d(
+      input, weights, weightScales, inputScale, sx, sy, px, py, dx, dy, groups);
+}
+
 Tensor conv2dBackwardData(
     const Tensor& gradOutput,
     const Tensor& input,
@@ -360,6 +432,29 @@ std::tuple<Tensor, Tensor, Tensor, Tensor> rnnBackward(
       payload);
 }
 
+std::tuple<Tensor, Tensor, Tensor> layerNormBackward(
+    const Tensor& gradOutput,
+    const Tensor& saveMean,
+    const Tensor& saveVar,
+    const Tensor& input,
+    const Tensor& weight,
+    const std::vector<int>& axes,
+    const double epsilon,
+    std::shared_ptr<detail::AutogradPayload> payload) {
+  return input.backend().getExtension<AutogradExtension>().layerNormBackward(
+      gradOutput, saveMean, saveVar, input, weight, axes, epsilon, payload);
+}
+
+Tensor softmaxBackward(
+    const Tensor& gradOutput,
+    const Tensor& output,
+    const int axis,
+    const bool logSoftmax,
+    std::shared_ptr<detail::AutogradPayload> payload) {
+  return output.backend().getExtension<AutogradExtension>().softmaxBackward(
+      gradOutput, output, axis, logSoftmax, payload);
+}
+
 } // namespace detail
 
 } // namespace fl
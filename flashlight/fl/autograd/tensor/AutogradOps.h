@@ -8,6 +8,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <tuple>
 
 #include "flashlight/fl/common/Defines.h"
@@ -292,6 +293,46 @@ FL_API std::tuple<Tensor, Tensor, Tensor> rnn(
     const float dropout,
     std::shared_ptr<detail::AutogradPayload> payload);
 
+// Returns std::nullopt if the backend has no fused layer norm
+FL_API std::optional<Tensor> layerNorm(
+    Tensor& saveMean,
+    Tensor& saveVar,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    const std::vector<int>& axes,
+    const bool train,
+    const double epsilon,
+    std::shared_ptr<detail::AutogradPayload> payload);
+
+// Returns std::nullopt if the backend has no fused softmax
+FL_API std::optional<Tensor> softmax(
+    const Tensor& input,
+    const int axis,
+    const bool logSoftmax,
+    std::shared_ptr<detail::AutogradPayload> payload);
+
+// Returns std::nullopt if the backend has no 8-bit linear
+FL_API std::optional<Tensor> quantizedLinear(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& weightScales,
+    const float inputScale);
+
+// Returns std::nullopt if the backend has no 8-bit convolution
+FL_API std::optional<Tensor> quantizedConv2d(
+    const Tensor& input,
+    const Tensor& weights,
+    const Tensor& weightScales,
+    const float inputScale,
+    const int sx,
+    const int sy,
+    const int px,
+    const int py,
+    const int dx,
+    const int dy,
+    const int groups);
+
 // Returns the gradient with respect to the input
 FL_API Tensor conv2dBackwardData(
     const Tensor& gradOutput,
@@ -376,6 +417,26 @@ FL_API std::tuple<Tensor, Tensor, Tensor, Tensor> rnnBackward(
     const float dropProb,
     std::shared_ptr<detail::AutogradPayload> payload);
 
+// Returns the gradients with respect to the input, weight, and bias,
+// respectively
+FL_API std::tuple<Tensor, Tensor, Tensor> layerNormBackward(
+    const Tensor& gradOutput,
+    const Tensor& saveMean,
+    const Tensor& saveVar,
+    const Tensor& input,
+    const Tensor& weight,
+    const std::vector<int>& axes,
+    const double epsilon,
+    std::shared_ptr<detail::AutogradPayload> payload);
+
+// Returns the gradient with respect to the input
+FL_API Tensor softmaxBackward(
+    const Tensor& gradOutput,
+    const Tensor& output,
+    const int axis,
+    const bool logSoftmax,
+    std::shared_ptr<detail::AutogradPayload> payload);
+
 } // namespace detail
 
 } // namespace fl
@@ -10,6 +10,7 @@
 #include <cudnn.h>
 
 #include "flashlight/fl/common/DynamicBenchmark.h"
+#include "flashlight/fl/runtime/CUDAUtils.h"
 
 namespace fl {
 
@@ -24,6 +25,13 @@ CudnnAutogradExtension::createBenchmarkOptions() {
           fl::kDynamicBenchmarkDefaultCount));
 }
 
+std::string CudnnAutogradExtension::benchmarkFingerprint() const {
+  cudaDeviceProp prop;
+  FL_CUDA_CHECK(cudaGetDeviceProperties(&prop, fl::cuda::getActiveDeviceId()));
+  return std::string(prop.name) + " sm" + std::to_string(prop.major) +
+      std::to_string(prop.minor) + " cudnn" + std::to_string(cudnnGetVersion());
+}
+
 bool CudnnAutogradExtension::isDataTypeSupported(const fl::dtype& dtype) const {
   switch (dtype) {
     case fl::dtype::f16:
@@ -25,6 +25,8 @@ class CudnnAutogradExtension : public AutogradExtension {
 
   std::shared_ptr<fl::DynamicBenchmark> createBenchmarkOptions() override;
 
+  std::string benchmarkFingerprint() const override;
+
   /**************************** Forward ****************************/
   Tensor conv2d(
       const Tensor& input,
@@ -8,7 +8,9 @@
 #include "flashlight/fl/autograd/tensor/backend/onednn/OneDnnAutogradExtension.h"
 
 #include <algorithm>
+#include <sstream>
 #include <stdexcept>
+#include <string>
 #include <utility>
 
 #include <dnnl.hpp>
@@ -84,6 +86,32 @@ struct OneDnnBatchNormPayload : detail::AutogradPayloadData {
   dnnl::memory weightsMemory;
 };
 
+// Primitives are created once per signature and cached
+
+struct OneDnnBatchNormForward {
+  dnnl::batch_normalization_forward::primitive_desc primDesc;
+  dnnl::batch_normalization_forward primitive;
+};
+
+struct OneDnnBatchNormBackward {
+  dnnl::batch_normalization_backward::primitive_desc primDesc;
+  dnnl::batch_normalization_backward primitive;
+};
+
+std::string batchNormKey(
+    fl::dtype type,
+    const dnnl::memory::dims& inputOutputDims,
+    const bool train,
+    const double epsilon) {
+  std::ostringstream ss;
+  ss << type << ";";
+  for (auto dim : inputOutputDims) {
+    ss << dim << ",";
+  }
+  ss << ";" << train << ";" << epsilon;
+  return ss.str();
+}
+
 } // namespace
 
 Tensor OneDnnAutogradExtension::batchnorm(
@@ -166,19 +194,26 @@ Tensor OneDnnAutogradExtension::batchnorm(
   payload->varMemory = varMemory.getMemory();
   payload->weightsMemory = weightsMemory.getMemory();
   // Primitives and descriptors
-  auto kind = train ? dnnl::prop_kind::forward_training
-                    : dnnl::prop_kind::forward_inference;
-  // https://fburl.com/6latj733
-  dnnl::normalization_flags flag = train
-      ? dnnl::normalization_flags::none
-      : dnnl::normalization_flags::use_global_stats;
-  flag = flag | dnnl::normalization_flags::use_scale_shift;
-  auto fwdDesc = dnnl::batch_normalization_forward::desc(
-      kind, inputOutputMemDesc, epsilon, flag);
-  payload->fwdPrimDesc =
-      dnnl::batch_normalization_forward::primitive_desc(fwdDesc, dnnlEngine);
+  static detail::DnnlCache<OneDnnBatchNormForward> cache;
+  auto batchNormForward = cache.get(
+      batchNormKey(input.type(), inputOutputDims, train, epsilon), [&]() {
+        auto kind = train ? dnnl::prop_kind::forward_training
+                          : dnnl::prop_kind::forward_inference;
+        // https://fburl.com/6latj733
+        dnnl::normalization_flags flag = train
+            ? dnnl::normalization_flags::none
+            : dnnl::normalization_flags::use_global_stats;
+        flag = flag | dnnl::normalization_flags::use_scale_shift;
+        auto fwdDesc = dnnl::batch_normalization_forward::desc(
+            kind, inputOutputMemDesc, epsilon, flag);
+        auto primDesc = dnnl::batch_normalization_forward::primitive_desc(
+            fwdDesc, dnnlEngine);
+        auto primitive = dnnl::batch_normalization_forward(primDesc);
+        return OneDnnBatchNormForward{
+            std::move(primDesc), std::move(primitive)};
+      });
+  payload->fwdPrimDesc = batchNormForward->primDesc;
   payload->outputMemoryDescriptor = outputMemory.getDescriptor();
-  auto bn = dnnl::batch_normalization_forward(payload->fwdPrimDesc);
   std::unordered_map<int, dnnl::memory> bnFwdArgs = {
       {DNNL_ARG_SRC, inputMemory.getMemory()},
       {DNNL_ARG_MEAN, meanMemory.getMemory()},
@@ -189,7 +224,7 @@ Tensor OneDnnAutogradExtension::batchnorm(
   // Execute
   std::vector<dnnl::primitive> network;
   std::vector<std::unordered_map<int, dnnl::memory>> fwdArgs = {bnFwdArgs};
-  network.push_back(bn);
+  network.push_back(batchNormForward->primitive);
   detail::executeNetwork(network, fwdArgs);
 
   return output;
@@ -241,16 +276,21 @@ std::tuple<Tensor, Tensor, Tensor> OneDnnAutogradExtension::batchnormBackward(
       gradWeightsDNNL, payload->weightsDnnlDims, format2d);
 
   // Primitives and descriptors
-  auto bwdDesc = dnnl::batch_normalization_backward::desc(
-      dnnl::prop_kind::backward,
-      gradOutputMem.getDescriptor(),
-      payload->outputMemoryDescriptor,
-      epsilon,
-      dnnl::normalization_flags::use_scale_shift);
-  auto bwdPrimDesc = dnnl::batch_normalization_backward::primitive_desc(
-      bwdDesc, dnnlEngine, payload->fwdPrimDesc);
-  auto bwdPrim =
-      std::make_shared<dnnl::batch_normalization_backward>(bwdPrimDesc);
+  static detail::DnnlCache<OneDnnBatchNormBackward> cache;
+  auto batchNormBackward = cache.get(
+      batchNormKey(input.type(), inputOutputDims, train, epsilon), [&]() {
+        auto bwdDesc = dnnl::batch_normalization_backward::desc(
+            dnnl::prop_kind::backward,
+            gradOutputMem.getDescriptor(),
+            payload->outputMemoryDescriptor,
+            epsilon,
+            dnnl::normalization_flags::use_scale_shift);
+        auto primDesc = dnnl::batch_normalization_backward::primitive_desc(
+            bwdDesc, dnnlEngine, payload->fwdPrimDesc);
+        auto primitive = dnnl::batch_normalization_backward(primDesc);
+        return OneDnnBatchNormBackward{
+            std::move(primDesc), std::move(primitive)};
+      });
 
   // Execute
   std::vector<dnnl::primitive> networkBackwards;
@@ -262,7 +302,7 @@ std::tuple<Tensor, Tensor, Tensor> OneDnnAutogradExtension::batchnormBackward(
        {DNNL_ARG_DIFF_SRC, gradInputMem.getMemory()},
        {DNNL_ARG_DIFF_DST, gradOutputMem.getMemory()},
        {DNNL_ARG_DIFF_SCALE_SHIFT, gradWeightsMem.getMemory()}}};
-  networkBackwards.push_back(*bwdPrim);
+  networkBackwards.push_back(batchNormBackward->primitive);
   detail::executeNetwork(networkBackwards, bwdArgs);
 
   return {
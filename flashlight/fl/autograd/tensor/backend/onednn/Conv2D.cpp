@@ -9,6 +9,8 @@
 
 #include <array>
 #include <memory>
+#include <sstream>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -110,12 +112,9 @@ OneDnnConv2DData createOneDnnConv2DData(
   out.weightMemDesc = memory::desc({out.weightDims}, dataType, formatWeight);
   out.biasMemDesc = memory::desc({out.biasDims}, dataType, formatAny);
 
-  //
+  // Training primitives serve both inference and, as hints, backward passes,
+  // so only one forward primitive is cached per signature
   const auto forwardMode = prop_kind::forward_training;
-  // TODO: determine train mode/assess perf impact of always choosing training
-  // (primitive cache storage overhead?)
-  // const auto forwardMode =
-  //     train ? prop_kind::forward_training : prop_kind::forward_inference;
 
   // Convolution descriptor
   std::shared_ptr<convolution_forward::desc> fwdDescriptor;
@@ -152,6 +151,89 @@ OneDnnConv2DData createOneDnnConv2DData(
   return out;
 }
 
+// Primitives are created once per signature and cached
+
+struct OneDnnConv2DForward {
+  OneDnnConv2DData data;
+  convolution_forward primitive;
+};
+
+struct OneDnnConv2DBackwardData {
+  convolution_backward_data::primitive_desc primDesc;
+  convolution_backward_data primitive;
+};
+
+struct OneDnnConv2DBackwardWeights {
+  convolution_backward_weights::primitive_desc primDesc;
+  convolution_backward_weights primitive;
+};
+
+std::string conv2DKey(
+    fl::dtype inputType,
+    const Shape& inputShape,
+    const Shape& weightsShape,
+    const bool hasBias,
+    const int sx,
+    const int sy,
+    const int px,
+    const int py,
+    const int dx,
+    const int dy,
+    const int groups) {
+  std::ostringstream ss;
+  ss << inputType << ";" << inputShape << ";" << weightsShape << ";"
+     << hasBias << ";" << sx << "," << sy << ";" << px << "," << py << ";"
+     << dx << "," << dy << ";" << groups;
+  return ss.str();
+}
+
+std::shared_ptr<const OneDnnConv2DForward> getConv2DForward(
+    fl::dtype inputType,
+    const Shape& inputShape,
+    const Shape& weightsShape,
+    const Shape& biasShape,
+    const Shape& outputShape,
+    const int sx,
+    const int sy,
+    const int px,
+    const int py,
+    const int dx,
+    const int dy,
+    const int groups) {
+  static detail::DnnlCache<OneDnnConv2DForward> cache;
+  const bool hasBias = biasShape.elements() > 0;
+  return cache.get(
+      conv2DKey(
+          inputType,
+          inputShape,
+          weightsShape,
+          hasBias,
+          sx,
+          sy,
+          px,
+          py,
+          dx,
+          dy,
+          groups),
+      [&]() {
+        auto data = createOneDnnConv2DData(
+            inputType,
+            inputShape,
+            weightsShape,
+            biasShape,
+            outputShape,
+            sx,
+            sy,
+            px,
+            py,
+            dx,
+            dy,
+            groups);
+        auto primitive = convolution_forward(data.fwdPrimDesc);
+        return OneDnnConv2DForward{std::move(data), std::move(primitive)};
+      });
+}
+
 } // namespace
 
 Tensor OneDnnAutogradExtension::conv2d(
@@ -165,7 +247,7 @@ Tensor OneDnnAutogradExtension::conv2d(
     const int dx,
     const int dy,
     const int groups,
-    std::shared_ptr<detail::AutogradPayload>) {
+    std::shared_ptr<detail::AutogradPayload> autogradPayload) {
   if (input.type() == fl::dtype::f16) {
     throw std::runtime_error("Half precision is not supported in CPU.");
   }
@@ -196,7 +278,7 @@ Tensor OneDnnAutogradExtension::conv2d(
   auto& dnnlEngine = detail::DnnlEngine::getInstance().getEngine();
 
   /********************************* Forward *******************************/
-  OneDnnConv2DData conv2DData = createOneDnnConv2DData(
+  auto conv2DForward = getConv2DForward(
       input.type(),
       input.shape(),
       weights.shape(),
@@ -209,6 +291,7 @@ Tensor OneDnnAutogradExtension::conv2d(
       dx,
       dy,
       groups);
+  const OneDnnConv2DData& conv2DData = conv2DForward->data;
 
   // Create memory
   const detail::DnnlMemoryWrapper inputMemInit(
@@ -232,21 +315,21 @@ Tensor OneDnnAutogradExtension::conv2d(
   // Input
   auto inputMemory = detail::dnnlAlignOrdering(
       network, fwdArgs, inputMemInit.getMemory(), inputDesc);
-  auto weightsMemory = detail::dnnlAlignOrdering(
-      network, fwdArgs, weightsMem.getMemory(), weightsDesc);
+  // Without gradients (e.g. for inference), weights are usually unchanged
+  // between calls, so keep them in the layout of the convolution
+  auto weightsMemory = autogradPayload
+      ? detail::dnnlAlignOrdering(
+            network, fwdArgs, weightsMem.getMemory(), weightsDesc)
+      : detail::dnnlCachedReorder(weights, weightsMem.getMemory(), weightsDesc);
   // Output - adds a reorder after the conv if needed
   auto outputMemory = outputMemInit.getMemory();
   if (outputMemInit.getMemory().get_desc() != outputDesc) {
     outputMemory = memory(outputDesc, dnnlEngine);
   }
 
-  // Create convolution
-  std::shared_ptr<convolution_forward> conv;
   const detail::DnnlMemoryWrapper biasMemory(
       bias, conv2DData.biasDims, formatBias);
-  conv = std::make_shared<convolution_forward>(conv2DData.fwdPrimDesc);
-
-  network.push_back(*conv);
+  network.push_back(conv2DForward->primitive);
 
   // Conv fwd args
   std::unordered_map<int, dnnl::memory> convFwdArgs = {
@@ -260,7 +343,8 @@ Tensor OneDnnAutogradExtension::conv2d(
 
   // Add output reordering if needed
   if (outputMemory != outputMemInit.getMemory()) {
-    network.push_back(dnnl::reorder(outputMemory, outputMemInit.getMemory()));
+    network.push_back(detail::dnnlReorder(
+        outputMemory.get_desc(), outputMemInit.getMemory().get_desc()));
     fwdArgs.push_back(
         {{DNNL_ARG_FROM, outputMemory},
          {DNNL_ARG_TO, outputMemInit.getMemory()}});
@@ -293,7 +377,7 @@ Tensor OneDnnAutogradExtension::conv2dBackwardData(
   auto& dnnlEngineBwd = detail::DnnlEngine::getInstance().getEngine();
 
   Tensor bias; // dummy
-  OneDnnConv2DData conv2DData = createOneDnnConv2DData(
+  auto conv2DForward = getConv2DForward(
       input.type(),
       input.shape(),
       weights.shape(),
@@ -306,21 +390,41 @@ Tensor OneDnnAutogradExtension::conv2dBackwardData(
       dx,
       dy,
       groups);
-
-  // Backward descriptor
-  auto bwdDataDesc = std::make_shared<convolution_backward_data::desc>(
-      algorithm::convolution_direct,
-      conv2DData.inputMemDesc,
-      conv2DData.weightMemDesc,
-      conv2DData.outputMemDesc,
-      conv2DData.strideDims,
-      conv2DData.dilationDims,
-      conv2DData.paddingDims,
-      conv2DData.paddingDims);
-  // Primitive descriptor
-  auto bwdDataPrimDesc =
-      std::make_shared<convolution_backward_data::primitive_desc>(
-          *bwdDataDesc, dnnlEngineBwd, conv2DData.fwdPrimDesc);
+  const OneDnnConv2DData& conv2DData = conv2DForward->data;
+
+  static detail::DnnlCache<OneDnnConv2DBackwardData> bwdDataCache;
+  auto conv2DBackwardData = bwdDataCache.get(
+      conv2DKey(
+          input.type(),
+          input.shape(),
+          weights.shape(),
+          /* hasBias = */ false,
+          sx,
+          sy,
+          px,
+          py,
+          dx,
+          dy,
+          groups),
+      [&]() {
+        // Backward descriptor
+        auto bwdDataDesc = convolution_backward_data::desc(
+            algorithm::convolution_direct,
+            conv2DData.inputMemDesc,
+            conv2DData.weightMemDesc,
+            conv2DData.outputMemDesc,
+            conv2DData.strideDims,
+            conv2DData.dilationDims,
+            conv2DData.paddingDims,
+            conv2DData.paddingDims);
+        // Primitive descriptor
+        auto primDesc = convolution_backward_data::primitive_desc(
+            bwdDataDesc, dnnlEngineBwd, conv2DData.fwdPrimDesc);
+        auto primitive = convolution_backward_data(primDesc);
+        return OneDnnConv2DBackwardData{
+            std::move(primDesc), std::move(primitive)};
+      });
+  const auto* bwdDataPrimDesc = &conv2DBackwardData->primDesc;
 
   // Create memory
   const detail::DnnlMemoryWrapper gradOutputMemInit(
@@ -354,19 +458,16 @@ Tensor OneDnnAutogradExtension::conv2dBackwardData(
   }
 
   // Convolution backwards
-  auto convBwdData =
-      std::make_shared<convolution_backward_data>(*bwdDataPrimDesc);
-
   bwdDataArgs.push_back(
       {{DNNL_ARG_DIFF_SRC, gradInputMemory},
        {DNNL_ARG_WEIGHTS, weightsMemoryBackwards},
        {DNNL_ARG_DIFF_DST, gradOutputMemory}});
-  networkBackwards.push_back(*convBwdData);
+  networkBackwards.push_back(conv2DBackwardData->primitive);
 
   // Reorder the output (which is gradInput here) if necessary
   if (gradInputMemory != gradInputMemInit.getMemory()) {
-    networkBackwards.push_back(
-        dnnl::reorder(gradInputMemory, gradInputMemInit.getMemory()));
+    networkBackwards.push_back(detail::dnnlReorder(
+        gradInputMemory.get_desc(), gradInputMemInit.getMemory().get_desc()));
     bwdDataArgs.push_back(
         {{DNNL_ARG_FROM, gradInputMemory},
          {DNNL_ARG_TO, gradInputMemInit.getMemory()}});
@@ -398,7 +499,7 @@ std::pair<Tensor, Tensor> OneDnnAutogradExtension::conv2dBackwardFilterBias(
   auto formatWeight =
       (groups == 1) ? memory::format_tag::oihw : memory::format_tag::goihw;
   auto& dnnlEngineBwd = detail::DnnlEngine::getInstance().getEngine();
-  OneDnnConv2DData conv2DData = createOneDnnConv2DData(
+  auto conv2DForward = getConv2DForward(
       input.type(),
       input.shape(),
       weights.shape(),
@@ -411,6 +512,7 @@ std::pair<Tensor, Tensor> OneDnnAutogradExtension::conv2dBackwardFilterBias(
       dx,
       dy,
       groups);
+  const OneDnnConv2DData& conv2DData = conv2DForward->data;
 
   Tensor gradBias;
   bool computeBiasGrad = !bias.isEmpty() && !conv2DData.biasMemDesc.is_zero();
@@ -418,34 +520,53 @@ std::pair<Tensor, Tensor> OneDnnAutogradExtension::conv2dBackwardFilterBias(
     gradBias = Tensor(bias.shape(), bias.type());
   }
 
-  // Weight backward descriptor
-  std::shared_ptr<convolution_backward_weights::desc> bwdWeightDesc;
-  if (computeBiasGrad) {
-    bwdWeightDesc = std::make_shared<convolution_backward_weights::desc>(
-        algorithm::convolution_direct,
-        conv2DData.inputMemDesc,
-        conv2DData.weightMemDesc,
-        conv2DData.biasMemDesc,
-        conv2DData.outputMemDesc,
-        conv2DData.strideDims,
-        conv2DData.dilationDims,
-        conv2DData.paddingDims,
-        conv2DData.paddingDims);
-  } else {
-    bwdWeightDesc = std::make_shared<convolution_backward_weights::desc>(
-        algorithm::convolution_direct,
-        conv2DData.inputMemDesc,
-        conv2DData.weightMemDesc,
-        conv2DData.outputMemDesc,
-        conv2DData.strideDims,
-        conv2DData.dilationDims,
-        conv2DData.paddingDims,
-        conv2DData.paddingDims);
-  }
-  // Weight backward primitive descriptor
-  auto bwdWeightPrimDesc =
-      std::make_shared<convolution_backward_weights::primitive_desc>(
-          *bwdWeightDesc, dnnlEngineBwd, conv2DData.fwdPrimDesc);
+  static detail::DnnlCache<OneDnnConv2DBackwardWeights> bwdWeightsCache;
+  auto conv2DBackwardWeights = bwdWeightsCache.get(
+      conv2DKey(
+          input.type(),
+          input.shape(),
+          weights.shape(),
+          computeBiasGrad,
+          sx,
+          sy,
+          px,
+          py,
+          dx,
+          dy,
+          groups),
+      [&]() {
+        // Weight backward descriptor
+        std::shared_ptr<convolution_backward_weights::desc> bwdWeightDesc;
+        if (computeBiasGrad) {
+          bwdWeightDesc = std::make_shared<convolution_backward_weights::desc>(
+              algorithm::convolution_direct,
+              conv2DData.inputMemDesc,
+              conv2DData.weightMemDesc,
+              conv2DData.biasMemDesc,
+              conv2DData.outputMemDesc,
+              conv2DData.strideDims,
+              conv2DData.dilationDims,
+              conv2DData.paddingDims,
+              conv2DData.paddingDims);
+        } else {
+          bwdWeightDesc = std::make_shared<convolution_backward_weights::desc>(
+              algorithm::convolution_direct,
+              conv2DData.inputMemDesc,
+              conv2DData.weightMemDesc,
+              conv2DData.outputMemDesc,
+              conv2DData.strideDims,
+              conv2DData.dilationDims,
+              conv2DData.paddingDims,
+              conv2DData.paddingDims);
+        }
+        // Weight backward primitive descriptor
+        auto primDesc = convolution_backward_weights::primitive_desc(
+            *bwdWeightDesc, dnnlEngineBwd, conv2DData.fwdPrimDesc);
+        auto primitive = convolution_backward_weights(primDesc);
+        return OneDnnConv2DBackwardWeights{
+            std::move(primDesc), std::move(primitive)};
+      });
+  const auto* bwdWeightPrimDesc = &conv2DBackwardWeights->primDesc;
 
   // Create memory
   const detail::DnnlMemoryWrapper inputRawMemInitBwd(
@@ -478,8 +599,7 @@ std::pair<Tensor, Tensor> OneDnnAutogradExtension::conv2dBackwardFilterBias(
     gradWeightsMemory = memory(gradWeightsDesc, dnnlEngineBwd);
   }
 
-  // Create the convolution backward weight
-  std::shared_ptr<convolution_backward_weights> bwdWeights;
+  // Run the convolution backward weight
   std::unordered_map<int, dnnl::memory> bwdConvWeightsArgs = {
       {DNNL_ARG_SRC, inputMemoryBackwards},
       {DNNL_ARG_DIFF_WEIGHTS, gradWeightsMemory},
@@ -488,20 +608,16 @@ std::pair<Tensor, Tensor> OneDnnAutogradExtension::conv2dBackwardFilterBias(
   if (computeBiasGrad) {
     const detail::DnnlMemoryWrapper gradBiasMem(
         gradBias, conv2DData.biasDims, formatBias);
-    bwdWeights =
-        std::make_shared<convolution_backward_weights>(*bwdWeightPrimDesc);
     bwdConvWeightsArgs[DNNL_ARG_DIFF_BIAS] = gradBiasMem.getMemory();
-  } else {
-    bwdWeights =
-        std::make_shared<convolution_backward_weights>(*bwdWeightPrimDesc);
   }
-  networkBackwards.push_back(*bwdWeights);
+  networkBackwards.push_back(conv2DBackwardWeights->primitive);
   bwdWeightsArgs.push_back(bwdConvWeightsArgs);
 
   // Reorder weight gradients if necessary
   if (gradWeightsMemory != gradWeightsMemInit.getMemory()) {
-    networkBackwards.push_back(
-        dnnl::reorder(gradWeightsMemory, gradWeightsMemInit.getMemory()));
+    networkBackwards.push_back(detail::dnnlReorder(
+        gradWeightsMemory.get_desc(),
+        gradWeightsMemInit.getMemory().get_desc()));
     bwdWeightsArgs.push_back(
         {{DNNL_ARG_FROM, gradWeightsMemory},
          {DNNL_ARG_TO, gradWeightsMemInit.getMemory()}});
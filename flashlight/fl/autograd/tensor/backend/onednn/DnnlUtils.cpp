@@ -7,6 +7,8 @@
 
 #include "flashlight/fl/autograd/tensor/backend/onednn/DnnlUtils.h"
 
+#include <cstdint>
+#include <sstream>
 #include <stdexcept>
 #include <utility>
 
@@ -70,7 +72,18 @@ dnnl::memory::dims convertShapeToDnnlDims(const Shape& shape) {
 DnnlMemoryWrapper::DnnlMemoryWrapper(
     const Tensor& tensor,
     dnnl::memory::dims dims,
-    dnnl::memory::format_tag format) {
+    dnnl::memory::format_tag format)
+    : DnnlMemoryWrapper(
+          tensor,
+          std::move(dims),
+          format,
+          detail::dnnlMapToType(tensor.type())) {}
+
+DnnlMemoryWrapper::DnnlMemoryWrapper(
+    const Tensor& tensor,
+    dnnl::memory::dims dims,
+    dnnl::memory::format_tag format,
+    dnnl::memory::data_type type) {
 #if FL_BACKEND_OPENCL
   fl::ocl::DevicePtrOpenCl _devicePtr(tensor);
   cl_mem* buffer = _devicePtr.getAsClMem();
@@ -79,8 +92,7 @@ DnnlMemoryWrapper::DnnlMemoryWrapper(
   devicePtr_ = fl::DevicePtr(tensor);
   void* buffer = devicePtr_.get();
 #endif
-  descriptor_ =
-      dnnl::memory::desc({dims}, detail::dnnlMapToType(tensor.type()), format);
+  descriptor_ = dnnl::memory::desc({dims}, type, format);
   memory_ = dnnl::memory(
       descriptor_, detail::DnnlEngine::getInstance().getEngine(), buffer);
 }
@@ -110,12 +122,62 @@ dnnl::memory dnnlAlignOrdering(
     // use the ordering requested by the descriptor
     memoryOut =
         dnnl::memory(desc, detail::DnnlEngine::getInstance().getEngine());
-    net.push_back(dnnl::reorder(memory, memoryOut));
+    net.push_back(dnnlReorder(memory.get_desc(), desc));
     netArgs.push_back({{DNNL_ARG_FROM, memory}, {DNNL_ARG_TO, memoryOut}});
   }
   return memoryOut;
 }
 
+std::string dnnlTensorDataKey(const Tensor& tensor) {
+  const auto version = tensor.dataVersion();
+  if (!version || tensor.isEmpty()) {
+    return "";
+  }
+  std::ostringstream ss;
+  ss << *version << ";" << tensor.shape() << ";" << tensor.type();
+  return ss.str();
+}
+
+std::string dnnlTensorSourceKey(const Tensor& tensor) {
+  return std::to_string(reinterpret_cast<std::uintptr_t>(&tensor));
+}
+
+std::string dnnlDescKey(const dnnl::memory::desc& desc) {
+  return std::string(
+      reinterpret_cast<const char*>(&desc.data), sizeof(desc.data));
+}
+
+dnnl::reorder dnnlReorder(
+    const dnnl::memory::desc& from,
+    const dnnl::memory::desc& to) {
+  static DnnlCache<dnnl::reorder> cache;
+  return *cache.get(dnnlDescKey(from) + dnnlDescKey(to), [&]() {
+    auto& engine = DnnlEngine::getInstance().getEngine();
+    return dnnl::reorder(
+        dnnl::reorder::primitive_desc(engine, from, engine, to));
+  });
+}
+
+dnnl::memory dnnlCachedReorder(
+    const Tensor& source,
+    const dnnl::memory& memory,
+    const dnnl::memory::desc& desc) {
+  if (memory.get_desc() == desc) {
+    return memory;
+  }
+  static DnnlTensorCache<dnnl::memory> cache;
+  const auto key = dnnlDescKey(memory.get_desc()) + dnnlDescKey(desc);
+  return *cache.get(source, key, [&]() {
+    auto reordered = dnnl::memory(desc, DnnlEngine::getInstance().getEngine());
+    std::vector<dnnl::primitive> network = {
+        dnnlReorder(memory.get_desc(), desc)};
+    std::vector<std::unordered_map<int, dnnl::memory>> args = {
+        {{DNNL_ARG_FROM, memory}, {DNNL_ARG_TO, reordered}}};
+    executeNetwork(network, args);
+    return reordered;
+  });
+}
+
 void executeNetwork(
     std::vector<dnnl::primitive>& net,
     std::vector<std::unordered_map<int, dnnl::memory>>& netArgs) {
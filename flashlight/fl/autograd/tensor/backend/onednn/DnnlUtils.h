@@ -8,20 +8,31 @@
 #pragma once
 
 #include <array>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
 
 #include <dnnl.hpp>
 
 #include "flashlight/fl/common/Defines.h"
 #include "flashlight/fl/common/DevicePtr.h"
 #include "flashlight/fl/tensor/Shape.h"
+#include "flashlight/fl/tensor/TensorBase.h"
 #include "flashlight/fl/tensor/Types.h"
 
 namespace fl {
-
-class Tensor;
-
 namespace detail {
 
+// Number of primitives (and primitive descriptors) cached per op
+constexpr size_t kDnnlPrimitiveCacheCapacity = 1024;
+// Number of tensors whose derived data, e.g. reordered weights, is cached per
+// op. Entries don't keep their source tensor alive, and are replaced once its
+// data changes
+constexpr size_t kDnnlTensorCacheCapacity = 256;
+
 /**
  * A singleton class that contains a static instance of a dnnl::stream.
  */
@@ -77,6 +88,15 @@ class DnnlMemoryWrapper {
       const Tensor& tensor,
       dnnl::memory::dims dims,
       dnnl::memory::format_tag format);
+  /**
+   * Views the data of `tensor` as `type`, which must be of the same size as
+   * its elements, e.g. s8 values held in a u8 tensor.
+   */
+  DnnlMemoryWrapper(
+      const Tensor& tensor,
+      dnnl::memory::dims dims,
+      dnnl::memory::format_tag format,
+      dnnl::memory::data_type type);
   DnnlMemoryWrapper() = default;
 
   DnnlMemoryWrapper& operator=(DnnlMemoryWrapper&& other);
@@ -126,6 +146,176 @@ void executeNetwork(
  */
 dnnl::algorithm dnnlMapToPoolingMode(const PoolingMode mode);
 
+/**
+ * A thread-safe cache of oneDNN objects such as primitive descriptors and
+ * primitives, keyed by the shapes and attributes of an op, which evicts the
+ * least recently used entries. Creating primitives is expensive compared to
+ * running them on small inputs, so ops create them once per signature.
+ */
+template <typename T>
+class DnnlCache {
+ public:
+  explicit DnnlCache(size_t capacity = kDnnlPrimitiveCacheCapacity)
+      : capacity_(capacity) {}
+
+  /**
+   * Returns the entry for `key`, creating it with `create()` if it isn't
+   * cached.
+   */
+  template <typename F>
+  std::shared_ptr<const T> get(const std::string& key, F&& create) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return it->second->second;
+    }
+    auto value = std::make_shared<const T>(create());
+    entries_.emplace_front(key, value);
+    index_[key] = entries_.begin();
+    if (entries_.size() > capacity_) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+    return value;
+  }
+
+  /**
+   * Returns the entry for `key`, creating it with `create()` if it isn't
+   * cached or replacing it if `isValid(entry)` is false, e.g. because the data
+   * it was derived from changed.
+   */
+  template <typename P, typename F>
+  std::shared_ptr<const T>
+  get(const std::string& key, P&& isValid, F&& create) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      entries_.splice(entries_.begin(), entries_, it->second);
+      auto& value = it->second->second;
+      if (!isValid(*value)) {
+        value = std::make_shared<const T>(create());
+      }
+      return value;
+    }
+    auto value = std::make_shared<const T>(create());
+    entries_.emplace_front(key, value);
+    index_[key] = entries_.begin();
+    if (entries_.size() > capacity_) {
+      index_.erase(entries_.back().first);
+      entries_.pop_back();
+    }
+    return value;
+  }
+
+  void clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    index_.clear();
+    entries_.clear();
+  }
+
+  size_t size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+  }
+
+ private:
+  using Entry = std::pair<std::string, std::shared_ptr<const T>>;
+
+  const size_t capacity_;
+  mutable std::mutex mutex_;
+  // Most recently used first
+  std::list<Entry> entries_;
+  std::unordered_map<std::string, typename std::list<Entry>::iterator> index_;
+};
+
+/**
+ * Returns a key identifying the data of a tensor, or an empty string if it
+ * can't be identified. See `Tensor::dataVersion`.
+ */
+std::string dnnlTensorDataKey(const Tensor& tensor);
+
+/**
+ * Returns a key identifying a tensor rather than its data: it doesn't change
+ * when the tensor is assigned new data, e.g. the weights of a Variable updated
+ * by an optimizer.
+ */
+std::string dnnlTensorSourceKey(const Tensor& tensor);
+
+/**
+ * Caches values derived from the data of a tensor, such as weights in the
+ * layout preferred by a primitive, so that they're only recomputed when the
+ * data of the tensor changes. There is one entry per tensor and derivation,
+ * which is replaced when the data changes rather than adding another.
+ * Values must not share the buffer of their source tensor, so that it's freed
+ * with the source.
+ */
+template <typename T>
+class DnnlTensorCache {
+ public:
+  explicit DnnlTensorCache(size_t capacity = kDnnlTensorCacheCapacity)
+      : cache_(capacity) {}
+
+  /**
+   * Returns the value derived from `source` by `create()`. `key` identifies
+   * the derivation, e.g. the layout of reordered weights.
+   */
+  template <typename F>
+  std::shared_ptr<const T> get(
+      const Tensor& source,
+      const std::string& key,
+      F&& create) {
+    auto dataKey = dnnlTensorDataKey(source);
+    if (dataKey.empty()) {
+      return std::make_shared<const T>(create());
+    }
+    auto entry = cache_.get(
+        key + "@" + dnnlTensorSourceKey(source),
+        [&dataKey](const Entry& cached) { return cached.dataKey == dataKey; },
+        [&]() { return Entry{dataKey, std::make_shared<const T>(create())}; });
+    return entry->value;
+  }
+
+  void clear() {
+    cache_.clear();
+  }
+
+  size_t size() const {
+    return cache_.size();
+  }
+
+ private:
+  struct Entry {
+    /// Identifies the data the value was derived from
+    std::string dataKey;
+    std::shared_ptr<const T> value;
+  };
+
+  DnnlCache<Entry> cache_;
+};
+
+/**
+ * Returns a key identifying a memory descriptor.
+ */
+std::string dnnlDescKey(const dnnl::memory::desc& desc);
+
+/**
+ * Returns a (cached) reorder primitive between memory descriptors.
+ */
+dnnl::reorder dnnlReorder(
+    const dnnl::memory::desc& from,
+    const dnnl::memory::desc& to);
+
+/**
+ * Returns `memory`, which holds the data of `source`, reordered to `desc`.
+ * Reordered memory is cached until the data of `source` changes, e.g. for the
+ * weights of a model running inference.
+ */
+dnnl::memory dnnlCachedReorder(
+    const Tensor& source,
+    const dnnl::memory& memory,
+    const dnnl::memory::desc& desc);
+
 /**
  * Maps an ArrayFire array datatype into the corresponding DNNL datatype.
  *
@@ -136,6 +326,10 @@ inline dnnl::memory::data_type dnnlMapToType(const fl::dtype t) {
     return dnnl::memory::data_type::f16;
   } else if (t == fl::dtype::f32) {
     return dnnl::memory::data_type::f32;
+  } else if (t == fl::dtype::u8) {
+    return dnnl::memory::data_type::u8;
+  } else if (t == fl::dtype::s32) {
+    return dnnl::memory::data_type::s32;
   } else if (t == fl::dtype::f64) {
     throw std::invalid_argument("float64 is not supported by DNNL");
   } else {
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/autograd/tensor/backend/onednn/OneDnnAutogradExtension.h"
+
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include <dnnl.hpp>
+
+#include "flashlight/fl/autograd/tensor/backend/onednn/DnnlUtils.h"
+#include "flashlight/fl/tensor/Index.h"
+
+namespace fl {
+
+namespace {
+
+// Inputs are viewed as row-major [slices, normalized elements]: oneDNN
+// normalizes over the innermost dimension, which is contiguous
+constexpr auto formatData = dnnl::memory::format_tag::ab;
+constexpr auto formatX = dnnl::memory::format_tag::x;
+constexpr auto format2d = dnnl::memory::format_tag::nc;
+
+struct OneDnnLayerNormPayload : detail::AutogradPayloadData {
+  dnnl::layer_normalization_forward::primitive_desc fwdPrimDesc;
+  Tensor weightsDnnl; // combined weight and bias
+};
+
+Dim getNormSize(const Shape& inputShape, const std::vector<int>& axes) {
+  Dim normSize = 1;
+  for (auto ax : axes) {
+    normSize *= ax < inputShape.ndim() ? inputShape.dim(ax) : 1;
+  }
+  return normSize;
+}
+
+} // namespace
+
+std::optional<Tensor> OneDnnAutogradExtension::layerNorm(
+    Tensor& saveMean,
+    Tensor& saveVar,
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    const std::vector<int>& axes,
+    const bool train,
+    const double epsilon,
+    std::shared_ptr<detail::AutogradPayload> autogradPayload) {
+  if (input.type() != fl::dtype::f32 || input.isEmpty() ||
+      (!weight.isEmpty() && weight.type() != fl::dtype::f32) ||
+      (!bias.isEmpty() && bias.type() != fl::dtype::f32)) {
+    return std::nullopt;
+  }
+
+  auto payload = std::make_shared<OneDnnLayerNormPayload>();
+  if (train && autogradPayload) {
+    autogradPayload->data = payload;
+  }
+
+  const Dim normSize = getNormSize(input.shape(), axes);
+  const Dim numSlices = input.elements() / normSize;
+  auto output = Tensor(input.shape(), input.type());
+  auto& dnnlEngine = detail::DnnlEngine::getInstance().getEngine();
+
+  // DNNL only accepts weight and bias as a combined input.
+  auto weightNonempty = weight.isEmpty()
+      ? fl::full({normSize}, 1., fl::dtype::f32)
+      : fl::reshape(weight, {normSize});
+  auto biasNonempty = bias.isEmpty() ? fl::full({normSize}, 0., fl::dtype::f32)
+                                     : fl::reshape(bias, {normSize});
+  payload->weightsDnnl = fl::concatenate(0, weightNonempty, biasNonempty);
+
+  const auto dataDims = detail::convertToDnnlDims({numSlices, normSize});
+  const detail::DnnlMemoryWrapper inputMemory(input, dataDims, formatData);
+  const detail::DnnlMemoryWrapper outputMemory(output, dataDims, formatData);
+  const detail::DnnlMemoryWrapper weightsMemory(
+      payload->weightsDnnl,
+      detail::convertToDnnlDims({2, normSize}),
+      format2d);
+
+  // Statistics are only outputs when training
+  auto kind = train ? dnnl::prop_kind::forward_training
+                    : dnnl::prop_kind::forward_inference;
+  auto fwdDesc = dnnl::layer_normalization_forward::desc(
+      kind,
+      inputMemory.getDescriptor(),
+      epsilon,
+      dnnl::normalization_flags::use_scale_shift);
+  payload->fwdPrimDesc =
+      dnnl::layer_normalization_forward::primitive_desc(fwdDesc, dnnlEngine);
+  std::unordered_map<int, dnnl::memory> lnFwdArgs = {
+      {DNNL_ARG_SRC, inputMemory.getMemory()},
+      {DNNL_ARG_DST, outputMemory.getMemory()},
+      {DNNL_ARG_SCALE_SHIFT, weightsMemory.getMemory()}};
+
+  detail::DnnlMemoryWrapper meanMemory;
+  detail::DnnlMemoryWrapper varMemory;
+  if (train) {
+    saveMean = Tensor({numSlices}, input.type());
+    saveVar = Tensor({numSlices}, input.type());
+    meanMemory = detail::DnnlMemoryWrapper(saveMean, {numSlices}, formatX);
+    varMemory = detail::DnnlMemoryWrapper(saveVar, {numSlices}, formatX);
+    lnFwdArgs[DNNL_ARG_MEAN] = meanMemory.getMemory();
+    lnFwdArgs[DNNL_ARG_VARIANCE] = varMemory.getMemory();
+  }
+
+  // Execute
+  std::vector<dnnl::primitive> network = {
+      dnnl::layer_normalization_forward(payload->fwdPrimDesc)};
+  std::vector<std::unordered_map<int, dnnl::memory>> fwdArgs = {lnFwdArgs};
+  detail::executeNetwork(network, fwdArgs);
+
+  return output;
+}
+
+std::tuple<Tensor, Tensor, Tensor> OneDnnAutogradExtension::layerNormBackward(
+    const Tensor& gradOutput,
+    const Tensor& saveMean,
+    const Tensor& saveVar,
+    const Tensor& input,
+    const Tensor& /* weight */,
+    const std::vector<int>& axes,
+    const double epsilon,
+    std::shared_ptr<detail::AutogradPayload> autogradPayload) {
+  if (!autogradPayload || !autogradPayload->data) {
+    throw std::invalid_argument(
+        "OneDnnAutogradExtension::layerNormBackward given null "
+        "detail::AutogradPayload");
+  }
+  auto payload =
+      std::static_pointer_cast<OneDnnLayerNormPayload>(autogradPayload->data);
+  auto& dnnlEngine = detail::DnnlEngine::getInstance().getEngine();
+
+  const Dim normSize = getNormSize(input.shape(), axes);
+  const Dim numSlices = input.elements() / normSize;
+  const auto dataDims = detail::convertToDnnlDims({numSlices, normSize});
+
+  auto gradOutputTyped = gradOutput.astype(input.type());
+  auto gradInput = Tensor(input.shape(), input.type());
+  auto gradWeightsDnnl =
+      Tensor(payload->weightsDnnl.shape(), payload->weightsDnnl.type());
+
+  const detail::DnnlMemoryWrapper inputMemory(input, dataDims, formatData);
+  const detail::DnnlMemoryWrapper gradOutputMemory(
+      gradOutputTyped, dataDims, formatData);
+  const detail::DnnlMemoryWrapper gradInputMemory(
+      gradInput, dataDims, formatData);
+  const detail::DnnlMemoryWrapper meanMemory(saveMean, {numSlices}, formatX);
+  const detail::DnnlMemoryWrapper varMemory(saveVar, {numSlices}, formatX);
+  const auto weightsDims = detail::convertToDnnlDims({2, normSize});
+  const detail::DnnlMemoryWrapper weightsMemory(
+      payload->weightsDnnl, weightsDims, format2d);
+  const detail::DnnlMemoryWrapper gradWeightsMemory(
+      gradWeightsDnnl, weightsDims, format2d);
+
+  // Primitives and descriptors
+  auto bwdDesc = dnnl::layer_normalization_backward::desc(
+      dnnl::prop_kind::backward,
+      gradOutputMemory.getDescriptor(),
+      inputMemory.getDescriptor(),
+      epsilon,
+      dnnl::normalization_flags::use_scale_shift);
+  auto bwdPrimDesc = dnnl::layer_normalization_backward::primitive_desc(
+      bwdDesc, dnnlEngine, payload->fwdPrimDesc);
+
+  // Execute
+  std::vector<dnnl::primitive> networkBackwards = {
+      dnnl::layer_normalization_backward(bwdPrimDesc)};
+  std::vector<std::unordered_map<int, dnnl::memory>> bwdArgs = {
+      {{DNNL_ARG_SRC, inputMemory.getMemory()},
+       {DNNL_ARG_MEAN, meanMemory.getMemory()},
+       {DNNL_ARG_VARIANCE, varMemory.getMemory()},
+       {DNNL_ARG_SCALE_SHIFT, weightsMemory.getMemory()},
+       {DNNL_ARG_DIFF_DST, gradOutputMemory.getMemory()},
+       {DNNL_ARG_DIFF_SRC, gradInputMemory.getMemory()},
+       {DNNL_ARG_DIFF_SCALE_SHIFT, gradWeightsMemory.getMemory()}}};
+  detail::executeNetwork(networkBackwards, bwdArgs);
+
+  return {
+      gradInput,
+      gradWeightsDnnl(fl::range(0, normSize)), // weight grad
+      gradWeightsDnnl(fl::range(normSize, 2 * normSize)) // bias grad
+  };
+}
+
+} // namespace fl
@@ -7,6 +7,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include "flashlight/fl/autograd/tensor/AutogradExtension.h"
 
 namespace fl {
@@ -68,6 +70,42 @@ class OneDnnAutogradExtension : public AutogradExtension {
       const float dropout,
       std::shared_ptr<detail::AutogradPayload> payload) override;
 
+  std::optional<Tensor> layerNorm(
+      Tensor& saveMean,
+      Tensor& saveVar,
+      const Tensor& input,
+      const Tensor& weight,
+      const Tensor& bias,
+      const std::vector<int>& axes,
+      const bool train,
+      const double epsilon,
+      std::shared_ptr<detail::AutogradPayload> payload) override;
+
+  std::optional<Tensor> softmax(
+      const Tensor& input,
+      const int axis,
+      const bool logSoftmax,
+      std::shared_ptr<detail::AutogradPayload> payload) override;
+
+  std::optional<Tensor> quantizedLinear(
+      const Tensor& input,
+      const Tensor& weight,
+      const Tensor& weightScales,
+      const float inputScale) override;
+
+  std::optional<Tensor> quantizedConv2d(
+      const Tensor& input,
+      const Tensor& weights,
+      const Tensor& weightScales,
+      const float inputScale,
+      const int sx,
+      const int sy,
+      const int px,
+      const int py,
+      const int dx,
+      const int dy,
+      const int groups) override;
+
   /**************************** Backward ****************************/
   // ]----- Convolution
   Tensor conv2dBackwardData(
@@ -140,6 +178,25 @@ class OneDnnAutogradExtension : public AutogradExtension {
       const bool bidirectional,
       const float dropProb,
       std::shared_ptr<detail::AutogradPayload> payload) override;
+
+  // ]----- layerNorm
+  std::tuple<Tensor, Tensor, Tensor> layerNormBackward(
+      const Tensor& gradOutput,
+      const Tensor& saveMean,
+      const Tensor& saveVar,
+      const Tensor& input,
+      const Tensor& weight,
+      const std::vector<int>& axes,
+      const double epsilon,
+      std::shared_ptr<detail::AutogradPayload> payload) override;
+
+  // ]----- softmax
+  Tensor softmaxBackward(
+      const Tensor& gradOutput,
+      const Tensor& output,
+      const int axis,
+      const bool logSoftmax,
+      std::shared_ptr<detail::AutogradPayload> payload) override;
 };
 
 } // namespace fl
@@ -7,6 +7,8 @@
 
 #include "flashlight/fl/autograd/tensor/backend/onednn/OneDnnAutogradExtension.h"
 
+#include <sstream>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -66,6 +68,36 @@ DimsData getDimsData(
   return d;
 }
 
+// Primitives are created once per signature and cached
+
+struct OneDnnPool2DForward {
+  pooling_forward::primitive_desc primDesc;
+  pooling_forward primitive;
+};
+
+struct OneDnnPool2DBackward {
+  pooling_backward::primitive_desc primDesc;
+  pooling_backward primitive;
+};
+
+std::string pool2DKey(
+    fl::dtype type,
+    const Shape& input,
+    const int wx,
+    const int wy,
+    const int sx,
+    const int sy,
+    const int px,
+    const int py,
+    const PoolingMode mode,
+    const bool train) {
+  std::ostringstream ss;
+  ss << type << ";" << input << ";" << wx << "," << wy << ";" << sx << ","
+     << sy << ";" << px << "," << py << ";" << static_cast<int>(mode) << ";"
+     << train;
+  return ss.str();
+}
+
 } // namespace
 
 struct OneDnnPool2DPayload : detail::AutogradPayloadData {
@@ -106,10 +138,6 @@ Tensor OneDnnAutogradExtension::pool2d(
   auto& d = payload->dimsData;
   auto dataType = detail::dnnlMapToType(input.type());
 
-  // Memory desc
-  auto inputMD = memory::desc({d.inputDims}, dataType, formatNCHW);
-  auto outputMD = memory::desc({d.outputDims}, dataType, formatAny);
-
   // Memory
   auto& dnnlEngine = detail::DnnlEngine::getInstance().getEngine();
   const detail::DnnlMemoryWrapper inputMemInit(
@@ -117,22 +145,35 @@ Tensor OneDnnAutogradExtension::pool2d(
   const detail::DnnlMemoryWrapper outputMemInit(
       output, {d.outputDims}, formatNCHW);
 
-  // Choose a mode based on whether gradients are needed
-  auto forwardMode = train ? prop_kind::forward : prop_kind::forward_inference;
-
-  // Descriptors
-  auto poolingMode = detail::dnnlMapToPoolingMode(mode);
-  auto desc = pooling_forward::desc(
-      forwardMode,
-      poolingMode,
-      inputMD,
-      outputMD,
-      d.strideDims,
-      d.windowDims,
-      d.paddingDims,
-      d.paddingDims);
-  payload->poolingFwdPrimDesc =
-      pooling_forward::primitive_desc(desc, dnnlEngine);
+  static detail::DnnlCache<OneDnnPool2DForward> cache;
+  auto pool2DForward = cache.get(
+      pool2DKey(
+          input.type(), input.shape(), wx, wy, sx, sy, px, py, mode, train),
+      [&]() {
+        // Memory desc
+        auto inputMD = memory::desc({d.inputDims}, dataType, formatNCHW);
+        auto outputMD = memory::desc({d.outputDims}, dataType, formatAny);
+
+        // Choose a mode based on whether gradients are needed
+        auto forwardMode =
+            train ? prop_kind::forward : prop_kind::forward_inference;
+
+        // Descriptors
+        auto poolingMode = detail::dnnlMapToPoolingMode(mode);
+        auto desc = pooling_forward::desc(
+            forwardMode,
+            poolingMode,
+            inputMD,
+            outputMD,
+            d.strideDims,
+            d.windowDims,
+            d.paddingDims,
+            d.paddingDims);
+        auto primDesc = pooling_forward::primitive_desc(desc, dnnlEngine);
+        auto primitive = pooling_forward(primDesc);
+        return OneDnnPool2DForward{std::move(primDesc), std::move(primitive)};
+      });
+  payload->poolingFwdPrimDesc = pool2DForward->primDesc;
   auto& primDesc = payload->poolingFwdPrimDesc;
 
   // Network
@@ -148,24 +189,21 @@ Tensor OneDnnAutogradExtension::pool2d(
     payload->outputMemory = memory(outputDesc, dnnlEngine);
   }
   // Workspace and layer (only training mode requires a workspace)
-  std::shared_ptr<pooling_forward> pooling;
   std::unordered_map<int, dnnl::memory> fwdPoolingArgs;
   fwdPoolingArgs[DNNL_ARG_SRC] = inputMemory;
   fwdPoolingArgs[DNNL_ARG_DST] = payload->outputMemory;
   if (train) {
     payload->workspace = memory(primDesc.workspace_desc(), dnnlEngine);
-    pooling = std::make_shared<pooling_forward>(primDesc);
     fwdPoolingArgs[DNNL_ARG_WORKSPACE] = payload->workspace;
-  } else {
-    pooling = std::make_shared<pooling_forward>(primDesc);
   }
-  network.push_back(*pooling);
+  network.push_back(pool2DForward->primitive);
   fwdArgs.push_back(fwdPoolingArgs);
 
   // Add output reordering if needed
   if (payload->outputMemory != outputMemInit.getMemory()) {
-    network.push_back(
-        dnnl::reorder(payload->outputMemory, outputMemInit.getMemory()));
+    network.push_back(detail::dnnlReorder(
+        payload->outputMemory.get_desc(),
+        outputMemInit.getMemory().get_desc()));
     fwdArgs.push_back(
         {{DNNL_ARG_FROM, payload->outputMemory},
          {DNNL_ARG_TO, outputMemInit.getMemory()}});
@@ -198,8 +236,6 @@ Tensor OneDnnAutogradExtension::pool2dBackward(
   auto& dnnlEngineBwd = detail::DnnlEngine::getInstance().getEngine();
 
   DimsData& d = payload->dimsData;
-  auto poolingMode = detail::dnnlMapToPoolingMode(mode);
-  auto dataType = detail::dnnlMapToType(input.type());
 
   // Memory
   const detail::DnnlMemoryWrapper gradInputMemInit(
@@ -207,22 +243,39 @@ Tensor OneDnnAutogradExtension::pool2dBackward(
   const detail::DnnlMemoryWrapper gradOutputMemInit(
       gradOutput, {d.outputDims}, formatNCHW);
 
-  // Descriptors
-  // Memory descriptors from initialized memory must be used since
-  // pooling_backward descriptors require an ordering
-  auto gradInputMD = gradInputMemInit.getMemory().get_desc();
-  auto gradOutputMD = gradOutputMemInit.getMemory().get_desc();
-  auto bwdDesc = pooling_backward::desc(
-      poolingMode,
-      gradInputMD,
-      gradOutputMD,
-      d.strideDims,
-      d.windowDims,
-      d.paddingDims,
-      d.paddingDims);
-  // Pass forward descriptor as a hint
-  auto bwdPrimDesc = pooling_backward::primitive_desc(
-      bwdDesc, dnnlEngineBwd, payload->poolingFwdPrimDesc);
+  static detail::DnnlCache<OneDnnPool2DBackward> cache;
+  auto pool2DBackward = cache.get(
+      pool2DKey(
+          input.type(),
+          input.shape(),
+          wx,
+          wy,
+          sx,
+          sy,
+          px,
+          py,
+          mode,
+          /* train = */ true),
+      [&]() {
+        // Descriptors
+        // Memory descriptors from initialized memory must be used since
+        // pooling_backward descriptors require an ordering
+        auto gradInputMD = gradInputMemInit.getMemory().get_desc();
+        auto gradOutputMD = gradOutputMemInit.getMemory().get_desc();
+        auto bwdDesc = pooling_backward::desc(
+            detail::dnnlMapToPoolingMode(mode),
+            gradInputMD,
+            gradOutputMD,
+            d.strideDims,
+            d.windowDims,
+            d.paddingDims,
+            d.paddingDims);
+        // Pass forward descriptor as a hint
+        auto primDesc = pooling_backward::primitive_desc(
+            bwdDesc, dnnlEngineBwd, payload->poolingFwdPrimDesc);
+        auto primitive = pooling_backward(primDesc);
+        return OneDnnPool2DBackward{std::move(primDesc), std::move(primitive)};
+      });
 
   std::vector<primitive> networkBackward;
   std::vector<std::unordered_map<int, dnnl::memory>> bwdArgs;
@@ -233,13 +286,12 @@ Tensor OneDnnAutogradExtension::pool2dBackward(
       gradOutputMemInit.getMemory(),
       payload->outputMemory.get_desc());
 
-  auto poolBwd = pooling_backward(bwdPrimDesc);
   std::unordered_map<int, dnnl::memory> bwdPoolingArgs = {
       {DNNL_ARG_DIFF_SRC, gradInputMemInit.getMemory()},
       {DNNL_ARG_DIFF_DST, gradOutputMemory},
       {DNNL_ARG_WORKSPACE, payload->workspace}};
   bwdArgs.push_back(bwdPoolingArgs);
-  networkBackward.push_back(poolBwd);
+  networkBackward.push_back(pool2DBackward->primitive);
 
   detail::executeNetwork(networkBackward, bwdArgs);
 
@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/autograd/tensor/backend/onednn/OneDnnAutogradExtension.h"
+
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <dnnl.hpp>
+
+#include "flashlight/fl/autograd/tensor/backend/onednn/DnnlUtils.h"
+
+using namespace dnnl;
+
+namespace fl {
+
+namespace {
+
+// Input, output: WHCN; weights: WHIO
+constexpr size_t kWIdx = 0;
+constexpr size_t kHIdx = 1;
+constexpr size_t kIOChannelSizeIdx = 2;
+constexpr size_t kIOBatchSizeIdx = 3;
+constexpr size_t kWeightOutputChannelSizeIdx = 3;
+
+constexpr auto formatAny = memory::format_tag::any;
+constexpr auto format2d = memory::format_tag::ab;
+constexpr auto formatNCHW = memory::format_tag::nchw;
+
+// Weights are quantized symmetrically to [-127, 127] and stored as u8 around
+// a zero point of 128 (see fl::quantizePerChannel); inputs use the same range
+constexpr double kQuantizedMax = 127;
+constexpr int kWeightZeroPoint = 128;
+
+// There is no s8 tensor type: s8 values are held in u8 tensors with the same
+// bits, which oneDNN reads as s8. `values` must be integers in [-128, 127].
+Tensor toS8Bits(const Tensor& values) {
+  return fl::where(values < 0, values + 256, values).astype(fl::dtype::u8);
+}
+
+Tensor quantizeInput(const Tensor& input, const float scale) {
+  return toS8Bits(
+      fl::clip(fl::rint(input / scale), -kQuantizedMax, kQuantizedMax));
+}
+
+// Returns the s8 weights in the layout of a primitive, which are cached until
+// the data of `weights` changes since they're reused by every forward
+memory quantizedWeights(
+    const Tensor& weights,
+    const memory::dims& dims,
+    const memory::format_tag format,
+    const memory::desc& desc) {
+  static detail::DnnlTensorCache<memory> cache;
+  return *cache.get(weights, detail::dnnlDescKey(desc), [&]() {
+    auto bits = toS8Bits(weights.astype(fl::dtype::s16) - kWeightZeroPoint);
+    const detail::DnnlMemoryWrapper weightsMemory(
+        bits, dims, format, memory::data_type::s8);
+    auto reordered =
+        memory(desc, detail::DnnlEngine::getInstance().getEngine());
+    std::vector<primitive> network = {
+        detail::dnnlReorder(weightsMemory.getDescriptor(), desc)};
+    std::vector<std::unordered_map<int, memory>> args = {
+        {{DNNL_ARG_FROM, weightsMemory.getMemory()},
+         {DNNL_ARG_TO, reordered}}};
+    detail::executeNetwork(network, args);
+    return reordered;
+  });
+}
+
+// Products are accumulated in s32, then scaled by the input and weight scales
+// of their output channel. Scales aren't attributes of the primitives so that
+// these are shared by layers of the same shape.
+Tensor dequantizeOutput(
+    const Tensor& output,
+    const Tensor& scales,
+    const float inputScale,
+    const fl::dtype type) {
+  return (output.astype(fl::dtype::f32) * (scales * inputScale)).astype(type);
+}
+
+// Qualified, as fl::matmul hides dnnl::matmul
+struct OneDnnQuantizedMatmul {
+  dnnl::matmul::primitive_desc primDesc;
+  dnnl::matmul primitive;
+};
+
+std::shared_ptr<const OneDnnQuantizedMatmul> getQuantizedMatmul(
+    const Dim batchSize,
+    const Dim inputSize,
+    const Dim outputSize) {
+  static detail::DnnlCache<OneDnnQuantizedMatmul> cache;
+  std::ostringstream key;
+  key << batchSize << ";" << inputSize << ";" << outputSize;
+  return cache.get(key.str(), [&]() {
+    auto inputDesc = memory::desc(
+        detail::convertToDnnlDims({batchSize, inputSize}),
+        memory::data_type::s8,
+        format2d);
+    auto weightDesc = memory::desc(
+        detail::convertToDnnlDims({inputSize, outputSize}),
+        memory::data_type::s8,
+        formatAny);
+    auto outputDesc = memory::desc(
+        detail::convertToDnnlDims({batchSize, outputSize}),
+        memory::data_type::s32,
+        format2d);
+    auto primDesc = dnnl::matmul::primitive_desc(
+        dnnl::matmul::desc(inputDesc, weightDesc, outputDesc),
+        detail::DnnlEngine::getInstance().getEngine());
+    auto primitive = dnnl::matmul(primDesc);
+    return OneDnnQuantizedMatmul{std::move(primDesc), std::move(primitive)};
+  });
+}
+
+struct OneDnnQuantizedConv2D {
+  memory::dims inputDims;
+  memory::dims weightDims;
+  memory::dims outputDims;
+  convolution_forward::primitive_desc primDesc;
+  convolution_forward primitive;
+};
+
+std::shared_ptr<const OneDnnQuantizedConv2D> getQuantizedConv2D(
+    const Shape& inputShape,
+    const Shape& weightsShape,
+    const Shape& outputShape,
+    const int sx,
+    const int sy,
+    const int px,
+    const int py,
+    const int dx,
+    const int dy,
+    const int groups) {
+  static detail::DnnlCache<OneDnnQuantizedConv2D> cache;
+  std::ostringstream key;
+  key << inputShape << ";" << weightsShape << ";" << sx << "," << sy << ";"
+      << px << "," << py << ";" << dx << "," << dy << ";" << groups;
+  return cache.get(key.str(), [&]() {
+    OneDnnQuantizedConv2D out;
+    out.inputDims = detail::convertToDnnlDims(
+        {inputShape.dim(kIOBatchSizeIdx),
+         inputShape.dim(kIOChannelSizeIdx),
+         inputShape.dim(kHIdx),
+         inputShape.dim(kWIdx)});
+    if (groups == 1) {
+      out.weightDims = detail::convertToDnnlDims(
+          {weightsShape.dim(kWeightOutputChannelSizeIdx),
+           inputShape.dim(kIOChannelSizeIdx),
+           weightsShape.dim(kHIdx),
+           weightsShape.dim(kWIdx)});
+    } else {
+      out.weightDims = detail::convertToDnnlDims(
+          {groups,
+           weightsShape.dim(kWeightOutputChannelSizeIdx) / groups,
+           inputShape.dim(kIOChannelSizeIdx) / groups,
+           weightsShape.dim(kHIdx),
+           weightsShape.dim(kWIdx)});
+    }
+    out.outputDims = detail::convertToDnnlDims(
+        {outputShape.dim(kIOBatchSizeIdx),
+         outputShape.dim(kIOChannelSizeIdx),
+         outputShape.dim(kHIdx),
+         outputShape.dim(kWIdx)});
+    // NB: DNNL treats a dilation of 0 as a standard convolution
+    auto fwdDesc = convolution_forward::desc(
+        prop_kind::forward_inference,
+        algorithm::convolution_direct,
+        memory::desc(out.inputDims, memory::data_type::s8, formatAny),
+        memory::desc(out.weightDims, memory::data_type::s8, formatAny),
+        memory::desc(out.outputDims, memory::data_type::s32, formatAny),
+        {sy, sx},
+        {dy - 1, dx - 1},
+        {py, px},
+        {py, px});
+    out.primDesc = convolution_forward::primitive_desc(
+        fwdDesc, detail::DnnlEngine::getInstance().getEngine());
+    out.primitive = convolution_forward(out.primDesc);
+    return out;
+  });
+}
+
+bool isQuantizable(
+    const Tensor& input,
+    const Tensor& weights,
+    const Tensor& weightScales,
+    const float inputScale) {
+  return input.type() == fl::dtype::f32 && !input.isEmpty() &&
+      weights.type() == fl::dtype::u8 &&
+      weightScales.type() == fl::dtype::f32 && inputScale > 0;
+}
+
+} // namespace
+
+std::optional<Tensor> OneDnnAutogradExtension::quantizedLinear(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& weightScales,
+    const float inputScale) {
+  if (!isQuantizable(input, weight, weightScales, inputScale) ||
+      weight.ndim() != 2 || input.dim(0) != weight.dim(1)) {
+    return std::nullopt;
+  }
+  const Dim outputSize = weight.dim(0);
+  const Dim inputSize = weight.dim(1);
+  const Dim batchSize = input.elements() / inputSize;
+  auto matmulForward = getQuantizedMatmul(batchSize, inputSize, outputSize);
+
+  // Column-major [inputSize, batchSize] input and [outputSize, inputSize]
+  // weight viewed as row-major: output = input * weight
+  auto quantizedInput = quantizeInput(input, inputScale);
+  auto output = Tensor({outputSize, batchSize}, fl::dtype::s32);
+  const detail::DnnlMemoryWrapper inputMemory(
+      quantizedInput,
+      detail::convertToDnnlDims({batchSize, inputSize}),
+      format2d,
+      memory::data_type::s8);
+  const detail::DnnlMemoryWrapper outputMemory(
+      output, detail::convertToDnnlDims({batchSize, outputSize}), format2d);
+  auto weightMemory = quantizedWeights(
+      weight,
+      detail::convertToDnnlDims({inputSize, outputSize}),
+      format2d,
+      matmulForward->primDesc.weights_desc());
+
+  std::vector<primitive> network = {matmulForward->primitive};
+  std::vector<std::unordered_map<int, memory>> args = {
+      {{DNNL_ARG_SRC, inputMemory.getMemory()},
+       {DNNL_ARG_WEIGHTS, weightMemory},
+       {DNNL_ARG_DST, outputMemory.getMemory()}}};
+  detail::executeNetwork(network, args);
+
+  auto outputShape = input.shape();
+  outputShape[0] = outputSize;
+  return fl::reshape(
+      dequantizeOutput(output, weightScales, inputScale, input.type()),
+      outputShape);
+}
+
+std::optional<Tensor> OneDnnAutogradExtension::quantizedConv2d(
+    const Tensor& input,
+    const Tensor& weights,
+    const Tensor& weightScales,
+    const float inputScale,
+    const int sx,
+    const int sy,
+    const int px,
+    const int py,
+    const int dx,
+    const int dy,
+    const int groups) {
+  if (!isQuantizable(input, weights, weightScales, inputScale) ||
+      input.ndim() != 4 || weights.ndim() != 4) {
+    return std::nullopt;
+  }
+  auto output = Tensor(
+      {1 +
+           (input.dim(kWIdx) + (2 * px) - (1 + (weights.dim(kWIdx) - 1) * dx)) /
+               sx,
+       1 +
+           (input.dim(kHIdx) + (2 * py) - (1 + (weights.dim(kHIdx) - 1) * dy)) /
+               sy,
+       weights.dim(kWeightOutputChannelSizeIdx),
+       input.dim(kIOBatchSizeIdx)},
+      fl::dtype::s32);
+  auto convForward = getQuantizedConv2D(
+      input.shape(),
+      weights.shape(),
+      output.shape(),
+      sx,
+      sy,
+      px,
+      py,
+      dx,
+      dy,
+      groups);
+  const auto formatWeight =
+      (groups == 1) ? memory::format_tag::oihw : memory::format_tag::goihw;
+
+  // Column-major WHCN/WHIO tensors are row-major NCHW/OIHW
+  auto quantizedInput = quantizeInput(input, inputScale);
+  const detail::DnnlMemoryWrapper inputMemInit(
+      quantizedInput,
+      convForward->inputDims,
+      formatNCHW,
+      memory::data_type::s8);
+  const detail::DnnlMemoryWrapper outputMemInit(
+      output, convForward->outputDims, formatNCHW);
+
+  std::vector<primitive> network;
+  std::vector<std::unordered_map<int, memory>> args;
+  auto inputMemory = detail::dnnlAlignOrdering(
+      network,
+      args,
+      inputMemInit.getMemory(),
+      convForward->primDesc.src_desc());
+  auto weightsMemory = quantizedWeights(
+      weights,
+      convForward->weightDims,
+      formatWeight,
+      convForward->primDesc.weights_desc());
+  auto outputMemory = outputMemInit.getMemory();
+  const auto outputDesc = convForward->primDesc.dst_desc();
+  if (outputMemory.get_desc() != outputDesc) {
+    outputMemory =
+        memory(outputDesc, detail::DnnlEngine::getInstance().getEngine());
+  }
+
+  network.push_back(convForward->primitive);
+  args.push_back(
+      {{DNNL_ARG_SRC, inputMemory},
+       {DNNL_ARG_WEIGHTS, weightsMemory},
+       {DNNL_ARG_DST, outputMemory}});
+  if (outputMemory != outputMemInit.getMemory()) {
+    network.push_back(
+        detail::dnnlReorder(outputDesc, outputMemInit.getDescriptor()));
+    args.push_back(
+        {{DNNL_ARG_FROM, outputMemory},
+         {DNNL_ARG_TO, outputMemInit.getMemory()}});
+  }
+  detail::executeNetwork(network, args);
+
+  // Scales are [1, 1, 1, O] like the weights; output channels are axis 2
+  return dequantizeOutput(
+      output,
+      fl::reshape(
+          weightScales, {1, 1, weights.dim(kWeightOutputChannelSizeIdx), 1}),
+      inputScale,
+      input.type());
+}
+
+} // namespace fl
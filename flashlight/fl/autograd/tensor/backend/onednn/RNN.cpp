@@ -7,7 +7,10 @@
 
 #include "flashlight/fl/autograd/tensor/backend/onednn/OneDnnAutogradExtension.h"
 
+#include <memory>
+#include <sstream>
 #include <stdexcept>
+#include <string>
 #include <tuple>
 #include <unordered_map>
 #include <vector>
@@ -224,6 +227,12 @@ ParsedWeightsAndBias parseWeights(
   return out;
 }
 
+// Primitives are created once per signature and cached
+struct OneDnnRnnForward {
+  dnnl::primitive primitive;
+  dnnl::memory::desc workspaceDesc;
+};
+
 struct RnnResult {
   dnnl::memory workspace;
   Tensor y; // output
@@ -284,6 +293,9 @@ RnnResult rnnImpl(
     cy = Tensor(hy.shape(), input.type());
   }
 
+  // Inference typically reuses the same weights between calls
+  const bool cacheWeights = kind == dnnl::prop_kind::forward_inference;
+
   // Memory for forward
   auto tnc = dnnl::memory::format_tag::tnc;
   auto ldnc = dnnl::memory::format_tag::ldnc;
@@ -310,11 +322,40 @@ RnnResult rnnImpl(
   // Primitive for reordering input weights: ldgoi --> ldigo
   auto weightsInputMemDesc = dnnl::memory::desc(
       weightsInputDims, dType, dnnl::memory::format_tag::ldigo);
-  auto weightsInputMemInit = dnnl::memory(weightsInputMemDesc, dnnlEngine);
   // Primitive for reordering iter/hidden weights: ldgoi --> ldigo
   auto weightsHiddenMemDesc = dnnl::memory::desc(
       weightsHiddenDims, dType, dnnl::memory::format_tag::ldigo);
-  auto weightsHiddenMemInit = dnnl::memory(weightsHiddenMemDesc, dnnlEngine);
+
+  // Workspace memory, if needed
+  dnnl::memory workspace;
+  std::vector<dnnl::primitive> network;
+  std::vector<std::unordered_map<int, dnnl::memory>> fwdArgs;
+
+  dnnl::memory weightsInputMemInit;
+  dnnl::memory weightsHiddenMemInit;
+  if (cacheWeights) {
+    weightsInputMemInit = detail::dnnlCachedReorder(
+        weightsInput, weightsInputMemRawInit.getMemory(), weightsInputMemDesc);
+    weightsHiddenMemInit = detail::dnnlCachedReorder(
+        weightsHidden,
+        weightsHiddenMemRawInit.getMemory(),
+        weightsHiddenMemDesc);
+  } else {
+    weightsInputMemInit = dnnl::memory(weightsInputMemDesc, dnnlEngine);
+    weightsHiddenMemInit = dnnl::memory(weightsHiddenMemDesc, dnnlEngine);
+    // reorder input weights
+    network.push_back(detail::dnnlReorder(
+        weightsInputMemRawInit.getMemory().get_desc(), weightsInputMemDesc));
+    fwdArgs.push_back(
+        {{DNNL_ARG_FROM, weightsInputMemRawInit.getMemory()},
+         {DNNL_ARG_TO, weightsInputMemInit}});
+    // reorder iter weights
+    network.push_back(detail::dnnlReorder(
+        weightsHiddenMemRawInit.getMemory().get_desc(), weightsHiddenMemDesc));
+    fwdArgs.push_back(
+        {{DNNL_ARG_FROM, weightsHiddenMemRawInit.getMemory()},
+         {DNNL_ARG_TO, weightsHiddenMemInit}});
+  }
 
   // Add arguments
   std::unordered_map<int, dnnl::memory> rnnFwdArgs = {
@@ -326,91 +367,84 @@ RnnResult rnnImpl(
       {DNNL_ARG_DST_LAYER, outputMemInit.getMemory()},
       {DNNL_ARG_DST_ITER, hiddenOutMemInit.getMemory()}};
 
-  // Workspace memory, if needed
-  dnnl::memory workspace;
-  std::vector<dnnl::primitive> network;
-  std::vector<std::unordered_map<int, dnnl::memory>> fwdArgs;
-
-  // reorder input weights
-  network.push_back(
-      dnnl::reorder(weightsInputMemRawInit.getMemory(), weightsInputMemInit));
-  fwdArgs.push_back(
-      {{DNNL_ARG_FROM, weightsInputMemRawInit.getMemory()},
-       {DNNL_ARG_TO, weightsInputMemInit}});
-  // reorder iter weights
-  network.push_back(
-      dnnl::reorder(weightsHiddenMemRawInit.getMemory(), weightsHiddenMemInit));
-  fwdArgs.push_back(
-      {{DNNL_ARG_FROM, weightsHiddenMemRawInit.getMemory()},
-       {DNNL_ARG_TO, weightsHiddenMemInit}});
-
-  // Initialize descriptors
-  if (mode == RnnMode::RELU || mode == RnnMode::TANH) {
-    auto vanilla = dnnl::vanilla_rnn_forward::desc(
-        kind,
-        activation,
-        direction,
-        inputMemInit.getDescriptor(),
-        hiddenInMemInit.getDescriptor(),
-        weightsInputMemDesc, // weights "layer"
-        weightsHiddenMemDesc, // weights "iter"
-        biasMemInit.getDescriptor(),
-        outputMemInit.getDescriptor(),
-        hiddenOutMemInit.getDescriptor());
-    auto vanillaPd =
-        dnnl::vanilla_rnn_forward::primitive_desc(vanilla, dnnlEngine);
-    network.push_back(dnnl::vanilla_rnn_forward(vanillaPd));
-    workspace = dnnl::memory(vanillaPd.workspace_desc(), dnnlEngine);
-
-  } else if (mode == RnnMode::LSTM) {
-    // LSTM-only
+  // Cell state memory is only used by LSTMs
+  detail::DnnlMemoryWrapper cellInMemInit;
+  detail::DnnlMemoryWrapper cellOutMemInit;
+  if (mode == RnnMode::LSTM) {
     // input cell state
     // TODO(jacobkahn): function that takes the array and
     // returns the desciptor and memory -- takes an argument for
     // which determines whether or not it's ok to return empty
     // descriptors if the array is empty
-    detail::DnnlMemoryWrapper cellInMemInit;
     if (!cellState.isEmpty()) {
       cellInMemInit = detail::DnnlMemoryWrapper(
           cellState.asContiguousTensor(), {cDims}, ldnc);
     }
     // output cell state
-    detail::DnnlMemoryWrapper cellOutMemInit(cy, cDims, ldnc);
-
-    auto lstm = dnnl::lstm_forward::desc(
-        kind,
-        direction,
-        inputMemInit.getDescriptor(),
-        hiddenInMemInit.getDescriptor(),
-        cellInMemInit.getDescriptor(),
-        weightsInputMemDesc, // weights "layer"
-        weightsHiddenMemDesc, // weights "iter"
-        biasMemInit.getDescriptor(),
-        outputMemInit.getDescriptor(),
-        hiddenOutMemInit.getDescriptor(),
-        cellOutMemInit.getDescriptor());
-    auto lstmPd = dnnl::lstm_forward::primitive_desc(lstm, dnnlEngine);
-    network.push_back(dnnl::lstm_forward(lstmPd));
-    workspace = dnnl::memory(lstmPd.workspace_desc(), dnnlEngine);
+    cellOutMemInit = detail::DnnlMemoryWrapper(cy, cDims, ldnc);
     rnnFwdArgs.insert({DNNL_ARG_SRC_ITER_C, cellInMemInit.getMemory()});
     rnnFwdArgs.insert({DNNL_ARG_DST_ITER_C, cellOutMemInit.getMemory()});
-
-  } else if (mode == RnnMode::GRU) {
-    // Use a linear-before-reset GRU so we can have parity with cuDNN
-    auto gru = dnnl::lbr_gru_forward::desc(
-        kind,
-        direction,
-        inputMemInit.getDescriptor(),
-        hiddenInMemInit.getDescriptor(),
-        weightsInputMemDesc,
-        weightsHiddenMemDesc,
-        biasMemInit.getDescriptor(),
-        outputMemInit.getDescriptor(),
-        hiddenOutMemInit.getDescriptor());
-    auto gruPd = dnnl::lbr_gru_forward::primitive_desc(gru, dnnlEngine);
-    network.push_back(dnnl::lbr_gru_forward(gruPd));
-    workspace = dnnl::memory(gruPd.workspace_desc(), dnnlEngine);
   }
+
+  // Initialize descriptors
+  static detail::DnnlCache<OneDnnRnnForward> cache;
+  std::ostringstream key;
+  key << static_cast<int>(mode) << ";" << static_cast<int>(kind) << ";"
+      << input.type() << ";" << seqLength << "," << batchSize << ","
+      << inSize << ";" << hiddenSize << ";" << numLayers << ";"
+      << directionMult << ";" << hiddenState.isEmpty() << ";"
+      << cellState.isEmpty();
+  auto rnnForward = cache.get(key.str(), [&]() -> OneDnnRnnForward {
+    if (mode == RnnMode::RELU || mode == RnnMode::TANH) {
+      auto vanilla = dnnl::vanilla_rnn_forward::desc(
+          kind,
+          activation,
+          direction,
+          inputMemInit.getDescriptor(),
+          hiddenInMemInit.getDescriptor(),
+          weightsInputMemDesc, // weights "layer"
+          weightsHiddenMemDesc, // weights "iter"
+          biasMemInit.getDescriptor(),
+          outputMemInit.getDescriptor(),
+          hiddenOutMemInit.getDescriptor());
+      auto vanillaPd =
+          dnnl::vanilla_rnn_forward::primitive_desc(vanilla, dnnlEngine);
+      return {
+          dnnl::vanilla_rnn_forward(vanillaPd), vanillaPd.workspace_desc()};
+    } else if (mode == RnnMode::LSTM) {
+      auto lstm = dnnl::lstm_forward::desc(
+          kind,
+          direction,
+          inputMemInit.getDescriptor(),
+          hiddenInMemInit.getDescriptor(),
+          cellInMemInit.getDescriptor(),
+          weightsInputMemDesc, // weights "layer"
+          weightsHiddenMemDesc, // weights "iter"
+          biasMemInit.getDescriptor(),
+          outputMemInit.getDescriptor(),
+          hiddenOutMemInit.getDescriptor(),
+          cellOutMemInit.getDescriptor());
+      auto lstmPd = dnnl::lstm_forward::primitive_desc(lstm, dnnlEngine);
+      return {dnnl::lstm_forward(lstmPd), lstmPd.workspace_desc()};
+    } else if (mode == RnnMode::GRU) {
+      // Use a linear-before-reset GRU so we can have parity with cuDNN
+      auto gru = dnnl::lbr_gru_forward::desc(
+          kind,
+          direction,
+          inputMemInit.getDescriptor(),
+          hiddenInMemInit.getDescriptor(),
+          weightsInputMemDesc,
+          weightsHiddenMemDesc,
+          biasMemInit.getDescriptor(),
+          outputMemInit.getDescriptor(),
+          hiddenOutMemInit.getDescriptor());
+      auto gruPd = dnnl::lbr_gru_forward::primitive_desc(gru, dnnlEngine);
+      return {dnnl::lbr_gru_forward(gruPd), gruPd.workspace_desc()};
+    }
+    throw std::invalid_argument("onednn RNN: unsupported RNN mode");
+  });
+  network.push_back(rnnForward->primitive);
+  workspace = dnnl::memory(rnnForward->workspaceDesc, dnnlEngine);
   rnnFwdArgs.insert({DNNL_ARG_WORKSPACE, workspace});
   fwdArgs.push_back(rnnFwdArgs);
 
@@ -476,8 +510,36 @@ std::tuple<Tensor, Tensor, Tensor> OneDnnAutogradExtension::rnn(
   // have to parse out the input weights, input biases, hidden weights, and
   // hidden biases from one tensor. Order doesn't matter since the arrangement
   // is a black box
-  auto parsedWeights = parseWeights(
-      weights, mode, numLayers, directionMult, inSize, numGates, hiddenSize);
+  auto parse = [&]() {
+    return parseWeights(
+        weights, mode, numLayers, directionMult, inSize, numGates, hiddenSize);
+  };
+  std::shared_ptr<const ParsedWeightsAndBias> parsedWeightsPtr;
+  if (train) {
+    parsedWeightsPtr = std::make_shared<const ParsedWeightsAndBias>(parse());
+  } else {
+    // Parsed weights are reused until the weights change so that their
+    // reordered copies are cached, too. Deep copies are contiguous, so are used
+    // as is by rnnImpl, and don't hold the buffer of the weights
+    static detail::DnnlTensorCache<ParsedWeightsAndBias> cache;
+    std::ostringstream key;
+    key << static_cast<int>(mode) << ";" << numLayers << ";" << directionMult
+        << ";" << inSize << ";" << hiddenSize;
+    parsedWeightsPtr = cache.get(weights, key.str(), [&]() {
+      auto parsed = parse();
+      for (auto* tensor :
+           {&parsed.weightsInput1L,
+            &parsed.weightsHidden1L,
+            &parsed.weightsInput,
+            &parsed.weightsHidden}) {
+        if (!tensor->isEmpty()) {
+          *tensor = tensor->copy();
+        }
+      }
+      return parsed;
+    });
+  }
+  const auto& parsedWeights = *parsedWeightsPtr;
 
   RnnResult result;
   // The oneDNN RNN primitive has an API limitation where input size and
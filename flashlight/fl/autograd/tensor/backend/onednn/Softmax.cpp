@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/autograd/tensor/backend/onednn/OneDnnAutogradExtension.h"
+
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include <dnnl.hpp>
+
+#include "flashlight/fl/autograd/tensor/backend/onednn/DnnlUtils.h"
+
+namespace fl {
+
+namespace {
+
+// Inputs are viewed as row-major [outer, axis, inner], where inner is the
+// product of the (column-major) dimensions before the softmax axis
+constexpr auto format3d = dnnl::memory::format_tag::abc;
+constexpr int kSoftmaxAxis = 1;
+
+struct OneDnnSoftmaxPayload : detail::AutogradPayloadData {
+  dnnl::softmax_forward::primitive_desc softmaxPrimDesc;
+  dnnl::logsoftmax_forward::primitive_desc logSoftmaxPrimDesc;
+};
+
+dnnl::memory::dims getSoftmaxDims(const Shape& shape, const int axis) {
+  Dim inner = 1;
+  Dim outer = 1;
+  for (int i = 0; i < shape.ndim(); ++i) {
+    if (i < axis) {
+      inner *= shape.dim(i);
+    } else if (i > axis) {
+      outer *= shape.dim(i);
+    }
+  }
+  return detail::convertToDnnlDims({outer, shape.dim(axis), inner});
+}
+
+} // namespace
+
+std::optional<Tensor> OneDnnAutogradExtension::softmax(
+    const Tensor& input,
+    const int axis,
+    const bool logSoftmax,
+    std::shared_ptr<detail::AutogradPayload> autogradPayload) {
+  if (input.type() != fl::dtype::f32 || input.isEmpty() || axis < 0 ||
+      axis >= input.ndim()) {
+    return std::nullopt;
+  }
+
+  auto payload = std::make_shared<OneDnnSoftmaxPayload>();
+  if (autogradPayload) {
+    autogradPayload->data = payload;
+  }
+
+  auto output = Tensor(input.shape(), input.type());
+  auto& dnnlEngine = detail::DnnlEngine::getInstance().getEngine();
+
+  const auto dims = getSoftmaxDims(input.shape(), axis);
+  const detail::DnnlMemoryWrapper inputMemory(input, dims, format3d);
+  const detail::DnnlMemoryWrapper outputMemory(output, dims, format3d);
+
+  auto kind = autogradPayload ? dnnl::prop_kind::forward_training
+                              : dnnl::prop_kind::forward_inference;
+  std::vector<dnnl::primitive> network;
+  if (logSoftmax) {
+    auto fwdDesc = dnnl::logsoftmax_forward::desc(
+        kind, inputMemory.getDescriptor(), kSoftmaxAxis);
+    payload->logSoftmaxPrimDesc =
+        dnnl::logsoftmax_forward::primitive_desc(fwdDesc, dnnlEngine);
+    network.push_back(dnnl::logsoftmax_forward(payload->logSoftmaxPrimDesc));
+  } else {
+    auto fwdDesc = dnnl::softmax_forward::desc(
+        kind, inputMemory.getDescriptor(), kSoftmaxAxis);
+    payload->softmaxPrimDesc =
+        dnnl::softmax_forward::primitive_desc(fwdDesc, dnnlEngine);
+    network.push_back(dnnl::softmax_forward(payload->softmaxPrimDesc));
+  }
+
+  // Execute
+  std::vector<std::unordered_map<int, dnnl::memory>> fwdArgs = {
+      {{DNNL_ARG_SRC, inputMemory.getMemory()},
+       {DNNL_ARG_DST, outputMemory.getMemory()}}};
+  detail::executeNetwork(network, fwdArgs);
+
+  return output;
+}
+
+Tensor OneDnnAutogradExtension::softmaxBackward(
+    const Tensor& gradOutput,
+    const Tensor& output,
+    const int axis,
+    const bool logSoftmax,
+    std::shared_ptr<detail::AutogradPayload> autogradPayload) {
+  if (!autogradPayload || !autogradPayload->data) {
+    throw std::invalid_argument(
+        "OneDnnAutogradExtension::softmaxBackward given null "
+        "detail::AutogradPayload");
+  }
+  auto payload =
+      std::static_pointer_cast<OneDnnSoftmaxPayload>(autogradPayload->data);
+  auto& dnnlEngine = detail::DnnlEngine::getInstance().getEngine();
+
+  auto gradInput = Tensor(output.shape(), output.type());
+
+  const auto dims = getSoftmaxDims(output.shape(), axis);
+  const detail::DnnlMemoryWrapper outputMemory(output, dims, format3d);
+  const detail::DnnlMemoryWrapper gradOutputMemory(gradOutput, dims, format3d);
+  const detail::DnnlMemoryWrapper gradInputMemory(gradInput, dims, format3d);
+
+  std::vector<dnnl::primitive> networkBackwards;
+  if (logSoftmax) {
+    auto bwdDesc = dnnl::logsoftmax_backward::desc(
+        gradOutputMemory.getDescriptor(),
+        outputMemory.getDescriptor(),
+        kSoftmaxAxis);
+    networkBackwards.push_back(
+        dnnl::logsoftmax_backward(dnnl::logsoftmax_backward::primitive_desc(
+            bwdDesc, dnnlEngine, payload->logSoftmaxPrimDesc)));
+  } else {
+    auto bwdDesc = dnnl::softmax_backward::desc(
+        gradOutputMemory.getDescriptor(),
+        outputMemory.getDescriptor(),
+        kSoftmaxAxis);
+    networkBackwards.push_back(
+        dnnl::softmax_backward(dnnl::softmax_backward::primitive_desc(
+            bwdDesc, dnnlEngine, payload->softmaxPrimDesc)));
+  }
+
+  // Execute
+  std::vector<std::unordered_map<int, dnnl::memory>> bwdArgs = {
+      {{DNNL_ARG_DST, outputMemory.getMemory()},
+       {DNNL_ARG_DIFF_DST, gradOutputMemory.getMemory()},
+       {DNNL_ARG_DIFF_SRC, gradInputMemory.getMemory()}}};
+  detail::executeNetwork(networkBackwards, bwdArgs);
+
+  return gradInput;
+}
+
+} // namespace fl
@@ -6,10 +6,130 @@
  */
 
 #include "flashlight/fl/common/DynamicBenchmark.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <system_error>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "flashlight/fl/common/Logging.h"
 #include "flashlight/fl/tensor/Compute.h"
 
 namespace fl {
 
+namespace {
+
+struct BenchmarkCache {
+  std::mutex mutex;
+  std::unordered_map<std::string, size_t> entries;
+  fs::path path;
+  bool writable{false};
+  // Modification time of the file when it was last read or written
+  fs::file_time_type lastWriteTime;
+};
+
+fs::file_time_type lastWriteTime(const fs::path& path) {
+  std::error_code ec;
+  auto time = fs::last_write_time(path, ec);
+  return ec ? fs::file_time_type::min() : time;
+}
+
+void loadEntries(
+    const fs::path& path,
+    std::unordered_map<std::string, size_t>& entries) {
+  std::ifstream file(path);
+  if (!file.is_open()) {
+    return;
+  }
+  std::string line;
+  while (std::getline(file, line)) {
+    const auto sep = line.rfind('\t');
+    if (line.empty() || line[0] == '#' || sep == std::string::npos) {
+      continue;
+    }
+    try {
+      entries[line.substr(0, sep)] = std::stoul(line.substr(sep + 1));
+    } catch (const std::exception&) {
+      // Skip malformed entries rather than failing to start
+    }
+  }
+}
+
+int processId() {
+#ifdef _WIN32
+  return _getpid();
+#else
+  return getpid();
+#endif
+}
+
+void saveEntries(
+    const fs::path& path,
+    const std::unordered_map<std::string, size_t>& entries) {
+  // Unique to the process, as processes sharing the file may save at once,
+  // possibly from different hosts with the same process ids
+  static const auto processTag = std::to_string(processId()) + "." +
+      std::to_string(std::random_device()());
+  const auto tmpPath = path.string() + ".tmp." + processTag;
+  {
+    std::ofstream file(tmpPath, std::ios::trunc);
+    if (!file.is_open()) {
+      throw std::runtime_error(
+          "DynamicBenchmarkCache::save - failed to open file for writing: " +
+          tmpPath);
+    }
+    file << "# key\toption index\n";
+    for (const auto& [key, idx] : entries) {
+      file << key << '\t' << idx << '\n';
+    }
+    file.close();
+    if (!file) {
+      std::error_code ec;
+      fs::remove(tmpPath, ec);
+      throw std::runtime_error(
+          "DynamicBenchmarkCache::save - failed to write file: " + tmpPath);
+    }
+  }
+  std::error_code ec;
+  fs::rename(tmpPath, path, ec);
+  if (ec) {
+    fs::remove(tmpPath, ec);
+    throw std::runtime_error(
+        "DynamicBenchmarkCache::save - failed to replace file: " +
+        path.string());
+  }
+}
+
+// Caller must hold cache.mutex
+bool isWriter(const BenchmarkCache& cache) {
+  return cache.writable && !cache.path.empty();
+}
+
+BenchmarkCache& benchmarkCache() {
+  // Warmed from the file given by the environment on first use
+  static auto* cache = []() {
+    auto* initial = new BenchmarkCache();
+    const char* path = std::getenv(DynamicBenchmarkCache::kPathEnvVariable);
+    if (path && *path) {
+      initial->path = path;
+      initial->writable = true;
+      loadEntries(initial->path, initial->entries);
+      initial->lastWriteTime = lastWriteTime(initial->path);
+    }
+    return initial;
+  }();
+  return *cache;
+}
+
+} // namespace
+
 // Default value for benchmark mode
 bool DynamicBenchmark::benchmarkMode_ = false;
 
@@ -37,6 +157,25 @@ void DynamicBenchmark::stop(bool incrementCount) {
   fl::sync();
   auto elapsedTime = fl::Timer::stop(currentTimer_);
   options_->accumulateTimeToCurrentOption(elapsedTime, incrementCount);
+  if (!cacheKey_.empty() && options_->timingsComplete()) {
+    DynamicBenchmarkCache::insert(cacheKey_, options_->currentOptionIndex());
+  }
+}
+
+void DynamicBenchmark::setCacheKey(const std::string& key) {
+  cacheKey_ = key;
+  if (cacheKey_.empty()) {
+    return;
+  }
+  auto cached = DynamicBenchmarkCache::lookup(cacheKey_);
+  // Entries from a different set of options are ignored
+  if (cached && *cached < options_->optionCount()) {
+    options_->setOptimalOptionIndex(*cached);
+  }
+}
+
+const std::string& DynamicBenchmark::getCacheKey() const {
+  return cacheKey_;
 }
 
 void DynamicBenchmark::setBenchmarkMode(bool mode) {
@@ -47,4 +186,106 @@ bool DynamicBenchmark::getBenchmarkMode() {
   return benchmarkMode_;
 }
 
+void DynamicBenchmarkCache::setPath(const fs::path& path, bool writable) {
+  auto& cache = benchmarkCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.path = path;
+  cache.writable = writable;
+  if (!path.empty()) {
+    loadEntries(path, cache.entries);
+    cache.lastWriteTime = lastWriteTime(path);
+  }
+}
+
+void DynamicBenchmarkCache::setWritable(bool writable) {
+  auto& cache = benchmarkCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.writable = writable;
+}
+
+fs::path DynamicBenchmarkCache::getPath() {
+  auto& cache = benchmarkCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  return cache.path;
+}
+
+std::optional<size_t> DynamicBenchmarkCache::lookup(const std::string& key) {
+  auto& cache = benchmarkCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  auto it = cache.entries.find(key);
+  if (it == cache.entries.end() && !isWriter(cache) && !cache.path.empty()) {
+    // Pick up entries added by the process writing the file
+    const auto time = lastWriteTime(cache.path);
+    if (time != cache.lastWriteTime) {
+      loadEntries(cache.path, cache.entries);
+      cache.lastWriteTime = time;
+      it = cache.entries.find(key);
+    }
+  }
+  if (it == cache.entries.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+void DynamicBenchmarkCache::insert(const std::string& key, size_t optionIdx) {
+  if (key.empty() || key.find_first_of("\t\n") != std::string::npos) {
+    throw std::invalid_argument(
+        "DynamicBenchmarkCache::insert - keys must be non-empty and "
+        "can't contain tabs or newlines: " +
+        key);
+  }
+  auto& cache = benchmarkCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  auto it = cache.entries.find(key);
+  if (it != cache.entries.end() && it->second == optionIdx) {
+    return;
+  }
+  cache.entries[key] = optionIdx;
+  if (isWriter(cache)) {
+    // Keep the entries other writers may have added since loading
+    auto entries = cache.entries;
+    if (lastWriteTime(cache.path) != cache.lastWriteTime) {
+      loadEntries(cache.path, entries);
+      entries[key] = optionIdx;
+    }
+    // Inserted as benchmarks converge, e.g. during training, which shouldn't
+    // fail because the cache can't be saved. The entry is kept in memory.
+    try {
+      saveEntries(cache.path, entries);
+    } catch (const std::exception& ex) {
+      FL_LOG(fl::LogLevel::WARNING)
+          << "DynamicBenchmarkCache::insert - failed to save the cache to "
+          << cache.path.string() << ": " << ex.what();
+      return;
+    }
+    cache.entries = std::move(entries);
+    cache.lastWriteTime = lastWriteTime(cache.path);
+  }
+}
+
+size_t DynamicBenchmarkCache::size() {
+  auto& cache = benchmarkCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  return cache.entries.size();
+}
+
+void DynamicBenchmarkCache::clear() {
+  auto& cache = benchmarkCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  cache.entries.clear();
+}
+
+void DynamicBenchmarkCache::load(const fs::path& path) {
+  auto& cache = benchmarkCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  loadEntries(path, cache.entries);
+}
+
+void DynamicBenchmarkCache::save(const fs::path& path) {
+  auto& cache = benchmarkCache();
+  std::lock_guard<std::mutex> lock(cache.mutex);
+  saveEntries(path, cache.entries);
+}
+
 } // namespace fl
@@ -9,13 +9,16 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
 #include <stdexcept>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "flashlight/fl/common/Defines.h"
+#include "flashlight/fl/common/Filesystem.h"
 #include "flashlight/fl/common/Timer.h"
 
 namespace fl {
@@ -42,6 +45,24 @@ struct FL_API DynamicBenchmarkOptionsBase {
         "- unimplemented");
   }
 
+  virtual size_t optionCount() {
+    throw std::logic_error(
+        "DynamicBenchmarkOptionsBase::optionCount "
+        "- unimplemented");
+  }
+
+  virtual size_t currentOptionIndex() {
+    throw std::logic_error(
+        "DynamicBenchmarkOptionsBase::currentOptionIndex "
+        "- unimplemented");
+  }
+
+  virtual void setOptimalOptionIndex(size_t) {
+    throw std::logic_error(
+        "DynamicBenchmarkOptionsBase::setOptimalOptionIndex "
+        "- unimplemented");
+  }
+
  protected:
   // Not intended for construction
   DynamicBenchmarkOptionsBase() = default;
@@ -141,6 +162,40 @@ struct DynamicBenchmarkOptions : DynamicBenchmarkOptionsBase {
     return timingsComplete_;
   }
 
+  /**
+   * @return the number of options
+   */
+  size_t optionCount() override {
+    return options_.size();
+  }
+
+  /**
+   * @return the index of the current option. See `currentOption`.
+   */
+  size_t currentOptionIndex() override {
+    updateState();
+    return currentOptionIdx_;
+  }
+
+  /**
+   * Fixes the option at a given index as the optimal option without timing
+   * options, e.g. from the result of a previous benchmark. Timings are
+   * complete until `reset` is called.
+   *
+   * @param[in] idx the index of the optimal option
+   */
+  void setOptimalOptionIndex(size_t idx) override {
+    if (idx >= options_.size()) {
+      throw std::out_of_range(
+          "DynamicBenchmarkOptions::setOptimalOptionIndex: "
+          "index " +
+          std::to_string(idx) + " out of range for " +
+          std::to_string(options_.size()) + " options");
+    }
+    timingsComplete_ = true;
+    currentOptionIdx_ = idx;
+  }
+
   /**
    * Adds time to the current option tally.
    *
@@ -213,6 +268,25 @@ class FL_API DynamicBenchmark {
    */
   void audit(const std::function<void()>& function, bool incrementCount = true);
 
+  /**
+   * Sets the key under which the optimal option of this benchmark is kept in
+   * the `DynamicBenchmarkCache`. If the cache holds the key, timings are
+   * completed with the cached option; otherwise, the optimal option is added
+   * to the cache once timings complete.
+   *
+   * The key should identify everything the timings depend on: the operation,
+   * the shapes and types of its operands and the hardware.
+   *
+   * @param[in] key the cache key
+   */
+  void setCacheKey(const std::string& key);
+
+  /**
+   * @return the key of this benchmark in the `DynamicBenchmarkCache`, or an
+   * empty string if the benchmark isn't cached
+   */
+  const std::string& getCacheKey() const;
+
   /**
    * Gets the benchmarks' underlying `DynamicBenchmarkOptionsBase` instance.
    *
@@ -245,6 +319,7 @@ class FL_API DynamicBenchmark {
   void stop(bool incrementCount);
 
   std::shared_ptr<DynamicBenchmarkOptionsBase> options_;
+  std::string cacheKey_;
   // Timer for current benchmark iteration
   fl::Timer currentTimer_;
 
@@ -253,6 +328,87 @@ class FL_API DynamicBenchmark {
   static bool benchmarkMode_;
 };
 
+/**
+ * Keeps the optimal options found by `DynamicBenchmark`s with a cache key -
+ * see `DynamicBenchmark::setCacheKey` - so that options are timed once rather
+ * than in every process.
+ *
+ * The cache is warmed from a file, given by `setPath` or by the
+ * `FL_DYNAMIC_BENCHMARK_CACHE` environment variable at startup, and the file
+ * is updated each time a benchmark converges. Failing to update the file is
+ * logged rather than thrown. Several processes, e.g. the ranks of a
+ * distributed job, can share a file on a shared filesystem: one of them writes
+ * it while the others only read it, and pick up the options timed by the
+ * writer. The file is writable by default, and the caller picks the writer,
+ * e.g. once the distributed environment is initialized:
+ * \code
+   // Only rank 0 writes the file
+   DynamicBenchmarkCache::setWritable(fl::getWorldRank() == 0);
+ * \endcode
+ *
+ * The file holds one `key<TAB>option index` entry per line.
+ */
+class FL_API DynamicBenchmarkCache {
+ public:
+  static constexpr const char* kPathEnvVariable = "FL_DYNAMIC_BENCHMARK_CACHE";
+
+  /**
+   * Sets the file backing the cache and loads its entries, if the file exists.
+   *
+   * @param[in] path the file; if empty, the cache is only kept in memory
+   * @param[in] writable whether to save the cache to the file each time a
+   * benchmark converges. Otherwise, the file is reloaded when a key is missing
+   * and the file has changed. Only one process sharing the file should write
+   * it.
+   */
+  static void setPath(const fs::path& path, bool writable = true);
+
+  /**
+   * Sets whether this process writes the file backing the cache, e.g. for a
+   * path given by the environment, which is the same for every process.
+   */
+  static void setWritable(bool writable);
+
+  /**
+   * @return the file backing the cache, or an empty path if there is none
+   */
+  static fs::path getPath();
+
+  /**
+   * @return the cached option index for a key, if any
+   */
+  static std::optional<size_t> lookup(const std::string& key);
+
+  /**
+   * Adds or replaces an entry, and saves the cache if its file is writable.
+   * Keys can't contain tabs or newlines.
+   */
+  static void insert(const std::string& key, size_t optionIdx);
+
+  /**
+   * @return the number of entries
+   */
+  static size_t size();
+
+  /**
+   * Removes all entries from memory. The file backing the cache is left
+   * unchanged.
+   */
+  static void clear();
+
+  /**
+   * Adds the entries of a file to the cache, replacing entries with the same
+   * key.
+   */
+  static void load(const fs::path& path);
+
+  /**
+   * Saves the entries of the cache to a file. The file is replaced atomically
+   * so that readers never see a partial file.
+   */
+  static void save(const fs::path& path);
+};
+
 // Specific benchmark implementations
 namespace detail {
 
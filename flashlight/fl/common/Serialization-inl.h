@@ -11,9 +11,12 @@
  */
 
 #include <fstream>
+#include <memory>
+#include <sstream>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "flashlight/fl/common/Filesystem.h"
 #include "flashlight/fl/tensor/TensorBase.h"
@@ -152,6 +155,88 @@ void load(std::istream& istr, Args&... args) {
   ar(args...);
 }
 
+namespace detail {
+
+class MappedFile;
+
+/**
+ * Writes a `saveMapped` file. While alive, tensors serialized on the
+ * constructing thread are written to the data section of a temporary file
+ * and replaced by their offset in the archive.
+ */
+class FL_API MappedModelWriter {
+ public:
+  explicit MappedModelWriter(const fs::path& filepath);
+  ~MappedModelWriter();
+
+  /// Stream to which the metadata archive is written
+  std::ostream& metadata();
+  /// Writes the metadata and the header, then moves the file to its
+  /// destination. Must be called once serialization succeeded, the file is
+  /// discarded otherwise.
+  void finish();
+  /// Writes the data of a tensor, returns its offset in the data section
+  uint64_t addTensor(const Tensor& tensor);
+
+  /// The writer of the current thread, if any
+  static MappedModelWriter* current();
+
+ private:
+  fs::path filepath_;
+  fs::path tmpPath_;
+  std::ofstream file_;
+  std::ostringstream metadata_;
+  std::vector<uint8_t> staging_;
+  uint64_t dataSize_{0};
+  bool finished_{false};
+  MappedModelWriter* previous_;
+};
+
+/**
+ * Reads a `saveMapped` file. While alive, tensors deserialized on the
+ * constructing thread are created from the data section of the mapping.
+ */
+class FL_API MappedModelReader {
+ public:
+  explicit MappedModelReader(const fs::path& filepath);
+  ~MappedModelReader();
+
+  /// Stream from which the metadata archive is read
+  std::istream& metadata();
+  /// Creates a tensor from the data section
+  Tensor tensor(const Shape& shape, fl::dtype type, uint64_t offset) const;
+
+  /// The reader of the current thread, if any
+  static MappedModelReader* current();
+
+ private:
+  std::unique_ptr<MappedFile> file_;
+  std::unique_ptr<std::streambuf> metadataBuf_;
+  std::unique_ptr<std::istream> metadata_;
+  const uint8_t* data_{nullptr};
+  uint64_t dataSize_{0};
+  MappedModelReader* previous_;
+};
+
+} // namespace detail
+
+template <typename... Args>
+void saveMapped(const fs::path& filepath, const Args&... args) {
+  detail::MappedModelWriter writer(filepath);
+  {
+    cereal::BinaryOutputArchive ar(writer.metadata());
+    ar(args...);
+  }
+  writer.finish();
+}
+
+template <typename... Args>
+void loadMapped(const fs::path& filepath, Args&... args) {
+  detail::MappedModelReader reader(filepath);
+  cereal::BinaryInputArchive ar(reader.metadata());
+  ar(args...);
+}
+
 namespace detail {
 /**
  * This workaround lets us use explicit versioning for Tensor; if we'd used
@@ -208,6 +293,10 @@ void save(
     throw cereal::Exception(
         "Serialzation of sparse Tensor is not supported yet!");
   }
+  if (auto* writer = fl::detail::MappedModelWriter::current()) {
+    ar(tensor.shape(), tensor.type(), writer->addTensor(tensor));
+    return;
+  }
   std::vector<uint8_t> vec(tensor.bytes());
   tensor.host(vec.data());
   ar(tensor.shape(), tensor.type(), vec);
@@ -217,6 +306,12 @@ template <class Archive>
 void load(Archive& ar, fl::Tensor& tensor, const uint32_t /* version */) {
   fl::Shape dims;
   fl::dtype ty;
+  if (auto* reader = fl::detail::MappedModelReader::current()) {
+    uint64_t offset;
+    ar(dims, ty, offset);
+    tensor = reader->tensor(dims, ty, offset);
+    return;
+  }
   std::vector<uint8_t> vec;
   ar(dims, ty, vec);
   tensor = fl::Tensor::fromVector(dims, vec, ty);
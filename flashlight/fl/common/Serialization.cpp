@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/common/Serialization.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fl {
+namespace detail {
+
+namespace {
+
+constexpr char kMappedMagic[8] = {'F', 'L', 'M', 'A', 'P', 'P', 'E', 'D'};
+constexpr uint32_t kMappedFormatVersion = 1;
+// The data section starts on a page boundary
+constexpr uint64_t kMappedHeaderSize = 4096;
+
+struct MappedHeader {
+  char magic[8];
+  uint32_t formatVersion;
+  uint32_t reserved;
+  uint64_t dataOffset;
+  uint64_t dataSize;
+  uint64_t metadataOffset;
+  uint64_t metadataSize;
+};
+
+thread_local MappedModelWriter* currentWriter = nullptr;
+thread_local MappedModelReader* currentReader = nullptr;
+
+uint64_t alignUp(uint64_t n, uint64_t alignment) {
+  return (n + alignment - 1) / alignment * alignment;
+}
+
+void writePadding(std::ostream& os, uint64_t bytes) {
+  static const char zeros[kMappedTensorAlignment] = {};
+  while (bytes > 0) {
+    auto n = std::min<uint64_t>(bytes, sizeof(zeros));
+    os.write(zeros, n);
+    bytes -= n;
+  }
+}
+
+/**
+ * A read-only stream buffer over a range of memory.
+ */
+class MemoryStreamBuf : public std::streambuf {
+ public:
+  MemoryStreamBuf(const uint8_t* data, uint64_t size) {
+    char* begin = const_cast<char*>(reinterpret_cast<const char*>(data));
+    setg(begin, begin, begin + size);
+  }
+};
+
+} // namespace
+
+/**
+ * A file mapped read-only into memory. Falls back to reading the whole file
+ * where mmap is not available.
+ */
+class MappedFile {
+ public:
+  explicit MappedFile(const fs::path& filepath) {
+#ifdef _WIN32
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+      throw std::runtime_error(
+          "MappedFile - failed to open file: " + filepath.string());
+    }
+    buffer_.assign(
+        std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data_ = reinterpret_cast<const uint8_t*>(buffer_.data());
+    size_ = buffer_.size();
+#else
+    int fd = ::open(filepath.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error(
+          "MappedFile - failed to open file: " + filepath.string());
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+      ::close(fd);
+      throw std::runtime_error(
+          "MappedFile - failed to stat file: " + filepath.string());
+    }
+    size_ = st.st_size;
+    if (size_ > 0) {
+      void* addr = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error(
+            "MappedFile - failed to map file: " + filepath.string());
+      }
+      // Tensors are usually created in the order they were saved
+      ::madvise(addr, size_, MADV_SEQUENTIAL);
+      data_ = static_cast<const uint8_t*>(addr);
+    }
+    // The mapping stays valid once the descriptor is closed
+    ::close(fd);
+#endif
+  }
+
+  ~MappedFile() {
+#ifndef _WIN32
+    if (data_) {
+      ::munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const uint8_t* data() const {
+    return data_;
+  }
+
+  /// Drops the resident pages within a range of the mapping, which are read
+  /// from the file again if accessed
+  void release(const uint8_t* begin, uint64_t size) const {
+#ifndef _WIN32
+    static const auto pageSize = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+    // Only whole pages, which don't hold data of other tensors, are dropped
+    const auto offset = static_cast<uint64_t>(begin - data_);
+    const auto first = alignUp(offset, pageSize);
+    const auto last = (offset + size) / pageSize * pageSize;
+    if (last > first) {
+      ::madvise(
+          const_cast<uint8_t*>(data_ + first), last - first, MADV_DONTNEED);
+    }
+#endif
+  }
+
+  uint64_t size() const {
+    return size_;
+  }
+
+ private:
+  const uint8_t* data_{nullptr};
+  uint64_t size_{0};
+#ifdef _WIN32
+  std::vector<char> buffer_;
+#endif
+};
+
+MappedModelWriter::MappedModelWriter(const fs::path& filepath)
+    : filepath_(filepath),
+      // Written next to its destination, which it replaces once complete
+      tmpPath_(filepath.string() + ".tmp"),
+      file_(tmpPath_, std::ios::binary | std::ios::trunc),
+      metadata_(std::ios::binary),
+      previous_(currentWriter) {
+  if (!file_.is_open()) {
+    throw std::runtime_error(
+        "saveMapped - failed to open file for writing: " + tmpPath_.string());
+  }
+  // Reserve the header, written once offsets are known
+  writePadding(file_, kMappedHeaderSize);
+  currentWriter = this;
+}
+
+MappedModelWriter::~MappedModelWriter() {
+  currentWriter = previous_;
+  if (!finished_) {
+    // Leave the destination as it was
+    file_.close();
+    std::error_code ec;
+    fs::remove(tmpPath_, ec);
+  }
+}
+
+std::ostream& MappedModelWriter::metadata() {
+  return metadata_;
+}
+
+uint64_t MappedModelWriter::addTensor(const Tensor& tensor) {
+  const uint64_t offset = alignUp(dataSize_, kMappedTensorAlignment);
+  writePadding(file_, offset - dataSize_);
+  const auto bytes = tensor.bytes();
+  if (bytes > 0) {
+    // One tensor is staged on the host at a time
+    staging_.resize(bytes);
+    tensor.host(staging_.data());
+    file_.write(reinterpret_cast<const char*>(staging_.data()), bytes);
+  }
+  dataSize_ = offset + bytes;
+  return offset;
+}
+
+void MappedModelWriter::finish() {
+  currentWriter = previous_;
+  const auto metadata = metadata_.str();
+
+  MappedHeader header{};
+  std::memcpy(header.magic, kMappedMagic, sizeof(kMappedMagic));
+  header.formatVersion = kMappedFormatVersion;
+  header.dataOffset = kMappedHeaderSize;
+  header.dataSize = dataSize_;
+  header.metadataOffset = kMappedHeaderSize + dataSize_;
+  header.metadataSize = metadata.size();
+
+  file_.write(metadata.data(), metadata.size());
+  file_.seekp(0);
+  file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file_.close();
+  if (!file_) {
+    throw std::runtime_error(
+        "saveMapped - failed to write file: " + tmpPath_.string());
+  }
+  fs::rename(tmpPath_, filepath_);
+  finished_ = true;
+}
+
+MappedModelWriter* MappedModelWriter::current() {
+  return currentWriter;
+}
+
+MappedModelReader::MappedModelReader(const fs::path& filepath)
+    : file_(std::make_unique<MappedFile>(filepath)),
+      previous_(currentReader) {
+  MappedHeader header;
+  if (file_->size() < kMappedHeaderSize) {
+    throw std::runtime_error(
+        "loadMapped - file is too small: " + filepath.string());
+  }
+  std::memcpy(&header, file_->data(), sizeof(header));
+  if (std::memcmp(header.magic, kMappedMagic, sizeof(kMappedMagic)) != 0) {
+    throw std::runtime_error(
+        "loadMapped - not a mapped model file: " + filepath.string());
+  }
+  if (header.formatVersion != kMappedFormatVersion) {
+    throw std::runtime_error(
+        "loadMapped - unsupported format version " +
+        std::to_string(header.formatVersion) + " in " + filepath.string());
+  }
+  if (header.dataOffset + header.dataSize > file_->size() ||
+      header.metadataOffset + header.metadataSize > file_->size()) {
+    throw std::runtime_error(
+        "loadMapped - truncated file: " + filepath.string());
+  }
+  data_ = file_->data() + header.dataOffset;
+  dataSize_ = header.dataSize;
+  metadataBuf_ = std::make_unique<MemoryStreamBuf>(
+      file_->data() + header.metadataOffset, header.metadataSize);
+  metadata_ = std::make_unique<std::istream>(metadataBuf_.get());
+  currentReader = this;
+}
+
+MappedModelReader::~MappedModelReader() {
+  currentReader = previous_;
+}
+
+std::istream& MappedModelReader::metadata() {
+  return *metadata_;
+}
+
+Tensor MappedModelReader::tensor(
+    const Shape& shape,
+    fl::dtype type,
+    uint64_t offset) const {
+  const uint64_t bytes = shape.elements() * fl::getTypeSize(type);
+  if (offset + bytes > dataSize_) {
+    throw std::runtime_error(
+        "loadMapped - tensor data is out of bounds of the data section");
+  }
+  if (bytes == 0) {
+    return Tensor(shape, type);
+  }
+  auto tensor = Tensor::fromBuffer(shape, type, data_ + offset, Location::Host);
+  // The backend copied the data, so its pages no longer need to be resident
+  file_->release(data_ + offset, bytes);
+  return tensor;
+}
+
+MappedModelReader* MappedModelReader::current() {
+  return currentReader;
+}
+
+} // namespace detail
+
+bool isMappedModelFile(const fs::path& filepath) {
+  std::ifstream file(filepath, std::ios::binary);
+  char magic[sizeof(detail::kMappedMagic)];
+  if (!file.read(magic, sizeof(magic))) {
+    return false;
+  }
+  return std::memcmp(magic, detail::kMappedMagic, sizeof(magic)) == 0;
+}
+
+} // namespace fl
@@ -15,6 +15,7 @@
 #include <iostream>
 #include <type_traits>
 
+#include "flashlight/fl/common/Defines.h"
 #include "flashlight/fl/common/Filesystem.h"
 #include "flashlight/fl/tensor/TensorBase.h"
 
@@ -81,6 +82,50 @@ void load(const fs::path& filepath, Args&... args);
 template <typename... Args>
 void load(std::istream& istr, Args&... args);
 
+/**
+ * Save (serialize) the specified args to a memory-mappable model file.
+ *
+ * The file starts with a small header, followed by a data section holding
+ * the raw contents of every tensor, each aligned to `kMappedTensorAlignment`
+ * bytes, and ends with the cereal stream describing the objects, in which
+ * tensors are replaced by references into the data section. Tensors are
+ * copied to host and written one at a time. The file is written next to
+ * `filepath` and renamed once complete, so an interrupted save leaves any
+ * existing file in place.
+ *
+ * @param filepath the file path to save to
+ * @param args the objects to save (e.g. shared_ptr to Module)
+ */
+template <typename... Args>
+void saveMapped(const fs::path& filepath, const Args&... args);
+
+/**
+ * Load (deserialize) the specified args from a file saved by `saveMapped`.
+ *
+ * The file is mapped into memory rather than read: only the metadata stream
+ * is parsed, and each tensor is created from the pages of the mapping which
+ * hold its data, without the intermediate host buffer `load` reads it into.
+ * Loading is not zero-copy: the backend copies each tensor into memory it
+ * owns, so a loaded model takes as much memory as with `load`. Pages of the
+ * mapping are released once copied, so the mapping itself holds little
+ * memory beyond the tensor being loaded.
+ *
+ * @param filepath the file path to load from
+ * @param args the objects to load (expects default-constructed)
+ */
+template <typename... Args>
+void loadMapped(const fs::path& filepath, Args&... args);
+
+/**
+ * @return whether the file at `filepath` was saved with `saveMapped`
+ */
+FL_API bool isMappedModelFile(const fs::path& filepath);
+
+/**
+ * Alignment in bytes of tensor data in files saved by `saveMapped`.
+ */
+constexpr std::size_t kMappedTensorAlignment = 64;
+
 /** @} */
 } // namespace fl
 
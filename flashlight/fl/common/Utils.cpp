@@ -11,6 +11,7 @@
 #include <cinttypes>
 #include <cstdio>
 #include <ctime>
+#include <iomanip>
 #include <sstream>
 #include <stdexcept>
 #include <unordered_map>
@@ -170,6 +171,34 @@ std::string prettyStringCount(size_t count) {
   return ss.str();
 }
 
+std::string jsonEscape(const std::string& str) {
+  std::ostringstream ss;
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        ss << "\\\"";
+        break;
+      case '\\':
+        ss << "\\\\";
+        break;
+      case '\n':
+        ss << "\\n";
+        break;
+      case '\t':
+        ss << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          ss << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+             << static_cast<int>(c) << std::dec;
+        } else {
+          ss << c;
+        }
+    }
+  }
+  return ss.str();
+}
+
 std::string getEnvVar(
     const std::string& key,
     const std::string& dflt /*= "" */) {
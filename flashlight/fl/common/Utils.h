@@ -44,6 +44,9 @@ FL_API std::string prettyStringMemorySize(size_t size);
 // Returns a string formatted similar to: 26675644(2m+667k+5644)
 FL_API std::string prettyStringCount(size_t count);
 
+// Escapes a string to be written between quotes in a JSON document.
+FL_API std::string jsonEscape(const std::string& str);
+
 /**
  * Calls `f(args...)` repeatedly, retrying if an exception is thrown.
  * Supports sleeps between retries, with duration starting at `initial` and
@@ -12,10 +12,32 @@
 
 #include "flashlight/fl/autograd/Functions.h"
 #include "flashlight/fl/nn/Init.h"
+#include "flashlight/fl/nn/Utils.h"
 #include "flashlight/fl/tensor/Index.h"
 
 namespace fl {
 
+namespace {
+
+// Looks up rows of a [N, D] table as [D, K] embeddings. Unlike a lookup in the
+// reordered table, the gradient of the table is row-sparse.
+Variable lookupRows(const Variable& indices, const Variable& table) {
+  auto result = fl::transpose(table.tensor()(indices.tensor().flatten()));
+
+  auto gradFunc = [](std::vector<Variable>& inputs,
+                     const Variable& gradOutput) {
+    auto& table = inputs[1];
+    if (!table.isCalcGrad()) {
+      return;
+    }
+    table.addSparseGrad(
+        fl::transpose(gradOutput.tensor()), inputs[0].tensor().flatten(), 0);
+  };
+  return Variable(result, {indices, table}, gradFunc);
+}
+
+} // namespace
+
 AdaptiveEmbedding::AdaptiveEmbedding(
     int embeddingDim,
     std::vector<int> cutoff,
@@ -49,6 +71,21 @@ AdaptiveEmbedding::AdaptiveEmbedding(
   }
 }
 
+Variable AdaptiveEmbedding::lookup(const Variable& indices, int bucket) const {
+  int offset = bucket > 0 ? cutoff_[bucket - 1] : 0;
+  const auto& table = params_[bucket * 2];
+  if (!isQuantized()) {
+    return lookupRows(indices - offset, table);
+  }
+  // Only dequantize the rows which are looked up
+  auto idxs = indices.tensor().flatten();
+  auto rows = dequantize(
+      table.tensor()(idxs - offset),
+      embeddingScales_(idxs),
+      fl::dtype::f32);
+  return Variable(fl::transpose(rows), false);
+}
+
 Variable AdaptiveEmbedding::forward(const Variable& input) {
   if (input.ndim() != 2) {
     throw std::invalid_argument(
@@ -62,8 +99,7 @@ Variable AdaptiveEmbedding::forward(const Variable& input) {
 
   Tensor headMask = flatInput.tensor() < cutoff_[0];
   if (fl::sum(headMask).scalar<unsigned>() > 0) {
-    auto headEmbedding =
-        embedding(flatInput(headMask), reorder(params_[0], {1, 0}));
+    auto headEmbedding = lookup(flatInput(headMask), 0);
     headEmbedding = matmul(params_[1], headEmbedding);
     indices.emplace_back(fl::nonzero(headMask), false);
     embeddings.push_back(headEmbedding);
@@ -73,9 +109,7 @@ Variable AdaptiveEmbedding::forward(const Variable& input) {
     Tensor tailMask = flatInput.tensor() < cutoff_[tailIdx] &&
         flatInput.tensor() >= cutoff_[tailIdx - 1];
     if (fl::any(tailMask).asScalar<bool>()) {
-      auto tailEmbedding = embedding(
-          flatInput(tailMask) - cutoff_[tailIdx - 1],
-          reorder(params_[tailIdx * 2], {1, 0}));
+      auto tailEmbedding = lookup(flatInput(tailMask), tailIdx);
       tailEmbedding = matmul(params_[tailIdx * 2 + 1], tailEmbedding);
       indices.emplace_back(fl::nonzero(tailMask), false);
       embeddings.push_back(tailEmbedding);
@@ -93,6 +127,26 @@ Variable AdaptiveEmbedding::forward(const Variable& input) {
   return moddims(result(fl::span, tmpIndices), outShape);
 }
 
+void AdaptiveEmbedding::quantizeWeights() {
+  if (isQuantized()) {
+    return;
+  }
+  std::vector<Tensor> scales;
+  for (int bucket = 0; bucket < cutoff_.size(); ++bucket) {
+    auto [quantized, bucketScales] =
+        quantizePerChannel(params_[bucket * 2].tensor(), 0);
+    params_[bucket * 2].tensor() = quantized;
+    params_[bucket * 2].setCalcGrad(false);
+    scales.push_back(bucketScales);
+  }
+  // Indexed by token, so that tail lookups don't need an offset
+  embeddingScales_ = fl::concatenate(scales, 0);
+}
+
+bool AdaptiveEmbedding::isQuantized() const {
+  return !embeddingScales_.isEmpty();
+}
+
 std::string AdaptiveEmbedding::prettyString() const {
   std::ostringstream ss;
   ss << "AdaptiveEmbedding (dim: " << embeddingDim_ << "), (cutoff: ";
@@ -101,6 +155,9 @@ std::string AdaptiveEmbedding::prettyString() const {
   }
   ss << cutoff_[cutoff_.size() - 1] << "), "
      << "(divValue: " << divValue_ << ")";
+  if (isQuantized()) {
+    ss << " (quantized)";
+  }
   return ss.str();
 }
 
@@ -25,8 +25,17 @@ class FL_API AdaptiveEmbedding : public UnaryModule {
   int embeddingDim_;
   std::vector<int> cutoff_;
   float divValue_;
+  // Per token scales of the head and tail embeddings, if quantized
+  Tensor embeddingScales_;
 
-  FL_SAVE_LOAD_WITH_BASE(UnaryModule, embeddingDim_, cutoff_, divValue_)
+  FL_SAVE_LOAD_WITH_BASE(
+      UnaryModule,
+      embeddingDim_,
+      cutoff_,
+      divValue_,
+      fl::versioned(embeddingScales_, 1))
+
+  Variable lookup(const Variable& indices, int bucket) const;
 
  public:
   /**
@@ -52,9 +61,23 @@ class FL_API AdaptiveEmbedding : public UnaryModule {
 
   Variable forward(const Variable& input) override;
 
+  /**
+   * Quantizes each head and tail embedding to 8 bits for inference. The
+   * projections, which are small compared to the dictionaries, are kept in
+   * full precision. The embeddings are no longer trainable, and mustn't be
+   * shared with other modules.
+   */
+  void quantizeWeights();
+
+  /**
+   * @return whether the embeddings are quantized
+   */
+  bool isQuantized() const;
+
   std::string prettyString() const override;
 };
 
 } // namespace fl
 
 CEREAL_REGISTER_TYPE(fl::AdaptiveEmbedding)
+CEREAL_CLASS_VERSION(fl::AdaptiveEmbedding, 1)
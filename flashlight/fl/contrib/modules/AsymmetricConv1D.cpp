@@ -68,33 +68,9 @@ Variable AsymmetricConv1D::forward(const Variable& input) {
   if (!(px >= 0)) {
     throw std::invalid_argument("invalid padding for AsymmetricConv1D");
   }
-  Variable output;
   int cutPx = std::abs(2 * (0.5 - futurePart_)) * px;
   int asymmetryPx = px + cutPx;
-  if (bias_) {
-    output = conv2d(
-        input,
-        params_[0],
-        params_[1],
-        xStride_,
-        yStride_,
-        asymmetryPx,
-        0,
-        xDilation_,
-        yDilation_,
-        groups_);
-  } else {
-    output = conv2d(
-        input,
-        params_[0],
-        xStride_,
-        yStride_,
-        asymmetryPx,
-        0,
-        xDilation_,
-        yDilation_,
-        groups_);
-  }
+  auto output = convolve(input, asymmetryPx, 0);
   if (futurePart_ < 0.5) {
     output = output(fl::range(0, output.dim(0) - 2 * cutPx));
   } else if (futurePart_ > 0.5) {
@@ -103,6 +79,10 @@ Variable AsymmetricConv1D::forward(const Variable& input) {
   return output;
 }
 
+float AsymmetricConv1D::futurePart() const {
+  return futurePart_;
+}
+
 std::string AsymmetricConv1D::prettyString() const {
   std::ostringstream ss;
   ss << "AsymmetricConv1D";
@@ -52,6 +52,11 @@ class FL_API AsymmetricConv1D : public fl::Conv2D {
 
   fl::Variable forward(const fl::Variable& input) override;
 
+  /**
+   * @return the part of the padding applied to the future (right) side
+   */
+  float futurePart() const;
+
   std::string prettyString() const override;
 
  private:
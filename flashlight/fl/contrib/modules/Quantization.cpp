@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/contrib/modules/Quantization.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "flashlight/fl/contrib/modules/AdaptiveEmbedding.h"
+#include "flashlight/fl/nn/modules/Container.h"
+#include "flashlight/fl/nn/modules/Conv2D.h"
+#include "flashlight/fl/nn/modules/Embedding.h"
+#include "flashlight/fl/nn/modules/Linear.h"
+
+namespace fl {
+
+namespace {
+
+// Collects the distinct modules of a model which aren't containers
+void collectLeaves(
+    const std::shared_ptr<Module>& module,
+    std::unordered_set<const Module*>& seen,
+    std::vector<std::shared_ptr<Module>>& leaves) {
+  if (!module || !seen.insert(module.get()).second) {
+    return;
+  }
+  if (auto container = std::dynamic_pointer_cast<Container>(module)) {
+    for (const auto& child : container->modules()) {
+      collectLeaves(child, seen, leaves);
+    }
+    return;
+  }
+  leaves.push_back(module);
+}
+
+// Returns the indices of the parameters of a module replaced by quantization
+std::vector<int> quantizedParams(const std::shared_ptr<Module>& module) {
+  // Conv2D subclasses such as AsymmetricConv1D are quantized as well
+  if (std::dynamic_pointer_cast<Linear>(module) ||
+      std::dynamic_pointer_cast<Conv2D>(module) ||
+      std::dynamic_pointer_cast<Embedding>(module)) {
+    return {0};
+  }
+  if (std::dynamic_pointer_cast<AdaptiveEmbedding>(module)) {
+    // Embedding tables and projections alternate
+    std::vector<int> tables;
+    for (int i = 0; i < static_cast<int>(module->params().size()); i += 2) {
+      tables.push_back(i);
+    }
+    return tables;
+  }
+  return {};
+}
+
+template <typename T>
+bool quantizeIf(const std::shared_ptr<Module>& module) {
+  auto typed = std::dynamic_pointer_cast<T>(module);
+  if (!typed || typed->isQuantized()) {
+    return false;
+  }
+  typed->quantizeWeights();
+  return true;
+}
+
+} // namespace
+
+int quantizeWeights(
+    const std::shared_ptr<Module>& module,
+    const std::vector<std::shared_ptr<Module>>& sharedWith) {
+  std::unordered_set<const Module*> seen;
+  std::vector<std::shared_ptr<Module>> leaves;
+  collectLeaves(module, seen, leaves);
+  // Modules of the model passed again are only counted once
+  std::vector<std::shared_ptr<Module>> sharingLeaves;
+  for (const auto& other : sharedWith) {
+    collectLeaves(other, seen, sharingLeaves);
+  }
+
+  // Parameters are identified by their data, which copies share
+  std::unordered_map<const Tensor*, int> uses;
+  for (const auto* modules : {&leaves, &sharingLeaves}) {
+    for (const auto& leaf : *modules) {
+      for (const auto& param : leaf->params()) {
+        ++uses[&param.tensor()];
+      }
+    }
+  }
+  // Checked before quantizing anything so that the model is left as is
+  for (const auto& leaf : leaves) {
+    for (int i : quantizedParams(leaf)) {
+      if (uses[&leaf->param(i).tensor()] > 1) {
+        throw std::invalid_argument(
+            "quantizeWeights: can't quantize weights shared with another "
+            "module, e.g. tied embeddings, in " +
+            leaf->prettyString());
+      }
+    }
+  }
+
+  int count = 0;
+  for (const auto& leaf : leaves) {
+    bool quantized = quantizeIf<Linear>(leaf) || quantizeIf<Conv2D>(leaf) ||
+        quantizeIf<Embedding>(leaf) || quantizeIf<AdaptiveEmbedding>(leaf);
+    count += quantized ? 1 : 0;
+  }
+  return count;
+}
+
+int calibrateActivations(
+    const std::shared_ptr<Module>& module,
+    const Dataset& dataset,
+    int inputIdx,
+    int64_t numSamples) {
+  std::unordered_set<const Module*> seen;
+  std::vector<std::shared_ptr<Module>> leaves;
+  collectLeaves(module, seen, leaves);
+  std::vector<std::shared_ptr<Linear>> linears;
+  std::vector<std::shared_ptr<Conv2D>> convs;
+  for (const auto& leaf : leaves) {
+    if (auto linear = std::dynamic_pointer_cast<Linear>(leaf)) {
+      if (linear->isQuantized()) {
+        linears.push_back(linear);
+      }
+    } else if (auto conv = std::dynamic_pointer_cast<Conv2D>(leaf)) {
+      if (conv->isQuantized()) {
+        convs.push_back(conv);
+      }
+    }
+  }
+  auto setCalibrating = [&](bool calibrating) {
+    for (auto& linear : linears) {
+      linear->setCalibrating(calibrating);
+    }
+    for (auto& conv : convs) {
+      conv->setCalibrating(calibrating);
+    }
+  };
+
+  const int64_t size =
+      numSamples < 0 ? dataset.size() : std::min(numSamples, dataset.size());
+  module->eval();
+  setCalibrating(true);
+  try {
+    for (int64_t i = 0; i < size; ++i) {
+      auto sample = dataset.get(i);
+      if (inputIdx < 0 || inputIdx >= static_cast<int>(sample.size())) {
+        throw std::invalid_argument(
+            "calibrateActivations: no input at index " +
+            std::to_string(inputIdx) + " of dataset samples");
+      }
+      module->forward({Variable(sample[inputIdx], false)});
+    }
+  } catch (...) {
+    setCalibrating(false);
+    throw;
+  }
+  setCalibrating(false);
+
+  int count = 0;
+  for (const auto& linear : linears) {
+    count += linear->isCalibrated() ? 1 : 0;
+  }
+  for (const auto& conv : convs) {
+    count += conv->isCalibrated() ? 1 : 0;
+  }
+  return count;
+}
+
+} // namespace fl
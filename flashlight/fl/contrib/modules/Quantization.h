@@ -0,0 +1,72 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "flashlight/fl/common/Defines.h"
+#include "flashlight/fl/dataset/Dataset.h"
+#include "flashlight/fl/nn/modules/Module.h"
+
+namespace fl {
+
+/**
+ * Quantizes the weights of all `Linear`, `Conv2D`, `Embedding` and
+ * `AdaptiveEmbedding` modules in a model to 8 bits for inference, recursing
+ * into containers. Quantization is per output channel and needs no data.
+ * Quantized weights are stored as `u8` with a zero point of
+ * `kQuantizedZeroPoint`, and are serialized with the model.
+ *
+ * By itself, quantization only reduces the memory and storage taken by
+ * weights: `Linear` and `Conv2D` dequantize their full weight for each
+ * forward, and embeddings the rows looked up. Calibrating the range of their
+ * inputs with `calibrateActivations` then lets `Linear` and `Conv2D` compute
+ * in 8-bit integer arithmetic on backends supporting it (oneDNN). The model
+ * should only be used for inference after quantization.
+ *
+ * Weights shared between modules, e.g. tied input and output embeddings,
+ * can't be quantized, as the modules sharing them would see quantized data.
+ * Sharing is only detected among `module` and `sharedWith`: pass the other
+ * modules using parameters of the model, e.g. a criterion such as
+ * `AdaptiveSoftMaxLoss` tied to an embedding. Parameters held elsewhere must
+ * not be weights of the model.
+ *
+ * @param[in] module the model to quantize
+ * @param[in] sharedWith other modules, which aren't quantized, that may share
+ * parameters with the model
+ * @return the number of modules which were quantized
+ * @throws std::invalid_argument if a weight to quantize is shared by several
+ * modules, in which case nothing is quantized
+ */
+FL_API int quantizeWeights(
+    const std::shared_ptr<Module>& module,
+    const std::vector<std::shared_ptr<Module>>& sharedWith = {});
+
+/**
+ * Calibrates the range of the inputs of the quantized `Linear` and `Conv2D`
+ * modules of a model so that they compute in 8-bit integer arithmetic (see
+ * `Linear::setCalibrating`). Runs the model in eval mode, which it's left
+ * in, on the input field of samples of a dataset, e.g. of the batches of a
+ * `BatchDataset`. Inputs are quantized over the largest range seen.
+ *
+ * @param[in] module the model, whose weights were quantized by
+ * `quantizeWeights`
+ * @param[in] dataset samples representative of the inputs at inference
+ * @param[in] inputIdx the index of the input of the model in the samples
+ * @param[in] numSamples the number of samples to calibrate with, or all of
+ * them if negative
+ * @return the number of quantized modules whose input range is calibrated
+ */
+FL_API int calibrateActivations(
+    const std::shared_ptr<Module>& module,
+    const Dataset& dataset,
+    int inputIdx = 0,
+    int64_t numSamples = -1);
+
+} // namespace fl
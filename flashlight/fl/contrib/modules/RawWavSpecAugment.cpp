@@ -5,6 +5,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 #include <stdexcept>
@@ -28,7 +29,8 @@ RawWavSpecAugment::RawWavSpecAugment(
     int highFreqHz /* 8000 */,
     int sampleRate /* 16000 */,
     int maxKernelSize /* 20000 */,
-    MaskingStrategy mStrategy /* = MaskingStrategy::ZERO */)
+    MaskingStrategy mStrategy /* = MaskingStrategy::ZERO */,
+    bool perUtterance /* = false */)
     : timeWarpW_(tWarpW),
       freqMaskF_(fMaskF),
       numFreqMask_(nFMask),
@@ -40,7 +42,8 @@ RawWavSpecAugment::RawWavSpecAugment(
       rawWavLowFreqHz_(lowFreqHz),
       rawWavHighFreqHz_(highFreqHz),
       rawWavSampleRate_(sampleRate),
-      maxKernelSize_(maxKernelSize) {
+      maxKernelSize_(maxKernelSize),
+      perUtterance_(perUtterance) {
   if (numFreqMask_ > 0 && freqMaskF_ <= 0) {
     throw std::invalid_argument("invalid arguments for frequency masking.");
   }
@@ -125,6 +128,22 @@ void RawWavSpecAugment::precomputeFilters() {
   }
 }
 
+Tensor RawWavSpecAugment::bandStopKernel(int low, int high) const {
+  // Low pass kernels have odd sizes and are centered: pad them to the same size
+  auto highKernel = lowPassFilters_[high]->param(0).tensor();
+  auto lowKernel = lowPassFilters_[low]->param(0).tensor();
+  int size = std::max(highKernel.dim(0), lowKernel.dim(0));
+  auto padTo = [size](const Tensor& kernel) {
+    int padding = (size - kernel.dim(0)) / 2;
+    return fl::pad(kernel, {{padding, padding}});
+  };
+  // Subtracting the band between the cutoffs from the input is the same as
+  // filtering with an identity kernel minus the band pass kernel
+  auto kernel = padTo(lowKernel) - padTo(highKernel);
+  kernel(size / 2) += 1;
+  return kernel;
+}
+
 Variable RawWavSpecAugment::forward(const Variable& input) {
   if (input.isCalcGrad()) {
     throw std::invalid_argument(
@@ -155,29 +174,42 @@ Variable RawWavSpecAugment::forward(const Variable& input) {
     auto high =
         generateRandomInt(low, std::min(rawWavNMels_, low + freqMaskF_) + 1);
     if (high > low) {
-      auto inputForFilter = fl::moddims(output, timeView);
-      auto midLowWav = lowPassFilters_[high]->forward(inputForFilter);
-      auto lowWav = lowPassFilters_[low]->forward(inputForFilter);
-      output = output - fl::moddims(midLowWav - lowWav, inputCast.shape());
+      auto kernel = bandStopKernel(low, high).astype(output.type());
+      auto filtered = fl::conv2d(
+          fl::moddims(output, timeView),
+          Variable(fl::reshape(kernel, {kernel.dim(0), 1, 1, 1}), false),
+          /* sx = */ 1,
+          /* sy = */ 1,
+          /* px = */ kernel.dim(0) / 2);
+      output = fl::moddims(filtered, inputCast.shape());
     }
   }
 
-  double replaceVal = (maskStrategy_ == MaskingStrategy::GLOBAL_MEAN)
-      ? fl::mean(inputCast.tensor()).asScalar<double>()
-      : 0.0;
+  // The mean stays on the device
+  Tensor replaceVal;
+  if (maskStrategy_ == MaskingStrategy::GLOBAL_MEAN) {
+    replaceVal = fl::mean(inputCast.tensor());
+  }
 
-  auto& opArr = output.tensor();
+  constexpr int kBatchAxis = 2;
   auto numTimeSteps = inputCast.dim(0); // number of time steps
   // an upper bound on the time mask
   int T = std::min(timeMaskT_, static_cast<int>(numTimeSteps * timeMaskP_));
+  const int numUtterances = perUtterance_ ? inputCast.dim(kBatchAxis) : 1;
+  std::vector<detail::SpecAugmentMask> timeMasks(numUtterances);
   if (T > 0) {
-    for (int i = 0; i < numTimeMask_; ++i) {
-      auto t = generateRandomInt(0, T);
-      auto t0 = generateRandomInt(0, numTimeSteps - t);
-      opArr(fl::range(t0, t0 + t + 1)) = replaceVal;
+    for (int b = 0; b < numUtterances; ++b) {
+      for (int i = 0; i < numTimeMask_; ++i) {
+        auto t = generateRandomInt(0, T);
+        auto t0 = generateRandomInt(0, numTimeSteps - t);
+        timeMasks[b].emplace_back(t0, t0 + t + 1);
+      }
     }
   }
-  return output;
+  return Variable(
+      detail::applySpecAugmentMasks(
+          output.tensor(), kBatchAxis, timeMasks, {}, replaceVal),
+      false);
 }
 
 int RawWavSpecAugment::generateRandomInt(int low, int high) {
@@ -9,6 +9,7 @@
 
 #include <random>
 
+#include "flashlight/fl/contrib/modules/SpecAugment.h"
 #include "flashlight/fl/nn/nn.h"
 
 namespace fl {
@@ -29,6 +30,11 @@ namespace fl {
  * is measured in number of input frames: there are sampleRate frames in 1s
  * audio, e.g. 50 frames for time masking of standard specAug corresponds to
  *8000 frames (in case of 16kHz audio) for time masking with raw wave specaug
+ *
+ * Each frequency mask is applied with a single (band stop) filter, and all
+ * time masks at once. With `perUtterance`, time masks are drawn for each
+ * utterance (the 2nd axis) of a T x C x B input, else they're shared by the
+ * batch. Frequency masks are always shared by the batch
  **/
 class FL_API RawWavSpecAugment : public UnaryModule {
  public:
@@ -50,7 +56,8 @@ class FL_API RawWavSpecAugment : public UnaryModule {
       int highFreqHz = 8000,
       int sampleRate = 16000,
       int maxKernelSize = 20000,
-      MaskingStrategy mStrategy = MaskingStrategy::ZERO);
+      MaskingStrategy mStrategy = MaskingStrategy::ZERO,
+      bool perUtterance = false);
 
   Variable forward(const Variable& input) override;
   std::string prettyString() const override;
@@ -73,6 +80,7 @@ class FL_API RawWavSpecAugment : public UnaryModule {
 
   std::mt19937 eng_{0};
   MaskingStrategy maskStrategy_;
+  bool perUtterance_{false};
 
   int rawWavNMels_;
   int rawWavLowFreqHz_;
@@ -89,6 +97,9 @@ class FL_API RawWavSpecAugment : public UnaryModule {
 
   Tensor lowPassFilter(int freq, Tensor wav);
 
+  // Kernel removing frequencies between the cutoffs of two low pass filters
+  Tensor bandStopKernel(int low, int high) const;
+
   RawWavSpecAugment() = default;
 
   FL_SAVE_LOAD_DECLARE()
@@ -108,11 +119,12 @@ void RawWavSpecAugment::save(Archive& ar, const uint32_t /* version */) const {
      rawWavLowFreqHz_,
      rawWavHighFreqHz_,
      rawWavSampleRate_,
-     maxKernelSize_);
+     maxKernelSize_,
+     perUtterance_);
 }
 
 template <class Archive>
-void RawWavSpecAugment::load(Archive& ar, const uint32_t /* version */) {
+void RawWavSpecAugment::load(Archive& ar, const uint32_t version) {
   ar(cereal::base_class<Module>(this),
      timeWarpW_,
      freqMaskF_,
@@ -126,9 +138,13 @@ void RawWavSpecAugment::load(Archive& ar, const uint32_t /* version */) {
      rawWavHighFreqHz_,
      rawWavSampleRate_,
      maxKernelSize_);
+  if (version >= 1) {
+    ar(perUtterance_);
+  }
   precomputeFilters();
 }
 
 } // namespace fl
 
 CEREAL_REGISTER_TYPE(fl::RawWavSpecAugment)
+CEREAL_CLASS_VERSION(fl::RawWavSpecAugment, 1)
@@ -5,14 +5,98 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
 #include <sstream>
 #include <stdexcept>
+#include <string>
 
 #include "flashlight/fl/contrib/modules/SpecAugment.h"
 
 #include "flashlight/fl/tensor/Index.h"
 
 namespace fl {
+namespace detail {
+
+namespace {
+
+constexpr int kSpecAugmentBatchAxis = 3;
+
+// Builds a tensor which is 0 in masked intervals along `axis` and 1 elsewhere,
+// of size 1 along all other axes but `batchAxis` if masks are per utterance
+Tensor buildKeepMask(
+    const std::vector<SpecAugmentMask>& masks,
+    const int axis,
+    const Dim size,
+    const int batchAxis,
+    const int ndim) {
+  const Dim numMasks = masks.size();
+  std::vector<float> keep(size * numMasks, 1.);
+  for (Dim b = 0; b < numMasks; ++b) {
+    for (const auto& [start, end] : masks[b]) {
+      auto first = std::clamp<Dim>(start, 0, size);
+      auto last = std::clamp<Dim>(end, first, size);
+      std::fill(
+          keep.begin() + b * size + first, keep.begin() + b * size + last, 0.);
+    }
+  }
+  Shape shape(std::vector<Dim>(ndim, 1));
+  shape[axis] = size;
+  if (numMasks > 1) {
+    shape[batchAxis] = numMasks;
+  }
+  return Tensor::fromVector(shape, keep);
+}
+
+bool hasMaskedIntervals(const std::vector<SpecAugmentMask>& masks) {
+  return std::any_of(masks.begin(), masks.end(), [](const auto& mask) {
+    return !mask.empty();
+  });
+}
+
+} // namespace
+
+Tensor applySpecAugmentMasks(
+    const Tensor& input,
+    const int batchAxis,
+    const std::vector<SpecAugmentMask>& timeMasks,
+    const std::vector<SpecAugmentMask>& freqMasks,
+    const Tensor& replaceVal /* = Tensor() */) {
+  const int ndim = input.ndim();
+  const Dim batchSize = batchAxis < input.ndim() ? input.dim(batchAxis) : 1;
+  for (const auto* masks : {&timeMasks, &freqMasks}) {
+    const Dim numMasks = masks->size();
+    if (numMasks > 1 && numMasks != batchSize) {
+      throw std::invalid_argument(
+          "applySpecAugmentMasks: number of masks (" +
+          std::to_string(numMasks) + ") doesn't match batch size (" +
+          std::to_string(batchSize) + ")");
+    }
+  }
+
+  // Masks are built on the host and combined into a single, broadcast keep
+  // mask, which is much smaller than the input
+  Tensor keep;
+  if (hasMaskedIntervals(timeMasks)) {
+    keep = buildKeepMask(timeMasks, 0, input.dim(0), batchAxis, ndim);
+  }
+  if (hasMaskedIntervals(freqMasks)) {
+    auto freqKeep = buildKeepMask(freqMasks, 1, input.dim(1), batchAxis, ndim);
+    keep = keep.isEmpty() ? freqKeep : keep * freqKeep;
+  }
+  if (keep.isEmpty()) {
+    return input;
+  }
+  keep = keep.astype(input.type());
+
+  // Kept values are multiplied by one, so are unchanged
+  auto output = input * keep;
+  if (!replaceVal.isEmpty()) {
+    output = output + replaceVal.astype(input.type()) * (1 - keep);
+  }
+  return output;
+}
+
+} // namespace detail
 
 SpecAugment::SpecAugment(
     int tWarpW,
@@ -21,14 +105,16 @@ SpecAugment::SpecAugment(
     int tMaskT,
     float tMaskP,
     int nTMask,
-    MaskingStrategy mStrategy /* = MaskingStrategy::ZERO */)
+    MaskingStrategy mStrategy /* = MaskingStrategy::ZERO */,
+    bool perUtterance /* = false */)
     : timeWarpW_(tWarpW),
       freqMaskF_(fMaskF),
       numFreqMask_(nFMask),
       timeMaskT_(tMaskT),
       timeMaskP_(tMaskP),
       numTimeMask_(nTMask),
-      maskStrategy_(mStrategy) {
+      maskStrategy_(mStrategy),
+      perUtterance_(perUtterance) {
   if (numFreqMask_ > 0 && freqMaskF_ <= 0) {
     throw std::invalid_argument("invalid arguments for frequency masking.");
   }
@@ -46,39 +132,52 @@ Variable SpecAugment::forward(const Variable& input) {
         "input gradient calculation is not supported for SpecAugment.");
   }
 
-  auto output = Variable(input.tensor(), false);
   if (!train_) {
-    return output;
+    return Variable(input.tensor(), false);
   }
 
-  auto& opArr = output.tensor();
-
-  double replaceVal = (maskStrategy_ == MaskingStrategy::GLOBAL_MEAN)
-      ? fl::mean(input.tensor()).asScalar<double>()
-      : 0.0;
-
   auto numFreqChans = input.dim(1); // number of frequency channels
   if (numFreqChans < freqMaskF_) {
     throw std::runtime_error("Invalid input frequency channels");
   }
-  for (int i = 0; i < numFreqMask_; ++i) {
-    auto f = generateRandomInt(0, freqMaskF_);
-    auto f0 = generateRandomInt(0, numFreqChans - f);
-    opArr(fl::span, fl::range(f0, f0 + f + 1)) = replaceVal;
-  }
-
   auto numTimeSteps = input.dim(0); // number of time steps
   // an upper bound on the time mask
   int T = std::min(timeMaskT_, static_cast<int>(numTimeSteps * timeMaskP_));
-  if (T > 0) {
-    for (int i = 0; i < numTimeMask_; ++i) {
-      auto t = generateRandomInt(0, T);
-      auto t0 = generateRandomInt(0, numTimeSteps - t);
-      opArr(fl::range(t0, t0 + t + 1)) = replaceVal;
+
+  const int numUtterances =
+      perUtterance_ && input.ndim() > detail::kSpecAugmentBatchAxis
+      ? input.dim(detail::kSpecAugmentBatchAxis)
+      : 1;
+  std::vector<detail::SpecAugmentMask> freqMasks(numUtterances);
+  std::vector<detail::SpecAugmentMask> timeMasks(numUtterances);
+  for (int b = 0; b < numUtterances; ++b) {
+    for (int i = 0; i < numFreqMask_; ++i) {
+      auto f = generateRandomInt(0, freqMaskF_);
+      auto f0 = generateRandomInt(0, numFreqChans - f);
+      freqMasks[b].emplace_back(f0, f0 + f + 1);
+    }
+    if (T > 0) {
+      for (int i = 0; i < numTimeMask_; ++i) {
+        auto t = generateRandomInt(0, T);
+        auto t0 = generateRandomInt(0, numTimeSteps - t);
+        timeMasks[b].emplace_back(t0, t0 + t + 1);
+      }
     }
   }
 
-  return output;
+  // The mean stays on the device
+  Tensor replaceVal;
+  if (maskStrategy_ == MaskingStrategy::GLOBAL_MEAN) {
+    replaceVal = fl::mean(input.tensor());
+  }
+  return Variable(
+      detail::applySpecAugmentMasks(
+          input.tensor(),
+          detail::kSpecAugmentBatchAxis,
+          timeMasks,
+          freqMasks,
+          replaceVal),
+      false);
 }
 
 int SpecAugment::generateRandomInt(int low, int high) {
@@ -8,10 +8,33 @@
 #pragma once
 
 #include <random>
+#include <utility>
+#include <vector>
 
 #include "flashlight/fl/nn/nn.h"
 
 namespace fl {
+namespace detail {
+
+/**
+ * Intervals [start, end) masked along an axis for one utterance.
+ */
+using SpecAugmentMask = std::vector<std::pair<int, int>>;
+
+/**
+ * Masks intervals of `input` along the time (0th) and frequency (1st) axes in
+ * a single pass. Masks are given per utterance, i.e. per index along
+ * `batchAxis`, or as a single mask shared by all utterances. Masked values are
+ * replaced with `replaceVal`, a scalar tensor, or zero if it's empty.
+ */
+FL_API Tensor applySpecAugmentMasks(
+    const Tensor& input,
+    int batchAxis,
+    const std::vector<SpecAugmentMask>& timeMasks,
+    const std::vector<SpecAugmentMask>& freqMasks,
+    const Tensor& replaceVal = Tensor());
+
+} // namespace detail
 
 /**
  * Implementation of SpecAugment: A Simple Data Augmentation Method
@@ -25,6 +48,10 @@ namespace fl {
  * LibriSpeech double (LD)   80        27        2     100       1.0       2
  * Switchboard mild (SM)     40        15        2      70       0.2       2
  * Switchboard strong (SS)   40        27        2      70       0.2       2
+ *
+ * All masks are applied at once. With `perUtterance`, masks are drawn for each
+ * utterance (the 3rd axis) of a T x F x C x B input, else they're shared by
+ * the batch
  **/
 class FL_API SpecAugment : public UnaryModule {
  public:
@@ -41,7 +68,8 @@ class FL_API SpecAugment : public UnaryModule {
       int tMaskT,
       float tMaskP,
       int nTMask,
-      MaskingStrategy mStrategy = MaskingStrategy::ZERO);
+      MaskingStrategy mStrategy = MaskingStrategy::ZERO,
+      bool perUtterance = false);
 
   Variable forward(const Variable& input) override;
 
@@ -53,7 +81,8 @@ class FL_API SpecAugment : public UnaryModule {
       timeMaskT_,
       timeMaskP_,
       numTimeMask_,
-      maskStrategy_)
+      maskStrategy_,
+      fl::versioned(perUtterance_, 1))
 
   std::string prettyString() const override;
 
@@ -75,6 +104,7 @@ class FL_API SpecAugment : public UnaryModule {
 
   std::mt19937 eng_{0};
   MaskingStrategy maskStrategy_;
+  bool perUtterance_{false};
 
   int generateRandomInt(int low, int high);
 
@@ -84,3 +114,4 @@ class FL_API SpecAugment : public UnaryModule {
 } // namespace fl
 
 CEREAL_REGISTER_TYPE(fl::SpecAugment)
+CEREAL_CLASS_VERSION(fl::SpecAugment, 1)
@@ -11,6 +11,7 @@
 #include "flashlight/fl/contrib/modules/AsymmetricConv1D.h"
 #include "flashlight/fl/contrib/modules/Conformer.h" 
 #include "flashlight/fl/contrib/modules/PositionEmbedding.h"
+#include "flashlight/fl/contrib/modules/Quantization.h"
 #include "flashlight/fl/contrib/modules/RawWavSpecAugment.h"
 #include "flashlight/fl/contrib/modules/Residual.h"
 #include "flashlight/fl/contrib/modules/SinusoidalPositionEmbedding.h"
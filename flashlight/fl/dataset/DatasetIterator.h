@@ -9,6 +9,8 @@
 
 #include <iterator>
 
+#include "flashlight/fl/tensor/Profile.h"
+
 namespace fl {
 namespace detail {
 
@@ -46,6 +48,7 @@ class DatasetIterator {
 
   // Dereferencable
   reference operator*() {
+    FL_PROFILE_TRACE_STATIC("Dataset::get");
     buffer_ = dataset_->get(idx_);
     return buffer_;
   }
@@ -11,6 +11,7 @@
 #include "flashlight/fl/common/Serialization.h"
 #include "flashlight/fl/dataset/PrefetchDataset.h"
 #include "flashlight/fl/tensor/Compute.h"
+#include "flashlight/fl/tensor/Profile.h"
 
 namespace fl {
 
@@ -56,8 +57,10 @@ std::vector<Tensor> PrefetchDataset::get(int64_t idx) const {
     if (fetchIdx >= size()) {
       break;
     }
-    prefetchCache_.emplace(threadPool_->enqueue(
-        [this, fetchIdx]() { return this->dataset_->get(fetchIdx); }));
+    prefetchCache_.emplace(threadPool_->enqueue([this, fetchIdx]() {
+      FL_PROFILE_TRACE_STATIC("PrefetchDataset::prefetch");
+      return this->dataset_->get(fetchIdx);
+    }));
   }
 
   auto curSample = prefetchCache_.front().get();
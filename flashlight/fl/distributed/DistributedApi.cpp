@@ -7,7 +7,10 @@
 
 #include "flashlight/fl/distributed/DistributedApi.h"
 
+#include <vector>
+
 #include "flashlight/fl/common/Defines.h"
+#include "flashlight/fl/tensor/Index.h"
 #include "flashlight/fl/tensor/TensorBase.h"
 
 namespace fl {
@@ -24,10 +27,35 @@ FL_API void
 allReduce(Variable& var, double scale /* = 1.0 */, bool async /* = false */) {
   if (getWorldSize() > 1) {
     allReduce(var.tensor(), async);
+    // Other processes may have had other nonzero rows
+    var.setDense();
   }
   var.tensor() *= scale;
 }
 
+FL_API void
+allReduceRowSparse(Variable& var, int axis, double scale /* = 1.0 */) {
+  if (getWorldSize() == 1) {
+    var.tensor() *= scale;
+    return;
+  }
+  bool sparse = var.isRowSparse() && var.sparseRowAxis() == axis;
+  auto mask = fl::full({var.dim(axis)}, sparse ? 0 : 1, fl::dtype::f32);
+  if (sparse && !var.sparseRows().isEmpty()) {
+    mask(var.sparseRows()) = 1;
+  }
+  allReduce(mask);
+  auto rows = fl::nonzero(mask);
+  if (!rows.isEmpty()) {
+    std::vector<Index> index(var.ndim(), fl::span);
+    index[axis] = rows;
+    auto slices = var.tensor()(index).copy();
+    allReduce(slices);
+    var.tensor()(index) = slices * scale;
+  }
+  var.setRowSparse(rows, axis);
+}
+
 FL_API void allReduceMultiple(
     std::vector<Variable> vars,
     double scale /* = 1.0 */,
@@ -42,6 +70,9 @@ FL_API void allReduceMultiple(
     allReduceMultiple(arrs, async, contiguous);
   }
   for (auto& var : vars) {
+    if (getWorldSize() > 1) {
+      var.setDense();
+    }
     var.tensor() *= scale;
   }
 }
@@ -70,6 +70,21 @@ FL_API int getWorldSize();
  */
 FL_API void allReduce(Variable& var, double scale = 1.0, bool async = false);
 
+/**
+ * Synchronizes a row-sparse Variable, e.g. the gradient of an embedding table,
+ * with allreduce. Processes first agree on the union of their nonzero rows
+ * with an allreduce of size ``var.dim(axis)``, then only reduce those rows.
+ * The result is row-sparse with the union of the rows.
+ *
+ * All processes must call this for the same Variables and axes. Dense
+ * Variables take part with all their rows.
+ *
+ * @param[in] var a Variable which will be synchronized
+ * @param[in] axis the axis along which the Variable is row-sparse
+ * @param[in] scale scale the Variable after allreduce by this factor
+ */
+FL_API void allReduceRowSparse(Variable& var, int axis, double scale = 1.0);
+
 /**
  * Synchronizes a single Flashlight array with allreduce.
  *
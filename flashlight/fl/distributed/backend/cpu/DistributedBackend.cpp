@@ -21,6 +21,7 @@
 
 #include "flashlight/fl/common/DevicePtr.h"
 #include "flashlight/fl/distributed/LRUCache.h"
+#include "flashlight/fl/tensor/Profile.h"
 #include "flashlight/fl/tensor/TensorBase.h"
 
 namespace {
@@ -102,6 +103,7 @@ void distributedInit(
 }
 
 void allReduce(fl::Tensor& tensor, bool async /* = false */) {
+  FL_PROFILE_TRACE_STATIC("allReduce");
   if (!isDistributedInit()) {
     throw std::runtime_error("distributed environment not initialized");
   }
@@ -145,6 +147,7 @@ void allReduceMultiple(
     std::vector<fl::Tensor*> tensors,
     bool async /* = false */,
     bool contiguous /* = false */) {
+  FL_PROFILE_TRACE_STATIC("allReduceMultiple");
   if (contiguous) {
     throw std::runtime_error(
         "contiguous allReduceMultiple is not yet supported for Gloo backend");
@@ -22,6 +22,7 @@
 #include "flashlight/fl/runtime/CUDAUtils.h"
 #include "flashlight/fl/runtime/DeviceManager.h"
 #include "flashlight/fl/tensor/Compute.h"
+#include "flashlight/fl/tensor/Profile.h"
 #include "flashlight/fl/tensor/Types.h"
 
 #define NCCLCHECK(expr) ::fl::detail::ncclCheck((expr))
@@ -110,6 +111,7 @@ void allReduceCuda(
 } // namespace detail
 
 void allReduce(Tensor& arr, bool async /* = false */) {
+  FL_PROFILE_TRACE_STATIC("allReduce");
   if (!isDistributedInit()) {
     throw std::runtime_error("distributed environment not initialized");
   }
@@ -128,6 +130,7 @@ void allReduceMultiple(
     std::vector<Tensor*> arrs,
     bool async /* = false */,
     bool contiguous /* = false */) {
+  FL_PROFILE_TRACE_STATIC("allReduceMultiple");
   // Fast paths
   if (arrs.empty()) {
     return;
@@ -231,6 +234,7 @@ void allReduceMultiple(
  * operations currently running in the NCCL [and worker] CUDA stream.
  */
 void syncDistributed() {
+  FL_PROFILE_TRACE_STATIC("syncDistributed");
   const auto& ncclContext = detail::NcclContext::getInstance();
   const auto& manager = DeviceManager::getInstance();
   const auto& activeCudaDevice = manager.getActiveDevice(DeviceType::CUDA);
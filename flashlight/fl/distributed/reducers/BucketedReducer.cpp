@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/distributed/reducers/BucketedReducer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+#include "flashlight/fl/distributed/DistributedApi.h"
+#include "flashlight/fl/tensor/TensorBase.h"
+
+namespace fl {
+
+BucketedReducer::BucketedReducer(
+    const std::vector<Variable>& params,
+    double scale,
+    bool async /* = true */,
+    bool contiguous /* = true */,
+    std::size_t bucketBytes /* = kCoalesceCacheSize */)
+    : scale_(scale),
+      async_(async),
+      contiguous_(contiguous),
+      params_(params),
+      paramBucket_(params.size()),
+      paramSlot_(params.size()),
+      ready_(params.size(), false),
+      rowSparseAxes_(params.size(), -1),
+      observedAxes_(params.size(), -1) {
+  // Gloo reduces synchronously, one tensor at a time
+  if (isDistributedInit() &&
+      distributedBackend() == DistributedBackend::GLOO) {
+    async_ = false;
+    contiguous_ = false;
+  }
+  if (contiguous_) {
+    bucketBytes =
+        std::min(bucketBytes, DistributedConstants::kCoalesceCacheSize);
+  }
+
+  // Gradients of the last parameters are typically computed first
+  std::size_t currBytes = 0;
+  for (std::size_t i = params_.size(); i-- > 0;) {
+    const auto& param = params_[i];
+    if (!buckets_.empty()) {
+      const auto& last = params_[i + 1];
+      // Contiguous reductions require a single type per bucket
+      if (currBytes + param.bytes() > bucketBytes ||
+          param.type() != last.type()) {
+        buckets_.emplace_back();
+        currBytes = 0;
+      }
+    } else {
+      buckets_.emplace_back();
+    }
+    auto& bucket = buckets_.back();
+    paramBucket_[i] = buckets_.size() - 1;
+    paramSlot_[i] = bucket.grads.size();
+    bucket.grads.emplace_back();
+    bucket.params.push_back(i);
+    bucket.pending++;
+    currBytes += param.bytes();
+  }
+
+  for (std::size_t i = 0; i < params_.size(); ++i) {
+    params_[i].registerGradHook(
+        [this, i](Variable& grad) { markReady(i, grad); });
+  }
+}
+
+BucketedReducer::~BucketedReducer() {
+  for (auto& param : params_) {
+    param.clearGradHook();
+  }
+}
+
+void BucketedReducer::add(Variable& var) {
+  allReduce(var, scale_, async_);
+}
+
+void BucketedReducer::finalize() {
+  // Parameters unused by this backward pass may have been used by other
+  // processes, so they take part in the reduction with a zero gradient
+  for (std::size_t i = 0; i < params_.size(); ++i) {
+    if (!ready_[i]) {
+      auto& param = params_[i];
+      if (!param.isGradAvailable()) {
+        auto zeros = Variable(fl::full(param.shape(), 0, param.type()), false);
+        if (rowSparseAxes_[i] >= 0) {
+          zeros.setRowSparse(Tensor(), rowSparseAxes_[i]);
+        }
+        param.addGrad(zeros);
+      }
+      markReady(i, param.grad());
+    }
+  }
+  if (async_ || contiguous_) {
+    syncDistributed();
+  }
+  if (!rowSparseAxesKnown_) {
+    detectRowSparseParams();
+  }
+
+  std::fill(ready_.begin(), ready_.end(), false);
+  for (auto& bucket : buckets_) {
+    std::fill(bucket.grads.begin(), bucket.grads.end(), Variable());
+    bucket.pending = bucket.grads.size();
+  }
+  nextBucket_ = 0;
+}
+
+std::size_t BucketedReducer::numBuckets() const {
+  return buckets_.size();
+}
+
+void BucketedReducer::markReady(std::size_t paramIdx, const Variable& grad) {
+  if (ready_[paramIdx]) {
+    throw std::logic_error(
+        "BucketedReducer: gradient of a parameter was computed twice "
+        "before finalize() was called");
+  }
+  ready_[paramIdx] = true;
+  if (!rowSparseAxesKnown_) {
+    observedAxes_[paramIdx] = grad.sparseRowAxis();
+  }
+  // As in CoalescingReducer, evaluating upfront lets the reduction overlap
+  // with the rest of the backward pass
+  if (async_) {
+    grad.eval();
+  }
+  auto& bucket = buckets_[paramBucket_[paramIdx]];
+  bucket.grads[paramSlot_[paramIdx]] = grad;
+  bucket.pending--;
+  reduceReadyBuckets();
+}
+
+void BucketedReducer::reduceReadyBuckets() {
+  while (nextBucket_ < buckets_.size() && buckets_[nextBucket_].pending == 0) {
+    const auto& bucket = buckets_[nextBucket_];
+    std::vector<Variable> grads;
+    for (std::size_t slot = 0; slot < bucket.grads.size(); ++slot) {
+      int axis = rowSparseAxes_[bucket.params[slot]];
+      if (axis >= 0) {
+        auto grad = bucket.grads[slot];
+        allReduceRowSparse(grad, axis, scale_);
+      } else {
+        grads.push_back(bucket.grads[slot]);
+      }
+    }
+    if (grads.size() == 1) {
+      allReduce(grads.front(), scale_, async_);
+    } else if (grads.size() > 1) {
+      allReduceMultiple(grads, scale_, async_, contiguous_);
+    }
+    ++nextBucket_;
+  }
+}
+
+void BucketedReducer::detectRowSparseParams() {
+  // Gradients are only reduced as row-sparse if they are along the same axis
+  // on all processes, so that all processes issue the same collectives
+  const auto numParams = params_.size();
+  std::vector<int> votes(2 * numParams, 0);
+  for (std::size_t i = 0; i < numParams; ++i) {
+    votes[i] = observedAxes_[i] >= 0 ? 1 : 0;
+    votes[numParams + i] = observedAxes_[i];
+  }
+  auto reduced = Tensor::fromVector(votes);
+  if (getWorldSize() > 1) {
+    allReduce(reduced);
+  }
+  auto totals = reduced.toHostVector<int>();
+  for (std::size_t i = 0; i < numParams; ++i) {
+    if (totals[i] == getWorldSize() &&
+        totals[numParams + i] == getWorldSize() * observedAxes_[i]) {
+      rowSparseAxes_[i] = observedAxes_[i];
+    }
+  }
+  rowSparseAxesKnown_ = true;
+}
+
+} // namespace fl
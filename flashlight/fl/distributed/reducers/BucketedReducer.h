@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "flashlight/fl/autograd/Variable.h"
+#include "flashlight/fl/common/Defines.h"
+#include "flashlight/fl/distributed/reducers/Reducer.h"
+
+namespace fl {
+
+/**
+ * A Reducer which overlaps gradient synchronization with the backward pass.
+ *
+ * Parameters are partitioned into buckets of at most a given size, in reverse
+ * parameter order, which is roughly the order in which the backward pass
+ * produces their gradients. The reducer registers a gradient hook on each
+ * parameter; as soon as every gradient in a bucket is final, the bucket is
+ * synchronized with ``allReduceMultiple``, while the backward pass carries on
+ * computing the gradients of the remaining buckets.
+ *
+ * Buckets are always synchronized in the same order so that every process
+ * issues the same sequence of collectives. A bucket which becomes ready before
+ * its predecessors waits for them.
+ *
+ * ``finalize`` must be called after the backward pass and before using the
+ * gradients. Parameters which did not receive a gradient during the backward
+ * pass are given a zero gradient so that their buckets can be synchronized.
+ *
+ * Parameters whose gradient was row-sparse along the same axis on every
+ * process during the first backward pass, such as embedding tables, are then
+ * synchronized with ``allReduceRowSparse``: only rows which are nonzero on some
+ * process are reduced, and gradients stay row-sparse for the optimizer.
+ */
+class FL_API BucketedReducer : public Reducer {
+ public:
+  /**
+   * Creates a new bucketed reducer and registers gradient hooks on
+   * ``params``, replacing existing hooks.
+   *
+   * @param[in] params the parameters whose gradients will be synchronized.
+   * Parameters sharing their gradient must only be listed once.
+   * @param[in] scale a scale by which to scale reduced gradients
+   * @param[in] async determines whether or not the distributed compute stream
+   * runs asynchronously to the Flashlight compute stream.
+   * @param[in] contiguous forces synchronization of each bucket to occur in a
+   * contiguous buffer. Buckets are then capped at
+   * ``DistributedConstants::kCoalesceCacheSize`` bytes.
+   *
+   * ``async`` and ``contiguous`` are ignored with the Gloo backend, which
+   * supports neither: buckets are then reduced inline, one tensor at a time.
+   * @param[in] bucketBytes the maximum size of a bucket, in bytes. A parameter
+   * larger than this forms a bucket on its own.
+   */
+  BucketedReducer(
+      const std::vector<Variable>& params,
+      double scale,
+      bool async = true,
+      bool contiguous = true,
+      std::size_t bucketBytes = DistributedConstants::kCoalesceCacheSize);
+
+  /**
+   * Destroy the Reducer. Clears the gradient hooks it registered.
+   */
+  ~BucketedReducer() override;
+
+  /**
+   * Synchronize a ``Variable`` which is not one of the reducer's parameters
+   * immediately with ``allReduce``.
+   */
+  void add(Variable& var) override;
+
+  /**
+   * Synchronize all remaining buckets and wait for pending reductions. Resets
+   * the reducer for the next backward pass.
+   */
+  void finalize() override;
+
+  /**
+   * @return the number of buckets parameters were partitioned into
+   */
+  std::size_t numBuckets() const;
+
+ private:
+  struct Bucket {
+    /// Gradients of the parameters of the bucket, filled in by hooks
+    std::vector<Variable> grads;
+    /// Number of gradients not yet available
+    std::size_t pending{0};
+    /// Indices of the parameters of the bucket
+    std::vector<std::size_t> params;
+  };
+
+  /// A scale by which to scale reduced gradients
+  double scale_;
+  /// Whether or not the distributed synchronization operates in a separate
+  /// compute stream asynchronously to the Flashlight stream
+  bool async_;
+  /// Whether each bucket is put into contiguous memory before being
+  /// synchronized
+  bool contiguous_;
+  std::vector<Variable> params_;
+  /// For each parameter, its bucket and position in the bucket
+  std::vector<std::size_t> paramBucket_;
+  std::vector<std::size_t> paramSlot_;
+  /// Whether the gradient of each parameter was received this iteration
+  std::vector<bool> ready_;
+  std::vector<Bucket> buckets_;
+  /// Index of the first bucket not yet synchronized
+  std::size_t nextBucket_{0};
+  /// For each parameter, the axis along which its gradient is synchronized as
+  /// row-sparse, or -1. Detected after the first backward pass.
+  std::vector<int> rowSparseAxes_;
+  /// Row-sparse axes of the gradients of the first backward pass
+  std::vector<int> observedAxes_;
+  bool rowSparseAxesKnown_{false};
+
+  void markReady(std::size_t paramIdx, const Variable& grad);
+
+  /**
+   * Agrees with the other processes on which parameters have row-sparse
+   * gradients.
+   */
+  void detectRowSparseParams();
+
+  /**
+   * Synchronize, in order, all complete buckets following the last
+   * synchronized bucket.
+   */
+  void reduceReadyBuckets();
+};
+
+} // namespace fl
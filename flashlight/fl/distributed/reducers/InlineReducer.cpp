@@ -13,10 +13,7 @@ namespace fl {
 InlineReducer::InlineReducer(double scale) : scale_(scale) {}
 
 void InlineReducer::add(Variable& var) {
-  if (getWorldSize() > 1) {
-    allReduce(var.tensor());
-  }
-  var.tensor() *= scale_;
+  allReduce(var, scale_);
 }
 
 } // namespace fl
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include "flashlight/fl/distributed/reducers/BucketedReducer.h"
 #include "flashlight/fl/distributed/reducers/CoalescingReducer.h"
 #include "flashlight/fl/distributed/reducers/InlineReducer.h"
 #include "flashlight/fl/distributed/reducers/Reducer.h"
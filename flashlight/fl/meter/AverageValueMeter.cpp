@@ -20,6 +20,7 @@ void AverageValueMeter::reset() {
   curMeanSquaredSum_ = 0;
   curWeightSum_ = 0;
   curWeightSquaredSum_ = 0;
+  pending_ = Tensor();
 }
 
 void AverageValueMeter::add(const double val, const double w /* = 1.0 */) {
@@ -36,25 +37,51 @@ void AverageValueMeter::add(const double val, const double w /* = 1.0 */) {
 }
 
 void AverageValueMeter::add(const Tensor& vals) {
-  double w = vals.elements();
-  curWeightSum_ += w;
-  curWeightSquaredSum_ += w;
+  // Each value has unit weight
+  const auto v = vals.flatten().astype(fl::dtype::f64);
+  const auto count =
+      fl::full({1}, static_cast<double>(vals.elements()), fl::dtype::f64);
+  accumulate(fl::concatenate(
+      0,
+      fl::reshape(fl::sum(v), {1}),
+      fl::reshape(fl::sum(v * v), {1}),
+      count,
+      count));
+}
 
-  if (curWeightSum_ == 0) {
-    return;
-  }
+void AverageValueMeter::add(const Tensor& val, const Tensor& w) {
+  const auto v = fl::reshape(val, {1}).astype(fl::dtype::f64);
+  const auto weight = fl::reshape(w, {1}).astype(fl::dtype::f64);
+  const auto weighted = weight * v;
+  accumulate(
+      fl::concatenate(0, weighted, weighted * v, weight, weight * weight));
+}
 
-  curMean_ = curMean_ +
-      (fl::sum(vals).asScalar<double>() - w * curMean_) / curWeightSum_;
-  curMeanSquaredSum_ = curMeanSquaredSum_ +
-      (fl::sum(vals * vals).asScalar<double>() - w * curMeanSquaredSum_) /
-          curWeightSum_;
+void AverageValueMeter::accumulate(const Tensor& sums) {
+  pending_ = pending_.isEmpty() ? sums : pending_ + sums;
 }
 
 std::vector<double> AverageValueMeter::value() const {
-  double mean = curMean_;
-  double var = (curMeanSquaredSum_ - curMean_ * curMean_) /
-      (1 - curWeightSquaredSum_ / (curWeightSum_ * curWeightSum_));
-  return {mean, var, curWeightSum_};
+  double curMean = curMean_;
+  double curMeanSquaredSum = curMeanSquaredSum_;
+  double curWeightSum = curWeightSum_;
+  double curWeightSquaredSum = curWeightSquaredSum_;
+  if (!pending_.isEmpty()) {
+    // Single device to host copy for everything added since the last reset
+    const auto sums = pending_.toHostVector<double>();
+    const double weightSum = curWeightSum + sums[2];
+    if (weightSum != 0) {
+      curMean = (curMean * curWeightSum + sums[0]) / weightSum;
+      curMeanSquaredSum =
+          (curMeanSquaredSum * curWeightSum + sums[1]) / weightSum;
+    }
+    curWeightSum = weightSum;
+    curWeightSquaredSum += sums[3];
+  }
+
+  double mean = curMean;
+  double var = (curMeanSquaredSum - curMean * curMean) /
+      (1 - curWeightSquaredSum / (curWeightSum * curWeightSum));
+  return {mean, var, curWeightSum};
 }
 } // namespace fl
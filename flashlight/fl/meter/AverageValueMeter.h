@@ -10,11 +10,10 @@
 #include <vector>
 
 #include "flashlight/fl/common/Defines.h"
+#include "flashlight/fl/tensor/TensorBase.h"
 
 namespace fl {
 
-class Tensor;
-
 /**
  * An implementation of average value meter, which measures the mean and
  * variance of a sequence of values.
@@ -48,9 +47,19 @@ class FL_API AverageValueMeter {
   /** Updates counters with the given value `val` with weight `w`. */
   void add(const double val, const double w = 1.0);
 
-  /** Updates counters with all values in `vals` with equal weights. */
+  /**
+   * Updates counters with all values in `vals` with unit weights. The update
+   * is accumulated on device and only read back by `value()`.
+   */
   void add(const Tensor& vals);
 
+  /**
+   * Updates counters with the scalar value `val` with weight `w`, both given
+   * as single-element tensors. The update is accumulated on device and only
+   * read back by `value()`, so it does not synchronize with the host.
+   */
+  void add(const Tensor& val, const Tensor& w);
+
   /** Returns a vector of four values:
    * - `unbiased mean`: \f$ \tilde{mu} \f$
    * - `unbiased variance`: \f$ \tilde{sigma}^2 = \frac{(\tilde{mu}_2 -
@@ -68,5 +77,10 @@ class FL_API AverageValueMeter {
   double curMeanSquaredSum_;
   double curWeightSum_;
   double curWeightSquaredSum_;
+  // Device-side sums of w * val, w * val^2, w and w^2 from the tensor `add`s,
+  // in double precision, which are not yet part of the counters above
+  Tensor pending_;
+
+  void accumulate(const Tensor& sums);
 };
 } // namespace fl
@@ -7,6 +7,9 @@
 
 #include <algorithm>
 #include <array>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 #include "flashlight/fl/nn/Utils.h"
 
@@ -158,4 +161,38 @@ Tensor join(
   return padSeq;
 }
 
+std::pair<Tensor, Tensor> quantizePerChannel(
+    const Tensor& weights,
+    int axis) {
+  if (axis < 0 || axis >= weights.ndim()) {
+    throw std::invalid_argument(
+        "quantizePerChannel: invalid axis " + std::to_string(axis) +
+        " for weights of shape " + weights.shape().toString());
+  }
+  std::vector<int> reduceAxes;
+  for (int i = 0; i < weights.ndim(); ++i) {
+    if (i != axis) {
+      reduceAxes.push_back(i);
+    }
+  }
+  // Symmetric quantization to [-127, 127] around the zero point
+  auto weightsF32 = weights.astype(fl::dtype::f32);
+  auto scales =
+      fl::amax(fl::abs(weightsF32), reduceAxes, /* keepDims = */ true);
+  scales = fl::where(scales > 0, scales / 127, 1.);
+  auto quantized = fl::clip(fl::rint(weightsF32 / scales), -127., 127.) +
+      kQuantizedZeroPoint;
+  return {quantized.astype(fl::dtype::u8), scales};
+}
+
+Tensor
+dequantize(const Tensor& quantized, const Tensor& scales, fl::dtype type) {
+  return ((quantized.astype(fl::dtype::f32) - kQuantizedZeroPoint) * scales)
+      .astype(type);
+}
+
+float quantizationScale(float absMax) {
+  return absMax > 0 ? absMax / 127 : 1;
+}
+
 } // namespace fl
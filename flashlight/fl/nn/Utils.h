@@ -13,6 +13,7 @@
 #pragma once
 
 #include <iomanip>
+#include <utility>
 
 #include "flashlight/fl/common/Defines.h"
 #include "flashlight/fl/common/Utils.h"
@@ -69,6 +70,40 @@ FL_API Tensor join(
     double padValue = 0.0,
     int batchDim = -1);
 
+/// zero point of weights quantized by `quantizePerChannel`
+constexpr int kQuantizedZeroPoint = 128;
+
+/**
+ * Quantizes weights to 8 bits with one (symmetric) scale per index along an
+ * axis, e.g. per output channel.
+ *
+ * @param[in] weights the weights to quantize
+ * @param[in] axis the axis along which weights have separate scales
+ * @return the quantized weights, of type u8 with a zero point of
+ * `kQuantizedZeroPoint`, and the f32 scales, which are of size 1 along all
+ * axes but `axis`
+ */
+FL_API std::pair<Tensor, Tensor> quantizePerChannel(
+    const Tensor& weights,
+    int axis);
+
+/**
+ * Dequantizes weights quantized by `quantizePerChannel`.
+ *
+ * @param[in] quantized the quantized weights
+ * @param[in] scales the scales of the quantized weights, which are broadcast
+ * @param[in] type the type of the dequantized weights
+ */
+FL_API Tensor
+dequantize(const Tensor& quantized, const Tensor& scales, fl::dtype type);
+
+/**
+ * Returns the scale which quantizes values of magnitude up to `absMax` to 8
+ * bits, symmetrically like `quantizePerChannel`, e.g. for activations whose
+ * range was calibrated.
+ */
+FL_API float quantizationScale(float absMax);
+
 /** @} */
 
 } // namespace fl
@@ -15,6 +15,17 @@
 
 namespace fl {
 
+namespace {
+
+Tensor logSoftmaxTensor(const Tensor& x) {
+  auto maxValues = fl::amax(x, {0}, /* keepDims = */ true);
+  auto shifted = x - maxValues;
+  return shifted -
+      fl::log(fl::sum(fl::exp(shifted), {0}, /* keepDims = */ true));
+}
+
+} // namespace
+
 AdaptiveSoftMax::AdaptiveSoftMax(
     int inputSize,
     const std::vector<int>& cutoff,
@@ -97,30 +108,57 @@ Variable AdaptiveSoftMax::predict(const Variable& inputs) const {
         "invalid input dimension for AdaptiveSoftMaxLoss");
   }
 
-  auto inputsFlattened = moddims(inputs, {inputSize, -1});
-  auto headOutput = matmul(params_[0], inputsFlattened);
+  auto inputsFlattened = fl::reshape(
+      inputs.tensor(), {inputSize, inputs.elements() / inputSize});
+  auto headOutput = fl::matmul(params_[0].tensor(), inputsFlattened);
   Tensor maxValue, prediction;
-  fl::max(maxValue, prediction, headOutput.tensor(), 0);
+  fl::max(maxValue, prediction, headOutput, 0);
 
+  // A word in a cluster is never more likely than the cluster, so shortlist
+  // predictions are exact. Elsewhere, clusters are only evaluated at positions
+  // where they're more likely than the best word found so far, starting with
+  // the cluster predicted by the head.
   auto notInShortlist = (prediction >= cutoff_[0]);
-  Variable ret = Variable(prediction, false);
   if (fl::any(notInShortlist).asScalar<bool>()) {
-    headOutput = logSoftmax(headOutput, 0);
-    auto logProbTailPositions = getFullLogProb(
-        inputsFlattened(fl::span, notInShortlist),
-        headOutput(fl::span, notInShortlist));
-    Tensor maxValueTailPositions, predictionTailPositions;
-    fl::max(
-        maxValueTailPositions,
-        predictionTailPositions,
-        logProbTailPositions.tensor(),
-        0);
-    ret.tensor()(notInShortlist) = predictionTailPositions;
+    auto positions = fl::nonzero(notInShortlist);
+    auto tailInputs = inputsFlattened(fl::span, positions);
+    auto headLogProb = logSoftmaxTensor(headOutput(fl::span, positions));
+    auto headPrediction = prediction(positions);
+    Tensor bestLogProb, best;
+    fl::max(bestLogProb, best, headLogProb(fl::range(0, cutoff_[0])), 0);
+
+    for (bool predictedCluster : {true, false}) {
+      for (int i = 0; i < cutoff_.size() - 1; i++) {
+        auto clusterLogProb =
+            headLogProb(fl::range(cutoff_[0] + i, cutoff_[0] + i + 1))
+                .flatten();
+        auto isPredicted = headPrediction == cutoff_[0] + i;
+        auto candidates = predictedCluster
+            ? isPredicted
+            : (!isPredicted && clusterLogProb > bestLogProb);
+        if (!fl::any(candidates).asScalar<bool>()) {
+          continue;
+        }
+        auto idx = fl::nonzero(candidates);
+        auto tailOutput = fl::matmul(
+            params_[2 + i * 2].tensor(),
+            fl::matmul(params_[1 + i * 2].tensor(), tailInputs(fl::span, idx)));
+        Tensor tailMax, tailPrediction;
+        fl::max(tailMax, tailPrediction, logSoftmaxTensor(tailOutput), 0);
+        auto candidateLogProb = clusterLogProb(idx) + tailMax;
+        auto better = candidateLogProb > bestLogProb(idx);
+        bestLogProb(idx) =
+            fl::where(better, candidateLogProb, bestLogProb(idx));
+        auto tailWord = (tailPrediction + cutoff_[i]).astype(best.type());
+        best(idx) = fl::where(better, tailWord, best(idx));
+      }
+    }
+    prediction(positions) = best;
   }
 
   Shape outDims = inputs.shape();
   outDims[0] = 1;
-  return moddims(ret, outDims);
+  return Variable(fl::reshape(prediction, outDims), false);
 }
 
 std::vector<int> AdaptiveSoftMax::getCutoff() const {
@@ -8,6 +8,7 @@
 #include "flashlight/fl/nn/modules/Container.h"
 
 #include "flashlight/fl/autograd/Variable.h"
+#include "flashlight/fl/tensor/Profile.h"
 
 namespace fl {
 
@@ -77,6 +78,7 @@ Sequential::Sequential() = default;
 std::vector<Variable> Sequential::forward(const std::vector<Variable>& input) {
   auto output = input;
   for (auto& module : modules_) {
+    FL_TRACE_SCOPE(module->traceScope());
     output = module->forward(output);
   }
   return output;
@@ -85,6 +87,7 @@ std::vector<Variable> Sequential::forward(const std::vector<Variable>& input) {
 Variable Sequential::forward(const Variable& input) {
   std::vector<Variable> output = {input};
   for (auto& module : modules_) {
+    FL_TRACE_SCOPE(module->traceScope());
     output = module->forward(output);
   }
   if (output.size() != 1) {
@@ -7,10 +7,12 @@
 
 #include "flashlight/fl/nn/modules/Conv2D.h"
 
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 
 #include "flashlight/fl/autograd/Functions.h"
+#include "flashlight/fl/autograd/tensor/AutogradOps.h"
 #include "flashlight/fl/common/DynamicBenchmark.h"
 #include "flashlight/fl/nn/Init.h"
 #include "flashlight/fl/nn/Utils.h"
@@ -111,10 +113,41 @@ Variable Conv2D::forward(const Variable& input) {
     throw std::invalid_argument("invalid padding for Conv2D");
   }
 
+  return convolve(input, px, py);
+}
+
+Variable Conv2D::convolve(const Variable& input, int px, int py) {
+  if (calibrating_) {
+    auto absMax = fl::amax(fl::abs(input.tensor())).astype(fl::dtype::f32);
+    inputAbsMax_ = std::max(inputAbsMax_, absMax.scalar<float>());
+  } else if (isCalibrated() && !input.isCalcGrad()) {
+    auto output = detail::quantizedConv2d(
+        input.tensor(),
+        params_[0].tensor(),
+        weightScales_,
+        inputScale_,
+        xStride_,
+        yStride_,
+        px,
+        py,
+        xDilation_,
+        yDilation_,
+        groups_);
+    if (output) {
+      if (bias_) {
+        auto tiledims = output->shape();
+        tiledims[2] = 1;
+        *output = *output +
+            fl::tile(params_[1].tensor().astype(output->type()), tiledims);
+      }
+      return Variable(*output, false);
+    }
+  }
+
   if (bias_) {
     return conv2d(
         input,
-        params_[0].astype(input.type()),
+        weights(input.type()),
         params_[1].astype(input.type()),
         xStride_,
         yStride_,
@@ -127,7 +160,7 @@ Variable Conv2D::forward(const Variable& input) {
   } else {
     return conv2d(
         input,
-        params_[0].astype(input.type()),
+        weights(input.type()),
         xStride_,
         yStride_,
         px,
@@ -158,6 +191,61 @@ void Conv2D::initialize() {
   benchmarks_ = std::make_shared<detail::ConvBenchmarks>();
 }
 
+int Conv2D::xFilter() const {
+  return xFilter_;
+}
+
+int Conv2D::xStride() const {
+  return xStride_;
+}
+
+int Conv2D::xPad() const {
+  return xPad_;
+}
+
+int Conv2D::xDilation() const {
+  return xDilation_;
+}
+
+Variable Conv2D::weights(fl::dtype type) const {
+  if (isQuantized()) {
+    return Variable(
+        dequantize(params_[0].tensor(), weightScales_, type), false);
+  }
+  return params_[0].astype(type);
+}
+
+void Conv2D::quantizeWeights() {
+  if (isQuantized()) {
+    return;
+  }
+  // Weights are WHIO
+  auto [quantized, scales] = quantizePerChannel(params_[0].tensor(), 3);
+  params_[0].tensor() = quantized;
+  params_[0].setCalcGrad(false);
+  weightScales_ = scales;
+}
+
+bool Conv2D::isQuantized() const {
+  return !weightScales_.isEmpty();
+}
+
+void Conv2D::setCalibrating(bool calibrating) {
+  if (calibrating && !isQuantized()) {
+    throw std::logic_error(
+        "Conv2D::setCalibrating - only quantized modules can be calibrated");
+  }
+  if (calibrating_ && !calibrating && inputAbsMax_ >= 0) {
+    inputScale_ = quantizationScale(inputAbsMax_);
+  }
+  calibrating_ = calibrating;
+  inputAbsMax_ = -1;
+}
+
+bool Conv2D::isCalibrated() const {
+  return isQuantized() && inputScale_ > 0;
+}
+
 std::string Conv2D::prettyString() const {
   std::ostringstream ss;
   ss << "Conv2D";
@@ -182,6 +270,11 @@ std::string Conv2D::prettyString() const {
   } else {
     ss << " (without bias)";
   }
+  if (isCalibrated()) {
+    ss << " (quantized, calibrated)";
+  } else if (isQuantized()) {
+    ss << " (quantized)";
+  }
   return ss.str();
 }
 
@@ -52,7 +52,9 @@ class FL_API Conv2D : public UnaryModule {
       fl::versioned(xDilation_, 1),
       fl::versioned(yDilation_, 1),
       bias_,
-      groups_)
+      groups_,
+      fl::versioned(weightScales_, 2),
+      fl::versioned(inputScale_, 3))
 
   void initialize();
 
@@ -65,6 +67,27 @@ class FL_API Conv2D : public UnaryModule {
   int xDilation_{1}, yDilation_{1}; // dilation
   bool bias_;
   int groups_;
+  // Per output channel scales of the weights, if quantized
+  Tensor weightScales_;
+  // Scale of the input quantized to 8 bits, if calibrated
+  float inputScale_{0};
+  // While calibrating, the largest magnitude of the inputs, or -1 if none
+  bool calibrating_{false};
+  float inputAbsMax_{-1};
+
+  /**
+   * @return the weights as a `Variable` of the given type, dequantized if
+   * needed
+   */
+  Variable weights(fl::dtype type) const;
+
+  /**
+   * Convolves the input with the weights and adds the bias, given the padding
+   * derived for the input. Computes in integer arithmetic if the weights are
+   * quantized and the input range calibrated, or records the input range
+   * while calibrating.
+   */
+  Variable convolve(const Variable& input, int px, int py);
 
  public:
   /**
@@ -178,6 +201,52 @@ class FL_API Conv2D : public UnaryModule {
 
   Variable forward(const Variable& input) override;
 
+  /**
+   * @return the filter size along the first dimension
+   */
+  int xFilter() const;
+
+  /**
+   * @return the stride along the first dimension
+   */
+  int xStride() const;
+
+  /**
+   * @return the padding along the first dimension, which may be a
+   * `PaddingMode` value
+   */
+  int xPad() const;
+
+  /**
+   * @return the dilation along the first dimension
+   */
+  int xDilation() const;
+
+  /**
+   * Quantizes the weights to 8 bits per output channel for inference, which
+   * makes them 4x smaller. Until the input range is calibrated (see
+   * `setCalibrating`), they're dequantized for each `forward`, which computes
+   * in full precision. They're no longer trainable, and mustn't be shared
+   * with other modules.
+   */
+  void quantizeWeights();
+
+  /**
+   * @return whether the weights are quantized
+   */
+  bool isQuantized() const;
+
+  /**
+   * Starts or stops calibrating the range of the input of a quantized
+   * module, as `Linear::setCalibrating` does.
+   */
+  void setCalibrating(bool calibrating);
+
+  /**
+   * @return whether the range of the input is calibrated
+   */
+  bool isCalibrated() const;
+
   std::string prettyString() const override;
 
  protected:
@@ -187,4 +256,4 @@ class FL_API Conv2D : public UnaryModule {
 } // namespace fl
 
 CEREAL_REGISTER_TYPE(fl::Conv2D)
-CEREAL_CLASS_VERSION(fl::Conv2D, 1)
+CEREAL_CLASS_VERSION(fl::Conv2D, 3)
@@ -11,6 +11,7 @@
 
 #include "flashlight/fl/autograd/Functions.h"
 #include "flashlight/fl/nn/Init.h"
+#include "flashlight/fl/nn/Utils.h"
 
 namespace fl {
 
@@ -30,13 +31,35 @@ void Embedding::initialize() {
 }
 
 Variable Embedding::forward(const Variable& input) {
+  if (isQuantized()) {
+    auto quantized = embedding(input, params_[0]).tensor();
+    auto scales = embedding(input, Variable(embeddingScales_, false)).tensor();
+    return Variable(dequantize(quantized, scales, fl::dtype::f32), false);
+  }
   return embedding(input, params_[0]);
 }
 
+void Embedding::quantizeWeights() {
+  if (isQuantized()) {
+    return;
+  }
+  auto [quantized, scales] = quantizePerChannel(params_[0].tensor(), 1);
+  params_[0].tensor() = quantized;
+  params_[0].setCalcGrad(false);
+  embeddingScales_ = scales;
+}
+
+bool Embedding::isQuantized() const {
+  return !embeddingScales_.isEmpty();
+}
+
 std::string Embedding::prettyString() const {
   std::ostringstream ss;
   ss << "Embedding (embeddings: " << numEmbeddings_
      << ") (dim: " << embeddingDim_ << ")";
+  if (isQuantized()) {
+    ss << " (quantized)";
+  }
   return ss.str();
 }
 
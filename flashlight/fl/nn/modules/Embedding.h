@@ -24,8 +24,14 @@ class FL_API Embedding : public UnaryModule {
 
   int embeddingDim_;
   int numEmbeddings_;
+  // Per embedding scales, if quantized
+  Tensor embeddingScales_;
 
-  FL_SAVE_LOAD_WITH_BASE(UnaryModule, embeddingDim_, numEmbeddings_)
+  FL_SAVE_LOAD_WITH_BASE(
+      UnaryModule,
+      embeddingDim_,
+      numEmbeddings_,
+      fl::versioned(embeddingScales_, 1))
 
   void initialize();
 
@@ -48,9 +54,22 @@ class FL_API Embedding : public UnaryModule {
 
   Variable forward(const Variable& input) override;
 
+  /**
+   * Quantizes each embedding to 8 bits, making the dictionary 4x smaller for
+   * inference. Only looked up embeddings are dequantized. The dictionary is no
+   * longer trainable, and mustn't be shared with other modules.
+   */
+  void quantizeWeights();
+
+  /**
+   * @return whether the embeddings are quantized
+   */
+  bool isQuantized() const;
+
   std::string prettyString() const override;
 };
 
 } // namespace fl
 
 CEREAL_REGISTER_TYPE(fl::Embedding)
+CEREAL_CLASS_VERSION(fl::Embedding, 1)
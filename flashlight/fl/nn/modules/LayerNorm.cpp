@@ -40,6 +40,32 @@ LayerNorm::LayerNorm(
 }
 
 Variable LayerNorm::forward(const Variable& _input) {
+  // Normalizing over the leading axes needs no reordering, so uses the fused
+  // layerNorm op
+  auto axis = getAxis();
+  bool leadingAxes = !axis.empty();
+  Dim normSize = 1;
+  for (int i = 0; i < static_cast<int>(axis.size()); ++i) {
+    leadingAxes &= axis[i] == i;
+    normSize *= i < _input.ndim() ? _input.dim(i) : 1;
+  }
+  if (leadingAxes && _input.ndim() <= kLnExpectedNumDims) {
+    Variable weight, bias;
+    if (affine_) {
+      weight = params_[0].astype(_input.type());
+      bias = params_[1].astype(_input.type());
+      if (axisSize_ == kLnVariableAxisSize) {
+        weight = tileAs(weight, Shape({normSize}));
+        bias = tileAs(bias, Shape({normSize}));
+      } else if (normSize != axisSize_) {
+        throw std::invalid_argument(
+            "[LayerNorm] Input size along the norm axis doesn't match "
+            "axisSize.");
+      }
+    }
+    return layerNorm(_input, weight, bias, axis, epsilon_);
+  }
+
   Variable input = _input;
   // If the input isn't of kLnExpectedNumDims, reshape so it is -- do this by
   // adding singleton dims. This is needed per computing the axis complement
@@ -139,6 +165,17 @@ void LayerNorm::initialize() {
   }
 }
 
+std::vector<int> LayerNorm::getAxis() const {
+  std::vector<int> axis;
+  for (int d = 0; d < kLnExpectedNumDims; ++d) {
+    if (std::find(axisComplement_.begin(), axisComplement_.end(), d) ==
+        axisComplement_.end()) {
+      axis.push_back(d);
+    }
+  }
+  return axis;
+}
+
 std::string LayerNorm::prettyString() const {
   std::ostringstream ss;
   ss << "LayerNorm";
@@ -71,6 +71,11 @@ class FL_API LayerNorm : public UnaryModule {
 
   Variable forward(const Variable& input) override;
 
+  /**
+   * @return the axes along which normalization is computed
+   */
+  std::vector<int> getAxis() const;
+
   std::string prettyString() const override;
 
  private:
@@ -7,10 +7,12 @@
 
 #include "flashlight/fl/nn/modules/Linear.h"
 
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 
 #include "flashlight/fl/autograd/Functions.h"
+#include "flashlight/fl/autograd/tensor/AutogradOps.h"
 #include "flashlight/fl/nn/Init.h"
 #include "flashlight/fl/nn/Utils.h"
 
@@ -33,11 +35,62 @@ Linear::Linear(const Variable& w, const Variable& b)
 }
 
 Variable Linear::forward(const Variable& input) {
+  if (calibrating_) {
+    auto absMax = fl::amax(fl::abs(input.tensor())).astype(fl::dtype::f32);
+    inputAbsMax_ = std::max(inputAbsMax_, absMax.scalar<float>());
+  } else if (isCalibrated() && !input.isCalcGrad()) {
+    auto output = detail::quantizedLinear(
+        input.tensor(), params_[0].tensor(), weightScales_, inputScale_);
+    if (output) {
+      if (bias_) {
+        auto tiledims = output->shape();
+        tiledims[0] = 1;
+        *output = *output +
+            fl::tile(params_[1].tensor().astype(output->type()), tiledims);
+      }
+      return Variable(*output, false);
+    }
+  }
+
+  auto weight = isQuantized()
+      ? Variable(
+            dequantize(params_[0].tensor(), weightScales_, input.type()), false)
+      : params_[0].astype(input.type());
   if (bias_) {
-    return linear(
-        input, params_[0].astype(input.type()), params_[1].astype(input.type()));
+    return linear(input, weight, params_[1].astype(input.type()));
+  }
+  return linear(input, weight);
+}
+
+void Linear::quantizeWeights() {
+  if (isQuantized()) {
+    return;
+  }
+  auto [quantized, scales] = quantizePerChannel(params_[0].tensor(), 0);
+  // Replaced in place so that containers holding the parameter see it
+  params_[0].tensor() = quantized;
+  params_[0].setCalcGrad(false);
+  weightScales_ = scales;
+}
+
+bool Linear::isQuantized() const {
+  return !weightScales_.isEmpty();
+}
+
+void Linear::setCalibrating(bool calibrating) {
+  if (calibrating && !isQuantized()) {
+    throw std::logic_error(
+        "Linear::setCalibrating - only quantized modules can be calibrated");
+  }
+  if (calibrating_ && !calibrating && inputAbsMax_ >= 0) {
+    inputScale_ = quantizationScale(inputAbsMax_);
   }
-  return linear(input, params_[0].astype(input.type()));
+  calibrating_ = calibrating;
+  inputAbsMax_ = -1;
+}
+
+bool Linear::isCalibrated() const {
+  return isQuantized() && inputScale_ > 0;
 }
 
 void Linear::initialize() {
@@ -63,6 +116,11 @@ std::string Linear::prettyString() const {
   } else {
     ss << " (without bias)";
   }
+  if (isCalibrated()) {
+    ss << " (quantized, calibrated)";
+  } else if (isQuantized()) {
+    ss << " (quantized)";
+  }
   return ss.str();
 }
 
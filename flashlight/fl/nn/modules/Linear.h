@@ -22,8 +22,21 @@ class FL_API Linear : public UnaryModule {
 
   int nIn_, nOut_;
   bool bias_;
+  // Per output channel scales of the weight, if quantized
+  Tensor weightScales_;
+  // Scale of the input quantized to 8 bits, if calibrated
+  float inputScale_{0};
+  // While calibrating, the largest magnitude of the inputs, or -1 if none
+  bool calibrating_{false};
+  float inputAbsMax_{-1};
 
-  FL_SAVE_LOAD_WITH_BASE(UnaryModule, nIn_, nOut_, bias_)
+  FL_SAVE_LOAD_WITH_BASE(
+      UnaryModule,
+      nIn_,
+      nOut_,
+      bias_,
+      fl::versioned(weightScales_, 1),
+      fl::versioned(inputScale_, 2))
 
   void initialize();
 
@@ -60,9 +73,40 @@ class FL_API Linear : public UnaryModule {
 
   Variable forward(const Variable& input) override;
 
+  /**
+   * Quantizes the weight to 8 bits per output channel, shrinking it by 4x
+   * for inference. Until the input range is calibrated (see
+   * `setCalibrating`), the weight is dequantized for each `forward`, which
+   * computes in full precision. The weight is no longer trainable, and
+   * mustn't be shared with other modules.
+   */
+  void quantizeWeights();
+
+  /**
+   * @return whether the weight is quantized
+   */
+  bool isQuantized() const;
+
+  /**
+   * Starts or stops calibrating the range of the input of a quantized
+   * module. While calibrating, `forward` computes in full precision and
+   * records the largest magnitude of its inputs. Once stopped, inputs are
+   * quantized to 8 bits over that range, clipping larger values, and
+   * `forward` computes in integer arithmetic on backends supporting it for
+   * inputs without gradients. Stopping without having seen inputs leaves the
+   * previous calibration.
+   */
+  void setCalibrating(bool calibrating);
+
+  /**
+   * @return whether the range of the input is calibrated
+   */
+  bool isCalibrated() const;
+
   std::string prettyString() const override;
 };
 
 } // namespace fl
 
 CEREAL_REGISTER_TYPE(fl::Linear)
+CEREAL_CLASS_VERSION(fl::Linear, 2)
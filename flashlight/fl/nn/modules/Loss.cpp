@@ -14,6 +14,51 @@
 
 namespace fl {
 
+namespace {
+
+// Fused log-softmax and negative log-likelihood of [C, X] logits along axis 0,
+// which materializes neither log-probabilities nor one-hot targets. Returns
+// the [X] losses, which are zero for ignored targets.
+Variable logSoftmaxNll(
+    const Variable& logits,
+    const Tensor& targets,
+    int ignoreIndex) {
+  const auto& x = logits.tensor();
+  int numClasses = x.dim(0);
+  auto numTargets = x.dim(1);
+  auto maxLogits = fl::amax(x, {0}, /* keepDims = */ true);
+  auto logNorm =
+      fl::log(fl::sum(fl::exp(x - maxLogits), {0}, /* keepDims = */ true)) +
+      maxLogits; // [1, X]
+
+  auto ignoreMask = (targets == ignoreIndex).flatten();
+  auto classes =
+      fl::where(ignoreMask, 0., targets.flatten()).astype(fl::dtype::s32);
+  auto targetIdx =
+      classes + numClasses * fl::arange({numTargets}, 0, fl::dtype::s32);
+  auto result = logNorm.flatten() - x.flatten()(targetIdx);
+  result = fl::where(ignoreMask, 0., result);
+
+  auto gradFunc = [logNorm, targetIdx, ignoreMask](
+                      std::vector<Variable>& inputs,
+                      const Variable& gradOutput) {
+    auto& in = inputs[0];
+    if (!in.isCalcGrad()) {
+      return;
+    }
+    auto grad = fl::where(ignoreMask, 0., gradOutput.tensor().flatten());
+    // softmax - onehot(target)
+    auto gradIn = (fl::exp(in.tensor() - logNorm) *
+                   fl::reshape(grad, {1, grad.dim(0)}))
+                      .flatten();
+    gradIn(targetIdx) = gradIn(targetIdx) - grad;
+    in.addGrad(Variable(fl::reshape(gradIn, in.shape()), false));
+  };
+  return Variable(result, {logits}, gradFunc);
+}
+
+} // namespace
+
 Variable MeanSquaredError::forward(
     const Variable& inputs,
     const Variable& targets) {
@@ -141,37 +186,49 @@ Variable AdaptiveSoftMaxLoss::forward(
   auto input = moddims(inputs, {N, T * B});
   auto target = moddims(targets, {T * B});
 
-  auto headOutput = matmul(params_[0], input);
-  auto headTarget = Variable(target.tensor(), false) * (target < cutoff[0]);
-  // TODO: check the type of res
-  auto res = Variable(fl::full({T * B}, 0, fl::dtype::f32), true);
+  const auto& targetTensor = target.tensor();
+  if (fl::any(
+          ((targetTensor < 0) || (targetTensor >= cutoff.back())) &&
+          (targetTensor != ignoreIndex_))
+          .scalar<char>()) {
+    throw std::invalid_argument(
+        "AdaptiveSoftMaxLoss: target contains elements out of valid range");
+  }
+
+  // Targets in the tail are replaced by their cluster for the head
+  auto headTarget = targetTensor.copy();
+  std::vector<Variable> tailLosses;
+  std::vector<Tensor> tailIndices;
 
-  // Tail forwawrd
+  // Tail forward: only positions with a target in a cluster go through its
+  // projections
   for (int i = 0; i < cutoff.size() - 1; i++) {
-    auto mask = (target >= cutoff[i]) && (target < cutoff[i + 1]);
-    if (!fl::any(mask.tensor()).scalar<char>()) {
+    auto mask = (targetTensor >= cutoff[i]) && (targetTensor < cutoff[i + 1]) &&
+        (targetTensor != ignoreIndex_);
+    if (!fl::any(mask).scalar<char>()) {
       continue;
     }
 
-    auto indicesArray = fl::nonzero(mask.tensor());
-    headTarget =
-        headTarget + (mask * (cutoff[0] + i)).astype(headTarget.type());
-    auto tailTarget = target(indicesArray) - cutoff[i];
+    auto indicesArray = fl::nonzero(mask);
+    headTarget(indicesArray) = cutoff[0] + i;
+    auto tailTarget = targetTensor(indicesArray) - cutoff[i];
     auto selectedInput = embedding(Variable(indicesArray, false), input);
     auto tailOutput = matmul(params_[1 + i * 2], selectedInput);
     tailOutput = matmul(params_[2 + i * 2], tailOutput);
-    auto localLoss = categoricalCrossEntropy(
-        logSoftmax(tailOutput, 0), tailTarget, ReduceMode::NONE, ignoreIndex_);
-    res = res + cast(localLoss, res.shape(), indicesArray);
+    // Ignored targets were excluded from the cluster
+    tailLosses.push_back(
+        logSoftmaxNll(tailOutput, tailTarget, /* ignoreIndex = */ -1));
+    tailIndices.push_back(indicesArray);
   }
 
   // Head forward
-  res = res +
-      categoricalCrossEntropy(
-            logSoftmax(headOutput, 0),
-            headTarget,
-            ReduceMode::NONE,
-            ignoreIndex_);
+  auto res = logSoftmaxNll(matmul(params_[0], input), headTarget, ignoreIndex_);
+  if (!tailLosses.empty()) {
+    res = res +
+        cast(concatenate(tailLosses, 0),
+             res.shape(),
+             fl::concatenate(tailIndices, 0));
+  }
 
   // Reduce
   if (reduction_ == ReduceMode::NONE) {
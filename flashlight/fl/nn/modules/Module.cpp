@@ -11,6 +11,7 @@
 
 #include "flashlight/fl/common/Utils.h"
 #include "flashlight/fl/nn/Init.h"
+#include "flashlight/fl/tensor/Profile.h"
 
 namespace fl {
 
@@ -58,9 +59,21 @@ std::vector<Variable> Module::params() const {
 }
 
 std::vector<Variable> Module::operator()(const std::vector<Variable>& input) {
+  FL_TRACE_SCOPE(traceScope());
   return this->forward(input);
 }
 
+uint32_t Module::traceScope() const {
+  if (!detail::TraceScope::enabled()) {
+    return 0;
+  }
+  if (traceScope_ == 0) {
+    auto name = prettyString();
+    traceScope_ = detail::TraceScope::intern(name.substr(0, name.find('\n')));
+  }
+  return traceScope_;
+}
+
 UnaryModule::UnaryModule() = default;
 
 UnaryModule::UnaryModule(const std::vector<Variable>& params)
@@ -75,6 +88,7 @@ std::vector<Variable> UnaryModule::forward(
 }
 
 Variable UnaryModule::operator()(const Variable& input) {
+  FL_TRACE_SCOPE(traceScope());
   return this->forward(input);
 }
 
@@ -94,6 +108,7 @@ std::vector<Variable> BinaryModule::forward(
 Variable BinaryModule::operator()(
     const Variable& input1,
     const Variable& input2) {
+  FL_TRACE_SCOPE(traceScope());
   return this->forward(input1, input2);
 }
 
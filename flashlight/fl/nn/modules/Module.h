@@ -11,6 +11,7 @@
 #include "flashlight/fl/common/Defines.h"
 #include "flashlight/fl/common/Serialization.h"
 
+#include <cstdint>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -29,6 +30,9 @@ class FL_API Module {
    */
   FL_SAVE_LOAD(params_, train_)
 
+  // Cache for traceScope()
+  mutable uint32_t traceScope_{0};
+
  protected:
   /**
    * Parameters of module, represented as a collection of `Variable`, whose
@@ -130,6 +134,14 @@ class FL_API Module {
    */
   virtual std::string prettyString() const = 0;
 
+  /**
+   * Returns the id of the profiling scope of the module, named after the
+   * first line of `prettyString()`; 0 if scope tracking is disabled. The scope
+   * is opened around the forward computation of modules called through
+   * `operator()` or by `Sequential`. See `fl::detail::TraceScope`.
+   */
+  uint32_t traceScope() const;
+
   virtual ~Module() = default;
 };
 
@@ -18,6 +18,10 @@ Variable Padding::forward(const Variable& input) {
   return padding(input, m_pad, m_val);
 }
 
+std::vector<std::pair<int, int>> Padding::getPadding() const {
+  return m_pad;
+}
+
 std::string Padding::prettyString() const {
   std::ostringstream ss;
   ss << "Padding (" << m_val << ", { ";
@@ -42,6 +42,11 @@ class FL_API Padding : public UnaryModule {
 
   Variable forward(const Variable& input) override;
 
+  /**
+   * @return the (before, after) padding of each axis
+   */
+  std::vector<std::pair<int, int>> getPadding() const;
+
   std::string prettyString() const override;
 };
 
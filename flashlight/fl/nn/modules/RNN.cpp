@@ -42,6 +42,12 @@ void RNN::initialize() {
 }
 
 std::vector<Variable> RNN::forward(const std::vector<Variable>& inputs) {
+  return forward(inputs, Tensor());
+}
+
+std::vector<Variable> RNN::forward(
+    const std::vector<Variable>& inputs,
+    const Tensor& lengths) {
   if (inputs.empty() || inputs.size() > 3) {
     throw std::invalid_argument("Invalid inputs size");
   }
@@ -51,16 +57,26 @@ std::vector<Variable> RNN::forward(const std::vector<Variable>& inputs) {
   const auto& cellState = inputs.size() == 3 ? inputs[2] : Variable();
 
   float dropProb = train_ ? dropProb_ : 0.0;
-  auto rnnRes =
-      rnn(input,
-          hiddenState.astype(input.type()),
-          cellState.astype(input.type()),
-          params_[0].astype(input.type()),
-          hiddenSize_,
-          numLayers_,
-          mode_,
-          bidirectional_,
-          dropProb);
+  auto rnnRes = lengths.isEmpty()
+      ? rnn(input,
+            hiddenState.astype(input.type()),
+            cellState.astype(input.type()),
+            params_[0].astype(input.type()),
+            hiddenSize_,
+            numLayers_,
+            mode_,
+            bidirectional_,
+            dropProb)
+      : rnn(input,
+            hiddenState.astype(input.type()),
+            cellState.astype(input.type()),
+            params_[0].astype(input.type()),
+            hiddenSize_,
+            numLayers_,
+            mode_,
+            bidirectional_,
+            dropProb,
+            lengths);
 
   std::vector<Variable> output(1, std::get<0>(rnnRes));
   if (inputs.size() >= 2) {
@@ -108,6 +124,10 @@ std::tuple<Variable, Variable, Variable> RNN::operator()(
   return forward(input, hidden_state, cell_state);
 }
 
+bool RNN::isBidirectional() const {
+  return bidirectional_;
+}
+
 std::string RNN::prettyString() const {
   std::ostringstream ss;
   switch (mode_) {
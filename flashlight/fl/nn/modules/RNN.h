@@ -86,6 +86,18 @@ class FL_API RNN : public Module {
 
   std::vector<Variable> forward(const std::vector<Variable>& inputs) override;
 
+  /** Forward the RNN Layer on packed variable-length sequences.
+   * @param inputs The input, and optionally the hidden and cell states, as
+   * for `forward(inputs)`
+   * @param lengths The number of valid time steps of each of the \f$N\f$
+   * samples. Steps past a sample's length are skipped: its output is zero
+   * there and its returned states are those after its last valid step. An
+   * empty tensor means every step is valid.
+   */
+  std::vector<Variable> forward(
+      const std::vector<Variable>& inputs,
+      const Tensor& lengths);
+
   using Module::operator();
 
   /** Forward the RNN Layer.
@@ -139,6 +151,11 @@ class FL_API RNN : public Module {
       const Variable& hidden_state,
       const Variable& cell_state);
 
+  /**
+   * @return whether the RNN is bidirectional
+   */
+  bool isBidirectional() const;
+
   std::string prettyString() const override;
 };
 
@@ -34,6 +34,11 @@ void AdagradOptimizer::step() {
       continue;
     }
 
+    if (lazyUpdate(parameters_[i])) {
+      sparseStep(i);
+      continue;
+    }
+
     const Tensor& grad = parameters_[i].grad().tensor();
     Tensor& data = parameters_[i].tensor();
     Tensor& variance = variance_[i];
@@ -50,6 +55,25 @@ void AdagradOptimizer::step() {
   }
 }
 
+void AdagradOptimizer::sparseStep(size_t i) {
+  auto [index, grad] = sparseRowGrad(parameters_[i]);
+  if (index.empty()) {
+    return;
+  }
+  Tensor& data = parameters_[i].tensor();
+  auto rows = data(index);
+
+  if (wd_ != 0) {
+    rows = rows - wd_ * rows;
+  }
+
+  auto variance = variance_[i](index) + grad * grad;
+  variance_[i](index) = variance;
+  fl::eval(variance_[i]);
+  data(index) = rows - lr_ * grad / (fl::sqrt(variance) + eps_);
+  fl::eval(data);
+}
+
 std::string AdagradOptimizer::prettyString() const {
   std::ostringstream ss;
   ss << "Adagrad";
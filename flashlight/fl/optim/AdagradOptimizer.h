@@ -21,6 +21,10 @@ namespace fl {
  * [Adaptive Subgradient Methods for Online Learning and Stochastic
  * Optimization](
  *    http://www.jmlr.org/papers/volume12/duchi11a/duchi11a.pdf).
+ *
+ * With lazy sparse updates enabled - see
+ * `FirstOrderOptimizer::setLazySparseUpdates` - parameters with a row-sparse
+ * gradient only have the rows with a gradient updated.
  */
 class FL_API AdagradOptimizer : public FirstOrderOptimizer {
  private:
@@ -32,6 +36,8 @@ class FL_API AdagradOptimizer : public FirstOrderOptimizer {
   float wd_;
   std::vector<Tensor> variance_; // store sum_{tau=0}^{tau=t} grad_tau*grad_tau
 
+  void sparseStep(size_t i);
+
  public:
   /** Construct an Adagrad optimizer
    * @param parameters The parameters from e.g. `model.parameters()`.
@@ -53,6 +53,11 @@ void AdamOptimizer::step() {
       continue;
     }
 
+    if (lazyUpdate(parameters_[i])) {
+      sparseStep(i, correctedLr);
+      continue;
+    }
+
     const Tensor& grad = parameters_[i].grad().tensor();
     Tensor& data = parameters_[i].tensor();
 
@@ -76,6 +81,34 @@ void AdamOptimizer::step() {
   }
 }
 
+void AdamOptimizer::sparseStep(size_t i, float correctedLr) {
+  auto [index, grad] = sparseRowGrad(parameters_[i]);
+  if (index.empty()) {
+    return;
+  }
+  Tensor& data = parameters_[i].tensor();
+  auto rows = data(index);
+
+  if (wd_ != 0) {
+    rows = rows - wd_ * lr_ * rows;
+  }
+
+  // Lazy Adam: moments of rows without a gradient don't decay
+  auto biasedFirst = beta1_ * biasedFirst_[i](index) + (1 - beta1_) * grad;
+  auto biasedSecond =
+      beta2_ * biasedSecond_[i](index) + (1 - beta2_) * grad * grad;
+  biasedFirst_[i](index) = biasedFirst;
+  biasedSecond_[i](index) = biasedSecond;
+
+  fl::eval(biasedFirst_[i]);
+  fl::eval(biasedSecond_[i]);
+
+  data(index) =
+      rows - (correctedLr * biasedFirst) / (fl::sqrt(biasedSecond) + eps_);
+
+  fl::eval(data);
+}
+
 std::string AdamOptimizer::prettyString() const {
   std::ostringstream ss;
   ss << "Adam";
@@ -20,6 +20,11 @@ namespace fl {
  * For more details see the paper
  * [Adam: A Method for Stochastic Optimization](
  *    https://arxiv.org/abs/1412.6980).
+ *
+ * With lazy sparse updates enabled - see
+ * `FirstOrderOptimizer::setLazySparseUpdates` - parameters with a row-sparse
+ * gradient only have the rows with a gradient and their moments updated, as in
+ * TensorFlow's LazyAdam.
  */
 class FL_API AdamOptimizer : public FirstOrderOptimizer {
  private:
@@ -43,6 +48,8 @@ class FL_API AdamOptimizer : public FirstOrderOptimizer {
   std::vector<Tensor> biasedFirst_;
   std::vector<Tensor> biasedSecond_;
 
+  void sparseStep(size_t i, float correctedLr);
+
  public:
   /** Construct an Adam optimizer.
    * @param parameters The parameters from e.g. `model.parameters()`.
@@ -8,6 +8,7 @@
 #include "flashlight/fl/optim/Optimizers.h"
 
 #include <cmath>
+#include <utility>
 
 using std::vector;
 
@@ -21,6 +22,27 @@ FirstOrderOptimizer::FirstOrderOptimizer(
     double learningRate)
     : parameters_(parameters.begin(), parameters.end()), lr_(learningRate) {}
 
+std::pair<std::vector<Index>, Tensor> FirstOrderOptimizer::sparseRowGrad(
+    const Variable& parameter) {
+  if (parameter.isGradSparse()) {
+    const auto& sparse = parameter.sparseGrad();
+    if (sparse.rows.isEmpty()) {
+      return {};
+    }
+    std::vector<Index> index(parameter.ndim(), fl::span);
+    index[sparse.axis] = sparse.rows;
+    return {std::move(index), sparse.values};
+  }
+  const auto& grad = parameter.grad();
+  if (grad.sparseRows().isEmpty()) {
+    return {};
+  }
+  std::vector<Index> index(grad.ndim(), fl::span);
+  index[grad.sparseRowAxis()] = grad.sparseRows();
+  auto rowGrad = grad.tensor()(index);
+  return {std::move(index), std::move(rowGrad)};
+}
+
 void FirstOrderOptimizer::zeroGrad() {
   for (auto& parameter : parameters_) {
     parameter.zeroGrad();
@@ -7,10 +7,12 @@
 
 #pragma once
 
+#include <utility>
 #include <vector>
 
 #include "flashlight/fl/autograd/Variable.h"
 #include "flashlight/fl/common/Defines.h"
+#include "flashlight/fl/tensor/Index.h"
 
 namespace fl {
 
@@ -36,9 +38,32 @@ class FL_API FirstOrderOptimizer {
  protected:
   std::vector<Variable> parameters_;
   double lr_;
+  bool lazySparseUpdates_{false};
 
   FirstOrderOptimizer() = default;
 
+  /**
+   * @return whether the parameter is to be updated lazily, i.e. lazy updates
+   * are enabled and its gradient is held as slices or is row-sparse
+   */
+  bool lazyUpdate(const Variable& parameter) const {
+    return lazySparseUpdates_ &&
+        (parameter.isGradSparse() || parameter.grad().isRowSparse());
+  }
+
+  /**
+   * Gathers the rows a parameter has a gradient for, so that optimizers can
+   * lazily update only those rows of the parameter and of its state. A
+   * gradient held as slices is used as is, without materializing it.
+   *
+   * @param[in] parameter a parameter whose gradient is held as slices or is
+   * row-sparse
+   * @return the index of the rows, or an empty vector if no row has a
+   * gradient, and the gradient of those rows
+   */
+  static std::pair<std::vector<Index>, Tensor> sparseRowGrad(
+      const Variable& parameter);
+
  public:
   /** The `FirstOrderOptimizer` base class constructor.
    * @param parameters The parameters from e.g. `model.parameters()`
@@ -60,6 +85,26 @@ class FL_API FirstOrderOptimizer {
     lr_ = lr;
   }
 
+  /**
+   * Sets whether parameters with a row-sparse gradient, such as embedding
+   * tables, are updated lazily: only the rows with a gradient, and their
+   * optimizer state, are updated - see `Variable::addSparseGrad` and
+   * `Variable::setRowSparse`. Off by default.
+   *
+   * Lazy updates are faster for large tables, but change the semantics of
+   * optimizers which update rows without a gradient too: their weight decay
+   * isn't applied and their momentum or moments don't decay until they have a
+   * gradient again. The setting isn't serialized.
+   */
+  void setLazySparseUpdates(bool lazy) {
+    lazySparseUpdates_ = lazy;
+  }
+
+  /** Whether parameters with a row-sparse gradient are updated lazily. */
+  bool getLazySparseUpdates() const {
+    return lazySparseUpdates_;
+  }
+
   /** Zero the gradients for all the parameters being optimized. Typically
    * this will be called after every call to step().
    */
@@ -41,6 +41,11 @@ void SGDOptimizer::step() {
       continue;
     }
 
+    if (lazyUpdate(parameters_[i])) {
+      sparseStep(i);
+      continue;
+    }
+
     Tensor& grad = parameters_[i].grad().tensor();
     Tensor& data = parameters_[i].tensor();
 
@@ -67,6 +72,33 @@ void SGDOptimizer::step() {
   }
 }
 
+void SGDOptimizer::sparseStep(size_t i) {
+  auto [index, grad] = sparseRowGrad(parameters_[i]);
+  if (index.empty()) {
+    return;
+  }
+  Tensor& data = parameters_[i].tensor();
+  auto rows = data(index);
+
+  if (wd_ != 0) {
+    grad = grad + wd_ * rows;
+  }
+
+  if (mu_ != 0) {
+    // Momentum of rows without a gradient is left as is
+    auto velocity = mu_ * velocities_[i](index) + grad;
+    velocities_[i](index) = velocity;
+    fl::eval(velocities_[i]);
+    if (useNesterov_) {
+      grad = grad + velocity * mu_;
+    } else {
+      grad = velocity;
+    }
+  }
+  data(index) = rows - lr_ * grad;
+  fl::eval(data);
+}
+
 std::string SGDOptimizer::prettyString() const {
   std::ostringstream ss;
   ss << "SGD";
@@ -27,6 +27,11 @@ namespace fl {
  *
  * Reference for SGD and Momentum:
  * http://cs231n.github.io/neural-networks-3/#sgd
+ *
+ * With lazy sparse updates enabled - see
+ * `FirstOrderOptimizer::setLazySparseUpdates` - parameters with a row-sparse
+ * gradient, such as embedding tables, only have the rows with a gradient
+ * updated, along with their momentum.
  */
 class FL_API SGDOptimizer : public FirstOrderOptimizer {
  private:
@@ -44,6 +49,8 @@ class FL_API SGDOptimizer : public FirstOrderOptimizer {
   float wd_;
   std::vector<Tensor> velocities_;
 
+  void sparseStep(size_t i);
+
  public:
   /** SGDOptimizer constructor.
    * @param parameters The parameters from e.g. `model.parameters()`
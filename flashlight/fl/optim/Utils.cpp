@@ -14,24 +14,38 @@
 namespace fl {
 
 double clipGradNorm(const std::vector<Variable>& parameters, double maxNorm) {
-  double gradNorm = 0.0;
+  return clipGradNormAsync(parameters, maxNorm).asScalar<double>();
+}
+
+Tensor clipGradNormAsync(
+    const std::vector<Variable>& parameters,
+    double maxNorm) {
+  Tensor squaredNorm = fl::fromScalar(0.0, fl::dtype::f32);
   for (const auto& p : parameters) {
     if (!p.isGradAvailable()) {
       continue;
     }
-    const auto& grad = p.grad().tensor();
-    gradNorm += fl::sum(grad * grad).asScalar<double>();
-  }
-  gradNorm = std::sqrt(gradNorm);
-  double scale = maxNorm / (gradNorm + 1e-6);
-  if (scale >= 1.0) {
-    return gradNorm;
+    // Gradients held as slices are clipped without materializing them
+    const auto& grad =
+        p.isGradSparse() ? p.sparseGrad().values : p.grad().tensor();
+    // Accumulate half-precision gradients in single precision
+    if (grad.type() == fl::dtype::f16) {
+      const auto grad32 = grad.astype(fl::dtype::f32);
+      squaredNorm = squaredNorm + fl::sum(grad32 * grad32);
+    } else {
+      squaredNorm = squaredNorm + fl::sum(grad * grad);
+    }
   }
-  for (auto& p : parameters) {
+  const Tensor gradNorm = fl::sqrt(squaredNorm);
+  // Scaling by 1 when the norm is already small enough is cheaper than
+  // reading the norm back to decide
+  const Tensor scale = fl::minimum(maxNorm / (gradNorm + 1e-6), 1.0);
+  for (const auto& p : parameters) {
     if (!p.isGradAvailable()) {
       continue;
     }
-    p.grad().tensor() *= scale;
+    auto& grad = p.isGradSparse() ? p.sparseGrad().values : p.grad().tensor();
+    grad = grad * scale.astype(grad.type());
   }
   return gradNorm;
 }
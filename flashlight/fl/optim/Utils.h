@@ -14,8 +14,27 @@
 
 namespace fl {
 
+/**
+ * Rescales the gradients of `parameters` so that their global L2 norm is at
+ * most `max_norm`.
+ *
+ * @return the global L2 norm of the gradients before clipping. Reading it back
+ * is the only host synchronization of the function; see `clipGradNormAsync`.
+ */
 FL_API double clipGradNorm(
     const std::vector<Variable>& parameters,
     double max_norm);
 
-}
+/**
+ * Same as `clipGradNorm`, without synchronizing with the host: the norm is
+ * accumulated on device and the clipping factor `min(1, max_norm / norm)` is
+ * applied to every gradient as a device-side scale.
+ *
+ * @return the global L2 norm of the gradients before clipping, as a scalar
+ * tensor which can be read back later, e.g. at logging intervals.
+ */
+FL_API Tensor clipGradNormAsync(
+    const std::vector<Variable>& parameters,
+    double max_norm);
+
+} // namespace fl
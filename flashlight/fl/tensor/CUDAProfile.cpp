@@ -5,7 +5,7 @@
  * LICENSE file in the root directory of this source tree.
  */
 
-#include "flashlight/fl/tensor/Profile.h"
+#include "flashlight/fl/tensor/CUDAProfile.h"
 
 #include <cuda_profiler_api.h>
 #include <nvToolsExt.h>
@@ -14,20 +14,20 @@
 
 namespace fl::detail {
 
-ScopedProfiler::ScopedProfiler() {
-  FL_CUDA_CHECK(cudaProfilerStart());
+void cudaProfilerStart() {
+  FL_CUDA_CHECK(::cudaProfilerStart());
 }
 
-ScopedProfiler::~ScopedProfiler() {
-  FL_CUDA_CHECK(cudaProfilerStop());
+void cudaProfilerStop() {
+  FL_CUDA_CHECK(::cudaProfilerStop());
 }
 
-ProfileTracer::ProfileTracer(const std::string& name) {
+void cudaRangePush(const std::string& name) {
   nvtxRangePush(name.c_str());
 }
 
-ProfileTracer::~ProfileTracer() {
+void cudaRangePop() {
   nvtxRangePop();
 }
 
-} // namespace fl
+} // namespace fl::detail
@@ -0,0 +1,26 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <string>
+
+namespace fl::detail {
+
+/**
+ * Starts and stops the CUDA profiler.
+ */
+void cudaProfilerStart();
+void cudaProfilerStop();
+
+/**
+ * Pushes and pops NVTX ranges.
+ */
+void cudaRangePush(const std::string& name);
+void cudaRangePop();
+
+} // namespace fl::detail
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/Profile.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "flashlight/fl/tensor/TraceRecorder.h"
+
+#if FL_BACKEND_CUDA && FL_BUILD_PROFILING
+#include "flashlight/fl/tensor/CUDAProfile.h"
+#endif
+
+namespace fl::detail {
+
+namespace {
+
+std::atomic<int> scopeTrackingUsers{0};
+thread_local uint32_t currentScope = 0;
+
+struct ScopeNames {
+  std::mutex mutex;
+  std::unordered_map<std::string, uint32_t> ids;
+  // Indexed by id; id 0 is no scope
+  std::vector<std::string> names{""};
+};
+
+ScopeNames& scopeNames() {
+  // Leaked so that scopes can be closed during static destruction
+  static auto* names = new ScopeNames();
+  return *names;
+}
+
+} // namespace
+
+TraceScope::TraceScope(const std::string& name)
+    : TraceScope(enabled() ? intern(name) : 0) {}
+
+TraceScope::TraceScope(uint32_t id) : previous_(currentScope) {
+  if (id != 0) {
+    currentScope = id;
+    open_ = true;
+  }
+}
+
+TraceScope::~TraceScope() {
+  if (open_) {
+    currentScope = previous_;
+  }
+}
+
+uint32_t TraceScope::current() {
+  return currentScope;
+}
+
+uint32_t TraceScope::intern(const std::string& name) {
+  auto& names = scopeNames();
+  std::lock_guard<std::mutex> lock(names.mutex);
+  auto it = names.ids.find(name);
+  if (it != names.ids.end()) {
+    return it->second;
+  }
+  const auto id = static_cast<uint32_t>(names.names.size());
+  if (id & kBackward) {
+    throw std::runtime_error("TraceScope::intern - too many scope names");
+  }
+  names.names.push_back(name);
+  names.ids.emplace(name, id);
+  return id;
+}
+
+std::string TraceScope::name(uint32_t id) {
+  auto& names = scopeNames();
+  const uint32_t index = id & ~kBackward;
+  std::string name;
+  {
+    std::lock_guard<std::mutex> lock(names.mutex);
+    if (index >= names.names.size()) {
+      throw std::invalid_argument(
+          "TraceScope::name - unknown scope id " + std::to_string(id));
+    }
+    name = names.names[index];
+  }
+  return (id & kBackward) ? name + " (backward)" : name;
+}
+
+bool TraceScope::enabled() {
+  return scopeTrackingUsers.load(std::memory_order_relaxed) > 0;
+}
+
+void TraceScope::enable() {
+  ++scopeTrackingUsers;
+}
+
+void TraceScope::disable() {
+  --scopeTrackingUsers;
+}
+
+ScopedProfiler::ScopedProfiler() {
+  if (!TraceRecorder::recording()) {
+    TraceRecorder::start();
+    startedRecording_ = true;
+  }
+#if FL_BACKEND_CUDA && FL_BUILD_PROFILING
+  cudaProfilerStart();
+#endif
+}
+
+ScopedProfiler::~ScopedProfiler() {
+#if FL_BACKEND_CUDA && FL_BUILD_PROFILING
+  cudaProfilerStop();
+#endif
+  if (startedRecording_) {
+    TraceRecorder::stop();
+  }
+}
+
+ProfileTracer::ProfileTracer(const std::string& name)
+    : id_(TraceScope::enabled() ? TraceScope::intern(name) : 0), scope_(id_) {
+  if (TraceRecorder::recording()) {
+    startNs_ = TraceRecorder::now();
+  }
+#if FL_BACKEND_CUDA && FL_BUILD_PROFILING
+  cudaRangePush(name);
+  rangePushed_ = true;
+#endif
+}
+
+ProfileTracer::ProfileTracer(uint32_t id, bool openScope)
+    : id_(id), scope_(openScope ? id : 0) {
+  if (id_ == 0) {
+    return;
+  }
+  if (TraceRecorder::recording()) {
+    startNs_ = TraceRecorder::now();
+  }
+#if FL_BACKEND_CUDA && FL_BUILD_PROFILING
+  cudaRangePush(TraceScope::name(id_));
+  rangePushed_ = true;
+#endif
+}
+
+ProfileTracer::~ProfileTracer() {
+  if (startNs_ >= 0 && id_ != 0) {
+    TraceRecorder::record(id_, startNs_, TraceRecorder::now());
+  }
+#if FL_BACKEND_CUDA && FL_BUILD_PROFILING
+  if (rangePushed_) {
+    cudaRangePop();
+  }
+#endif
+}
+
+} // namespace fl::detail
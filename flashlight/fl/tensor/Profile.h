@@ -7,23 +7,100 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 
+#include "flashlight/fl/common/Defines.h"
+
 namespace fl {
 namespace detail {
 
 /**
- * An RAII abstraction to start and stop profiling recording.
+ * An RAII abstraction to label the work done on the calling thread over the
+ * lifetime of an object, for tools which attribute resources to the code
+ * using them - e.g. `AllocationTracer`. Scopes nest: the innermost scope open
+ * on a thread is its current scope. Scope names are interned and identified
+ * by an id, 0 standing for no scope.
+ *
+ * Scopes are only tracked while enabled by some tool, so that naming them
+ * costs nothing otherwise:
+ * \code
+   {
+     TraceScope scope("myOperation");
+     // allocations made here are attributed to myOperation
+   }
+ * \endcode
+ */
+class FL_API TraceScope {
+ public:
+  /**
+   * Set on the id of a scope to denote the backward computation of the
+   * scope - see `fl::Variable`.
+   */
+  static constexpr uint32_t kBackward = 1u << 31;
+
+  /**
+   * Opens the scope named `name`, if scope tracking is enabled.
+   */
+  explicit TraceScope(const std::string& name);
+
+  /**
+   * Opens the scope with the given id, as returned by `intern`. Does nothing
+   * if `id` is 0.
+   */
+  explicit TraceScope(uint32_t id);
+
+  ~TraceScope();
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+  /**
+   * @return the id of the innermost scope open on the calling thread, 0 if
+   * none is
+   */
+  static uint32_t current();
+
+  /**
+   * @return the id of the scope named `name`
+   */
+  static uint32_t intern(const std::string& name);
+
+  /**
+   * @return the name of the scope with the given id
+   */
+  static std::string name(uint32_t id);
+
+  /**
+   * Scope tracking is enabled by tools consuming scopes, from the first call
+   * to `enable` to the matching call to `disable`.
+   */
+  static bool enabled();
+  static void enable();
+  static void disable();
+
+ private:
+  uint32_t previous_;
+  bool open_{false};
+};
+
+/**
+ * An RAII abstraction to start and stop profiling recording: `TraceRecorder`
+ * recording, and the CUDA profiler in CUDA builds.
  */
-class ScopedProfiler {
+class FL_API ScopedProfiler {
  public:
   ScopedProfiler();
   ~ScopedProfiler();
+
+ private:
+  // whether TraceRecorder was started by this profiler
+  bool startedRecording_{false};
 };
 
 /**
- * An RAII abstractiont to label a profile interval over the lifetime for an
- object given a specific scope. For example:
+ * An RAII abstraction to label a profile interval over the lifetime for an
+ * object given a specific scope. For example:
  * \code
    {
      ProfileTracer tr("myOperation");
@@ -31,27 +108,68 @@ class ScopedProfiler {
      // as myOperation
    }
  * \endcode
+ *
+ * Intervals are recorded by `TraceRecorder` while it records, and as NVTX
+ * ranges in CUDA builds. The tracer also opens the `TraceScope` of the same
+ * name, unless it only labels the interval of a tensor op.
  */
-class ProfileTracer {
+class FL_API ProfileTracer {
  public:
   explicit ProfileTracer(const std::string& name);
+
+  /**
+   * Labels the interval with the scope with the given id, as returned by
+   * `TraceScope::intern`. Does nothing if `id` is 0.
+   *
+   * @param[in] openScope whether to open the scope too. Tensor ops don't, so
+   * that their allocations stay attributed to the enclosing scope, e.g. the
+   * module computing them.
+   */
+  explicit ProfileTracer(uint32_t id, bool openScope = true);
+
   ~ProfileTracer();
+
+  ProfileTracer(const ProfileTracer&) = delete;
+  ProfileTracer& operator=(const ProfileTracer&) = delete;
+
+ private:
+  uint32_t id_;
+  TraceScope scope_;
+  // start of the interval if recorded by TraceRecorder, else -1
+  int64_t startNs_{-1};
+  bool rangePushed_{false};
 };
 
 } // namespace detail
 } // namespace fl
 
-#if FL_BUILD_PROFILING
 // Used to generate a unique name for the expansion
-#define _FL_PROFILE_CAT(a, b) a##b
+#define _FL_PROFILE_CAT_IMPL(a, b) a##b
+#define _FL_PROFILE_CAT(a, b) _FL_PROFILE_CAT_IMPL(a, b)
 
+#if FL_BUILD_PROFILING
 #define FL_PROFILE_TRACE(name) \
   fl::detail::ProfileTracer _FL_PROFILE_CAT(profileTracer, __LINE__)(name);
 
+// Labels the interval of a tensor op with a name known at compile time,
+// interned once. Doesn't open a scope.
+#define FL_PROFILE_TRACE_STATIC(name)                                 \
+  static const uint32_t _FL_PROFILE_CAT(profileScope, __LINE__) =     \
+      fl::detail::TraceScope::intern(name);                           \
+  fl::detail::ProfileTracer _FL_PROFILE_CAT(profileTracer, __LINE__)( \
+      _FL_PROFILE_CAT(profileScope, __LINE__), /* openScope = */ false);
+
+// Opens the scope with the given id, which is also profiled
+#define FL_TRACE_SCOPE(id) \
+  fl::detail::ProfileTracer _FL_PROFILE_CAT(profileTracer, __LINE__)(id);
+
 #define FL_SCOPED_PROFILE() \
   fl::detail::ScopedProfiler _FL_PROFILE_CAT(scopedProfile, __LINE__);
 
 #else
 #define FL_PROFILE_TRACE(_)
+#define FL_PROFILE_TRACE_STATIC(_)
+#define FL_TRACE_SCOPE(id) \
+  fl::detail::TraceScope _FL_PROFILE_CAT(traceScope, __LINE__)(id);
 #define FL_SCOPED_PROFILE()
 #endif
@@ -7,8 +7,10 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include "flashlight/fl/common/Defines.h"
@@ -154,6 +156,14 @@ class FL_API TensorAdapterBase {
    */
   virtual bool isLocked() = 0;
 
+  /**
+   * Returns an identifier of the data of the tensor, or std::nullopt if the
+   * backend doesn't track it. See Tensor::dataVersion().
+   */
+  virtual std::optional<uint64_t> dataVersion() {
+    return std::nullopt;
+  }
+
   /**
    * Returns a bool based on Tensor contiguousness in memory.
    */
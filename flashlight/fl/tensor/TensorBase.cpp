@@ -12,6 +12,7 @@
 #include <algorithm>
 
 #include "flashlight/fl/tensor/DefaultTensorType.h"
+#include "flashlight/fl/tensor/Profile.h"
 #include "flashlight/fl/tensor/TensorAdapter.h"
 #include "flashlight/fl/tensor/TensorBackend.h"
 
@@ -250,6 +251,10 @@ bool Tensor::isLocked() const {
   return impl_->isLocked();
 }
 
+std::optional<uint64_t> Tensor::dataVersion() const {
+  return impl_->dataVersion();
+}
+
 bool Tensor::isContiguous() const {
   return impl_->isContiguous();
 }
@@ -371,6 +376,7 @@ FL_CREATE_FUN_LITERAL_TYPE(const unsigned short&);
 #undef FL_CREATE_FUN_LITERAL_TYPE
 
 Tensor identity(const Dim dim, const dtype type) {
+  FL_PROFILE_TRACE_STATIC("identity");
   return defaultTensorBackend().identity(dim, type);
 }
 
@@ -391,24 +397,29 @@ FL_ARANGE_FUN_DEF(const long long&);
 FL_ARANGE_FUN_DEF(const unsigned long long&);
 
 Tensor arange(const Shape& shape, const Dim seqDim, const dtype type) {
+  FL_PROFILE_TRACE_STATIC("arange");
   return defaultTensorBackend().arange(shape, seqDim, type);
 }
 
 Tensor iota(const Shape& dims, const Shape& tileDims, const dtype type) {
+  FL_PROFILE_TRACE_STATIC("iota");
   return defaultTensorBackend().iota(dims, tileDims, type);
 }
 
 /************************ Shaping and Indexing *************************/
 
 Tensor reshape(const Tensor& tensor, const Shape& shape) {
+  FL_PROFILE_TRACE_STATIC("reshape");
   return tensor.backend().reshape(tensor, shape);
 }
 
 Tensor transpose(const Tensor& tensor, const Shape& axes /* = {} */) {
+  FL_PROFILE_TRACE_STATIC("transpose");
   return tensor.backend().transpose(tensor, axes);
 }
 
 Tensor tile(const Tensor& tensor, const Shape& shape) {
+  FL_PROFILE_TRACE_STATIC("tile");
   return tensor.backend().tile(tensor, shape);
 }
 
@@ -428,10 +439,12 @@ Tensor concatenate(const std::vector<Tensor>& tensors, const unsigned axis) {
         "concatenate: tried to concatenate tensors of different backends");
   }
 
+  FL_PROFILE_TRACE_STATIC("concatenate");
   return tensors.front().backend().concatenate(tensors, axis);
 }
 
 Tensor nonzero(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("nonzero");
   return tensor.backend().nonzero(tensor);
 }
 
@@ -439,129 +452,159 @@ Tensor pad(
     const Tensor& input,
     const std::vector<std::pair<int, int>>& padWidths,
     const PadType type) {
+  FL_PROFILE_TRACE_STATIC("pad");
   return input.backend().pad(input, padWidths, type);
 }
 
 /************************** Unary Operators ***************************/
 Tensor exp(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("exp");
   return tensor.backend().exp(tensor);
 }
 
 Tensor log(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("log");
   return tensor.backend().log(tensor);
 }
 
 Tensor negative(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("negative");
   return tensor.backend().negative(tensor);
 }
 
 Tensor logicalNot(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("logicalNot");
   return tensor.backend().logicalNot(tensor);
 }
 
 Tensor log1p(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("log1p");
   return tensor.backend().log1p(tensor);
 }
 
 Tensor sin(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("sin");
   return tensor.backend().sin(tensor);
 }
 
 Tensor cos(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("cos");
   return tensor.backend().cos(tensor);
 }
 
 Tensor sqrt(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("sqrt");
   return tensor.backend().sqrt(tensor);
 }
 
 Tensor tanh(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("tanh");
   return tensor.backend().tanh(tensor);
 }
 
 Tensor floor(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("floor");
   return tensor.backend().floor(tensor);
 }
 
 Tensor ceil(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("ceil");
   return tensor.backend().ceil(tensor);
 }
 
 Tensor rint(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("rint");
   return tensor.backend().rint(tensor);
 }
 
 Tensor absolute(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("absolute");
   return tensor.backend().absolute(tensor);
 }
 
 Tensor sigmoid(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("sigmoid");
   return tensor.backend().sigmoid(tensor);
 }
 
 Tensor erf(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("erf");
   return tensor.backend().erf(tensor);
 }
 
 Tensor flip(const Tensor& tensor, const unsigned dim) {
+  FL_PROFILE_TRACE_STATIC("flip");
   return tensor.backend().flip(tensor, dim);
 }
 
 Tensor clip(const Tensor& tensor, const Tensor& low, const Tensor& high) {
   FL_TENSOR_BACKENDS_MATCH_CHECK(tensor, low, high);
+  FL_PROFILE_TRACE_STATIC("clip");
   return tensor.backend().clip(tensor, low, high);
 }
 
 Tensor clip(const Tensor& tensor, const Tensor& low, const double& high) {
   FL_TENSOR_BACKENDS_MATCH_CHECK(tensor, low);
+  FL_PROFILE_TRACE_STATIC("clip");
   return tensor.backend().clip(tensor, low, high);
 }
 
 Tensor clip(const Tensor& tensor, const double& low, const Tensor& high) {
   FL_TENSOR_BACKENDS_MATCH_CHECK(tensor, high);
+  FL_PROFILE_TRACE_STATIC("clip");
   return tensor.backend().clip(tensor, low, high);
 }
 
 Tensor clip(const Tensor& tensor, const double& low, const double& high) {
+  FL_PROFILE_TRACE_STATIC("clip");
   return tensor.backend().clip(tensor, low, high);
 }
 
 Tensor roll(const Tensor& tensor, const int shift, const unsigned axis) {
+  FL_PROFILE_TRACE_STATIC("roll");
   return tensor.backend().roll(tensor, shift, axis);
 }
 
 Tensor isnan(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("isnan");
   return tensor.backend().isnan(tensor);
 }
 
 Tensor isinf(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("isinf");
   return tensor.backend().isinf(tensor);
 }
 
 Tensor sign(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("sign");
   return tensor.backend().sign(tensor);
 }
 
 Tensor tril(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("tril");
   return tensor.backend().tril(tensor);
 }
 
 Tensor triu(const Tensor& tensor) {
+  FL_PROFILE_TRACE_STATIC("triu");
   return tensor.backend().triu(tensor);
 }
 
 Tensor where(const Tensor& condition, const Tensor& x, const Tensor& y) {
   FL_TENSOR_BACKENDS_MATCH_CHECK(condition, x, y);
+  FL_PROFILE_TRACE_STATIC("where");
   return condition.backend().where(condition, x, y);
 }
 
 Tensor where(const Tensor& condition, const Tensor& x, const double& y) {
   FL_TENSOR_BACKENDS_MATCH_CHECK(condition, x);
+  FL_PROFILE_TRACE_STATIC("where");
   return condition.backend().where(condition, x, y);
 }
 
 Tensor where(const Tensor& condition, const double& x, const Tensor& y) {
   FL_TENSOR_BACKENDS_MATCH_CHECK(condition, y);
+  FL_PROFILE_TRACE_STATIC("where");
   return condition.backend().where(condition, x, y);
 }
 
@@ -573,10 +616,12 @@ void topk(
     const Dim axis,
     const SortMode sortMode /* = SortMode::Descending */) {
   FL_TENSOR_BACKENDS_MATCH_CHECK(values, indices, input);
+  FL_PROFILE_TRACE_STATIC("topk");
   input.backend().topk(values, indices, input, k, axis, sortMode);
 }
 
 Tensor sort(const Tensor& input, const Dim axis, const SortMode sortMode) {
+  FL_PROFILE_TRACE_STATIC("sort");
   return input.backend().sort(input, axis, sortMode);
 }
 
@@ -586,19 +631,23 @@ void sort(
     const Tensor& input,
     const Dim axis,
     const SortMode sortMode /* = SortMode::Descending */) {
+  FL_PROFILE_TRACE_STATIC("sort");
   return values.backend().sort(values, indices, input, axis, sortMode);
 }
 
 Tensor argsort(const Tensor& input, const Dim axis, const SortMode sortMode) {
+  FL_PROFILE_TRACE_STATIC("argsort");
   return input.backend().argsort(input, axis, sortMode);
 }
 
 /************************** Binary Operators ***************************/
 #define FL_BINARY_OP_LITERAL_TYPE_DEF(OP, FUNC, TYPE) \
   Tensor FUNC(TYPE lhs, const Tensor& rhs) {          \
+    FL_PROFILE_TRACE_STATIC(#FUNC);                   \
     return rhs.backend().FUNC(lhs, rhs);              \
   }                                                   \
   Tensor FUNC(const Tensor& lhs, TYPE rhs) {          \
+    FL_PROFILE_TRACE_STATIC(#FUNC);                   \
     return lhs.backend().FUNC(lhs, rhs);              \
   }                                                   \
   Tensor operator OP(TYPE lhs, const Tensor& rhs) {   \
@@ -626,6 +675,7 @@ Tensor argsort(const Tensor& input, const Dim axis, const SortMode sortMode) {
 #define FL_BINARY_OP_DEF(OP, FUNC)                           \
   Tensor FUNC(const Tensor& lhs, const Tensor& rhs) {        \
     FL_TENSOR_BACKENDS_MATCH_CHECK(lhs, rhs);                \
+    FL_PROFILE_TRACE_STATIC(#FUNC);                          \
     return lhs.backend().FUNC(lhs, rhs);                     \
   }                                                          \
   Tensor operator OP(const Tensor& lhs, const Tensor& rhs) { \
@@ -658,40 +708,49 @@ FL_BINARY_OP_DEF(>>, rShift);
 
 Tensor minimum(const Tensor& lhs, const Tensor& rhs) {
   FL_TENSOR_BACKENDS_MATCH_CHECK(lhs, rhs);
+  FL_PROFILE_TRACE_STATIC("minimum");
   return lhs.backend().minimum(lhs, rhs);
 }
 
 Tensor maximum(const Tensor& lhs, const Tensor& rhs) {
   FL_TENSOR_BACKENDS_MATCH_CHECK(lhs, rhs);
+  FL_PROFILE_TRACE_STATIC("maximum");
   return lhs.backend().maximum(lhs, rhs);
 }
 
 Tensor minimum(const Tensor& lhs, const double& rhs) {
+  FL_PROFILE_TRACE_STATIC("minimum");
   return lhs.backend().minimum(lhs, rhs);
 }
 
 Tensor minimum(const double& lhs, const Tensor& rhs) {
+  FL_PROFILE_TRACE_STATIC("minimum");
   return rhs.backend().minimum(lhs, rhs);
 }
 
 Tensor maximum(const Tensor& lhs, const double& rhs) {
+  FL_PROFILE_TRACE_STATIC("maximum");
   return lhs.backend().maximum(lhs, rhs);
 }
 
 Tensor maximum(const double& lhs, const Tensor& rhs) {
+  FL_PROFILE_TRACE_STATIC("maximum");
   return rhs.backend().maximum(lhs, rhs);
 }
 
 Tensor power(const Tensor& lhs, const Tensor& rhs) {
   FL_TENSOR_BACKENDS_MATCH_CHECK(lhs, rhs);
+  FL_PROFILE_TRACE_STATIC("power");
   return lhs.backend().power(lhs, rhs);
 }
 
 Tensor power(const Tensor& lhs, const double& rhs) {
+  FL_PROFILE_TRACE_STATIC("power");
   return lhs.backend().power(lhs, rhs);
 }
 
 Tensor power(const double& lhs, const Tensor& rhs) {
+  FL_PROFILE_TRACE_STATIC("power");
   return rhs.backend().power(lhs, rhs);
 }
 
@@ -702,6 +761,7 @@ Tensor matmul(
     MatrixProperty lhsProp,
     MatrixProperty rhsProp) {
   FL_TENSOR_BACKENDS_MATCH_CHECK(lhs, rhs);
+  FL_PROFILE_TRACE_STATIC("matmul");
   return lhs.backend().matmul(lhs, rhs, lhsProp, rhsProp);
 }
 
@@ -711,6 +771,7 @@ Tensor amin(
     const Tensor& input,
     const std::vector<int>& axes /* = {} */,
     const bool keepDims /* = false */) {
+  FL_PROFILE_TRACE_STATIC("amin");
   return input.backend().amin(input, axes, keepDims);
 }
 
@@ -718,6 +779,7 @@ Tensor amax(
     const Tensor& input,
     const std::vector<int>& axes /* = {} */,
     const bool keepDims /* = false */) {
+  FL_PROFILE_TRACE_STATIC("amax");
   return input.backend().amax(input, axes, keepDims);
 }
 
@@ -728,6 +790,7 @@ void min(
     const unsigned axis,
     const bool keepDims) {
   FL_TENSOR_BACKENDS_MATCH_CHECK(values, indices, input);
+  FL_PROFILE_TRACE_STATIC("min");
   return input.backend().min(values, indices, input, axis, keepDims);
 }
 
@@ -738,6 +801,7 @@ void max(
     const unsigned axis,
     const bool keepDims /* = false */) {
   FL_TENSOR_BACKENDS_MATCH_CHECK(values, indices, input);
+  FL_PROFILE_TRACE_STATIC("max");
   return input.backend().max(values, indices, input, axis, keepDims);
 }
 
@@ -745,10 +809,12 @@ Tensor sum(
     const Tensor& input,
     const std::vector<int>& axes /* = {} */,
     const bool keepDims /* = false */) {
+  FL_PROFILE_TRACE_STATIC("sum");
   return input.backend().sum(input, axes, keepDims);
 }
 
 Tensor cumsum(const Tensor& input, const unsigned axis) {
+  FL_PROFILE_TRACE_STATIC("cumsum");
   return input.backend().cumsum(input, axis);
 }
 
@@ -756,6 +822,7 @@ Tensor argmax(
     const Tensor& input,
     const unsigned axis,
     const bool keepDims /* = false */) {
+  FL_PROFILE_TRACE_STATIC("argmax");
   return input.backend().argmax(input, axis, keepDims);
 }
 
@@ -763,6 +830,7 @@ Tensor argmin(
     const Tensor& input,
     const unsigned axis,
     const bool keepDims /* = false */) {
+  FL_PROFILE_TRACE_STATIC("argmin");
   return input.backend().argmin(input, axis, keepDims);
 }
 
@@ -770,6 +838,7 @@ Tensor mean(
     const Tensor& input,
     const std::vector<int>& axes /* = {} */,
     const bool keepDims /* = false */) {
+  FL_PROFILE_TRACE_STATIC("mean");
   return input.backend().mean(input, axes, keepDims);
 }
 
@@ -777,6 +846,7 @@ Tensor median(
     const Tensor& input,
     const std::vector<int>& axes /* = {} */,
     const bool keepDims /* = false */) {
+  FL_PROFILE_TRACE_STATIC("median");
   return input.backend().median(input, axes, keepDims);
 }
 
@@ -785,6 +855,7 @@ Tensor var(
     const std::vector<int>& axes /* = {} */,
     const bool bias,
     const bool keepDims /* = false */) {
+  FL_PROFILE_TRACE_STATIC("var");
   return input.backend().var(input, axes, bias, keepDims);
 }
 
@@ -792,6 +863,7 @@ Tensor std(
     const Tensor& input,
     const std::vector<int>& axes /* = {} */,
     const bool keepDims /* = false */) {
+  FL_PROFILE_TRACE_STATIC("std");
   return input.backend().std(input, axes, keepDims);
 }
 
@@ -800,6 +872,7 @@ Tensor norm(
     const std::vector<int>& axes /* = {} */,
     double p /* = 2 */,
     const bool keepDims /* = false */) {
+  FL_PROFILE_TRACE_STATIC("norm");
   return input.backend().norm(input, axes, p, keepDims);
 }
 
@@ -807,6 +880,7 @@ Tensor countNonzero(
     const Tensor& input,
     const std::vector<int>& axes /* = {} */,
     const bool keepDims /* = false */) {
+  FL_PROFILE_TRACE_STATIC("countNonzero");
   return input.backend().countNonzero(input, axes, keepDims);
 }
 
@@ -814,6 +888,7 @@ Tensor any(
     const Tensor& input,
     const std::vector<int>& axes /* = {} */,
     const bool keepDims /* = false */) {
+  FL_PROFILE_TRACE_STATIC("any");
   return input.backend().any(input, axes, keepDims);
 }
 
@@ -821,6 +896,7 @@ Tensor all(
     const Tensor& input,
     const std::vector<int>& axes /* = {} */,
     const bool keepDims /* = false */) {
+  FL_PROFILE_TRACE_STATIC("all");
   return input.backend().all(input, axes, keepDims);
 }
 
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -562,6 +563,18 @@ class FL_API Tensor {
    */
   bool isLocked() const;
 
+  /**
+   * Returns an identifier of the data of the tensor which changes whenever the
+   * data is written through the Tensor API, and is never reused for other
+   * data. Tensors sharing data, such as copies that weren't written to since,
+   * have the same identifier. Writes through pointers from Tensor::device()
+   * aren't tracked.
+   *
+   * @return the identifier, or std::nullopt if the backend doesn't track the
+   * data of the tensor
+   */
+  std::optional<uint64_t> dataVersion() const;
+
   /**
    * Returns if the Tensor is contiguous in its memory-based representation.
    *
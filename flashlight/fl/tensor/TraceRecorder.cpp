@@ -0,0 +1,222 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/TraceRecorder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flashlight/fl/common/Utils.h"
+#include "flashlight/fl/tensor/Profile.h"
+
+namespace fl {
+
+namespace {
+
+struct Interval {
+  int64_t startNs;
+  int64_t endNs;
+  uint32_t scope;
+};
+
+/**
+ * Intervals recorded by one thread. Only the owning thread writes; `count`
+ * is published with release semantics after each write so that readers see
+ * complete intervals.
+ */
+struct ThreadBuffer {
+  ThreadBuffer(uint32_t threadId, uint64_t generation, size_t capacity)
+      : threadId(threadId),
+        generation(generation),
+        capacity(capacity),
+        intervals(std::make_unique<Interval[]>(capacity)) {}
+
+  const uint32_t threadId;
+  // recording session the buffer belongs to
+  const uint64_t generation;
+  const size_t capacity;
+  std::unique_ptr<Interval[]> intervals;
+  // number of intervals ever written
+  std::atomic<uint64_t> count{0};
+};
+
+struct Recorder {
+  std::atomic<bool> recording{false};
+  // Bumped by start and clear, so that threads move to new buffers
+  std::atomic<uint64_t> generation{0};
+  std::atomic<uint32_t> nextThreadId{0};
+  std::mutex mutex;
+  size_t capacity{TraceRecorder::kDefaultCapacity};
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+Recorder& recorder() {
+  // Leaked so that threads can record during static destruction
+  static auto* instance = new Recorder();
+  return *instance;
+}
+
+const std::chrono::steady_clock::time_point kEpoch =
+    std::chrono::steady_clock::now();
+
+uint32_t threadId() {
+  thread_local const uint32_t id = recorder().nextThreadId++;
+  return id;
+}
+
+ThreadBuffer& threadBuffer() {
+  thread_local std::shared_ptr<ThreadBuffer> buffer;
+  auto& rec = recorder();
+  const auto generation = rec.generation.load(std::memory_order_acquire);
+  if (!buffer || buffer->generation != generation) {
+    std::lock_guard<std::mutex> lock(rec.mutex);
+    buffer = std::make_shared<ThreadBuffer>(
+        threadId(), rec.generation.load(), rec.capacity);
+    rec.buffers.push_back(buffer);
+  }
+  return *buffer;
+}
+
+} // namespace
+
+void TraceRecorder::start(size_t capacity) {
+  if (capacity == 0) {
+    throw std::invalid_argument("TraceRecorder::start - capacity must be > 0");
+  }
+  auto& rec = recorder();
+  std::lock_guard<std::mutex> lock(rec.mutex);
+  if (rec.recording) {
+    return;
+  }
+  rec.capacity = capacity;
+  ++rec.generation;
+  detail::TraceScope::enable();
+  rec.recording = true;
+}
+
+void TraceRecorder::stop() {
+  auto& rec = recorder();
+  std::lock_guard<std::mutex> lock(rec.mutex);
+  if (!rec.recording) {
+    return;
+  }
+  rec.recording = false;
+  detail::TraceScope::disable();
+}
+
+bool TraceRecorder::recording() {
+  return recorder().recording.load(std::memory_order_relaxed);
+}
+
+void TraceRecorder::clear() {
+  auto& rec = recorder();
+  std::lock_guard<std::mutex> lock(rec.mutex);
+  ++rec.generation;
+  rec.buffers.clear();
+}
+
+int64_t TraceRecorder::now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - kEpoch)
+      .count();
+}
+
+void TraceRecorder::record(uint32_t scope, int64_t startNs, int64_t endNs) {
+  if (!recording()) {
+    return;
+  }
+  auto& buffer = threadBuffer();
+  const auto index = buffer.count.load(std::memory_order_relaxed);
+  buffer.intervals[index % buffer.capacity] = {startNs, endNs, scope};
+  buffer.count.store(index + 1, std::memory_order_release);
+}
+
+void TraceRecorder::save(const fs::path& filepath) {
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  {
+    auto& rec = recorder();
+    std::lock_guard<std::mutex> lock(rec.mutex);
+    buffers = rec.buffers;
+  }
+
+  std::ofstream file(filepath, std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::runtime_error(
+        "TraceRecorder::save - failed to open file for writing: " +
+        filepath.string());
+  }
+
+  std::unordered_map<uint32_t, std::string> names;
+  auto nameOf = [&names](uint32_t scope) -> const std::string& {
+    auto it = names.find(scope);
+    if (it == names.end()) {
+      it = names.emplace(scope, jsonEscape(detail::TraceScope::name(scope)))
+               .first;
+    }
+    return it->second;
+  };
+
+  // Timestamps are in microseconds
+  file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[\n";
+  bool first = true;
+  std::vector<uint32_t> threadIds;
+  std::vector<Interval> intervals;
+  for (const auto& buffer : buffers) {
+    // Copy the intervals, then drop those the thread may have overwritten
+    // meanwhile
+    const auto end = buffer->count.load(std::memory_order_acquire);
+    auto begin = end > buffer->capacity ? end - buffer->capacity : 0;
+    intervals.clear();
+    for (auto i = begin; i < end; ++i) {
+      intervals.push_back(buffer->intervals[i % buffer->capacity]);
+    }
+    const auto newEnd = buffer->count.load(std::memory_order_acquire);
+    // The thread may be writing interval newEnd, in the slot of interval
+    // newEnd - capacity, so that one is dropped too
+    const auto overwritten =
+        newEnd + 1 > buffer->capacity ? newEnd + 1 - buffer->capacity : 0;
+    const auto skip = std::min<uint64_t>(
+        intervals.size(), overwritten > begin ? overwritten - begin : 0);
+
+    for (size_t i = skip; i < intervals.size(); ++i) {
+      const auto& interval = intervals[i];
+      file << (first ? "" : ",\n") << "{\"name\":\"" << nameOf(interval.scope)
+           << "\",\"ph\":\"X\",\"ts\":" << interval.startNs / 1e3
+           << ",\"dur\":" << (interval.endNs - interval.startNs) / 1e3
+           << ",\"pid\":0,\"tid\":" << buffer->threadId << "}";
+      first = false;
+    }
+    threadIds.push_back(buffer->threadId);
+  }
+
+  std::sort(threadIds.begin(), threadIds.end());
+  threadIds.erase(
+      std::unique(threadIds.begin(), threadIds.end()), threadIds.end());
+  for (auto id : threadIds) {
+    file << (first ? "" : ",\n")
+         << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << id
+         << ",\"args\":{\"name\":\"thread " << id << "\"}}";
+    first = false;
+  }
+  file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  file.close();
+  if (!file) {
+    throw std::runtime_error(
+        "TraceRecorder::save - failed to write file: " + filepath.string());
+  }
+}
+
+} // namespace fl
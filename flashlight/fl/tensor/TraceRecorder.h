@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "flashlight/fl/common/Defines.h"
+#include "flashlight/fl/common/Filesystem.h"
+
+namespace fl {
+
+/**
+ * Records the intervals labeled by `FL_PROFILE_TRACE` on every thread and
+ * saves them as a Chrome trace event JSON file, to be opened in
+ * chrome://tracing or Perfetto. This profiles CPU time without external
+ * tools:
+ * \code
+   TraceRecorder::start();
+   for (auto& sample : dataset) {
+     // train
+   }
+   TraceRecorder::stop();
+   TraceRecorder::save("trace.json");
+ * \endcode
+ *
+ * Intervals are labeled around tensor operations, the forward computation of
+ * modules, the gradient functions of autograd nodes, dataset reads and
+ * allreduces when Flashlight is built with `FL_BUILD_PROFILING`.
+ *
+ * Each thread records to its own ring buffer, without locking; once a buffer
+ * is full, the oldest intervals of the thread are overwritten. Intervals
+ * being recorded while saving may be missing from the file.
+ */
+class FL_API TraceRecorder {
+ public:
+  static constexpr size_t kDefaultCapacity = 1 << 16;
+
+  /**
+   * Starts recording. Enables `fl::detail::TraceScope` tracking, so that
+   * modules and autograd nodes are labeled.
+   *
+   * @param[in] capacity the number of intervals each thread keeps at most.
+   * Once full, the oldest of them may be being overwritten, so isn't saved.
+   */
+  static void start(size_t capacity = kDefaultCapacity);
+
+  /**
+   * Stops recording. Recorded intervals are kept until `clear` is called.
+   */
+  static void stop();
+
+  /**
+   * @return whether intervals are being recorded
+   */
+  static bool recording();
+
+  /**
+   * Discards the recorded intervals.
+   */
+  static void clear();
+
+  /**
+   * Saves the recorded intervals as a Chrome trace event JSON file.
+   */
+  static void save(const fs::path& filepath);
+
+  /**
+   * @return the current time in nanoseconds, as used to record intervals
+   */
+  static int64_t now();
+
+  /**
+   * Records an interval of the calling thread labeled with the scope `scope`
+   * - see `fl::detail::TraceScope`. Does nothing when not recording.
+   */
+  static void record(uint32_t scope, int64_t startNs, int64_t endNs);
+};
+
+} // namespace fl
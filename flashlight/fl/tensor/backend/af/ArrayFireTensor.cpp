@@ -25,6 +25,19 @@
 #include <af/sparse.h>
 
 namespace fl {
+namespace {
+
+uint64_t nextDataVersion() {
+  static std::atomic<uint64_t> version{0};
+  return ++version;
+}
+
+std::shared_ptr<std::atomic<uint64_t>> makeDataVersion(
+    uint64_t version = nextDataVersion()) {
+  return std::make_shared<std::atomic<uint64_t>>(version);
+}
+
+} // namespace
 
 const af::array& toArray(const Tensor& tensor) {
   if (tensor.backendType() != TensorBackendType::ArrayFire) {
@@ -42,6 +55,7 @@ af::array& toArray(Tensor& tensor) {
 
 ArrayFireTensor::ArrayFireTensor(af::array&& array, const unsigned numDims)
     : arrayHandle_(std::make_shared<af::array>(std::move(array))),
+      dataVersion_(makeDataVersion()),
       numDims_(numDims) {}
 
 ArrayFireTensor::ArrayFireTensor(
@@ -49,8 +63,10 @@ ArrayFireTensor::ArrayFireTensor(
     std::vector<af::index>&& afIndices,
     std::vector<detail::IndexType>&& indexTypes,
     const unsigned numDims,
-    const bool isFlat)
+    const bool isFlat,
+    std::shared_ptr<std::atomic<uint64_t>> dataVersion)
     : arrayHandle_(arr),
+      dataVersion_(std::move(dataVersion)),
       indices_(std::move(afIndices)),
       indexTypes_(std::move(indexTypes)),
       handle_(IndexedArrayComponent(isFlat)),
@@ -58,11 +74,16 @@ ArrayFireTensor::ArrayFireTensor(
 
 ArrayFireTensor::ArrayFireTensor(
     std::shared_ptr<af::array> arr,
-    unsigned numDims)
-    : arrayHandle_(arr), numDims_(numDims) {}
+    unsigned numDims,
+    std::shared_ptr<std::atomic<uint64_t>> dataVersion)
+    : arrayHandle_(arr),
+      dataVersion_(std::move(dataVersion)),
+      numDims_(numDims) {}
 
 ArrayFireTensor::ArrayFireTensor()
-    : arrayHandle_(std::make_shared<af::array>()), handle_(ArrayComponent()) {}
+    : arrayHandle_(std::make_shared<af::array>()),
+      dataVersion_(makeDataVersion()),
+      handle_(ArrayComponent()) {}
 
 ArrayFireTensor::ArrayFireTensor(
     const Shape& shape,
@@ -71,6 +92,7 @@ ArrayFireTensor::ArrayFireTensor(
     Location memoryLocation)
     : arrayHandle_(std::make_shared<af::array>(
           detail::fromFlData(shape, ptr, type, memoryLocation))),
+      dataVersion_(makeDataVersion()),
       handle_(ArrayComponent()),
       numDims_(shape.ndim()) {}
 
@@ -88,6 +110,7 @@ ArrayFireTensor::ArrayFireTensor(
           toArray(rowIdx),
           toArray(colIdx),
           detail::flToAfStorageType(storageType)))),
+      dataVersion_(makeDataVersion()),
       handle_(ArrayComponent()),
       // ArrayFire only supports 2D sparsity
       numDims_(2) {}
@@ -142,6 +165,8 @@ af::array& ArrayFireTensor::getHandle() {
         /* keepDims = */ false,
         indexTypes_,
         /* isFlat = */ idxComp.isFlat));
+    // The indexed array no longer shares the data of the tensor it indexes
+    dataVersion_ = makeDataVersion();
     // Clear state
     handle_ = ArrayComponent(); // set to passthrough
     indices_ = {}; // remove indices
@@ -152,8 +177,10 @@ af::array& ArrayFireTensor::getHandle() {
 
 std::unique_ptr<TensorAdapterBase> ArrayFireTensor::clone() const {
   af::array arr = getHandle(); // increment internal AF refcount
-  return std::make_unique<ArrayFireTensor>(
-      std::move(arr), numDims());
+  auto out = std::make_unique<ArrayFireTensor>(std::move(arr), numDims());
+  // Arrays are copy-on-write, so the clone has the same data until written
+  out->dataVersion_ = makeDataVersion(dataVersion_->load());
+  return out;
 }
 
 Tensor ArrayFireTensor::copy() {
@@ -164,7 +191,7 @@ Tensor ArrayFireTensor::copy() {
 Tensor ArrayFireTensor::shallowCopy() {
   getHandle(); // if this tensor was a view, run indexing and promote
   return Tensor(std::unique_ptr<ArrayFireTensor>(
-      new ArrayFireTensor(arrayHandle_, numDims())));
+      new ArrayFireTensor(arrayHandle_, numDims(), dataVersion_)));
 }
 
 TensorBackendType ArrayFireTensor::backendType() const {
@@ -224,6 +251,18 @@ void ArrayFireTensor::unlock() {
   AF_CHECK(af_unlock_array(getHandle().get()));
 }
 
+std::optional<uint64_t> ArrayFireTensor::dataVersion() {
+  // Views which weren't indexed yet share the version of the tensor they index
+  if (!std::holds_alternative<ArrayComponent>(handle_)) {
+    return std::nullopt;
+  }
+  return dataVersion_->load();
+}
+
+void ArrayFireTensor::updateDataVersion() {
+  dataVersion_->store(nextDataVersion());
+}
+
 bool ArrayFireTensor::isLocked() {
   bool res;
   auto err = af_is_locked_array(&res, getHandle().get());
@@ -251,7 +290,12 @@ const Stream& ArrayFireTensor::stream() const {
 
 Tensor ArrayFireTensor::astype(const dtype type) {
   auto a = getHandle().as(detail::flToAfType(type));
-  return toTensor<ArrayFireTensor>(std::move(a), numDims());
+  auto out = std::make_unique<ArrayFireTensor>(std::move(a), numDims());
+  if (type == this->type()) {
+    // The array is shared, as for clone()
+    out->dataVersion_ = makeDataVersion(dataVersion_->load());
+  }
+  return Tensor(std::move(out));
 }
 
 Tensor ArrayFireTensor::index(const std::vector<Index>& indices) {
@@ -318,7 +362,8 @@ Tensor ArrayFireTensor::index(const std::vector<Index>& indices) {
       std::move(afIndices),
       std::move(indexTypes),
       newNumDims,
-      /* isFlat = */ false)));
+      /* isFlat = */ false,
+      dataVersion_)));
 }
 
 Tensor ArrayFireTensor::flatten() const {
@@ -335,7 +380,8 @@ Tensor ArrayFireTensor::flat(const Index& idx) const {
       {detail::flToAfIndex(idx)},
       {idx.type()},
       /* numDims = */ 1,
-      /* isFlat = */ true)));
+      /* isFlat = */ true,
+      dataVersion_)));
 }
 
 Tensor ArrayFireTensor::asContiguousTensor() {
@@ -374,6 +420,7 @@ std::ostream& ArrayFireTensor::operator<<(std::ostream& ostr) {
   void ArrayFireTensor::FUN(const TYPE& val) {                           \
     std::visit(                                                          \
         [val, this](auto&& arr) { arr.get(*this) AF_OP val; }, handle_); \
+    updateDataVersion();                                                 \
   }
 
 #define ASSIGN_OP_LITERALS(FUN, AF_OP)        \
@@ -488,6 +535,7 @@ af::array ArrayFireTensor::adjustInPlaceOperandDims(const Tensor& operand) {
           arr.get(*this) AF_OP this->adjustInPlaceOperandDims(tensor); \
         },                                                             \
         handle_);                                                      \
+    updateDataVersion();                                               \
   }
 
 #define ASSIGN_OP(FUN, AF_OP)  \
@@ -516,6 +564,7 @@ void ArrayFireTensor::assign(const Tensor& tensor) {
         }
       },
       handle_);
+  updateDataVersion();
 }
 
 /*
@@ -550,6 +599,7 @@ void ArrayFireTensor::inPlaceAdd(const Tensor& tensor) {
           arr.get(*this) += this->adjustInPlaceOperandDims(tensor);
         },
         handle_);
+    updateDataVersion();
     return;
   } else {
     af::dim4 inDims = arrayHandle_->dims();
@@ -588,6 +638,7 @@ void ArrayFireTensor::inPlaceAdd(const Tensor& tensor) {
 
     fl::detail::advancedIndex(
         toArray(tensor), idxStart, idxEnd, inDims, idxArr, *arrayHandle_);
+    updateDataVersion();
   }
 }
 
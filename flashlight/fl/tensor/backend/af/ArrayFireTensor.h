@@ -11,6 +11,10 @@
 #include <af/array.h>
 #include <af/statistics.h>
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <variant>
 
 #include "flashlight/fl/runtime/Stream.h"
@@ -30,6 +34,9 @@ class ArrayFireTensor : public TensorAdapterBase {
   // A pointer to the internal ArrayFire array. Shared amongst tensors that are
   // shallow-copied.
   std::shared_ptr<af::array> arrayHandle_;
+  // Identifies the data of arrayHandle_ - see Tensor::dataVersion(). Shared
+  // amongst tensors sharing arrayHandle_, and renewed whenever it's written.
+  std::shared_ptr<std::atomic<uint64_t>> dataVersion_;
 
   // Indices in the event that this tensor is about to be indexed. Cleared the
   // next time this array handle is acquired. See getHandle().
@@ -72,19 +79,27 @@ class ArrayFireTensor : public TensorAdapterBase {
    * @param[in] indexTypes a vector of index types to lazily index. Needed to
    * determine singleton dimension condensation
    * @param[in] isFlat if the indexing op is flat (condense all dims)
+   * @param[in] dataVersion the data version of the tensor holding the handle
    */
   ArrayFireTensor(
       std::shared_ptr<af::array> handle,
       std::vector<af::index>&& afIndices,
       std::vector<detail::IndexType>&& indexTypes,
       const unsigned numDims,
-      const bool isFlat);
+      const bool isFlat,
+      std::shared_ptr<std::atomic<uint64_t>> dataVersion);
 
   /**
    * Construct an ArrayFireTensor from an ArrayFire array handle without copying
    * the handle. Used for creating guaranteed-shallow copies.
    */
-  explicit ArrayFireTensor(std::shared_ptr<af::array> arr, unsigned numDims);
+  ArrayFireTensor(
+      std::shared_ptr<af::array> arr,
+      unsigned numDims,
+      std::shared_ptr<std::atomic<uint64_t>> dataVersion);
+
+  // Gives the data a new version after it's written
+  void updateDataVersion();
 
   /*
    * A Flashlight Shape that mirrors ArrayFire dims.
@@ -187,6 +202,7 @@ class ArrayFireTensor : public TensorAdapterBase {
   void host(void* out) override;
   void unlock() override;
   bool isLocked() override;
+  std::optional<uint64_t> dataVersion() override;
   bool isContiguous() override;
   Shape strides() override;
   const Stream& stream() const override;
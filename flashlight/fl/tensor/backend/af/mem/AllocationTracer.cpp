@@ -0,0 +1,382 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/fl/tensor/backend/af/mem/AllocationTracer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+#include <utility>
+
+#include "flashlight/fl/common/Utils.h"
+#include "flashlight/fl/tensor/Profile.h"
+
+namespace fl {
+
+namespace {
+
+constexpr char kTraceMagic[8] = {'F', 'L', 'M', 'T', 'R', 'A', 'C', 'E'};
+constexpr uint32_t kTraceFormatVersion = 1;
+
+// Values are written in host byte order
+template <typename T>
+void writeValue(std::ostream& os, const T& value) {
+  os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T readValue(std::istream& is) {
+  T value;
+  if (!is.read(reinterpret_cast<char*>(&value), sizeof(T))) {
+    throw std::runtime_error("AllocationTrace::load - truncated file");
+  }
+  return value;
+}
+
+} // namespace
+
+size_t AllocationTrace::peakBytes() const {
+  size_t live = 0;
+  size_t peak = 0;
+  for (const auto& event : events) {
+    if (event.type == EventType::Alloc) {
+      live += event.bytes;
+      peak = std::max(peak, live);
+    } else {
+      // The allocation may predate the trace
+      live -= std::min<size_t>(live, event.bytes);
+    }
+  }
+  return peak;
+}
+
+std::unordered_map<std::string, AllocationTrace::ScopeStats>
+AllocationTrace::scopeStats() const {
+  std::unordered_map<uint32_t, ScopeStats> stats;
+  std::unordered_map<uint32_t, size_t> scopeLive;
+  size_t live = 0;
+  size_t peak = 0;
+  size_t eventsToPeak = 0;
+  for (size_t i = 0; i < events.size(); ++i) {
+    const auto& event = events[i];
+    auto& scopeStats = stats[event.scope];
+    auto& liveInScope = scopeLive[event.scope];
+    if (event.type == EventType::Alloc) {
+      ++scopeStats.numAllocs;
+      scopeStats.totalBytes += event.bytes;
+      liveInScope += event.bytes;
+      scopeStats.peakBytes = std::max(scopeStats.peakBytes, liveInScope);
+      live += event.bytes;
+      if (live > peak) {
+        peak = live;
+        eventsToPeak = i + 1;
+      }
+    } else {
+      liveInScope -= std::min<size_t>(liveInScope, event.bytes);
+      live -= std::min<size_t>(live, event.bytes);
+    }
+  }
+
+  // Replay up to the peak to find what was in use then
+  scopeLive.clear();
+  for (size_t i = 0; i < eventsToPeak; ++i) {
+    const auto& event = events[i];
+    auto& liveInScope = scopeLive[event.scope];
+    if (event.type == EventType::Alloc) {
+      liveInScope += event.bytes;
+    } else {
+      liveInScope -= std::min<size_t>(liveInScope, event.bytes);
+    }
+  }
+
+  std::unordered_map<std::string, ScopeStats> out;
+  for (const auto& [scope, scopeStats] : stats) {
+    auto nameIt = scopeNames.find(scope);
+    auto& named =
+        out[nameIt == scopeNames.end() ? std::string() : nameIt->second];
+    named.numAllocs += scopeStats.numAllocs;
+    named.totalBytes += scopeStats.totalBytes;
+    named.peakBytes += scopeStats.peakBytes;
+    named.bytesAtPeak += scopeLive[scope];
+  }
+  return out;
+}
+
+void AllocationTrace::save(const fs::path& filepath) const {
+  std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::runtime_error(
+        "AllocationTrace::save - failed to open file for writing: " +
+        filepath.string());
+  }
+  file.write(kTraceMagic, sizeof(kTraceMagic));
+  writeValue(file, kTraceFormatVersion);
+  writeValue(file, static_cast<uint32_t>(scopeNames.size()));
+  for (const auto& [scope, name] : scopeNames) {
+    writeValue(file, scope);
+    writeValue(file, static_cast<uint32_t>(name.size()));
+    file.write(name.data(), name.size());
+  }
+  writeValue(file, static_cast<uint64_t>(events.size()));
+  for (const auto& event : events) {
+    writeValue(file, event.timeNs);
+    writeValue(file, event.ptr);
+    writeValue(file, event.bytes);
+    writeValue(file, event.scope);
+    writeValue(file, static_cast<uint8_t>(event.type));
+  }
+  writeValue(file, static_cast<uint64_t>(snapshots.size()));
+  for (const auto& snapshot : snapshots) {
+    writeValue(file, snapshot.timeNs);
+    writeValue(file, snapshot.liveBytes);
+    writeValue(file, snapshot.reservedBytes);
+    writeValue(file, snapshot.cachedBytes);
+    writeValue(file, snapshot.largestCachedBlock);
+  }
+  file.close();
+  if (!file) {
+    throw std::runtime_error(
+        "AllocationTrace::save - failed to write file: " + filepath.string());
+  }
+}
+
+AllocationTrace AllocationTrace::load(const fs::path& filepath) {
+  std::ifstream file(filepath, std::ios::binary);
+  if (!file.is_open()) {
+    throw std::runtime_error(
+        "AllocationTrace::load - failed to open file: " + filepath.string());
+  }
+  char magic[sizeof(kTraceMagic)];
+  if (!file.read(magic, sizeof(magic)) ||
+      std::memcmp(magic, kTraceMagic, sizeof(magic)) != 0) {
+    throw std::runtime_error(
+        "AllocationTrace::load - not an allocation trace: " +
+        filepath.string());
+  }
+  const auto version = readValue<uint32_t>(file);
+  if (version != kTraceFormatVersion) {
+    throw std::runtime_error(
+        "AllocationTrace::load - unsupported format version " +
+        std::to_string(version) + " in " + filepath.string());
+  }
+
+  AllocationTrace trace;
+  const auto numScopes = readValue<uint32_t>(file);
+  for (uint32_t i = 0; i < numScopes; ++i) {
+    const auto scope = readValue<uint32_t>(file);
+    std::string name(readValue<uint32_t>(file), '\0');
+    if (!file.read(name.data(), name.size())) {
+      throw std::runtime_error("AllocationTrace::load - truncated file");
+    }
+    trace.scopeNames.emplace(scope, std::move(name));
+  }
+  const auto numEvents = readValue<uint64_t>(file);
+  for (uint64_t i = 0; i < numEvents; ++i) {
+    Event event;
+    event.timeNs = readValue<int64_t>(file);
+    event.ptr = readValue<uint64_t>(file);
+    event.bytes = readValue<uint64_t>(file);
+    event.scope = readValue<uint32_t>(file);
+    event.type = static_cast<EventType>(readValue<uint8_t>(file));
+    trace.events.push_back(event);
+  }
+  const auto numSnapshots = readValue<uint64_t>(file);
+  for (uint64_t i = 0; i < numSnapshots; ++i) {
+    MemorySnapshot snapshot;
+    snapshot.timeNs = readValue<int64_t>(file);
+    snapshot.liveBytes = readValue<uint64_t>(file);
+    snapshot.reservedBytes = readValue<uint64_t>(file);
+    snapshot.cachedBytes = readValue<uint64_t>(file);
+    snapshot.largestCachedBlock = readValue<uint64_t>(file);
+    trace.snapshots.push_back(snapshot);
+  }
+  return trace;
+}
+
+void AllocationTrace::saveChromeTrace(const fs::path& filepath) const {
+  std::ofstream file(filepath, std::ios::trunc);
+  if (!file.is_open()) {
+    throw std::runtime_error(
+        "AllocationTrace::saveChromeTrace - failed to open file for writing: " +
+        filepath.string());
+  }
+
+  std::unordered_map<uint32_t, std::string> names;
+  for (const auto& [scope, name] : scopeNames) {
+    names[scope] = jsonEscape(name.empty() ? "(no scope)" : name);
+  }
+  auto nameOf = [&names](uint32_t scope) -> const std::string& {
+    auto it = names.find(scope);
+    if (it == names.end()) {
+      it = names.emplace(scope, "(no scope)").first;
+    }
+    return it->second;
+  };
+
+  // Timestamps are in microseconds
+  file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[\n";
+  bool first = true;
+  auto separator = [&file, &first]() -> std::ostream& {
+    file << (first ? "" : ",\n");
+    first = false;
+    return file;
+  };
+  size_t live = 0;
+  for (const auto& event : events) {
+    const double ts = event.timeNs / 1e3;
+    const bool isAlloc = event.type == EventType::Alloc;
+    separator() << "{\"name\":\"" << nameOf(event.scope)
+                << "\",\"cat\":\"allocation\",\"ph\":\""
+                << (isAlloc ? "b" : "e") << "\",\"id\":\"0x" << std::hex
+                << event.ptr << std::dec << "\",\"ts\":" << ts
+                << ",\"pid\":0,\"tid\":0,\"args\":{\"bytes\":" << event.bytes
+                << "}}";
+    if (isAlloc) {
+      live += event.bytes;
+    } else {
+      live -= std::min<size_t>(live, event.bytes);
+    }
+    separator() << "{\"name\":\"live bytes\",\"ph\":\"C\",\"ts\":" << ts
+                << ",\"pid\":0,\"args\":{\"bytes\":" << live << "}}";
+  }
+  for (const auto& snapshot : snapshots) {
+    separator() << "{\"name\":\"memory manager\",\"ph\":\"C\",\"ts\":"
+                << snapshot.timeNs / 1e3
+                << ",\"pid\":0,\"args\":{\"reserved\":"
+                << snapshot.reservedBytes
+                << ",\"cached\":" << snapshot.cachedBytes
+                << ",\"largest cached block\":" << snapshot.largestCachedBlock
+                << "}}";
+  }
+  file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+  file.close();
+  if (!file) {
+    throw std::runtime_error(
+        "AllocationTrace::saveChromeTrace - failed to write file: " +
+        filepath.string());
+  }
+}
+
+AllocationTracer::AllocationTracer(size_t snapshotInterval)
+    : snapshotInterval_(snapshotInterval),
+      start_(std::chrono::steady_clock::now()) {
+  if (snapshotInterval_ == 0) {
+    throw std::invalid_argument(
+        "AllocationTracer - snapshot interval must be positive");
+  }
+  detail::TraceScope::enable();
+}
+
+AllocationTracer::~AllocationTracer() {
+  detail::TraceScope::disable();
+}
+
+int64_t AllocationTracer::now() const {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now() - start_)
+      .count();
+}
+
+void AllocationTracer::recordAlloc(void* ptr, size_t bytes, bool userLock) {
+  const auto scope = detail::TraceScope::current();
+  const auto timeNs = now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = live_.find(ptr);
+  if (it != live_.end()) {
+    // The free of the previous allocation at ptr was missed, e.g. it was
+    // released before the tracer was set
+    recordFree(it, timeNs);
+  }
+  live_.emplace(ptr, Allocation{bytes, scope, !userLock, userLock});
+  liveBytes_ += bytes;
+  ++allocsSinceSnapshot_;
+  events_.push_back(
+      {timeNs,
+       reinterpret_cast<uint64_t>(ptr),
+       bytes,
+       scope,
+       AllocationTrace::EventType::Alloc});
+}
+
+void AllocationTracer::recordUnlock(void* ptr, bool userLock) {
+  const auto timeNs = now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = live_.find(ptr);
+  if (it == live_.end()) {
+    return;
+  }
+  (userLock ? it->second.userLock : it->second.managerLock) = false;
+  if (!it->second.userLock && !it->second.managerLock) {
+    recordFree(it, timeNs);
+  }
+}
+
+void AllocationTracer::recordUserLock(void* ptr) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = live_.find(ptr);
+  if (it != live_.end()) {
+    it->second.userLock = true;
+  }
+}
+
+void AllocationTracer::recordFree(
+    std::unordered_map<void*, Allocation>::iterator it,
+    int64_t timeNs) {
+  liveBytes_ -= it->second.bytes;
+  events_.push_back(
+      {timeNs,
+       reinterpret_cast<uint64_t>(it->first),
+       it->second.bytes,
+       it->second.scope,
+       AllocationTrace::EventType::Free});
+  live_.erase(it);
+}
+
+bool AllocationTracer::snapshotDue() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return allocsSinceSnapshot_ >= snapshotInterval_;
+}
+
+void AllocationTracer::recordSnapshot(MemorySnapshot snapshot) {
+  snapshot.timeNs = now();
+  std::lock_guard<std::mutex> lock(mutex_);
+  snapshot.liveBytes = liveBytes_;
+  snapshots_.push_back(snapshot);
+  allocsSinceSnapshot_ = 0;
+}
+
+size_t AllocationTracer::liveBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return liveBytes_;
+}
+
+AllocationTrace AllocationTracer::trace() const {
+  AllocationTrace trace;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    trace.events = events_;
+    trace.snapshots = snapshots_;
+  }
+  for (const auto& event : trace.events) {
+    if (!trace.scopeNames.count(event.scope)) {
+      trace.scopeNames.emplace(
+          event.scope, detail::TraceScope::name(event.scope));
+    }
+  }
+  return trace;
+}
+
+void AllocationTracer::clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.clear();
+  snapshots_.clear();
+  allocsSinceSnapshot_ = 0;
+}
+
+} // namespace fl
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "flashlight/fl/common/Defines.h"
+#include "flashlight/fl/common/Filesystem.h"
+
+namespace fl {
+
+/**
+ * The memory held by a memory manager at some point in time, from which its
+ * fragmentation can be measured.
+ */
+struct MemorySnapshot {
+  // nanoseconds since the start of the trace
+  int64_t timeNs{0};
+  // bytes of the allocations in use
+  uint64_t liveBytes{0};
+  // bytes allocated from the device by the manager
+  uint64_t reservedBytes{0};
+  // bytes held by the manager and not in use
+  uint64_t cachedBytes{0};
+  // size of the largest free block held by the manager
+  uint64_t largestCachedBlock{0};
+};
+
+/**
+ * A recorded sequence of allocations and frees, as produced by
+ * `AllocationTracer`.
+ */
+struct FL_API AllocationTrace {
+  enum class EventType : uint8_t { Alloc = 0, Free = 1 };
+
+  struct Event {
+    // nanoseconds since the start of the trace
+    int64_t timeNs;
+    uint64_t ptr;
+    // bytes requested by the allocation
+    uint64_t bytes;
+    // profiling scope the allocation was made in - see
+    // `fl::detail::TraceScope`. Frees are attributed to the scope of their
+    // allocation.
+    uint32_t scope;
+    EventType type;
+  };
+
+  /**
+   * Memory attributed to a profiling scope.
+   */
+  struct ScopeStats {
+    size_t numAllocs{0};
+    size_t totalBytes{0};
+    // maximum of the bytes allocated in the scope and not freed yet
+    size_t peakBytes{0};
+    // bytes allocated in the scope and in use when the live bytes of the
+    // whole trace peaked
+    size_t bytesAtPeak{0};
+  };
+
+  std::vector<Event> events;
+  std::vector<MemorySnapshot> snapshots;
+  // names of the scopes of the events
+  std::unordered_map<uint32_t, std::string> scopeNames;
+
+  /**
+   * @return the maximum number of bytes in use at any point of the trace
+   */
+  size_t peakBytes() const;
+
+  /**
+   * @return the memory attributed to each scope, by scope name. The name of
+   * allocations made outside of any scope is empty.
+   */
+  std::unordered_map<std::string, ScopeStats> scopeStats() const;
+
+  /**
+   * Saves the trace in a compact binary format, read by `load`.
+   */
+  void save(const fs::path& filepath) const;
+
+  static AllocationTrace load(const fs::path& filepath);
+
+  /**
+   * Saves the trace as a Chrome trace event JSON file, to be opened in
+   * chrome://tracing or Perfetto. Allocations are shown as asynchronous spans
+   * named after their scope, and the live bytes and snapshots as counters.
+   */
+  void saveChromeTrace(const fs::path& filepath) const;
+};
+
+/**
+ * Records the allocations of a memory manager, to find out which code holds
+ * memory. Tracing is opt-in: a tracer is set on a manager with
+ * `MemoryManagerAdapter::setAllocationTracer`, which then records every
+ * allocation made through ArrayFire with its size, lifetime and the profiling
+ * scope it was made in, and snapshots the memory held by the manager every
+ * `snapshotInterval` allocations. For instance:
+ *
+ * \code
+   auto tracer = std::make_shared<AllocationTracer>();
+   MemoryManagerInstaller::currentlyInstalledMemoryManager()
+       ->setAllocationTracer(tracer);
+   auto loss = criterion(model(input), target);
+   loss.backward();
+   tracer->trace().saveChromeTrace("memory.json");
+ * \endcode
+ *
+ * Scopes are opened by `FL_PROFILE_TRACE` and around the forward computation
+ * of modules, and backward computations are attributed to the scope of the
+ * forward computation - see `fl::detail::TraceScope`. Scope tracking is
+ * enabled for the lifetime of the tracer.
+ */
+class FL_API AllocationTracer {
+ public:
+  explicit AllocationTracer(size_t snapshotInterval = 1000);
+  ~AllocationTracer();
+
+  AllocationTracer(const AllocationTracer&) = delete;
+  AllocationTracer& operator=(const AllocationTracer&) = delete;
+
+  /**
+   * Records an allocation of `bytes` bytes at `ptr`, locked by the user if
+   * `userLock`.
+   */
+  void recordAlloc(void* ptr, size_t bytes, bool userLock);
+
+  /**
+   * Records that `ptr` is released by ArrayFire (`userLock` false) or the
+   * user. The allocation is freed once released by both.
+   */
+  void recordUnlock(void* ptr, bool userLock);
+
+  void recordUserLock(void* ptr);
+
+  /**
+   * @return whether a snapshot should be recorded, i.e. whether
+   * `snapshotInterval` allocations were recorded since the last one
+   */
+  bool snapshotDue() const;
+
+  /**
+   * Records the memory held by the manager. The live bytes of the snapshot
+   * are filled in by the tracer.
+   */
+  void recordSnapshot(MemorySnapshot snapshot);
+
+  /**
+   * @return the bytes of the recorded allocations not freed yet
+   */
+  size_t liveBytes() const;
+
+  /**
+   * @return a copy of everything recorded so far
+   */
+  AllocationTrace trace() const;
+
+  /**
+   * Discards everything recorded so far. Allocations in use stay tracked.
+   */
+  void clear();
+
+ private:
+  struct Allocation {
+    size_t bytes;
+    uint32_t scope;
+    bool managerLock;
+    bool userLock;
+  };
+
+  const size_t snapshotInterval_;
+  const std::chrono::steady_clock::time_point start_;
+  mutable std::mutex mutex_;
+  std::unordered_map<void*, Allocation> live_;
+  size_t liveBytes_{0};
+  size_t allocsSinceSnapshot_{0};
+  std::vector<AllocationTrace::Event> events_;
+  std::vector<MemorySnapshot> snapshots_;
+
+  int64_t now() const;
+  // Caller must hold mutex_
+  void recordFree(
+      std::unordered_map<void*, Allocation>::iterator it,
+      int64_t timeNs);
+};
+
+} // namespace fl
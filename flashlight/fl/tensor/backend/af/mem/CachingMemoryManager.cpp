@@ -16,6 +16,7 @@
 #include <numeric>
 #include <stdexcept>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace fl {
@@ -32,6 +33,11 @@ constexpr size_t kLargeBuffer =
 constexpr size_t kMinLargeAlloc =
     10485760; // allocations between 1 and 10 MiB may use kLargeBuffer
 constexpr size_t kRoundLarge = 2097152; // round up large allocs to 2 MiB
+constexpr size_t kThreadCacheBytes =
+    1048576; // bytes of free slots per size class a thread cache may hold
+
+constexpr uint8_t kManagerLockBit = 1;
+constexpr uint8_t kUserLockBit = 2;
 
 // Environment variables names, specifying number of mega bytes as floats.
 constexpr const char* kMemRecyclingSize = "FL_MEM_RECYCLING_SIZE_MB";
@@ -56,6 +62,39 @@ size_t getAllocationSize(size_t size) {
   }
 }
 
+// Slot sizes of slabs: multiples of 512 B up to 2 KiB, then four sizes per
+// power of two up to kSmallSize, so that little of a slot goes unused.
+const std::vector<size_t>& slabSizeClasses() {
+  static const std::vector<size_t> sizeClasses = [] {
+    std::vector<size_t> sizes = {512, 1024, 1536, 2048};
+    for (size_t base = 2048; base < kSmallSize; base *= 2) {
+      for (size_t step = 1; step <= 4; ++step) {
+        sizes.push_back(base + step * base / 4);
+      }
+    }
+    return sizes;
+  }();
+  return sizeClasses;
+}
+
+size_t sizeClassIndex(size_t size) {
+  const auto& sizes = slabSizeClasses();
+  return std::lower_bound(sizes.begin(), sizes.end(), size) - sizes.begin();
+}
+
+// Number of free slots a thread cache holds before returning half of them
+size_t maxCachedSlots(size_t slotSize) {
+  return std::max<size_t>(2, kThreadCacheBytes / slotSize);
+}
+
+// Threads are assigned to caches round-robin when they first allocate
+size_t threadCacheIndex() {
+  static std::atomic<size_t> nextThread{0};
+  thread_local const size_t index =
+      nextThread++ % CachingMemoryManager::kNumThreadCaches;
+  return index;
+}
+
 static bool BlockComparator(
     const CachingMemoryManager::Block* a,
     const CachingMemoryManager::Block* b) {
@@ -100,7 +139,28 @@ size_t getEnvAsBytesFromFloatMb(const char* name, size_t defaultVal) {
 CachingMemoryManager::DeviceMemoryInfo::DeviceMemoryInfo(int id)
     : deviceId_(id),
       largeBlocks_(BlockComparator),
-      smallBlocks_(BlockComparator) {}
+      smallBlocks_(BlockComparator),
+      freeSlots_(slabSizeClasses().size()) {
+  for (auto& cache : threadCaches_) {
+    cache.slots_.resize(slabSizeClasses().size());
+  }
+}
+
+CachingMemoryManager::Slab::Slab(
+    void* ptr,
+    size_t slotSize,
+    size_t numSlots,
+    size_t sizeClass)
+    : ptr_(ptr),
+      slotSize_(slotSize),
+      numSlots_(numSlots),
+      sizeClass_(sizeClass),
+      slotLocks_(new std::atomic<uint8_t>[numSlots]),
+      numTaken_(0) {
+  for (size_t i = 0; i < numSlots; ++i) {
+    slotLocks_[i].store(0, std::memory_order_relaxed);
+  }
+}
 
 CachingMemoryManager::CachingMemoryManager(
     int numDevices,
@@ -126,6 +186,10 @@ void CachingMemoryManager::setSplitSizeLimit(size_t limit) {
   splitSizeLimit_ = limit;
 }
 
+void CachingMemoryManager::setSlabAllocation(bool enabled) {
+  slabAllocation_ = enabled;
+}
+
 void CachingMemoryManager::shutdown() {
   signalMemoryCleanup();
 }
@@ -150,8 +214,6 @@ void* CachingMemoryManager::alloc(
     const unsigned ndims,
     dim_t* dims,
     const unsigned elementSize) {
-  auto& memoryInfo = getDeviceMemoryInfo();
-  std::lock_guard<std::recursive_mutex> lock(memoryInfo.mutexAll_);
   size_t size = elementSize;
   for (unsigned i = 0; i < ndims; ++i) {
     size *= dims[i];
@@ -161,6 +223,11 @@ void* CachingMemoryManager::alloc(
   }
   size = roundSize(size);
   const bool isSmallAlloc = (size <= kSmallSize);
+  auto& memoryInfo = getDeviceMemoryInfo();
+  if (isSmallAlloc && slabAllocation_) {
+    return allocSlot(memoryInfo, size, userLock);
+  }
+  std::lock_guard<std::recursive_mutex> lock(memoryInfo.mutexAll_);
   CachingMemoryManager::Block searchKey(size);
   CachingMemoryManager::BlockSet& pool =
       isSmallAlloc ? memoryInfo.smallBlocks_ : memoryInfo.largeBlocks_;
@@ -218,6 +285,10 @@ size_t CachingMemoryManager::allocated(void* ptr) {
     return 0;
   }
   auto& memoryInfo = getDeviceMemoryInfo();
+  if (auto* slab = findSlab(memoryInfo, ptr)) {
+    return slab->slotLocks_[slab->slotIndex(ptr)].load() != 0 ? slab->slotSize_
+                                                               : 0;
+  }
   std::lock_guard<std::recursive_mutex> lock(memoryInfo.mutexAll_);
   auto it = memoryInfo.allocatedBlocks_.find(ptr);
   if (it == memoryInfo.allocatedBlocks_.end()) {
@@ -231,6 +302,10 @@ void CachingMemoryManager::unlock(void* ptr, bool userUnlock) {
     return;
   }
   auto& memoryInfo = getDeviceMemoryInfo();
+  if (auto* slab = findSlab(memoryInfo, ptr)) {
+    unlockSlot(memoryInfo, slab, ptr, userUnlock);
+    return;
+  }
   std::lock_guard<std::recursive_mutex> lock(memoryInfo.mutexAll_);
   auto it = memoryInfo.allocatedBlocks_.find(ptr);
   if (it == memoryInfo.allocatedBlocks_.end()) {
@@ -272,6 +347,179 @@ void CachingMemoryManager::freeBlock(CachingMemoryManager::Block* block) {
   memoryInfo.stats_.cachedBytes_ += block->size_;
 }
 
+void* CachingMemoryManager::allocSlot(
+    DeviceMemoryInfo& memoryInfo,
+    size_t size,
+    bool userLock) {
+  const size_t sizeClass = sizeClassIndex(size);
+  auto& cache = memoryInfo.threadCaches_[threadCacheIndex()];
+  FreeSlot slot{nullptr, nullptr};
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex_);
+    auto& slots = cache.slots_[sizeClass];
+    if (!slots.empty()) {
+      slot = slots.back();
+      slots.pop_back();
+      ++slot.slab_->numTaken_;
+    }
+  }
+  if (!slot.ptr_) {
+    // Refill the thread cache. The cache lock is not held meanwhile: locks are
+    // always taken in the order mutexAll_, then thread caches.
+    auto batch = takeFreeSlots(memoryInfo, sizeClass);
+    slot = batch.back();
+    batch.pop_back();
+    if (!batch.empty()) {
+      std::lock_guard<std::mutex> lock(cache.mutex_);
+      auto& slots = cache.slots_[sizeClass];
+      for (const auto& s : batch) {
+        slots.push_back(s);
+        --s.slab_->numTaken_;
+      }
+    }
+  }
+
+  auto* slab = slot.slab_;
+  slab->slotLocks_[slab->slotIndex(slot.ptr_)].store(
+      userLock ? kUserLockBit : kManagerLockBit);
+  memoryInfo.stats_.cachedBytes_ -= slab->slotSize_;
+  return slot.ptr_;
+}
+
+std::vector<CachingMemoryManager::FreeSlot>
+CachingMemoryManager::takeFreeSlots(
+    DeviceMemoryInfo& memoryInfo,
+    size_t sizeClass) {
+  const size_t slotSize = slabSizeClasses()[sizeClass];
+  std::lock_guard<std::recursive_mutex> lock(memoryInfo.mutexAll_);
+  auto& freeSlots = memoryInfo.freeSlots_[sizeClass];
+  if (freeSlots.empty()) {
+    const size_t numSlots = std::max<size_t>(1, kSmallBuffer / slotSize);
+    void* ptr = nullptr;
+    mallocWithRetry(slotSize * numSlots, &ptr); // could throw
+    auto slab = std::make_unique<Slab>(ptr, slotSize, numSlots, sizeClass);
+    // Hand out slots in increasing address order
+    for (size_t i = numSlots; i-- > 0;) {
+      freeSlots.push_back({static_cast<char*>(ptr) + i * slotSize, slab.get()});
+    }
+    memoryInfo.stats_.allocatedBytes_ += slab->bytes();
+    memoryInfo.stats_.cachedBytes_ += slab->bytes();
+    std::unique_lock<std::shared_mutex> slabsLock(memoryInfo.slabsMutex_);
+    memoryInfo.slabs_.emplace(
+        reinterpret_cast<uintptr_t>(ptr), std::move(slab));
+  }
+
+  const size_t count = std::min(
+      freeSlots.size(), std::max<size_t>(1, maxCachedSlots(slotSize) / 2));
+  std::vector<FreeSlot> batch(freeSlots.end() - count, freeSlots.end());
+  freeSlots.resize(freeSlots.size() - count);
+  for (const auto& s : batch) {
+    ++s.slab_->numTaken_;
+  }
+  return batch;
+}
+
+void CachingMemoryManager::unlockSlot(
+    DeviceMemoryInfo& memoryInfo,
+    Slab* slab,
+    void* ptr,
+    bool userUnlock) {
+  const uint8_t bit = userUnlock ? kUserLockBit : kManagerLockBit;
+  const uint8_t prev = slab->slotLocks_[slab->slotIndex(ptr)].fetch_and(~bit);
+  // Return early if already free or still locked
+  if (!(prev & bit) || (prev & ~bit)) {
+    return;
+  }
+  memoryInfo.stats_.cachedBytes_ += slab->slotSize_;
+
+  auto& cache = memoryInfo.threadCaches_[threadCacheIndex()];
+  std::vector<FreeSlot> overflow;
+  {
+    std::lock_guard<std::mutex> lock(cache.mutex_);
+    auto& slots = cache.slots_[slab->sizeClass_];
+    slots.push_back({ptr, slab});
+    --slab->numTaken_;
+    if (slots.size() > maxCachedSlots(slab->slotSize_)) {
+      // Give the oldest half back so that other threads can use them
+      const size_t count = slots.size() / 2;
+      overflow.assign(slots.begin(), slots.begin() + count);
+      slots.erase(slots.begin(), slots.begin() + count);
+      for (const auto& s : overflow) {
+        ++s.slab_->numTaken_;
+      }
+    }
+  }
+  if (!overflow.empty()) {
+    std::lock_guard<std::recursive_mutex> lock(memoryInfo.mutexAll_);
+    auto& freeSlots = memoryInfo.freeSlots_[slab->sizeClass_];
+    for (const auto& s : overflow) {
+      freeSlots.push_back(s);
+      --s.slab_->numTaken_;
+    }
+  }
+}
+
+CachingMemoryManager::Slab* CachingMemoryManager::findSlab(
+    DeviceMemoryInfo& memoryInfo,
+    const void* ptr) {
+  const auto address = reinterpret_cast<uintptr_t>(ptr);
+  std::shared_lock<std::shared_mutex> lock(memoryInfo.slabsMutex_);
+  auto it = memoryInfo.slabs_.upper_bound(address);
+  if (it == memoryInfo.slabs_.begin()) {
+    return nullptr;
+  }
+  --it;
+  auto* slab = it->second.get();
+  return address < it->first + slab->bytes() ? slab : nullptr;
+}
+
+void CachingMemoryManager::freeSlabs(DeviceMemoryInfo& memoryInfo) {
+  std::vector<std::unique_lock<std::mutex>> cacheLocks;
+  for (auto& cache : memoryInfo.threadCaches_) {
+    cacheLocks.emplace_back(cache.mutex_);
+  }
+  std::unique_lock<std::shared_mutex> slabsLock(memoryInfo.slabsMutex_);
+
+  // With all locks held, every free slot is in a free list
+  std::unordered_set<Slab*> unused;
+  for (const auto& entry : memoryInfo.slabs_) {
+    if (entry.second->numTaken_ == 0) {
+      unused.insert(entry.second.get());
+    }
+  }
+  if (unused.empty()) {
+    return;
+  }
+  auto removeUnused = [&unused](std::vector<FreeSlot>& slots) {
+    slots.erase(
+        std::remove_if(
+            slots.begin(),
+            slots.end(),
+            [&unused](const FreeSlot& s) { return unused.count(s.slab_); }),
+        slots.end());
+  };
+  for (auto& slots : memoryInfo.freeSlots_) {
+    removeUnused(slots);
+  }
+  for (auto& cache : memoryInfo.threadCaches_) {
+    for (auto& slots : cache.slots_) {
+      removeUnused(slots);
+    }
+  }
+  for (auto it = memoryInfo.slabs_.begin(); it != memoryInfo.slabs_.end();) {
+    auto* slab = it->second.get();
+    if (unused.count(slab)) {
+      this->deviceInterface->nativeFree(slab->ptr_);
+      ++memoryInfo.stats_.totalNativeFrees_;
+      memoryInfo.stats_.allocatedBytes_ -= slab->bytes();
+      memoryInfo.stats_.cachedBytes_ -= slab->bytes();
+      it = memoryInfo.slabs_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 /** combine previously split blocks */
 void CachingMemoryManager::tryMergeBlocks(
     CachingMemoryManager::Block* dst,
@@ -364,6 +612,24 @@ void CachingMemoryManager::signalMemoryCleanup() {
       memoryInfo.smallBlocks_,
       memoryInfo.smallBlocks_.begin(),
       memoryInfo.smallBlocks_.end());
+
+  freeSlabs(memoryInfo);
+}
+
+MemorySnapshot CachingMemoryManager::getMemorySnapshot(int device) {
+  auto& memoryInfo = getDeviceMemoryInfo(device);
+  MemorySnapshot snapshot;
+  snapshot.reservedBytes = memoryInfo.stats_.allocatedBytes_;
+  snapshot.cachedBytes = memoryInfo.stats_.cachedBytes_;
+  std::lock_guard<std::recursive_mutex> lock(memoryInfo.mutexAll_);
+  // Blocks are ordered by size
+  for (auto* blocks : {&memoryInfo.smallBlocks_, &memoryInfo.largeBlocks_}) {
+    if (!blocks->empty()) {
+      snapshot.largestCachedBlock = std::max<uint64_t>(
+          snapshot.largestCachedBlock, (*blocks->rbegin())->size_);
+    }
+  }
+  return snapshot;
 }
 
 float CachingMemoryManager::getMemoryPressure() {
@@ -389,9 +655,9 @@ void CachingMemoryManager::printInfo(
           << ", Allocated: " << formatMemory(memInfo.stats_.allocatedBytes_)
           << ", Cached: " << formatMemory(memInfo.stats_.cachedBytes_)
           << std::endl
-          << "\nTotal native calls: " << memInfo.stats_.totalNativeMallocs_
-          << "(mallocs), " << memInfo.stats_.totalNativeFrees_ << "(frees)"
-          << std::endl;
+          << "\nTotal native calls: "
+          << memInfo.stats_.totalNativeMallocs_.load() << "(mallocs), "
+          << memInfo.stats_.totalNativeFrees_.load() << "(frees)" << std::endl;
 }
 
 void CachingMemoryManager::userLock(const void* ptr) {
@@ -399,6 +665,10 @@ void CachingMemoryManager::userLock(const void* ptr) {
     return;
   }
   auto& memoryInfo = getDeviceMemoryInfo();
+  if (auto* slab = findSlab(memoryInfo, ptr)) {
+    slab->slotLocks_[slab->slotIndex(ptr)] |= kUserLockBit;
+    return;
+  }
   std::lock_guard<std::recursive_mutex> lock(memoryInfo.mutexAll_);
 
   auto it = memoryInfo.allocatedBlocks_.find(const_cast<void*>(ptr));
@@ -422,6 +692,9 @@ bool CachingMemoryManager::isUserLocked(const void* ptr) {
     return false;
   }
   auto& memoryInfo = getDeviceMemoryInfo();
+  if (auto* slab = findSlab(memoryInfo, ptr)) {
+    return slab->slotLocks_[slab->slotIndex(ptr)].load() & kUserLockBit;
+  }
   std::lock_guard<std::recursive_mutex> lock(memoryInfo.mutexAll_);
   auto it = memoryInfo.allocatedBlocks_.find(const_cast<void*>(ptr));
   if (it == memoryInfo.allocatedBlocks_.end()) {
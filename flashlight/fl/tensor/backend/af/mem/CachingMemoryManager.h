@@ -7,13 +7,17 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <cstdint>
 #include <limits>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <numeric>
 #include <ostream>
 #include <set>
+#include <shared_mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -27,6 +31,11 @@ namespace fl {
  * Sources :
  * https://github.com/torch/cutorch/blob/master/lib/THC/THCCachingAllocator.h
  * https://github.com/pytorch/pytorch/blob/master/c10/cuda/CUDACachingAllocator.cpp
+ *
+ * Allocations of at most 1 MiB are served from slabs: native allocations
+ * carved into equal slots of a single size class. Free slots are kept in
+ * per-thread caches, so that most small allocations and frees only take an
+ * uncontended lock and never go through the ordered sets of blocks.
  */
 class CachingMemoryManager : public MemoryManagerAdapter {
  public:
@@ -51,6 +60,7 @@ class CachingMemoryManager : public MemoryManagerAdapter {
   void userUnlock(const void* ptr) override;
   bool isUserLocked(const void* ptr) override;
   void signalMemoryCleanup() override;
+  MemorySnapshot getMemorySnapshot(int device = -1) override;
   float getMemoryPressure() override;
   bool jitTreeExceedsMemoryPressure(size_t bytes) override;
   void addMemoryManagement(int device) override;
@@ -59,6 +69,12 @@ class CachingMemoryManager : public MemoryManagerAdapter {
   // thread safe
   void setRecyclingSizeLimit(size_t);
   void setSplitSizeLimit(size_t);
+  // Serve allocations of at most 1 MiB from slabs (default). When disabled,
+  // they are split from 2 MiB blocks like larger allocations.
+  void setSlabAllocation(bool);
+
+  // Number of caches threads are spread over
+  static constexpr size_t kNumThreadCaches = 16;
 
   // Block denotes a single allocated unit of memory.
   struct Block {
@@ -89,18 +105,50 @@ class CachingMemoryManager : public MemoryManagerAdapter {
   typedef bool (*Comparison)(const Block*, const Block*);
   typedef std::set<Block*, Comparison> BlockSet;
 
-  // A structure to store allocation stats per device.
+  // A slab is a single native allocation split into equal slots.
+  struct Slab {
+    void* ptr_; // memory address
+    size_t slotSize_; // size of a slot in bytes
+    size_t numSlots_;
+    size_t sizeClass_; // index of the size class of the slots
+    // lock state of each slot (manager and user lock bits)
+    std::unique_ptr<std::atomic<uint8_t>[]> slotLocks_;
+    // number of slots in no free list, i.e. in use or moving between free
+    // lists. The slab can only be released when this is 0.
+    std::atomic<size_t> numTaken_;
+
+    Slab(void* ptr, size_t slotSize, size_t numSlots, size_t sizeClass);
+
+    size_t bytes() const {
+      return slotSize_ * numSlots_;
+    }
+
+    size_t slotIndex(const void* ptr) const {
+      return (static_cast<const char*>(ptr) - static_cast<const char*>(ptr_)) /
+          slotSize_;
+    }
+  };
+
+  struct FreeSlot {
+    void* ptr_;
+    Slab* slab_;
+  };
+
+  // Free slots of each size class, shared by a subset of the threads.
+  struct ThreadCache {
+    std::mutex mutex_;
+    std::vector<std::vector<FreeSlot>> slots_;
+  };
+
+  // A structure to store allocation stats per device. Counters are updated
+  // without holding any lock.
   struct MemoryAllocationStats {
-    size_t totalNativeMallocs_;
-    size_t totalNativeFrees_;
-    size_t allocatedBytes_; // memory allocated by mem manager for the program
-    size_t cachedBytes_; // memory held by mem manager & not used by the program
-
-    MemoryAllocationStats()
-        : totalNativeMallocs_(0),
-          totalNativeFrees_(0),
-          allocatedBytes_(0),
-          cachedBytes_(0) {}
+    std::atomic<size_t> totalNativeMallocs_{0};
+    std::atomic<size_t> totalNativeFrees_{0};
+    // memory allocated by mem manager for the program
+    std::atomic<size_t> allocatedBytes_{0};
+    // memory held by mem manager & not used by the program
+    std::atomic<size_t> cachedBytes_{0};
   };
 
   // Stores the mutex and misc variables per device so that we operate in a
@@ -108,8 +156,8 @@ class CachingMemoryManager : public MemoryManagerAdapter {
   struct DeviceMemoryInfo {
     int deviceId_;
 
-    // lock around all operations
-    std::recursive_mutex mutexAll_; // TODO:: improve perf using R/W locks
+    // lock around all operations on blocks and on freeSlots_
+    std::recursive_mutex mutexAll_;
 
     // cached blocks larger than 1 MB
     BlockSet largeBlocks_;
@@ -120,6 +168,15 @@ class CachingMemoryManager : public MemoryManagerAdapter {
     // allocated blocks by device pointer
     std::unordered_map<void*, Block*> allocatedBlocks_;
 
+    // slabs by address, to find the slab of a pointer being freed
+    std::shared_mutex slabsMutex_;
+    std::map<uintptr_t, std::unique_ptr<Slab>> slabs_;
+
+    // free slots of each size class not held by a thread cache
+    std::vector<std::vector<FreeSlot>> freeSlots_;
+
+    std::array<ThreadCache, kNumThreadCaches> threadCaches_;
+
     MemoryAllocationStats stats_;
 
     explicit DeviceMemoryInfo(int id);
@@ -145,6 +202,23 @@ class CachingMemoryManager : public MemoryManagerAdapter {
   void tryMergeBlocks(Block* dst, Block* src, BlockSet& freeBlocks);
   void freeBlock(Block* block);
 
+  void* allocSlot(DeviceMemoryInfo& memoryInfo, size_t size, bool userLock);
+  // Moves free slots of the given size class from the shared free list,
+  // allocating a new slab if needed. Returned slots are counted as taken.
+  std::vector<FreeSlot> takeFreeSlots(
+      DeviceMemoryInfo& memoryInfo,
+      size_t sizeClass);
+  // Returns the slot to a thread cache if all its locks are released.
+  void unlockSlot(
+      DeviceMemoryInfo& memoryInfo,
+      Slab* slab,
+      void* ptr,
+      bool userUnlock);
+  // Returns the slab containing ptr, or nullptr
+  Slab* findSlab(DeviceMemoryInfo& memoryInfo, const void* ptr);
+  // Frees slabs with no slot in use. Caller must hold mutexAll_.
+  void freeSlabs(DeviceMemoryInfo& memoryInfo);
+
  private:
   // Non-const runtime options in order to fine tune the behavior of this
   // manager. Prevents to recycle some buffers, to be set by the user if
@@ -153,6 +227,7 @@ class CachingMemoryManager : public MemoryManagerAdapter {
   // size_t recyclingSizeLimit;
   // Prevents to split big buffers, to be set by the user if desired:
   size_t splitSizeLimit_{std::numeric_limits<size_t>::max()};
+  bool slabAllocation_{true};
 };
 
 } // namespace fl
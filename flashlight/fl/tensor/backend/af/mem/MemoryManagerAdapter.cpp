@@ -75,4 +75,17 @@ size_t MemoryManagerAdapter::getMemStepSize() {
 
 void MemoryManagerAdapter::setMemStepSize(size_t size) {}
 
+MemorySnapshot MemoryManagerAdapter::getMemorySnapshot(int /* device */) {
+  return MemorySnapshot();
+}
+
+void MemoryManagerAdapter::setAllocationTracer(
+    std::shared_ptr<AllocationTracer> tracer) {
+  allocationTracer_ = std::move(tracer);
+}
+
+AllocationTracer* MemoryManagerAdapter::getAllocationTracer() const {
+  return allocationTracer_.get();
+}
+
 } // namespace fl
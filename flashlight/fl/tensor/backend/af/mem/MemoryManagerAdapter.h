@@ -17,6 +17,7 @@
 #include <stdexcept>
 #include <string>
 
+#include "flashlight/fl/tensor/backend/af/mem/AllocationTracer.h"
 #include "flashlight/fl/tensor/backend/af/mem/MemoryManagerDeviceInterface.h"
 
 namespace fl {
@@ -94,6 +95,32 @@ class MemoryManagerAdapter {
   virtual size_t getMemStepSize();
   virtual void setMemStepSize(size_t size);
 
+  /**
+   * Returns the memory held by the manager on a device, to measure its
+   * fragmentation. Using "-1" returns the memory of the active device. The
+   * default implementation reports nothing.
+   *
+   * @param[in] device the device
+   * @return a snapshot of the memory held, whose live bytes are unset
+   */
+  virtual MemorySnapshot getMemorySnapshot(int device = -1);
+
+  /**
+   * Sets a tracer recording all allocations made through the memory manager
+   * once installed, or disables tracing if null. Must not be called while
+   * allocations are made on other threads.
+   *
+   * @param[in] tracer the tracer to set.
+   */
+  void setAllocationTracer(std::shared_ptr<AllocationTracer> tracer);
+
+  /**
+   * Returns the allocation tracer of the memory manager.
+   *
+   * @return the tracer, or null if allocations are not traced.
+   */
+  AllocationTracer* getAllocationTracer() const;
+
   /**
    * Logs information to the `MemoryManagerAdapters`'s log stream. If logging
    * mode is enabled, function calls to virtual base class methods are logged.
@@ -159,6 +186,7 @@ class MemoryManagerAdapter {
   std::stringstream logStreamBuffer_;
   size_t logStreamBufferSize_{0}; // in number of lines
   size_t logFlushInterval_{kDefaultLogFlushInterval};
+  std::shared_ptr<AllocationTracer> allocationTracer_;
 };
 
 template <typename... Values>
@@ -86,6 +86,16 @@ MemoryManagerInstaller::MemoryManagerInstaller(
         /* size */ dims[0], // HACK: dims[0] until af::memAlloc is size-aware
         userLock,
         (std::uintptr_t)*ptr);
+    if (auto* tracer = m->getAllocationTracer()) {
+      size_t bytes = elSize;
+      for (unsigned i = 0; i < ndims; ++i) {
+        bytes *= dims[i];
+      }
+      tracer->recordAlloc(*ptr, bytes, userLock);
+      if (tracer->snapshotDue()) {
+        tracer->recordSnapshot(m->getMemorySnapshot());
+      }
+    }
     return AF_SUCCESS;
   };
   AF_CHECK(af_memory_manager_set_alloc_fn(itf, allocFn));
@@ -99,6 +109,10 @@ MemoryManagerInstaller::MemoryManagerInstaller(
   auto unlockFn = [](af_memory_manager manager, void* ptr, int userLock) {
     MemoryManagerAdapter* m = MemoryManagerInstaller::getImpl(manager);
     m->log("unlock", (std::uintptr_t)ptr, userLock);
+    // Recorded first, since the manager may hand out ptr again once unlocked
+    if (auto* tracer = m->getAllocationTracer()) {
+      tracer->recordUnlock(ptr, (bool)userLock);
+    }
     m->unlock(ptr, (bool)userLock);
     return AF_SUCCESS;
   };
@@ -122,12 +136,18 @@ MemoryManagerInstaller::MemoryManagerInstaller(
     MemoryManagerAdapter* m = MemoryManagerInstaller::getImpl(manager);
     m->log("userLock", (std::uintptr_t)ptr);
     m->userLock(ptr);
+    if (auto* tracer = m->getAllocationTracer()) {
+      tracer->recordUserLock(ptr);
+    }
     return AF_SUCCESS;
   };
   AF_CHECK(af_memory_manager_set_user_lock_fn(itf, userLockFn));
   auto userUnlockFn = [](af_memory_manager manager, void* ptr) {
     MemoryManagerAdapter* m = MemoryManagerInstaller::getImpl(manager);
     m->log("userUnlock", (std::uintptr_t)ptr);
+    if (auto* tracer = m->getAllocationTracer()) {
+      tracer->recordUnlock(ptr, /* userLock = */ true);
+    }
     MemoryManagerInstaller::getImpl(manager)->userUnlock(ptr);
     return AF_SUCCESS;
   };
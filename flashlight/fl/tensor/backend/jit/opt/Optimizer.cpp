@@ -7,6 +7,7 @@
 
 #include "flashlight/fl/tensor/backend/jit/opt/Optimizer.h"
 
+#include <atomic>
 #include <iterator>
 
 #include "flashlight/fl/tensor/TensorBackend.h"
@@ -26,6 +27,8 @@ void extend(std::vector<T>& extendee, std::vector<T>&& elems) {
       std::make_move_iterator(std::end(elems)));
 }
 
+std::atomic<bool> extensionPassesEnabled_{true};
+
 } // namespace
 
 Optimizer::Optimizer(TensorBackend& backend) : backend_(backend) {
@@ -33,6 +36,7 @@ Optimizer::Optimizer(TensorBackend& backend) : backend_(backend) {
   // 1. figure out a configuration API (e.g., LLVM pass style macro)
   // 2. think about ordering
   passes_.emplace_back(std::make_unique<ScalarFolding>());
+  numBuiltinPasses_ = passes_.size();
   auto& registrar = detail::TensorExtensionRegistrar::getInstance();
   if (registrar.isTensorExtensionRegistered(
           backend_.backendType(), TensorExtensionType::JitOptimizer)) {
@@ -40,6 +44,14 @@ Optimizer::Optimizer(TensorBackend& backend) : backend_(backend) {
   }
 }
 
+void Optimizer::setExtensionPassesEnabled(bool enabled) {
+  extensionPassesEnabled_ = enabled;
+}
+
+bool Optimizer::extensionPassesEnabled() {
+  return extensionPassesEnabled_;
+}
+
 Node* Optimizer::optimize(Node* node) {
   // TODO use an `ExternalUse` interface to enable `Node::replaceAllUsesWith()`
   // to update JitTensorBase::node() as well. We don't want to store these
@@ -50,8 +62,10 @@ Node* Optimizer::optimize(Node* node) {
   // return a Node* anymore, and relevant refcount management gets cleaner too.
   Node* currNode = node;
   bool currNodeMustBeDeleted = false;
-  for (const auto& pass : passes_) {
-    Node* nextNode = pass->apply(currNode);
+  const auto numPasses =
+      extensionPassesEnabled() ? passes_.size() : numBuiltinPasses_;
+  for (size_t i = 0; i < numPasses; ++i) {
+    Node* nextNode = passes_[i]->apply(currNode);
     // intermediate nodes must be deleted -- caller only gets final output node
     if (currNode != node && currNode != nextNode && currNodeMustBeDeleted) {
       delete currNode;
@@ -19,12 +19,23 @@ namespace fl {
  */
 class Optimizer {
   std::vector<std::unique_ptr<Pass>> passes_;
+  // passes_[0, numBuiltinPasses_) are backend-agnostic, the rest come from
+  // the JIT optimizer extension of backend_
+  size_t numBuiltinPasses_{0};
   // backend used for optional JIT optimizer extension
   TensorBackend& backend_;
 
  public:
   explicit Optimizer(TensorBackend& backend);
 
+  /**
+   * Enable or disable the passes of JIT optimizer extensions (e.g.
+   * `OneDnnOpFusion`) for all optimizers, to measure their effect. Enabled by
+   * default.
+   */
+  static void setExtensionPassesEnabled(bool enabled);
+  static bool extensionPassesEnabled();
+
   /**
    * Apply in-place optimization to nodes within the tree.
    *
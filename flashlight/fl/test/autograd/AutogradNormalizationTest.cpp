@@ -408,6 +408,58 @@ TEST_F(AutogradTestF16, LayerNormJacobianF16) {
   ASSERT_TRUE(fl::detail::jacobianTestImpl(funcLnIn, input, 1e-4, 1e-2));
 }
 
+TEST(AutogradNormalizationTest, LayerNormFusedOutput) {
+  const double eps = 1E-5;
+  auto input = Variable(fl::rand({6, 4, 5}), false);
+  auto weight = Variable(fl::rand({24}), false);
+  auto bias = Variable(fl::rand({24}), false);
+
+  auto flat = fl::reshape(input.tensor(), {24, 5});
+  auto mean = fl::mean(flat, {0}, /* keepDims = */ true);
+  auto var = fl::var(flat, {0}, /* bias = */ true, /* keepDims = */ true);
+  auto expected = (flat - fl::tile(mean, {24, 1})) /
+          fl::tile(fl::sqrt(var + eps), {24, 1}) *
+          fl::tile(fl::reshape(weight.tensor(), {24, 1}), {1, 5}) +
+      fl::tile(fl::reshape(bias.tensor(), {24, 1}), {1, 5});
+
+  auto out = layerNorm(input, weight, bias, {0, 1}, eps);
+  ASSERT_EQ(out.shape(), input.shape());
+  ASSERT_TRUE(allClose(out.tensor(), fl::reshape(expected, {6, 4, 5}), 1E-4));
+
+  // Without affine transform
+  out = layerNorm(input, Variable(), Variable(), {0, 1}, eps);
+  auto normalized =
+      (flat - fl::tile(mean, {24, 1})) / fl::tile(fl::sqrt(var + eps), {24, 1});
+  ASSERT_TRUE(
+      allClose(out.tensor(), fl::reshape(normalized, {6, 4, 5}), 1E-4));
+
+  // Only leading axes are supported
+  ASSERT_THROW(
+      layerNorm(input, Variable(), Variable(), {1}, eps),
+      std::invalid_argument);
+}
+
+TEST(AutogradNormalizationTest, LayerNormFusedJacobian) {
+  auto input = Variable(fl::rand({5, 3, 4}), true);
+  auto weight = Variable(fl::rand({15}), true);
+  auto bias = Variable(fl::rand({15}), true);
+
+  auto funcLnIn = [&](Variable& in) {
+    return layerNorm(in, weight, bias, {0, 1}, 1E-5);
+  };
+  ASSERT_TRUE(fl::detail::jacobianTestImpl(funcLnIn, input, 1e-2, 1e-4));
+
+  auto funcLnWt = [&](Variable& wt) {
+    return layerNorm(input, wt, bias, {0, 1}, 1E-5);
+  };
+  ASSERT_TRUE(fl::detail::jacobianTestImpl(funcLnWt, weight, 1e-2, 1e-4));
+
+  auto funcLnBs = [&](Variable& bs) {
+    return layerNorm(input, weight, bs, {0, 1}, 1E-5);
+  };
+  ASSERT_TRUE(fl::detail::jacobianTestImpl(funcLnBs, bias, 1e-2, 1e-4));
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   fl::init();
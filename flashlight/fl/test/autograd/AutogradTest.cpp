@@ -364,6 +364,41 @@ TEST(AutogradTest, Embedding) {
   ASSERT_TRUE(fl::detail::jacobianTestImpl(funcEmbed, weights, 1E-5));
 }
 
+TEST(AutogradTest, EmbeddingRowSparseGrad) {
+  auto weights = Variable(fl::randn({4, 10}), true);
+  auto input = Variable(Tensor::fromVector<float>({3, 1, 3}), false);
+  auto output = embedding(input, weights);
+  output.backward();
+  // Only the looked up columns are kept, with repeated rows summed
+  ASSERT_TRUE(weights.isGradSparse());
+  const auto& sparse = weights.sparseGrad();
+  ASSERT_EQ(sparse.axis, 1);
+  ASSERT_EQ(sparse.values.shape(), Shape({4, 2}));
+  ASSERT_TRUE(allClose(sparse.rows, Tensor::fromVector<int>({1, 3})));
+  ASSERT_TRUE(fl::all(sparse.values(fl::span, 1) == 2).asScalar<bool>());
+
+  // The dense gradient is row-sparse
+  auto& grad = weights.grad();
+  ASSERT_FALSE(weights.isGradSparse());
+  ASSERT_TRUE(grad.isRowSparse());
+  ASSERT_EQ(grad.sparseRowAxis(), 1);
+  ASSERT_TRUE(allClose(
+      grad.sparseRows().astype(fl::dtype::s32),
+      Tensor::fromVector<int>({1, 3})));
+  // Repeated rows are summed
+  ASSERT_TRUE(fl::all(grad.tensor()(fl::span, 3) == 2).asScalar<bool>());
+
+  // Rows of sparse gradients are merged
+  auto other = Variable(Tensor::fromVector<float>({5}), false);
+  embedding(other, weights).backward();
+  ASSERT_TRUE(weights.grad().isRowSparse());
+  ASSERT_EQ(weights.grad().sparseRows().elements(), 3);
+
+  // A dense gradient makes the gradient dense
+  (weights * 2).backward();
+  ASSERT_FALSE(weights.grad().isRowSparse());
+}
+
 TEST(AutogradTest, GetAdvancedIndex) {
   // TODO: remove me
   if (!FL_BACKEND_CUDA) {
@@ -154,6 +154,25 @@ TEST_F(AutogradTestF16, LogSoftmaxF16) {
   ASSERT_TRUE(fl::detail::jacobianTestImpl(funcLsm, in, 1E-2, 1e-1));
 }
 
+TEST(AutogradUnaryOpsTest, SoftmaxF32) {
+  // f32 inputs may use a fused kernel: check all axes against the op graph
+  auto in = Variable(fl::rand({3, 4, 5}), true);
+  for (int dim = 0; dim < in.ndim(); ++dim) {
+    Shape tileDims({1, 1, 1});
+    tileDims[dim] = in.dim(dim);
+    auto exp = fl::exp(in.tensor());
+    auto expected = exp / fl::tile(fl::sum(exp, {dim}, true), tileDims);
+    ASSERT_TRUE(allClose(softmax(in, dim).tensor(), expected, 1E-5));
+    ASSERT_TRUE(
+        allClose(logSoftmax(in, dim).tensor(), fl::log(expected), 1E-5));
+
+    auto funcSm = [&](Variable& input) { return softmax(input, dim); };
+    ASSERT_TRUE(fl::detail::jacobianTestImpl(funcSm, in, 1E-2, 1E-3));
+    auto funcLsm = [&](Variable& input) { return logSoftmax(input, dim); };
+    ASSERT_TRUE(fl::detail::jacobianTestImpl(funcLsm, in, 1E-2, 1E-3));
+  }
+}
+
 TEST(AutogradUnaryOpsTest, Pow) {
   {
     auto x = Variable(fl::rand({5}), true);
@@ -7,12 +7,14 @@
 
 #include <algorithm>
 #include <chrono>
+#include <fstream>
 #include <memory>
 #include <thread>
 
 #include <gtest/gtest.h>
 
 #include "flashlight/fl/common/DynamicBenchmark.h"
+#include "flashlight/fl/common/Filesystem.h"
 #include "flashlight/fl/tensor/Compute.h"
 #include "flashlight/fl/tensor/Init.h"
 #include "flashlight/fl/tensor/Random.h"
@@ -149,6 +151,103 @@ TEST_F(DynamicBenchmark, DynamicBenchmarkMatmul) {
       *std::min_element(arraySizes.begin(), arraySizes.end()));
 }
 
+TEST_F(DynamicBenchmark, OptionsOptimalOptionIndex) {
+  std::vector<int> ops = {1, 2, 3};
+  auto options = std::make_shared<fl::DynamicBenchmarkOptions<int>>(
+      ops, /* maxCount = */ 3);
+
+  ASSERT_EQ(options->optionCount(), 3);
+  options->setOptimalOptionIndex(2);
+  ASSERT_TRUE(options->timingsComplete());
+  ASSERT_EQ(options->currentOption(), 3);
+  ASSERT_EQ(options->currentOptionIndex(), 2);
+  ASSERT_THROW(options->setOptimalOptionIndex(3), std::out_of_range);
+  options->reset();
+  ASSERT_FALSE(options->timingsComplete());
+}
+
+TEST_F(DynamicBenchmark, DynamicBenchmarkCache) {
+  const auto path =
+      fs::temp_directory_path() / "DynamicBenchmarkTestCache.tsv";
+  fs::remove(path);
+  fl::DynamicBenchmarkCache::clear();
+  fl::DynamicBenchmarkCache::setPath(path);
+
+  size_t maxCount = 2;
+  std::vector<int> sleepTimes = {4, 2, 6};
+  const std::string key = "sleep;dtype=f32";
+  {
+    auto options = std::make_shared<fl::DynamicBenchmarkOptions<int>>(
+        sleepTimes, maxCount);
+    fl::DynamicBenchmark dynamicBench(options);
+    dynamicBench.setCacheKey(key);
+    ASSERT_FALSE(options->timingsComplete());
+    for (size_t i = 0; i < maxCount * sleepTimes.size(); ++i) {
+      std::chrono::milliseconds sleepTime(options->currentOption());
+      dynamicBench.audit(
+          [sleepTime]() { std::this_thread::sleep_for(sleepTime); });
+    }
+    ASSERT_TRUE(options->timingsComplete());
+  }
+  ASSERT_TRUE(fl::DynamicBenchmarkCache::lookup(key).has_value());
+  ASSERT_EQ(*fl::DynamicBenchmarkCache::lookup(key), 1);
+  ASSERT_TRUE(fs::exists(path));
+
+  // A new process warms the cache from disk and skips the timings
+  fl::DynamicBenchmarkCache::clear();
+  ASSERT_FALSE(fl::DynamicBenchmarkCache::lookup(key).has_value());
+  fl::DynamicBenchmarkCache::setPath(path, /* writable = */ false);
+  {
+    auto options = std::make_shared<fl::DynamicBenchmarkOptions<int>>(
+        sleepTimes, maxCount);
+    fl::DynamicBenchmark dynamicBench(options);
+    dynamicBench.setCacheKey(key);
+    ASSERT_TRUE(options->timingsComplete());
+    ASSERT_EQ(options->currentOption(), 2);
+  }
+
+  // Readers pick up entries written to the file later
+  {
+    std::ofstream file(path, std::ios::app);
+    file << "other\t0\n";
+  }
+  // Make sure the modification time changes
+  fs::last_write_time(
+      path, fs::last_write_time(path) + std::chrono::seconds(1));
+  ASSERT_EQ(fl::DynamicBenchmarkCache::lookup("other"), 0);
+
+  // Entries from other sets of options are ignored
+  {
+    fl::DynamicBenchmarkCache::insert("big", 7);
+    auto options = std::make_shared<fl::DynamicBenchmarkOptions<int>>(
+        sleepTimes, maxCount);
+    fl::DynamicBenchmark dynamicBench(options);
+    dynamicBench.setCacheKey("big");
+    ASSERT_FALSE(options->timingsComplete());
+  }
+  ASSERT_THROW(
+      fl::DynamicBenchmarkCache::insert("bad\tkey", 0), std::invalid_argument);
+
+  // Processes that aren't the writer leave the file unchanged
+  fl::DynamicBenchmarkCache::setWritable(false);
+  fl::DynamicBenchmarkCache::insert("unwritten", 1);
+  ASSERT_EQ(fl::DynamicBenchmarkCache::lookup("unwritten"), 1);
+  fl::DynamicBenchmarkCache::clear();
+  fl::DynamicBenchmarkCache::load(path);
+  ASSERT_FALSE(fl::DynamicBenchmarkCache::lookup("unwritten").has_value());
+
+  // Failing to save keeps the entry in memory rather than throwing
+  fl::DynamicBenchmarkCache::setPath(
+      fs::temp_directory_path() / "DynamicBenchmarkTestMissingDir" /
+      "cache.tsv");
+  ASSERT_NO_THROW(fl::DynamicBenchmarkCache::insert("unsaved", 1));
+  ASSERT_EQ(fl::DynamicBenchmarkCache::lookup("unsaved"), 1);
+
+  fl::DynamicBenchmarkCache::setPath("");
+  fl::DynamicBenchmarkCache::clear();
+  fs::remove(path);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   fl::init();
@@ -10,6 +10,7 @@
 #include "flashlight/fl/autograd/autograd.h"
 #include "flashlight/fl/common/common.h"
 #include "flashlight/fl/contrib/modules/modules.h"
+#include "flashlight/fl/dataset/datasets.h"
 #include "flashlight/fl/nn/nn.h"
 #include "flashlight/fl/tensor/Index.h"
 #include "flashlight/fl/tensor/Random.h"
@@ -345,6 +346,92 @@ TEST(ContribModuleTest, AdaptiveEmbedding) {
   ASSERT_EQ(output.dim(2), B);
 }
 
+TEST(ContribModuleTest, QuantizeWeights) {
+  auto mlp = std::make_shared<Sequential>();
+  mlp->add(Linear(10, 20));
+  mlp->add(ReLU());
+  mlp->add(Linear(20, 5));
+  auto conv = std::make_shared<Conv2D>(3, 4, 3, 3);
+  auto emb = std::make_shared<Embedding>(16, 10);
+  std::vector<int> cutoff = {5, 10, 25};
+  auto adaptiveEmb = std::make_shared<AdaptiveEmbedding>(128, cutoff);
+
+  std::vector<float> values = {1, 4, 6, 2, 12, 7, 4, 21, 22, 18, 3, 23};
+  auto tokens = Variable(Tensor::fromVector({6, 2}, values), false);
+  std::vector<std::pair<std::shared_ptr<Module>, Variable>> tests = {
+      {mlp, Variable(fl::rand({10, 4}), false)},
+      {conv, Variable(fl::rand({8, 8, 3, 2}), false)},
+      {emb, Variable(fl::floor(fl::rand({6, 2}) * 10), false)},
+      {adaptiveEmb, tokens}};
+  std::vector<int> numQuantized = {2, 1, 1, 1};
+  for (int i = 0; i < tests.size(); ++i) {
+    auto& [model, input] = tests[i];
+    model->eval();
+    auto expected = model->forward({input}).front();
+    ASSERT_EQ(quantizeWeights(model), numQuantized[i]);
+    ASSERT_EQ(quantizeWeights(model), 0);
+    ASSERT_NE(model->prettyString().find("quantized"), std::string::npos);
+    ASSERT_EQ(model->param(0).type(), fl::dtype::u8);
+
+    auto output = model->forward({input}).front();
+    ASSERT_EQ(output.shape(), expected.shape());
+    ASSERT_TRUE(allClose(output, expected, 5e-2));
+  }
+
+  // Tied weights are rejected, leaving the model as is
+  auto tiedEmb = std::make_shared<Embedding>(16, 10);
+  auto tied = std::make_shared<Sequential>();
+  tied->add(tiedEmb);
+  tied->add(std::make_shared<Linear>(tiedEmb->param(0)));
+  ASSERT_THROW(quantizeWeights(tied), std::invalid_argument);
+  ASSERT_FALSE(tiedEmb->isQuantized());
+  ASSERT_EQ(tiedEmb->param(0).type(), fl::dtype::f32);
+
+  // As are weights tied to a criterion, which is given separately
+  auto inputEmb = std::make_shared<Embedding>(16, 10);
+  auto criterion = std::make_shared<Linear>(inputEmb->param(0));
+  ASSERT_THROW(quantizeWeights(inputEmb, {criterion}), std::invalid_argument);
+  ASSERT_FALSE(inputEmb->isQuantized());
+  auto untiedEmb = std::make_shared<Embedding>(16, 10);
+  ASSERT_EQ(quantizeWeights(untiedEmb, {untiedEmb}), 1);
+}
+
+TEST(ContribModuleTest, CalibrateActivations) {
+  auto mlp = std::make_shared<Sequential>();
+  mlp->add(Linear(10, 20));
+  mlp->add(ReLU());
+  mlp->add(Linear(20, 5));
+  auto conv = std::make_shared<Conv2D>(3, 4, 3, 3, 1, 1, 1, 1);
+  auto groupedConv = std::make_shared<Conv2D>(
+      4, 6, 3, 3, 2, 2, 1, 1, 1, 1, /* bias = */ false, /* groups = */ 2);
+  std::vector<std::pair<std::shared_ptr<Module>, Tensor>> tests = {
+      {mlp, fl::rand({10, 8}) * 2 - 1},
+      {conv, fl::rand({8, 8, 3, 8})},
+      {groupedConv, fl::rand({7, 7, 4, 8})}};
+  std::vector<int> numCalibrated = {2, 1, 1};
+  for (int i = 0; i < tests.size(); ++i) {
+    auto& [model, inputs] = tests[i];
+    model->eval();
+    auto input = Variable(inputs, false);
+    auto expected = model->forward({input}).front();
+
+    // Only quantized modules are calibrated
+    BatchDataset dataset(
+        std::make_shared<TensorDataset>(std::vector<Tensor>{inputs}), 4);
+    ASSERT_EQ(calibrateActivations(model, dataset), 0);
+    quantizeWeights(model);
+    ASSERT_EQ(calibrateActivations(model, dataset), numCalibrated[i]);
+    ASSERT_NE(model->prettyString().find("calibrated"), std::string::npos);
+
+    auto output = model->forward({input}).front();
+    ASSERT_EQ(output.shape(), expected.shape());
+    ASSERT_TRUE(allClose(output, expected, 5e-2));
+    // Inputs with gradients are computed in full precision
+    auto withGrad = model->forward({Variable(inputs, true)}).front();
+    ASSERT_TRUE(allClose(withGrad, expected, 5e-2));
+  }
+}
+
 void tdsFwd(bool isfp16) {
   int batchsize = 10;
   int timesteps = 120;
@@ -444,6 +531,33 @@ TEST(ContribModuleTest, SpecAugmentFwd) {
   ASSERT_GT(fZeros, 0);
 }
 
+TEST(ContribModuleTest, SpecAugmentPerUtterance) {
+  SpecAugment specAug(
+      0, 10, 2, 20, 0.5, 2, SpecAugment::MaskingStrategy::GLOBAL_MEAN, true);
+  int T = 100, F = 40, B = 8;
+  auto input = Variable(fl::rand({T, F, 1, B}) + 1, false);
+  auto mean = fl::mean(input.tensor()).scalar<float>();
+
+  specAug.train();
+  auto output = specAug(input).tensor();
+  ASSERT_EQ(output.shape(), input.shape());
+
+  // Every value of output is either the mean or input
+  auto masked = fl::abs(output - mean) < 1e-5;
+  ASSERT_TRUE(fl::all(masked || output == input.tensor()).asScalar<bool>());
+
+  // Masks are drawn for each utterance
+  auto maskedTimes = fl::all(masked, {1});
+  bool differ = false;
+  for (int b = 1; b < B; ++b) {
+    differ |= fl::any(
+                  maskedTimes(fl::span, fl::span, fl::span, b) !=
+                  maskedTimes(fl::span, fl::span, fl::span, 0))
+                  .asScalar<bool>();
+  }
+  ASSERT_TRUE(differ);
+}
+
 void computeRawWavSpecAug(bool isfp16, float epsilon) {
   // no time, only freq masking
   for (int nmask = 1; nmask < 3; nmask++) {
@@ -13,6 +13,7 @@
 #include "flashlight/fl/autograd/autograd.h"
 #include "flashlight/fl/common/Filesystem.h"
 #include "flashlight/fl/contrib/modules/modules.h"
+#include "flashlight/fl/dataset/datasets.h"
 #include "flashlight/fl/nn/nn.h"
 #include "flashlight/fl/tensor/Index.h"
 #include "flashlight/fl/tensor/Init.h"
@@ -170,6 +171,36 @@ TEST(SerializationTest, AdaptiveEmbedding) {
   ASSERT_TRUE(allClose(outputl, output));
 }
 
+TEST(SerializationTest, QuantizedWeights) {
+  auto model = std::make_shared<Sequential>();
+  model->add(Conv2D(3, 4, 5, 5));
+  model->add(View(Shape({4, -1})));
+  model->add(Linear(4, 2));
+  auto input = Variable(fl::rand({5, 5, 3, 2}), false);
+  model->eval();
+  ASSERT_EQ(quantizeWeights(model), 2);
+  BatchDataset calibration(
+      std::make_shared<TensorDataset>(std::vector<Tensor>{input.tensor()}), 2);
+  ASSERT_EQ(calibrateActivations(model, calibration), 2);
+
+  const fs::path path = fs::temp_directory_path() / "QuantizedWeights.mdl";
+  save(path, model);
+
+  std::shared_ptr<Sequential> loaded;
+  load(path, loaded);
+  ASSERT_EQ(loaded->param(0).type(), fl::dtype::u8);
+  ASSERT_TRUE(std::dynamic_pointer_cast<Linear>(loaded->module(2))
+                  ->isCalibrated());
+  ASSERT_TRUE(std::dynamic_pointer_cast<Conv2D>(loaded->module(0))
+                  ->isCalibrated());
+
+  auto output = model->forward(input);
+  auto outputl = loaded->forward(input);
+
+  ASSERT_TRUE(allParamsClose(*loaded, *model));
+  ASSERT_TRUE(allClose(outputl, output));
+}
+
 TEST(SerializationTest, RawWavSpecAugment) {
   auto model = std::make_shared<RawWavSpecAugment>(
       0, 1, 1, 0, 0, 0, 1, 2000, 6000, 16000, 20000);
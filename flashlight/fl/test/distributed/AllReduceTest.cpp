@@ -182,6 +182,71 @@ TEST(Distributed, CoalescingReducer) {
   }
 }
 
+TEST(Distributed, BucketedReducer) {
+  if (!isDistributedInit()) {
+    GTEST_SKIP() << "Distributed initialization failed or not enabled.";
+  }
+
+  auto rank = getWorldRank();
+  auto size = getWorldSize();
+
+  std::vector<Variable> params;
+  for (size_t i = 0; i < 8; ++i) {
+    params.emplace_back(fl::full({1 << 10}, 1, dtype::f32), true);
+  }
+  // Two parameters per bucket
+  auto reducer = std::make_shared<fl::BucketedReducer>(
+      params,
+      /* scale = */ 1.0 / size,
+      /* async = */ true,
+      /* contiguous = */ true, // ignored with Gloo
+      /* bucketBytes = */ 2 * params[0].bytes());
+  ASSERT_EQ(reducer->numBuckets(), 4);
+
+  for (int iter = 0; iter < 2; ++iter) {
+    for (auto& p : params) {
+      p.zeroGrad();
+    }
+    // The last parameter is unused and gets a zero gradient
+    auto loss = params[0] * (rank + 1);
+    for (size_t i = 1; i + 1 < params.size(); ++i) {
+      loss = loss + params[i] * (rank + 1);
+    }
+    loss.backward();
+    reducer->finalize();
+
+    // The reducer scales down by a factor of 1 / size
+    float expected_val = size * (size + 1.0);
+    for (size_t i = 0; i + 1 < params.size(); ++i) {
+      auto arr = params[i].grad().tensor() * (size * 2);
+      ASSERT_TRUE(fl::all(arr == expected_val).scalar<char>());
+    }
+    ASSERT_TRUE(fl::all(params.back().grad().tensor() == 0).scalar<char>());
+  }
+}
+
+TEST(Distributed, AllReduceRowSparse) {
+  if (!isDistributedInit()) {
+    GTEST_SKIP() << "Distributed initialization failed or not enabled.";
+  }
+
+  auto rank = getWorldRank();
+  auto size = getWorldSize();
+
+  // Each process has a gradient for its own row; the last row is unused
+  Variable var(fl::full({3, size + 1}, 0, dtype::f32), false);
+  var.tensor()(fl::span, rank) = 1;
+  var.setRowSparse(Tensor::fromVector<int>({rank}), 1);
+
+  allReduceRowSparse(var, 1, 2.0);
+
+  ASSERT_TRUE(var.isRowSparse());
+  ASSERT_EQ(var.sparseRows().elements(), size);
+  ASSERT_TRUE(
+      fl::all(var.tensor()(fl::span, fl::range(0, size)) == 2).scalar<char>());
+  ASSERT_TRUE(fl::all(var.tensor()(fl::span, size) == 0).scalar<char>());
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   fl::init();
@@ -72,6 +72,33 @@ TEST(MeterTest, AverageValueMeter) {
   ASSERT_EQ(val[2], 6.0);
 }
 
+TEST(MeterTest, AverageValueMeterDeferred) {
+  AverageValueMeter meter;
+  meter.add(2.0);
+  meter.add(fl::fromScalar(3.0), fl::fromScalar(1.0));
+  meter.add(fl::full({1}, 4.0), fl::fromScalar(1.0));
+  // Zero weight values don't count
+  meter.add(fl::fromScalar(100.0), fl::fromScalar(0.0));
+  auto val = meter.value();
+  ASSERT_NEAR(val[0], 3.0, 1e-6);
+  ASSERT_NEAR(val[1], 1.0, 1e-6);
+  ASSERT_EQ(val[2], 3.0);
+
+  meter.reset();
+  meter.add(fl::fromScalar(5.0), fl::fromScalar(2.0));
+  val = meter.value();
+  ASSERT_NEAR(val[0], 5.0, 1e-6);
+  ASSERT_EQ(val[2], 2.0);
+
+  // Values of a tensor are samples of their own
+  meter.reset();
+  meter.add(Tensor::fromVector<float>({2}, {1, 3}));
+  val = meter.value();
+  ASSERT_NEAR(val[0], 2.0, 1e-10);
+  ASSERT_NEAR(val[1], 2.0, 1e-10);
+  ASSERT_EQ(val[2], 2.0);
+}
+
 TEST(MeterTest, MSEMeter) {
   MSEMeter meter;
   std::vector<int> b = {4, 5, 6, 7, 8};
@@ -525,6 +525,64 @@ TEST(ModuleTest, GRUFwd) {
   ASSERT_TRUE(allClose(out, expected_outVar, 1E-4));
 }
 
+TEST(ModuleTest, RNNPackedFwd) {
+  int num_layers = 2;
+  int hidden_size = 4;
+  int input_size = 3;
+  int seq_length = 5;
+  std::vector<int> lengths = {3, 5, 0, 3, 1};
+  int batch_size = lengths.size();
+
+  auto in = Variable(
+      fl::rand({input_size, batch_size, seq_length}, fl::dtype::f32), false);
+  for (auto mode : {RnnMode::LSTM, RnnMode::GRU}) {
+    for (bool bidirectional : {false, true}) {
+      int total_layers = num_layers * (bidirectional ? 2 : 1);
+      int out_size = hidden_size * (bidirectional ? 2 : 1);
+      Shape state_dims({hidden_size, batch_size, total_layers});
+      std::vector<Variable> states = {Variable(fl::rand(state_dims), false)};
+      if (mode == RnnMode::LSTM) {
+        states.emplace_back(fl::rand(state_dims), false);
+      }
+      auto rnn = RNN(input_size, hidden_size, num_layers, mode, bidirectional);
+      std::vector<Variable> inputs = {in};
+      inputs.insert(inputs.end(), states.begin(), states.end());
+      auto out = rnn.forward(inputs, Tensor::fromVector(lengths));
+      ASSERT_EQ(out[0].shape(), Shape({out_size, batch_size, seq_length}));
+
+      // Each sample matches running the RNN on its valid steps alone
+      for (int b = 0; b < batch_size; ++b) {
+        auto sample = fl::range(b, b + 1);
+        if (lengths[b] < seq_length) {
+          auto outPad = out[0].tensor()(
+              fl::span, sample, fl::range(lengths[b], seq_length));
+          ASSERT_TRUE(allClose(outPad, fl::full(outPad.shape(), 0.0)));
+        }
+
+        // A sample without valid steps keeps its input states
+        std::vector<Variable> expected = {Variable()};
+        for (const auto& state : states) {
+          expected.push_back(state(fl::span, sample));
+        }
+        if (lengths[b] > 0) {
+          expected[0] = in(fl::span, sample, fl::range(0, lengths[b]));
+          expected = rnn.forward(expected);
+        }
+        for (size_t i = 1; i < out.size(); ++i) {
+          ASSERT_TRUE(allClose(
+              out[i].tensor()(fl::span, sample), expected[i].tensor(), 1E-5));
+        }
+        if (lengths[b] > 0) {
+          ASSERT_TRUE(allClose(
+              out[0].tensor()(fl::span, sample, fl::range(0, lengths[b])),
+              expected[0].tensor(),
+              1E-5));
+        }
+      }
+    }
+  }
+}
+
 TEST_F(ModuleTestF16, RNNFwdF16) {
   if (!fl::f16Supported()) {
     GTEST_SKIP() << "Half-precision not supported on this device";
@@ -871,6 +929,51 @@ TEST(ModuleTest, AdaptiveSoftMaxLossIgnoreIndex) {
       1E-5);
 }
 
+TEST(ModuleTest, AdaptiveSoftMaxTailClusters) {
+  // Only some positions go through each tail cluster: loss and predictions
+  // must match the full distribution
+  int N = 8;
+  int C = 20;
+  int T = 6;
+  int B = 3;
+
+  auto x = input(fl::randn({N, T, B}, fl::dtype::f32) * 4);
+  auto y = Variable(
+      (fl::rand({T, B}, fl::dtype::u32) % C).astype(fl::dtype::s32), false);
+
+  std::vector<int> cutoff{{4, 10, C}};
+  auto activation = std::make_shared<AdaptiveSoftMax>(N, cutoff, 2);
+  auto asml =
+      std::make_shared<AdaptiveSoftMaxLoss>(activation, ReduceMode::NONE);
+
+  auto logProbs = activation->forward(x).tensor();
+  auto targetIdx = y.tensor().flatten() +
+      C * fl::arange({T * B}, 0, fl::dtype::s32);
+  auto expectedLoss = fl::reshape(-logProbs.flatten()(targetIdx), {T, B});
+  ASSERT_TRUE(allClose(asml->forward(x, y).tensor(), expectedLoss, 1E-4));
+
+  // Input gradients match finite differences
+  auto sumLoss =
+      std::make_shared<AdaptiveSoftMaxLoss>(activation, ReduceMode::SUM);
+  auto xGrad = Variable(x.tensor(), true);
+  sumLoss->forward(xGrad, y).backward();
+  float eps = 1E-2;
+  for (int n = 0; n < N; ++n) {
+    auto plus = x.tensor().copy();
+    plus(n, 0, 0) += eps;
+    auto minus = x.tensor().copy();
+    minus(n, 0, 0) -= eps;
+    auto numeric = (sumLoss->forward(input(plus), y).scalar<float>() -
+                    sumLoss->forward(input(minus), y).scalar<float>()) /
+        (2 * eps);
+    ASSERT_NEAR(numeric, xGrad.grad().tensor()(n, 0, 0).scalar<float>(), 1E-2);
+  }
+
+  auto prediction = activation->predict(x).tensor();
+  auto expectedPrediction = fl::argmax(logProbs, 0, /* keepDims = */ true);
+  ASSERT_TRUE(allClose(prediction, expectedPrediction));
+}
+
 TEST(ModuleTest, IdentityFwd) {
   auto module = Identity();
   std::vector<Variable> in = {
@@ -292,6 +292,53 @@ TEST(NNSerializationTest, LeNet) {
   ASSERT_TRUE(allClose(leNet2->forward(in), leNet->forward(in)));
 }
 
+TEST(NNSerializationTest, Mapped) {
+  auto seq = std::make_shared<Sequential>();
+  seq->add(Conv2D(3, 6, 5, 5));
+  seq->add(ReLU());
+  seq->add(View(Shape({6 * 28 * 28})));
+  seq->add(Linear(6 * 28 * 28, 10, /* bias = */ false));
+  Variable empty(Tensor(), false);
+  const int64_t step = 5;
+
+  const fs::path path = fs::temp_directory_path() / "Mapped.mdl";
+  saveMapped(path, seq, empty, step);
+  ASSERT_TRUE(isMappedModelFile(path));
+  fs::path tmpPath = path;
+  tmpPath += ".tmp";
+  ASSERT_FALSE(fs::exists(tmpPath));
+
+  // A failed save leaves the previous file in place
+  auto sparse = Tensor(
+      2,
+      2,
+      fl::full({2}, 1),
+      Tensor::fromVector<int>({0, 1, 2}),
+      Tensor::fromVector<int>({0, 1}),
+      fl::StorageType::CSR);
+  ASSERT_ANY_THROW(saveMapped(path, sparse));
+  ASSERT_TRUE(isMappedModelFile(path));
+  ASSERT_FALSE(fs::exists(tmpPath));
+
+  std::shared_ptr<Sequential> seq2;
+  Variable empty2;
+  int64_t step2;
+  loadMapped(path, seq2, empty2, step2);
+  ASSERT_TRUE(seq2);
+  ASSERT_TRUE(allParamsClose(*seq2, *seq));
+  ASSERT_TRUE(empty2.isEmpty());
+  ASSERT_EQ(step2, step);
+
+  auto in = input(fl::rand({32, 32, 3, 1}));
+  ASSERT_TRUE(allClose(seq2->forward(in), seq->forward(in)));
+
+  // Regular files are not mistaken for mapped ones
+  const fs::path regular = fs::temp_directory_path() / "NotMapped.mdl";
+  save(regular, seq);
+  ASSERT_FALSE(isMappedModelFile(regular));
+  ASSERT_THROW(loadMapped(regular, seq2), std::runtime_error);
+}
+
 // Make sure serialized file size if not too high
 TEST(NNSerializationTest, FileSize) {
   auto conv = std::make_shared<Conv2D>(300, 600, 10, 10);
@@ -111,6 +111,24 @@ TEST(UtilsTest, Join) {
                   .asScalar<bool>());
 }
 
+TEST(UtilsTest, QuantizePerChannel) {
+  auto weights = fl::rand({6, 5}) * 2 - 1;
+  weights(2) = 0; // an all-zero channel
+  auto [quantized, scales] = quantizePerChannel(weights, 0);
+  ASSERT_EQ(quantized.type(), fl::dtype::u8);
+  ASSERT_EQ(quantized.shape(), weights.shape());
+  ASSERT_EQ(scales.shape(), Shape({6, 1}));
+
+  auto dequantized = dequantize(quantized, scales, fl::dtype::f32);
+  ASSERT_EQ(dequantized.type(), fl::dtype::f32);
+  // Rounding errors are at most half a step
+  ASSERT_TRUE(fl::all(fl::abs(dequantized - weights) <= scales / 2 + 1e-6)
+                  .asScalar<bool>());
+  ASSERT_TRUE(fl::all(dequantized(2) == 0).asScalar<bool>());
+
+  ASSERT_THROW(quantizePerChannel(weights, 2), std::invalid_argument);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   fl::init();
@@ -8,6 +8,9 @@
 #include <gtest/gtest.h>
 
 #include <cmath>
+#include <functional>
+#include <memory>
+#include <vector>
 
 #include "flashlight/fl/common/common.h"
 #include "flashlight/fl/optim/optim.h"
@@ -35,6 +38,35 @@ TEST(OptimTest, GradNorm) {
   ASSERT_TRUE(allClose(fl::full({1}, max_norm), fl::full({1}, clipped)));
 }
 
+TEST(OptimTest, GradNormAsync) {
+  std::vector<Variable> parameters;
+  double norm = 0.0;
+  for (int i = 0; i < 5; i++) {
+    auto v = Variable(fl::randn({10, 10, 10}), true);
+    v.addGrad(Variable(fl::randn({10, 10, 10}), false));
+    auto& g = v.grad().tensor();
+    norm += fl::sum(g * g).asScalar<double>();
+    parameters.push_back(v);
+  }
+  norm = std::sqrt(norm);
+
+  // No clipping below the threshold
+  auto before = parameters[0].grad().tensor().copy();
+  auto gradNorm = clipGradNormAsync(parameters, norm * 2);
+  ASSERT_NEAR(gradNorm.asScalar<double>(), norm, 1e-3);
+  ASSERT_TRUE(allClose(before, parameters[0].grad().tensor()));
+
+  double max_norm = norm / 2;
+  gradNorm = clipGradNormAsync(parameters, max_norm);
+  ASSERT_NEAR(gradNorm.asScalar<double>(), norm, 1e-3);
+  double clipped = 0.0;
+  for (auto& v : parameters) {
+    auto& g = v.grad().tensor();
+    clipped += fl::sum(g * g).asScalar<double>();
+  }
+  ASSERT_NEAR(std::sqrt(clipped), max_norm, 1e-3);
+}
+
 TEST(OptimTest, GradNormF16) {
   if (!fl::f16Supported()) {
     GTEST_SKIP() << "Half-precision not supported on this device";
@@ -59,6 +91,90 @@ TEST(OptimTest, GradNormF16) {
   ASSERT_TRUE(allClose(fl::full({1}, max_norm), fl::full({1}, clipped), 1e-2));
 }
 
+TEST(OptimTest, RowSparseUpdates) {
+  auto makeGrad = [](const std::vector<int>& rows, bool sparse) {
+    auto grad = Variable(fl::full({3, 6}, 0), false);
+    auto idx = Tensor::fromVector(rows);
+    Dim numRows = rows.size();
+    grad.tensor()(fl::span, idx) = fl::randn({3, numRows});
+    if (sparse) {
+      grad.setRowSparse(idx, 1);
+    }
+    return grad;
+  };
+  using OptimizerFactory = std::function<std::shared_ptr<FirstOrderOptimizer>(
+      const std::vector<Variable>&)>;
+  std::vector<OptimizerFactory> factories = {
+      [](const std::vector<Variable>& p) {
+        return std::make_shared<SGDOptimizer>(p, 0.1, 0.9);
+      },
+      [](const std::vector<Variable>& p) {
+        return std::make_shared<AdamOptimizer>(p, 0.1);
+      },
+      [](const std::vector<Variable>& p) {
+        return std::make_shared<AdagradOptimizer>(p, 0.1);
+      }};
+
+  for (const auto& factory : factories) {
+    auto init = fl::randn({3, 6});
+    auto sparse = Variable(init.copy(), true);
+    auto dense = Variable(init.copy(), true);
+    auto sparseOpt = factory({sparse});
+    auto denseOpt = factory({dense});
+    ASSERT_FALSE(sparseOpt->getLazySparseUpdates());
+    sparseOpt->setLazySparseUpdates(true);
+
+    // Rows without a gradient have no state yet: updates match
+    auto grad = makeGrad({1, 4}, true);
+    sparse.addGrad(grad);
+    dense.addGrad(Variable(grad.tensor().copy(), false));
+    sparseOpt->step();
+    denseOpt->step();
+    ASSERT_TRUE(allClose(sparse.tensor(), dense.tensor()));
+
+    // Gradients held as slices, with repeated rows, are updated the same way
+    auto compact = Variable(init.copy(), true);
+    auto compactOpt = factory({compact});
+    compactOpt->setLazySparseUpdates(true);
+    auto rows = Tensor::fromVector<int>({4, 1, 4});
+    auto slices = grad.tensor()(fl::span, rows).copy();
+    slices(fl::span, 0) = slices(fl::span, 0) / 2;
+    slices(fl::span, 2) = slices(fl::span, 2) / 2;
+    compact.addSparseGrad(slices, rows, 1);
+    compactOpt->step();
+    ASSERT_TRUE(allClose(compact.tensor(), dense.tensor()));
+
+    // Rows without a gradient are left as is
+    auto before = sparse.tensor().copy();
+    sparseOpt->zeroGrad();
+    sparse.addGrad(makeGrad({2}, true));
+    sparseOpt->step();
+    ASSERT_TRUE(allClose(
+        sparse.tensor()(fl::span, fl::range(0, 2)),
+        before(fl::span, fl::range(0, 2))));
+    ASSERT_TRUE(allClose(
+        sparse.tensor()(fl::span, fl::range(3, 6)),
+        before(fl::span, fl::range(3, 6))));
+    ASSERT_FALSE(allClose(sparse.tensor()(fl::span, 2), before(fl::span, 2)));
+
+    // Without lazy updates, row-sparse gradients are applied as dense ones
+    auto eager = Variable(init.copy(), true);
+    auto reference = Variable(init.copy(), true);
+    auto eagerOpt = factory({eager});
+    auto referenceOpt = factory({reference});
+    for (const auto& rows : {std::vector<int>{1, 4}, std::vector<int>{2}}) {
+      auto rowGrad = makeGrad(rows, true);
+      eager.addGrad(rowGrad);
+      reference.addGrad(Variable(rowGrad.tensor().copy(), false));
+      eagerOpt->step();
+      referenceOpt->step();
+      eagerOpt->zeroGrad();
+      referenceOpt->zeroGrad();
+    }
+    ASSERT_TRUE(allClose(eager.tensor(), reference.tensor()));
+  }
+}
+
 TEST(SerializationTest, OptimizerSerialize) {
   const fs::path path = fs::temp_directory_path() / "optmizer.bin";
 
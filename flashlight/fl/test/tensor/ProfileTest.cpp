@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "flashlight/fl/common/Filesystem.h"
+#include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/Profile.h"
+#include "flashlight/fl/tensor/TraceRecorder.h"
+
+using namespace ::testing;
+using namespace fl;
+
+namespace {
+
+std::string readFile(const fs::path& path) {
+  std::ifstream file(path);
+  return std::string(
+      (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+size_t countOccurrences(const std::string& str, const std::string& sub) {
+  size_t count = 0;
+  for (auto pos = str.find(sub); pos != std::string::npos;
+       pos = str.find(sub, pos + sub.size())) {
+    ++count;
+  }
+  return count;
+}
+
+} // namespace
+
+TEST(ProfileTest, TraceScope) {
+  ASSERT_EQ(detail::TraceScope::current(), 0);
+  const auto outer = detail::TraceScope::intern("outer");
+  ASSERT_EQ(detail::TraceScope::intern("outer"), outer);
+  ASSERT_EQ(detail::TraceScope::name(outer), "outer");
+  ASSERT_EQ(
+      detail::TraceScope::name(outer | detail::TraceScope::kBackward),
+      "outer (backward)");
+  {
+    detail::TraceScope scope(outer);
+    ASSERT_EQ(detail::TraceScope::current(), outer);
+    {
+      // Names are only interned when scopes are tracked
+      detail::TraceScope inner("inner");
+      ASSERT_EQ(detail::TraceScope::current(), outer);
+    }
+    detail::TraceScope::enable();
+    {
+      detail::TraceScope inner("inner");
+      ASSERT_EQ(
+          detail::TraceScope::name(detail::TraceScope::current()), "inner");
+    }
+    detail::TraceScope::disable();
+    ASSERT_EQ(detail::TraceScope::current(), outer);
+  }
+  ASSERT_EQ(detail::TraceScope::current(), 0);
+}
+
+TEST(ProfileTest, TraceRecorder) {
+  const auto path = fs::temp_directory_path() / "ProfileTest.json";
+  TraceRecorder::clear();
+  {
+    // Not recorded
+    detail::ProfileTracer tracer("beforeStart");
+  }
+  TraceRecorder::start();
+  ASSERT_TRUE(TraceRecorder::recording());
+  ASSERT_TRUE(detail::TraceScope::enabled());
+  {
+    detail::ProfileTracer outer("outerSpan");
+    detail::ProfileTracer inner("innerSpan");
+    const auto scope = detail::TraceScope::current();
+    ASSERT_EQ(detail::TraceScope::name(scope), "innerSpan");
+    // Tensor ops are recorded without opening a scope
+    detail::ProfileTracer op(
+        detail::TraceScope::intern("opSpan"), /* openScope = */ false);
+    ASSERT_EQ(detail::TraceScope::current(), scope);
+  }
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 2; ++i) {
+    threads.emplace_back([]() { detail::ProfileTracer tracer("threadSpan"); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  TraceRecorder::stop();
+  ASSERT_FALSE(detail::TraceScope::enabled());
+  TraceRecorder::save(path);
+
+  const auto trace = readFile(path);
+  ASSERT_EQ(trace.rfind("{\"traceEvents\":[", 0), 0);
+  ASSERT_EQ(countOccurrences(trace, "\"name\":\"outerSpan\""), 1);
+  ASSERT_EQ(countOccurrences(trace, "\"name\":\"innerSpan\""), 1);
+  ASSERT_EQ(countOccurrences(trace, "\"name\":\"opSpan\""), 1);
+  ASSERT_EQ(countOccurrences(trace, "\"name\":\"threadSpan\""), 2);
+  ASSERT_EQ(countOccurrences(trace, "beforeStart"), 0);
+  // One thread name per thread
+  ASSERT_EQ(countOccurrences(trace, "\"thread_name\""), 3);
+
+  TraceRecorder::clear();
+  TraceRecorder::save(path);
+  ASSERT_EQ(countOccurrences(readFile(path), "Span"), 0);
+}
+
+TEST(ProfileTest, TraceRecorderRingBuffer) {
+  const auto path = fs::temp_directory_path() / "ProfileTestRing.json";
+  TraceRecorder::clear();
+  TraceRecorder::start(/* capacity = */ 4);
+  for (int i = 0; i < 10; ++i) {
+    detail::ProfileTracer tracer("span" + std::to_string(i));
+  }
+  TraceRecorder::stop();
+  TraceRecorder::save(path);
+
+  // Only the last intervals are kept, except the oldest one, whose slot is
+  // the next to be overwritten
+  const auto trace = readFile(path);
+  ASSERT_EQ(countOccurrences(trace, "\"ph\":\"X\""), 3);
+  ASSERT_EQ(countOccurrences(trace, "\"name\":\"span6\""), 0);
+  ASSERT_EQ(countOccurrences(trace, "\"name\":\"span7\""), 1);
+  ASSERT_EQ(countOccurrences(trace, "\"name\":\"span9\""), 1);
+  TraceRecorder::clear();
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  fl::init();
+  return RUN_ALL_TESTS();
+}
@@ -192,6 +192,29 @@ TEST(ArrayFireTensorBaseTest, ArrayFireAssignmentOperators) {
   ASSERT_EQ(getRefCount(aArr), 2); // aArr, bArr
 }
 
+TEST(ArrayFireTensorBaseTest, dataVersion) {
+  auto a = fl::rand({4, 4});
+  const auto version = a.dataVersion();
+  ASSERT_TRUE(version.has_value());
+  // Reading the data or copying the tensor doesn't change the version
+  a.device<float>();
+  a.unlock();
+  auto b = a;
+  ASSERT_EQ(b.dataVersion(), version);
+  ASSERT_EQ(a.astype(fl::dtype::f32).dataVersion(), version);
+  ASSERT_NE(a.astype(fl::dtype::f64).dataVersion(), version);
+  ASSERT_NE(a.copy().dataVersion(), version);
+  // Writes to a copy don't change the original
+  b += 1;
+  ASSERT_NE(b.dataVersion(), version);
+  ASSERT_EQ(a.dataVersion(), version);
+  // Writes to a view change the viewed tensor
+  auto c = a.shallowCopy();
+  a(fl::range(0, 2)) = 0;
+  ASSERT_NE(a.dataVersion(), version);
+  ASSERT_EQ(c.dataVersion(), a.dataVersion());
+}
+
 TEST(ArrayFireTensorBaseTest, BinaryOperators) {
   auto a =
       toTensor<ArrayFireTensor>(af::constant(1, {2, 2}), /* numDims = */ 2);
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <af/device.h>
+#include <af/internal.h>
+#include <arrayfire.h>
+
+#include "flashlight/fl/common/Timer.h"
+#include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/backend/af/mem/CachingMemoryManager.h"
+#include "flashlight/fl/tensor/backend/af/mem/MemoryManagerInstaller.h"
+
+using namespace fl;
+
+namespace {
+
+constexpr int kIters = 100000;
+// Number of buffers each thread keeps alive at most
+constexpr size_t kMaxLive = 64;
+
+/**
+ * Allocates and frees buffers of random sizes up to maxBytes directly through
+ * the memory manager from numThreads threads. Returns the time per
+ * allocation/free pair in microseconds.
+ */
+double allocFree(
+    CachingMemoryManager& manager,
+    int numThreads,
+    dim_t maxBytes) {
+  auto fn = [&manager, maxBytes](int seed) {
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<dim_t> sizeDist(1, maxBytes);
+    std::vector<void*> live;
+    live.reserve(kMaxLive);
+    for (int i = 0; i < kIters; ++i) {
+      if (live.size() < kMaxLive && (live.empty() || gen() % 2)) {
+        dim_t bytes = sizeDist(gen);
+        live.push_back(manager.alloc(false, 1, &bytes, 1));
+      } else {
+        auto idx = gen() % live.size();
+        manager.unlock(live[idx], false);
+        live[idx] = live.back();
+        live.pop_back();
+      }
+    }
+    for (auto* ptr : live) {
+      manager.unlock(ptr, false);
+    }
+  };
+
+  // warmup
+  fn(0);
+
+  auto start = fl::Timer::start();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < numThreads; ++t) {
+    threads.emplace_back(fn, t + 1);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  return fl::Timer::stop(start) * 1e6 / kIters;
+}
+
+} // namespace
+
+int main() {
+  fl::init();
+  const int maxThreads =
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+
+  std::cout << std::setw(10) << "threads" << std::setw(12) << "max size"
+            << std::setw(14) << "tree (us)" << std::setw(14) << "slab (us)"
+            << std::endl;
+  for (dim_t maxBytes : {4096, 65536, 1048576}) {
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+      std::pair<double, double> times;
+      for (bool slabs : {false, true}) {
+        auto deviceInterface =
+            std::make_shared<fl::MemoryManagerDeviceInterface>();
+        auto manager = std::make_shared<fl::CachingMemoryManager>(
+            af::getDeviceCount(), deviceInterface);
+        manager->setSlabAllocation(slabs);
+        fl::MemoryManagerInstaller installer(manager);
+        installer.setAsMemoryManager();
+        const double time = allocFree(*manager, threads, maxBytes);
+        (slabs ? times.second : times.first) = time;
+        manager->signalMemoryCleanup();
+        af_unset_memory_manager();
+      }
+      std::cout << std::setw(10) << threads << std::setw(12) << maxBytes
+                << std::setw(14) << std::setprecision(4) << times.first
+                << std::setw(14) << times.second << std::endl;
+    }
+  }
+  return 0;
+}
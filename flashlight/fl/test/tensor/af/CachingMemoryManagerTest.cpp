@@ -5,8 +5,13 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <fstream>
+#include <iterator>
 #include <memory>
 #include <random>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include <af/device.h>
@@ -14,7 +19,10 @@
 #include <arrayfire.h>
 #include <gtest/gtest.h>
 
+#include "flashlight/fl/common/Filesystem.h"
 #include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/Profile.h"
+#include "flashlight/fl/tensor/backend/af/mem/AllocationTracer.h"
 #include "flashlight/fl/tensor/backend/af/mem/CachingMemoryManager.h"
 #include "flashlight/fl/tensor/backend/af/mem/MemoryManagerAdapter.h"
 #include "flashlight/fl/tensor/backend/af/mem/MemoryManagerInstaller.h"
@@ -149,6 +157,50 @@ TEST_F(CachingMemoryManagerTest, OOM) {
   }
 }
 
+TEST_F(CachingMemoryManagerTest, SlabAllocations) {
+  // Allocations of at most 1 MiB come from slabs shared between threads
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([this, t]() {
+      std::vector<std::pair<void*, dim_t>> ptrs;
+      for (dim_t bytes = 1 + t; bytes <= (1 << 20); bytes = bytes * 3 + 1) {
+        dim_t dims = bytes;
+        void* ptr = adapter_->alloc(false, 1, &dims, 1);
+        ASSERT_NE(ptr, nullptr);
+        ASSERT_GE(adapter_->allocated(ptr), bytes);
+        ptrs.emplace_back(ptr, bytes);
+      }
+      for (size_t i = 0; i < ptrs.size(); ++i) {
+        for (size_t j = i + 1; j < ptrs.size(); ++j) {
+          auto* a = static_cast<char*>(ptrs[i].first);
+          auto* b = static_cast<char*>(ptrs[j].first);
+          ASSERT_TRUE(a + ptrs[i].second <= b || b + ptrs[j].second <= a);
+        }
+      }
+      for (auto& ptr : ptrs) {
+        adapter_->unlock(ptr.first, false);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  // A slot locked by both the user and the manager is only freed once both
+  // locks are released
+  dim_t dims = 1000;
+  void* ptr = adapter_->alloc(false, 1, &dims, 1);
+  adapter_->userLock(ptr);
+  ASSERT_TRUE(adapter_->isUserLocked(ptr));
+  adapter_->unlock(ptr, false);
+  ASSERT_GT(adapter_->allocated(ptr), 0);
+  adapter_->userUnlock(ptr);
+  ASSERT_FALSE(adapter_->isUserLocked(ptr));
+  ASSERT_EQ(adapter_->allocated(ptr), 0);
+
+  adapter_->signalMemoryCleanup();
+}
+
 void testFragmentation(
     std::shared_ptr<fl::MemoryManagerDeviceInterface> deviceInterface_,
     std::shared_ptr<fl::CachingMemoryManager> adapter_,
@@ -186,6 +238,60 @@ void testFragmentation(
   }
 }
 
+TEST_F(CachingMemoryManagerTest, AllocationTracer) {
+  auto tracer = std::make_shared<fl::AllocationTracer>(
+      /* snapshotInterval = */ 1);
+  adapter_->setAllocationTracer(tracer);
+  ASSERT_TRUE(fl::detail::TraceScope::enabled());
+
+  const size_t bytes = 1000 * sizeof(float);
+  {
+    fl::detail::TraceScope outer("outer");
+    af::array a = af::constant(1.0, 1000);
+    a.eval();
+    {
+      fl::detail::TraceScope inner("inner");
+      af::array b = af::constant(2.0, 1000);
+      b.eval();
+      ASSERT_GE(tracer->liveBytes(), 2 * bytes);
+    }
+  }
+  af::sync();
+  adapter_->setAllocationTracer(nullptr);
+  ASSERT_EQ(tracer->liveBytes(), 0);
+
+  auto trace = tracer->trace();
+  ASSERT_GE(trace.peakBytes(), 2 * bytes);
+  auto stats = trace.scopeStats();
+  ASSERT_TRUE(stats.count("outer"));
+  ASSERT_TRUE(stats.count("inner"));
+  ASSERT_GE(stats["inner"].totalBytes, bytes);
+  ASSERT_GE(stats["inner"].peakBytes, bytes);
+  ASSERT_GE(stats["inner"].bytesAtPeak, bytes);
+  ASSERT_GE(stats["outer"].bytesAtPeak, bytes);
+  ASSERT_FALSE(trace.snapshots.empty());
+  ASSERT_GT(trace.snapshots.back().reservedBytes, 0);
+
+  const auto path = fs::temp_directory_path() / "AllocationTracer.bin";
+  trace.save(path);
+  auto loaded = fl::AllocationTrace::load(path);
+  ASSERT_EQ(loaded.events.size(), trace.events.size());
+  ASSERT_EQ(loaded.snapshots.size(), trace.snapshots.size());
+  ASSERT_EQ(
+      loaded.scopeStats()["inner"].totalBytes, stats["inner"].totalBytes);
+
+  const auto jsonPath = fs::temp_directory_path() / "AllocationTracer.json";
+  trace.saveChromeTrace(jsonPath);
+  std::ifstream json(jsonPath);
+  std::string contents(
+      (std::istreambuf_iterator<char>(json)), std::istreambuf_iterator<char>());
+  ASSERT_EQ(contents.rfind("{\"traceEvents\":[", 0), 0);
+  ASSERT_NE(contents.find("\"name\":\"inner\""), std::string::npos);
+
+  tracer.reset();
+  ASSERT_FALSE(fl::detail::TraceScope::enabled());
+}
+
 TEST_F(CachingMemoryManagerTest, Fragmentation) {
   GTEST_SKIP() << "Causes spurious OOMs even with exception handling.";
   testFragmentation(deviceInterface_, adapter_, true); // should OOM
@@ -0,0 +1,324 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/pkg/runtime/common/AsyncCheckpointer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+namespace fl {
+namespace pkg {
+namespace runtime {
+
+namespace {
+
+// Number of files written concurrently
+constexpr std::size_t kWriterThreads = 4;
+
+void writeFile(const fs::path& filepath, const std::string& data) {
+  // Rename is atomic within a filesystem, so the temporary file lives next to
+  // its destination
+  fs::path tmpPath = filepath;
+  tmpPath += ".tmp";
+  try {
+    {
+      std::ofstream file(tmpPath, std::ios::binary | std::ios::trunc);
+      if (!file.is_open()) {
+        throw std::runtime_error(
+            "failed to open file for writing: " + tmpPath.string());
+      }
+      file.write(data.data(), data.size());
+      file.close();
+      if (!file) {
+        throw std::runtime_error("failed to write file: " + tmpPath.string());
+      }
+    }
+    fs::rename(tmpPath, filepath);
+  } catch (const std::exception& ex) {
+    FL_LOG(fl::LogLevel::ERROR)
+        << "Error while saving \"" << filepath << "\": " << ex.what() << "\n";
+    throw;
+  }
+}
+
+void writeFileWithRetries(const fs::path& filepath, const std::string& data) {
+  fl::retryWithBackoff(
+      std::chrono::seconds(1),
+      2.0,
+      6,
+      writeFile,
+      filepath,
+      data); // max wait 31s
+}
+
+/**
+ * The content of a commit marker: the save it commits, and the layout of the
+ * checkpoint.
+ */
+struct Commit {
+  uint64_t runId{0};
+  uint64_t saveCount{0};
+  std::size_t numShards{0};
+  std::size_t worldSize{0};
+
+  bool operator==(const Commit& other) const {
+    return runId == other.runId && saveCount == other.saveCount &&
+        numShards == other.numShards && worldSize == other.worldSize;
+  }
+
+  std::string toString() const {
+    std::ostringstream ss;
+    ss << runId << " " << saveCount << " " << numShards << " " << worldSize
+       << "\n";
+    return ss.str();
+  }
+
+  // Returns false if the marker is missing or malformed
+  bool read(const fs::path& path) {
+    std::ifstream file(path);
+    return file.is_open() &&
+        static_cast<bool>(file >> runId >> saveCount >> numShards >> worldSize);
+  }
+};
+
+/**
+ * Tracks the shards of a sharded checkpoint being written by this rank, so
+ * that the last of them to be written commits the checkpoint.
+ */
+struct PendingCommit {
+  PendingCommit(
+      fs::path filepath,
+      fs::path markerPath,
+      Commit commit,
+      bool isFirstRank,
+      std::size_t numShards)
+      : filepath(std::move(filepath)),
+        markerPath(std::move(markerPath)),
+        commit(commit),
+        isFirstRank(isFirstRank),
+        remaining(numShards) {}
+
+  const fs::path filepath;
+  const fs::path markerPath;
+  const Commit commit;
+  const bool isFirstRank;
+  std::atomic<std::size_t> remaining;
+  std::atomic<bool> failed{false};
+
+  // Called once per shard, whether it was written or not
+  void shardDone(bool written) {
+    if (!written) {
+      failed = true;
+    }
+    if (--remaining > 0 || failed) {
+      return;
+    }
+    writeFileWithRetries(markerPath, commit.toString());
+    // An unsharded checkpoint at the same path would take precedence when
+    // loading
+    if (isFirstRank && fs::exists(filepath)) {
+      fs::remove(filepath);
+    }
+  }
+};
+
+} // namespace
+
+AsyncCheckpointer::AsyncCheckpointer(int rank, int worldSize)
+    : rank_(rank), worldSize_(worldSize) {
+  if (worldSize <= 0 || rank < 0 || rank >= worldSize) {
+    throw std::invalid_argument(
+        "AsyncCheckpointer: invalid rank " + std::to_string(rank) +
+        " for world size " + std::to_string(worldSize));
+  }
+  if (worldSize > 1 && fl::isDistributedInit() &&
+      fl::getWorldSize() == worldSize) {
+    // Rank 0 draws the id of the run and shares it with the other ranks
+    std::vector<int> id = {0, 0};
+    if (rank == 0) {
+      std::random_device rd;
+      id = {static_cast<int>(rd() >> 1), static_cast<int>(rd() >> 1)};
+    }
+    auto idTensor = Tensor::fromVector(id);
+    fl::allReduce(idTensor);
+    id = idTensor.toHostVector<int>();
+    runId_ =
+        (static_cast<uint64_t>(id[0]) << 32) | static_cast<uint32_t>(id[1]);
+  }
+}
+
+AsyncCheckpointer::~AsyncCheckpointer() {
+  try {
+    wait();
+  } catch (const std::exception& ex) {
+    FL_LOG(fl::LogLevel::ERROR)
+        << "AsyncCheckpointer: checkpoint not saved: " << ex.what();
+  }
+}
+
+void AsyncCheckpointer::wait() {
+  std::exception_ptr error;
+  for (auto& write : pending_) {
+    try {
+      write.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  pending_.clear();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+bool AsyncCheckpointer::isSharded() const {
+  return worldSize_ > 1;
+}
+
+bool AsyncCheckpointer::exists(const fs::path& filepath) {
+  return fs::exists(filepath) || committedShards(filepath) > 0;
+}
+
+std::size_t AsyncCheckpointer::committedShards(const fs::path& filepath) {
+  Commit commit;
+  if (!commit.read(commitPath(filepath, 0)) || commit.worldSize < 2) {
+    return 0;
+  }
+  for (std::size_t rank = 1; rank < commit.worldSize; ++rank) {
+    Commit other;
+    if (!other.read(commitPath(filepath, rank)) || !(other == commit)) {
+      return 0;
+    }
+  }
+  for (std::size_t shard = 0; shard < commit.numShards; ++shard) {
+    if (!fs::exists(shardPath(filepath, shard))) {
+      return 0;
+    }
+  }
+  return commit.numShards;
+}
+
+std::vector<Tensor*> AsyncCheckpointer::distinct(std::vector<Tensor*> tensors) {
+  std::unordered_set<const Tensor*> seen;
+  tensors.erase(
+      std::remove_if(
+          tensors.begin(),
+          tensors.end(),
+          [&seen](const Tensor* tensor) {
+            return !seen.insert(tensor).second;
+          }),
+      tensors.end());
+  return tensors;
+}
+
+std::vector<std::size_t> AsyncCheckpointer::tensorOwners(
+    const std::vector<Tensor*>& tensors,
+    std::size_t worldSize) {
+  std::vector<std::size_t> order(tensors.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+    return tensors[a]->bytes() > tensors[b]->bytes();
+  });
+  std::vector<std::size_t> owners(tensors.size());
+  std::vector<std::size_t> load(worldSize, 0);
+  for (auto i : order) {
+    const auto rank = static_cast<std::size_t>(
+        std::min_element(load.begin(), load.end()) - load.begin());
+    owners[i] = rank;
+    load[rank] += tensors[i]->bytes();
+  }
+  return owners;
+}
+
+fs::path AsyncCheckpointer::shardPath(
+    const fs::path& filepath,
+    std::size_t shard) {
+  fs::path path = filepath;
+  path += ".shard" + std::to_string(shard);
+  return path;
+}
+
+fs::path AsyncCheckpointer::commitPath(
+    const fs::path& filepath,
+    std::size_t rank) {
+  fs::path path = filepath;
+  path += ".commit" + std::to_string(rank);
+  return path;
+}
+
+void AsyncCheckpointer::writeSnapshot(
+    const std::vector<fs::path>& filepaths,
+    std::vector<Shard> shards,
+    std::size_t numShards) {
+  const bool sharded = worldSize_ > 1;
+  const Commit commit{runId_, saveCount_++, numShards, worldSize_};
+  if (filepaths.empty() || (shards.empty() && !sharded)) {
+    return;
+  }
+  // Threads are started lazily: unsharded checkpointers which save nothing
+  // never need any
+  if (!threadPool_) {
+    threadPool_ = std::make_unique<fl::ThreadPool>(kWriterThreads);
+  }
+
+  for (const auto& filepath : filepaths) {
+    if (!sharded) {
+      for (const auto& shard : shards) {
+        pending_.push_back(threadPool_->enqueue(
+            [filepath](std::shared_ptr<const std::string> data) {
+              writeFileWithRetries(filepath, *data);
+            },
+            shard.data));
+      }
+      continue;
+    }
+    // Uncommitted until all of this rank's shards of the save are written
+    const auto markerPath = commitPath(filepath, rank_);
+    fs::remove(markerPath);
+    auto pendingCommit = std::make_shared<PendingCommit>(
+        filepath,
+        markerPath,
+        commit,
+        rank_ == 0,
+        std::max<std::size_t>(shards.size(), 1));
+    if (shards.empty()) {
+      // A rank owning no shard commits right away
+      pending_.push_back(threadPool_->enqueue(
+          [pendingCommit]() { pendingCommit->shardDone(true); }));
+      continue;
+    }
+    for (const auto& shard : shards) {
+      pending_.push_back(threadPool_->enqueue(
+          [pendingCommit, path = shardPath(filepath, shard.index)](
+              std::shared_ptr<const std::string> data) {
+            try {
+              writeFileWithRetries(path, *data);
+            } catch (...) {
+              pendingCommit->shardDone(false);
+              throw;
+            }
+            pendingCommit->shardDone(true);
+          },
+          shard.data));
+    }
+  }
+}
+
+} // namespace runtime
+} // namespace pkg
+} // namespace fl
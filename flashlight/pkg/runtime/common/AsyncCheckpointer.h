@@ -0,0 +1,349 @@
+/**
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "flashlight/fl/common/Filesystem.h"
+#include "flashlight/fl/common/threadpool/ThreadPool.h"
+#include "flashlight/fl/flashlight.h"
+#include "flashlight/pkg/runtime/common/Serializer.h"
+
+namespace fl {
+namespace pkg {
+namespace runtime {
+
+namespace detail {
+
+/**
+ * A stream buffer appending everything written to it to a string, so that
+ * objects can be serialized to host memory without an extra copy.
+ */
+class StringSinkBuf : public std::streambuf {
+ public:
+  explicit StringSinkBuf(std::string& out) : out_(out) {}
+
+ protected:
+  std::streamsize xsputn(const char* s, std::streamsize n) override {
+    out_.append(s, n);
+    return n;
+  }
+
+  int_type overflow(int_type c) override {
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+      out_.push_back(traits_type::to_char_type(c));
+    }
+    return traits_type::not_eof(c);
+  }
+
+ private:
+  std::string& out_;
+};
+
+/// Whether `T` points to a module, whose parameters are sharded
+template <typename T>
+struct IsModulePtr : std::false_type {};
+
+template <typename T>
+struct IsModulePtr<std::shared_ptr<T>> : std::is_base_of<fl::Module, T> {};
+
+/**
+ * Appends the tensors of `obj` which are saved to tensor shards: `obj` itself
+ * if it's a tensor, or the parameters of a module.
+ */
+template <typename T>
+void collectTensors(const T& obj, std::vector<Tensor*>& tensors) {
+  if constexpr (std::is_same_v<T, Tensor>) {
+    tensors.push_back(const_cast<Tensor*>(&obj));
+  } else if constexpr (IsModulePtr<T>::value) {
+    if (obj) {
+      for (const auto& param : obj->params()) {
+        tensors.push_back(&param.tensor());
+      }
+    }
+  }
+}
+
+/**
+ * Moves the data out of distinct tensors while alive, so that objects holding
+ * them are serialized without it, and moves it back on destruction.
+ */
+class TensorStash {
+ public:
+  explicit TensorStash(std::vector<Tensor*> tensors)
+      : tensors_(std::move(tensors)), data_(tensors_.size()) {
+    for (std::size_t i = 0; i < tensors_.size(); ++i) {
+      std::swap(*tensors_[i], data_[i]);
+    }
+  }
+
+  ~TensorStash() {
+    for (std::size_t i = 0; i < tensors_.size(); ++i) {
+      std::swap(*tensors_[i], data_[i]);
+    }
+  }
+
+  TensorStash(const TensorStash&) = delete;
+  TensorStash& operator=(const TensorStash&) = delete;
+
+ private:
+  std::vector<Tensor*> tensors_;
+  std::vector<Tensor> data_;
+};
+
+} // namespace detail
+
+/**
+ * Saves checkpoints without blocking the training loop on disk I/O.
+ *
+ * `save` serializes its arguments to host memory on the calling thread -
+ * this is where tensors are copied off the device - and hands the snapshot
+ * to background threads which write it out. Every file is first written to a
+ * temporary file next to its destination then renamed, so an interrupted save
+ * never leaves a truncated checkpoint behind. Host buffers are kept from one
+ * save to the next, so that the snapshot of a large model does not allocate
+ * and fault in fresh memory each time.
+ *
+ * Unsharded checkpoints (`worldSize == 1`) have the same format as
+ * `Serializer::save` and can be read with `Serializer::load`.
+ *
+ * With `worldSize > 1`, the checkpoint is sharded at the tensor level. The
+ * tensors among the arguments of `save`, and the parameters of the modules
+ * among them, are spread over ranks so that each rank holds about the same
+ * number of bytes, and rank `r` writes its tensors to `<path>.shard<r + 1>`.
+ * Rank 0 also writes the version and the arguments, without those tensors,
+ * to `<path>.shard0`; other state, such as the moments of an optimizer, is
+ * saved there in full. This spreads the cost of checkpointing data-parallel
+ * replicas - which hold identical state - over all ranks, even for a single
+ * large model. Every rank must call `save` with the same arguments. Sharded
+ * checkpoints are read with `AsyncCheckpointer::load`.
+ *
+ * Once all of its shards are written, each rank writes a commit marker,
+ * `<path>.commit<rank>`, identifying the save. A sharded checkpoint only
+ * exists once the markers of all ranks identify the same save, so that a
+ * checkpoint interrupted on some rank, which mixes shards of different saves,
+ * is never loaded. When the ranks are those of the initialized distributed
+ * environment, they agree on a random id for the run on construction, so that
+ * saves of different runs are told apart too.
+ */
+class AsyncCheckpointer {
+ public:
+  /**
+   * @param rank the rank of this process
+   * @param worldSize the number of processes sharing the checkpoint. With 1,
+   * checkpoints are saved as a single file.
+   */
+  explicit AsyncCheckpointer(int rank = 0, int worldSize = 1);
+
+  /**
+   * Waits for pending writes. Errors are logged, not thrown.
+   */
+  ~AsyncCheckpointer();
+
+  /**
+   * Snapshots `version` and `args` to host memory and writes them to each of
+   * `filepaths` in the background. Waits for the previous checkpoint to be
+   * written first, so at most one snapshot is held in memory.
+   *
+   * Throws if the previous checkpoint failed to be written.
+   */
+  template <class... Args>
+  void save(
+      const std::vector<fs::path>& filepaths,
+      const std::string& version,
+      const Args&... args) {
+    wait();
+
+    std::vector<Shard> shards;
+    std::size_t nextBuffer = 0;
+    auto snapshot = [&](std::size_t index, const auto&... objs) {
+      if (nextBuffer == buffers_.size()) {
+        buffers_.push_back(std::make_shared<std::string>());
+      }
+      auto& buffer = buffers_[nextBuffer++];
+      buffer->clear();
+      {
+        detail::StringSinkBuf sink(*buffer);
+        std::ostream os(&sink);
+        cereal::BinaryOutputArchive ar(os);
+        ar(objs...);
+      }
+      shards.push_back({index, buffer});
+    };
+
+    if (worldSize_ == 1) {
+      snapshot(0, version, args...);
+      writeSnapshot(filepaths, std::move(shards), 1);
+      return;
+    }
+    const auto tensors = shardedTensors(args...);
+    const auto owners = tensorOwners(tensors, worldSize_);
+    std::vector<int64_t> indices;
+    std::vector<Tensor> owned;
+    for (std::size_t i = 0; i < tensors.size(); ++i) {
+      if (owners[i] == rank_) {
+        indices.push_back(i);
+        owned.push_back(*tensors[i]);
+      }
+    }
+    const std::size_t tensorShard = 1 + rank_;
+    snapshot(tensorShard, static_cast<uint64_t>(tensorShard), indices, owned);
+    if (rank_ == 0) {
+      // The tensors are in their own shards. Saving doesn't change the
+      // arguments: their data is moved back once serialized.
+      detail::TensorStash stash(tensors);
+      snapshot(0, static_cast<uint64_t>(0), version, args...);
+    }
+    writeSnapshot(filepaths, std::move(shards), 1 + worldSize_);
+  }
+
+  /**
+   * Blocks until all pending writes are done. Rethrows the first error
+   * encountered while writing.
+   */
+  void wait();
+
+  /**
+   * @return whether checkpoints are split among several processes
+   */
+  bool isSharded() const;
+
+  /**
+   * @return whether a checkpoint, sharded or not, exists at `filepath`. A
+   * sharded checkpoint exists once committed by all ranks.
+   */
+  static bool exists(const fs::path& filepath);
+
+  /**
+   * Loads a checkpoint saved by `AsyncCheckpointer::save` or
+   * `Serializer::save`. As with `Serializer::load`, the first argument
+   * receives the version and the rest the saved objects, in order; trailing
+   * objects may be omitted.
+   *
+   * Throws if a sharded checkpoint wasn't committed by all ranks.
+   */
+  template <typename... Args>
+  static void load(const fs::path& filepath, Args&... args) {
+    if (fs::exists(filepath)) {
+      Serializer::load(filepath, args...);
+      return;
+    }
+    const auto numShards = committedShards(filepath);
+    if (numShards == 0) {
+      throw std::runtime_error(
+          "AsyncCheckpointer::load - no complete checkpoint at " +
+          filepath.string());
+    }
+    auto checkShard = [&](uint64_t savedShard, std::size_t shard) {
+      if (savedShard != shard) {
+        throw std::runtime_error(
+            "AsyncCheckpointer::load - unexpected shard in " +
+            shardPath(filepath, shard).string());
+      }
+    };
+    uint64_t savedShard;
+    Serializer::load(shardPath(filepath, 0), savedShard, args...);
+    checkShard(savedShard, 0);
+    // Tensors of omitted objects are skipped
+    const auto tensors = shardedTensors(args...);
+    for (std::size_t shard = 1; shard < numShards; ++shard) {
+      std::vector<int64_t> indices;
+      std::vector<Tensor> data;
+      Serializer::load(shardPath(filepath, shard), savedShard, indices, data);
+      checkShard(savedShard, shard);
+      for (std::size_t i = 0; i < indices.size() && i < data.size(); ++i) {
+        if (indices[i] >= 0 &&
+            static_cast<std::size_t>(indices[i]) < tensors.size()) {
+          *tensors[indices[i]] = std::move(data[i]);
+        }
+      }
+    }
+  }
+
+  /**
+   * @return the path of the file holding shard `shard` of a sharded
+   * checkpoint saved to `filepath`
+   */
+  static fs::path shardPath(const fs::path& filepath, std::size_t shard);
+
+  /**
+   * @return the path of the commit marker written by rank `rank` for a
+   * sharded checkpoint saved to `filepath`
+   */
+  static fs::path commitPath(const fs::path& filepath, std::size_t rank);
+
+ private:
+  struct Shard {
+    std::size_t index;
+    std::shared_ptr<const std::string> data;
+  };
+
+  const std::size_t rank_;
+  const std::size_t worldSize_;
+  /// Identifies the run, and with saveCount_ a save, in commit markers
+  uint64_t runId_{0};
+  uint64_t saveCount_{0};
+  /// Host buffers holding the last snapshot, reused by the next save
+  std::vector<std::shared_ptr<std::string>> buffers_;
+  /// Shards of the last snapshot not yet written
+  std::vector<std::future<void>> pending_;
+  std::unique_ptr<fl::ThreadPool> threadPool_;
+
+  /**
+   * @return the distinct tensors of `objs` saved to tensor shards, in order
+   */
+  template <typename... Objs>
+  static std::vector<Tensor*> shardedTensors(const Objs&... objs) {
+    std::vector<Tensor*> tensors;
+    (detail::collectTensors(objs, tensors), ...);
+    return distinct(std::move(tensors));
+  }
+
+  /**
+   * @return `tensors` without repeats, e.g. of parameters shared by modules
+   */
+  static std::vector<Tensor*> distinct(std::vector<Tensor*> tensors);
+
+  /**
+   * Balances tensors over ranks: each, from the largest, goes to the rank
+   * holding the fewest bytes so far. Ranks holding identical tensors agree.
+   *
+   * @return the rank saving each of `tensors`
+   */
+  static std::vector<std::size_t> tensorOwners(
+      const std::vector<Tensor*>& tensors,
+      std::size_t worldSize);
+
+  /**
+   * Writes each of `shards` to each of `filepaths` in parallel, then commits
+   * sharded checkpoints made of `numShards` shards.
+   */
+  void writeSnapshot(
+      const std::vector<fs::path>& filepaths,
+      std::vector<Shard> shards,
+      std::size_t numShards);
+
+  /**
+   * @return the number of shards of the sharded checkpoint at `filepath` if
+   * all ranks committed the same save of it and all of its shards exist, or 0
+   */
+  static std::size_t committedShards(const fs::path& filepath);
+};
+
+} // namespace runtime
+} // namespace pkg
+} // namespace fl
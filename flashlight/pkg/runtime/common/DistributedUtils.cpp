@@ -32,6 +32,8 @@ void initDistributed(
           std::to_string(maxDevicesPerNode)},
          {fl::DistributedConstants::kFilePath, rndvFilepath}});
   }
+  // Ranks share the benchmark cache file, which only one of them writes
+  fl::DynamicBenchmarkCache::setWritable(fl::getWorldRank() == 0);
 }
 
 Tensor allreduceGet(fl::AverageValueMeter& mtr) {
@@ -35,6 +35,26 @@ struct Serializer {
         args...); // max wait 31s
   }
 
+  /**
+   * Same as `save`, but in the memory-mappable format of `fl::saveMapped`,
+   * which `load` reads without an intermediate host buffer per tensor; see
+   * `fl::loadMapped`.
+   */
+  template <class... Args>
+  static void saveMapped(
+      const fs::path& filepath,
+      const std::string& version,
+      const Args&... args) {
+    fl::retryWithBackoff(
+        std::chrono::seconds(1),
+        2.0,
+        6,
+        saveMappedImpl<Args...>,
+        filepath,
+        version,
+        args...); // max wait 31s
+  }
+
   template <typename... Args>
   static void load(const fs::path& filepath, Args&... args) {
     fl::retryWithBackoff(
@@ -68,9 +88,27 @@ struct Serializer {
     }
   }
 
+  template <typename... Args>
+  static void saveMappedImpl(
+      const fs::path& filepath,
+      const std::string& version,
+      const Args&... args) {
+    try {
+      fl::saveMapped(filepath, version, args...);
+    } catch (const std::exception& ex) {
+      FL_LOG(fl::LogLevel::ERROR)
+          << "Error while saving \"" << filepath << "\": " << ex.what() << "\n";
+      throw;
+    }
+  }
+
   template <typename... Args>
   static void loadImpl(const fs::path& filepath, Args&... args) {
     try {
+      if (fl::isMappedModelFile(filepath)) {
+        fl::loadMapped(filepath, args...);
+        return;
+      }
       std::ifstream file(filepath, std::ios::binary);
       if (!file.is_open()) {
         throw std::runtime_error(
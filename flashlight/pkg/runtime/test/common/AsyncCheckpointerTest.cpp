@@ -0,0 +1,175 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "flashlight/fl/common/Filesystem.h"
+#include "flashlight/fl/nn/nn.h"
+#include "flashlight/fl/optim/optim.h"
+#include "flashlight/fl/tensor/Init.h"
+#include "flashlight/fl/tensor/Random.h"
+#include "flashlight/fl/tensor/TensorBase.h"
+#include "flashlight/pkg/runtime/common/AsyncCheckpointer.h"
+#include "flashlight/pkg/runtime/common/Serializer.h"
+
+using namespace fl;
+using namespace fl::pkg::runtime;
+
+TEST(AsyncCheckpointerTest, SaveLoad) {
+  const fs::path path = fs::temp_directory_path() / "AsyncCheckpointer.bin";
+  fs::path copyPath = path;
+  copyPath += ".best";
+
+  auto tensor = fl::rand({4, 5});
+  int64_t step = 42;
+  {
+    AsyncCheckpointer checkpointer;
+    checkpointer.save({path, copyPath}, "v1", tensor, step);
+    // The snapshot is already taken: later updates aren't saved
+    step = 0;
+    checkpointer.wait();
+  }
+
+  for (const auto& p : {path, copyPath}) {
+    ASSERT_TRUE(AsyncCheckpointer::exists(p));
+    fs::path tmpPath = p;
+    tmpPath += ".tmp";
+    ASSERT_FALSE(fs::exists(tmpPath));
+
+    // Same format as Serializer
+    std::string version;
+    Tensor loaded;
+    int64_t loadedStep;
+    Serializer::load(p, version, loaded, loadedStep);
+    ASSERT_EQ(version, "v1");
+    ASSERT_TRUE(allClose(loaded, tensor));
+    ASSERT_EQ(loadedStep, 42);
+  }
+}
+
+TEST(AsyncCheckpointerTest, Sharded) {
+  const fs::path path = fs::temp_directory_path() / "AsyncCheckpointerShard";
+  fs::remove(path);
+  for (int rank = 0; rank < 2; ++rank) {
+    fs::remove(AsyncCheckpointer::commitPath(path, rank));
+  }
+
+  auto weights = fl::rand({3, 3});
+  auto moments = fl::rand({6});
+  int64_t step = 7;
+  const int worldSize = 2;
+  // Simulate two data-parallel ranks holding the same state
+  AsyncCheckpointer rank0(0, worldSize), rank1(1, worldSize);
+  rank0.save({path}, "v2", weights, moments, step);
+  rank0.wait();
+  // Not committed by all ranks yet
+  ASSERT_FALSE(AsyncCheckpointer::exists(path));
+  rank1.save({path}, "v2", weights, moments, step);
+  rank1.wait();
+
+  ASSERT_FALSE(fs::exists(path));
+  ASSERT_TRUE(AsyncCheckpointer::exists(path));
+  // The arguments, then the tensors of each rank
+  for (int shard = 0; shard < 1 + worldSize; ++shard) {
+    ASSERT_TRUE(fs::exists(AsyncCheckpointer::shardPath(path, shard)));
+  }
+  for (int rank = 0; rank < worldSize; ++rank) {
+    ASSERT_TRUE(fs::exists(AsyncCheckpointer::commitPath(path, rank)));
+  }
+
+  std::string version;
+  Tensor loadedWeights, loadedMoments;
+  int64_t loadedStep;
+  AsyncCheckpointer::load(
+      path, version, loadedWeights, loadedMoments, loadedStep);
+  ASSERT_EQ(version, "v2");
+  ASSERT_TRUE(allClose(loadedWeights, weights));
+  ASSERT_TRUE(allClose(loadedMoments, moments));
+  ASSERT_EQ(loadedStep, 7);
+
+  // Trailing objects may be omitted
+  Tensor onlyWeights;
+  AsyncCheckpointer::load(path, version, onlyWeights);
+  ASSERT_TRUE(allClose(onlyWeights, weights));
+
+  // A save which only completed on some ranks mixes shards of two saves
+  rank0.save({path}, "v2", weights, moments, step + 1);
+  rank0.wait();
+  ASSERT_FALSE(AsyncCheckpointer::exists(path));
+  ASSERT_THROW(
+      AsyncCheckpointer::load(path, version, loadedWeights), std::runtime_error);
+}
+
+TEST(AsyncCheckpointerTest, ShardedParameters) {
+  const fs::path path = fs::temp_directory_path() / "AsyncCheckpointerParams";
+  const int worldSize = 2;
+  for (int rank = 0; rank < worldSize; ++rank) {
+    fs::remove(AsyncCheckpointer::commitPath(path, rank));
+  }
+
+  // Parameters of a single module are split between ranks
+  auto model = std::make_shared<Sequential>();
+  model->add(Linear(8, 8));
+  model->add(Linear(8, 4));
+  auto optimizer = std::make_shared<SGDOptimizer>(model->params(), 0.1);
+  const auto params = model->params();
+  AsyncCheckpointer rank0(0, worldSize), rank1(1, worldSize);
+  rank0.save({path}, "v3", model, optimizer);
+  rank1.save({path}, "v3", model, optimizer);
+  rank0.wait();
+  rank1.wait();
+  ASSERT_TRUE(AsyncCheckpointer::exists(path));
+  // Saving leaves the parameters as they were
+  for (const auto& param : model->params()) {
+    ASSERT_FALSE(param.isEmpty());
+  }
+
+  std::size_t numTensors = 0;
+  for (int rank = 0; rank < worldSize; ++rank) {
+    uint64_t shard;
+    std::vector<int64_t> indices;
+    std::vector<Tensor> tensors;
+    Serializer::load(
+        AsyncCheckpointer::shardPath(path, 1 + rank), shard, indices, tensors);
+    ASSERT_FALSE(indices.empty());
+    numTensors += tensors.size();
+  }
+  ASSERT_EQ(numTensors, params.size());
+
+  std::string version;
+  std::shared_ptr<Sequential> loadedModel;
+  std::shared_ptr<FirstOrderOptimizer> loadedOptimizer;
+  AsyncCheckpointer::load(path, version, loadedModel, loadedOptimizer);
+  ASSERT_EQ(version, "v3");
+  auto loadedParams = loadedModel->params();
+  ASSERT_EQ(loadedParams.size(), params.size());
+  for (std::size_t i = 0; i < params.size(); ++i) {
+    ASSERT_TRUE(allClose(loadedParams[i].tensor(), params[i].tensor()));
+  }
+  // The optimizer still updates the parameters of the model
+  for (auto& param : loadedParams) {
+    param.addGrad(Variable(fl::full(param.shape(), 1.0), false));
+  }
+  loadedOptimizer->step();
+  ASSERT_FALSE(
+      allClose(loadedModel->params()[0].tensor(), params[0].tensor()));
+}
+
+TEST(AsyncCheckpointerTest, InvalidRank) {
+  EXPECT_THROW(AsyncCheckpointer(2, 2), std::invalid_argument);
+  EXPECT_THROW(AsyncCheckpointer(0, 0), std::invalid_argument);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  fl::init();
+  return RUN_ALL_TESTS();
+}
@@ -33,11 +33,13 @@ void Ceplifter::applyInPlace(std::vector<float>& input) const {
     throw std::invalid_argument(
         "Ceplifter: input size is not divisible by numFilters");
   }
-  size_t n = 0;
-  for (auto& in : input) {
-    in *= coefs_[n++];
-    if (n == numFilters_) {
-      n = 0;
+  size_t nframes = input.size() / numFilters_;
+  const float* coefs = coefs_.data();
+  for (size_t f = 0; f < nframes; ++f) {
+    float* frame = input.data() + f * numFilters_;
+#pragma omp simd
+    for (size_t i = 0; i < numFilters_; ++i) {
+      frame[i] *= coefs[i];
     }
   }
 }
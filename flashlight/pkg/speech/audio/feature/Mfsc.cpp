@@ -78,16 +78,20 @@ std::vector<float> Mfsc::apply(const std::vector<float>& input) {
 std::vector<float> Mfsc::mfscImpl(std::vector<float>& frames) {
   auto powspectrum = this->powSpectrumImpl(frames);
   if (this->featParams_.usePower) {
-    std::transform(
-        powspectrum.begin(),
-        powspectrum.end(),
-        powspectrum.begin(),
-        [](float x) { return x * x; });
+    float* pow = powspectrum.data();
+    size_t n = powspectrum.size();
+#pragma omp simd
+    for (size_t i = 0; i < n; ++i) {
+      pow[i] *= pow[i];
+    }
   }
   auto triflt = triFltBank_.apply(powspectrum, this->featParams_.melFloor);
-  std::transform(triflt.begin(), triflt.end(), triflt.begin(), [](float x) {
-    return std::log(x);
-  });
+  float* out = triflt.data();
+  size_t n = triflt.size();
+#pragma omp simd
+  for (size_t i = 0; i < n; ++i) {
+    out[i] = std::log(out[i]);
+  }
   return triflt;
 }
 
@@ -10,14 +10,70 @@
 #include <fftw3.h>
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
+#include <numeric>
 #include <unordered_map>
 
 #include "flashlight/pkg/speech/audio/feature/SpeechUtils.h"
 
 namespace fl::lib::audio {
 
-std::mutex PowerSpectrum::fftPlanMutex_;
+namespace {
+
+// Per-thread FFT input/output buffers which grow as needed. They are allocated
+// with fftw_malloc so that they have the same alignment as the buffers the
+// plans were created with, as required by fftw_execute_dft_r2c.
+struct FftWorkspace {
+  double* in{nullptr};
+  fftw_complex* out{nullptr};
+  size_t inSize{0};
+  size_t outSize{0};
+
+  void reserve(size_t nIn, size_t nOut) {
+    if (nIn > inSize) {
+      fftw_free(in);
+      in = static_cast<double*>(fftw_malloc(sizeof(double) * nIn));
+      inSize = nIn;
+    }
+    if (nOut > outSize) {
+      fftw_free(out);
+      out =
+          static_cast<fftw_complex*>(fftw_malloc(sizeof(fftw_complex) * nOut));
+      outSize = nOut;
+    }
+  }
+
+  ~FftWorkspace() {
+    fftw_free(in);
+    fftw_free(out);
+  }
+};
+
+FftWorkspace& threadFftWorkspace() {
+  thread_local FftWorkspace workspace;
+  return workspace;
+}
+
+// Copies a frame into an FFT input buffer, zero-padding it to nFft
+void loadFftFrame(const float* src, double* dst, int nSamples, int nFft) {
+#pragma omp simd
+  for (int i = 0; i < nSamples; ++i) {
+    dst[i] = src[i];
+  }
+  std::fill(dst + nSamples, dst + nFft, 0.0);
+}
+
+void absSpectrum(const fftw_complex* src, float* dst, int n) {
+  const double* spec = reinterpret_cast<const double*>(src);
+#pragma omp simd
+  for (int i = 0; i < n; ++i) {
+    dst[i] = std::sqrt(
+        spec[2 * i] * spec[2 * i] + spec[2 * i + 1] * spec[2 * i + 1]);
+  }
+}
+
+} // namespace
 
 PowerSpectrum::PowerSpectrum(const FeatureParams& params)
     : featParams_(params),
@@ -27,14 +83,34 @@ PowerSpectrum::PowerSpectrum(const FeatureParams& params)
   // Need to lock plan creation, which only happens once per instance
   // https://www.fftw.org/fftw3_doc/Thread-safety.html -- multiple threads can
   // use the same plans with fftw_execute
-  std::lock_guard<std::mutex> lock(fftPlanMutex_);
+  std::lock_guard<std::mutex> lock(fftwPlanMutex());
 
   validatePowSpecParams();
-  auto nFFt = featParams_.nFft();
-  inFftBuf_.resize(nFFt, 0.0);
-  outFftBuf_.resize(2 * nFFt);
-  fftPlan_ = std::make_unique<fftw_plan>(std::move(fftw_plan_dft_r2c_1d(
-      nFFt, inFftBuf_.data(), (fftw_complex*)outFftBuf_.data(), FFTW_MEASURE)));
+  int nFft = featParams_.nFft();
+  int K = featParams_.filterFreqResponseLen();
+  // Planning with FFTW_MEASURE overwrites the buffers, so plan on scratch
+  // buffers; execution happens on per-thread workspaces
+  auto* in =
+      static_cast<double*>(fftw_malloc(sizeof(double) * nFft * kFftBatchSize));
+  auto* out = static_cast<fftw_complex*>(
+      fftw_malloc(sizeof(fftw_complex) * K * kFftBatchSize));
+  fftPlan_ = std::make_unique<fftw_plan>(
+      fftw_plan_dft_r2c_1d(nFft, in, out, FFTW_MEASURE));
+  fftBatchPlan_ = std::make_unique<fftw_plan>(fftw_plan_many_dft_r2c(
+      /* rank = */ 1,
+      &nFft,
+      kFftBatchSize,
+      in,
+      /* inembed = */ nullptr,
+      /* istride = */ 1,
+      /* idist = */ nFft,
+      out,
+      /* onembed = */ nullptr,
+      /* ostride = */ 1,
+      /* odist = */ K,
+      FFTW_MEASURE));
+  fftw_free(in);
+  fftw_free(out);
 }
 
 std::vector<float> PowerSpectrum::apply(const std::vector<float>& input) {
@@ -52,42 +128,47 @@ std::vector<float> PowerSpectrum::powSpectrumImpl(std::vector<float>& frames) {
   int K = featParams_.filterFreqResponseLen();
 
   if (featParams_.ditherVal != 0.0) {
-    frames = dither_.apply(frames);
+    std::lock_guard<std::mutex> lock(ditherMutex_);
+    dither_.applyInPlace(frames);
   }
   if (featParams_.zeroMeanFrame) {
     for (size_t f = 0; f < nFrames; ++f) {
       auto begin = frames.data() + f * nSamples;
       float mean = std::accumulate(begin, begin + nSamples, 0.0);
       mean /= nSamples;
-      std::transform(
-          begin, begin + nSamples, begin, [mean](float x) { return x - mean; });
+#pragma omp simd
+      for (int i = 0; i < nSamples; ++i) {
+        begin[i] -= mean;
+      }
     }
   }
   if (featParams_.preemCoef != 0) {
     preEmphasis_.applyInPlace(frames);
   }
   windowing_.applyInPlace(frames);
-  std::vector<float> dft(K * nFrames);
-  for (size_t f = 0; f < nFrames; ++f) {
-    auto begin = frames.data() + f * nSamples;
-    {
-      std::lock_guard<std::mutex> lock(fftMutex_);
-      std::copy(begin, begin + nSamples, inFftBuf_.data());
-      std::fill(outFftBuf_.begin(), outFftBuf_.end(), 0.0);
-      fftw_execute(*fftPlan_);
-
-      // Copy stuff to the redundant part
-      for (size_t i = K; i < nFft; ++i) {
-        outFftBuf_[2 * i] = outFftBuf_[2 * nFft - 2 * i];
-        outFftBuf_[2 * i + 1] = -outFftBuf_[2 * nFft - 2 * i + 1];
-      }
 
-      for (size_t i = 0; i < K; ++i) {
-        dft[f * K + i] = std::sqrt(
-            outFftBuf_[2 * i] * outFftBuf_[2 * i] +
-            outFftBuf_[2 * i + 1] * outFftBuf_[2 * i + 1]);
-      }
+  auto& workspace = threadFftWorkspace();
+  workspace.reserve(nFft * kFftBatchSize, K * kFftBatchSize);
+  double* in = workspace.in;
+  fftw_complex* out = workspace.out;
+
+  std::vector<float> dft(K * nFrames);
+  int f = 0;
+  for (; f + kFftBatchSize <= nFrames; f += kFftBatchSize) {
+    for (int b = 0; b < kFftBatchSize; ++b) {
+      loadFftFrame(
+          frames.data() + (f + b) * nSamples, in + b * nFft, nSamples, nFft);
     }
+    fftw_execute_dft_r2c(*fftBatchPlan_, in, out);
+    // Output bins of consecutive frames are contiguous in both buffers
+    absSpectrum(out, dft.data() + f * K, kFftBatchSize * K);
+  }
+  // Remaining frames go through the single-frame plan; executing on offsets
+  // into the workspace could break the alignment the plan was created with
+  for (; f < nFrames; ++f) {
+    loadFftFrame(frames.data() + f * nSamples, in, nSamples, nFft);
+    fftw_execute_dft_r2c(*fftPlan_, in, out);
+    absSpectrum(out, dft.data() + f * K, K);
   }
   return dft;
 }
@@ -142,6 +223,8 @@ void PowerSpectrum::validatePowSpecParams() const {
 }
 
 PowerSpectrum::~PowerSpectrum() {
+  std::lock_guard<std::mutex> lock(fftwPlanMutex());
   fftw_destroy_plan(*fftPlan_);
+  fftw_destroy_plan(*fftBatchPlan_);
 }
 } // namespace fl
@@ -24,6 +24,10 @@ namespace lib {
 namespace audio {
 
 // Computes Power Spectrum features for a speech signal.
+//
+// Instances can be shared across threads: FFT plans are immutable after
+// construction and every thread uses its own FFT workspace, so concurrent
+// calls to apply() don't serialize (except for the dithering step).
 
 class PowerSpectrum {
  public:
@@ -58,10 +62,14 @@ class PowerSpectrum {
   PreEmphasis preEmphasis_;
   Windowing windowing_;
 
-  std::unique_ptr<fftw_plan> fftPlan_; // fftw_plan is an opque pointer type
-  std::vector<double> inFftBuf_, outFftBuf_;
-  std::mutex fftMutex_;
-  static std::mutex fftPlanMutex_;
+  // Number of frames transformed by a single execution of fftBatchPlan_
+  static constexpr int kFftBatchSize = 32;
+
+  // fftw_plan is an opque pointer type
+  std::unique_ptr<fftw_plan> fftPlan_; // single frame
+  std::unique_ptr<fftw_plan> fftBatchPlan_; // kFftBatchSize frames
+  // Dither keeps RNG state which isn't safe to share between threads
+  std::mutex ditherMutex_;
 };
 } // namespace audio
 } // namespace lib
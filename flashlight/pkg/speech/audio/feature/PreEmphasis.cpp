@@ -34,13 +34,14 @@ void PreEmphasis::applyInPlace(std::vector<float>& input) const {
         "PreEmphasis: input.size() not divisible by windowLength");
   }
   size_t nframes = input.size() / windowLength_;
-  for (size_t n = nframes; n > 0; --n) {
-    size_t e = n * windowLength_ - 1; // end of current frame
-    size_t s = (n - 1) * windowLength_; // start of current frame
-    for (size_t i = e; i > s; --i) {
-      input[i] -= (preemCoef_ * input[i - 1]);
+  for (size_t n = 0; n < nframes; ++n) {
+    float* frame = input.data() + n * windowLength_;
+    // Iterating backwards, each sample is read before it is overwritten; this
+    // is a write-after-read dependency which doesn't prevent vectorization
+    for (size_t i = windowLength_ - 1; i > 0; --i) {
+      frame[i] -= (preemCoef_ * frame[i - 1]);
     }
-    input[s] *= (1 - preemCoef_);
+    frame[0] *= (1 - preemCoef_);
   }
 }
 } // namespace fl
@@ -84,4 +84,9 @@ std::vector<float> cblasGemm(
 
   return matC;
 };
+
+std::mutex& fftwPlanMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
 } // namespace fl
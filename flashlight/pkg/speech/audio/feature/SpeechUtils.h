@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <mutex>
 #include <vector>
 
 #include "flashlight/pkg/speech/audio/feature/FeatureParams.h"
@@ -28,6 +29,10 @@ std::vector<float> cblasGemm(
     const std::vector<float>& matB,
     int n,
     int k);
+// FFTW plan creation and destruction are not thread-safe; all callers must
+// hold this mutex while doing either (plan execution is thread-safe)
+// https://www.fftw.org/fftw3_doc/Thread-safety.html
+std::mutex& fftwPlanMutex();
 } // namespace audio
 } // namespace lib
 } // namespace fl
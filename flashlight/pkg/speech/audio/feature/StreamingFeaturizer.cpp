@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/pkg/speech/audio/feature/StreamingFeaturizer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+namespace fl::lib::audio {
+
+namespace {
+
+FeatureParams withoutDerivatives(FeatureParams params) {
+  params.deltaWindow = 0;
+  params.accWindow = 0;
+  return params;
+}
+
+float derivativeDenominator(int windowlen) {
+  return (windowlen * (windowlen + 1) * (2 * windowlen + 1)) / 3.0;
+}
+
+} // namespace
+
+template <class Featurizer>
+StreamingFeaturizer<Featurizer>::StreamingFeaturizer(
+    const FeatureParams& params)
+    : featParams_(params),
+      featurizer_(withoutDerivatives(params)),
+      // Power spectrum features never have derivatives
+      deltaWindow_(
+          std::is_same<Featurizer, PowerSpectrum>::value ? 0
+                                                         : params.deltaWindow),
+      accWindow_(
+          std::is_same<Featurizer, PowerSpectrum>::value ? 0
+                                                         : params.accWindow),
+      numBaseFeat_(featurizer_.outputSize(params.numFrameSizeSamples())) {
+  if (deltaWindow_ <= 0) {
+    // Same as Derivatives: no accelerations without deltas
+    deltaWindow_ = 0;
+    accWindow_ = 0;
+  }
+  accWindow_ = std::max(accWindow_, 0);
+  reset();
+}
+
+template <class Featurizer>
+void StreamingFeaturizer<Featurizer>::reset() {
+  pending_.clear();
+  base_.clear();
+  deltas_.clear();
+  baseStart_ = 0;
+  numBase_ = 0;
+  deltaStart_ = 0;
+  numDelta_ = 0;
+  numOutput_ = 0;
+  finished_ = false;
+}
+
+template <class Featurizer>
+std::vector<float> StreamingFeaturizer<Featurizer>::accept(
+    const std::vector<float>& chunk) {
+  if (finished_) {
+    throw std::logic_error(
+        "StreamingFeaturizer: accept() called after finish() without reset()");
+  }
+  pending_.insert(pending_.end(), chunk.begin(), chunk.end());
+  int64_t nFrames = featParams_.numFrames(pending_.size());
+  if (nFrames > 0) {
+    int64_t stride = featParams_.numFrameStrideSamples();
+    int64_t used = (nFrames - 1) * stride + featParams_.numFrameSizeSamples();
+    auto feat = featurizer_.apply(
+        std::vector<float>(pending_.begin(), pending_.begin() + used));
+    base_.insert(base_.end(), feat.begin(), feat.end());
+    numBase_ += nFrames;
+    // Keep the overlap with the next frame
+    pending_.erase(pending_.begin(), pending_.begin() + nFrames * stride);
+  }
+  return emit();
+}
+
+template <class Featurizer>
+std::vector<float> StreamingFeaturizer<Featurizer>::finish() {
+  finished_ = true;
+  pending_.clear();
+  return emit();
+}
+
+template <class Featurizer>
+const float* StreamingFeaturizer<Featurizer>::baseFrame(int64_t t) const {
+  return base_.data() + (t - baseStart_) * numBaseFeat_;
+}
+
+template <class Featurizer>
+const float* StreamingFeaturizer<Featurizer>::deltaFrame(int64_t t) const {
+  return deltas_.data() + (t - deltaStart_) * numBaseFeat_;
+}
+
+template <class Featurizer>
+std::vector<float> StreamingFeaturizer<Featurizer>::emit() {
+  int nFeat = numBaseFeat_;
+  // Derivatives replicate the first and last frames at the edges
+  auto clampFrame = [this](int64_t t) {
+    return std::min(std::max(t, int64_t(0)), numBase_ - 1);
+  };
+
+  // Deltas
+  if (deltaWindow_ > 0) {
+    int64_t end = finished_ ? numBase_ : numBase_ - deltaWindow_;
+    float denominator = derivativeDenominator(deltaWindow_);
+    for (int64_t t = numDelta_; t < end; ++t) {
+      size_t offset = deltas_.size();
+      deltas_.resize(offset + nFeat, 0.0);
+      float* out = deltas_.data() + offset;
+      for (int d = 1; d <= deltaWindow_; ++d) {
+        const float* next = baseFrame(clampFrame(t + d));
+        const float* prev = baseFrame(clampFrame(t - d));
+        for (int j = 0; j < nFeat; ++j) {
+          out[j] += d * (next[j] - prev[j]);
+        }
+      }
+      for (int j = 0; j < nFeat; ++j) {
+        out[j] /= denominator;
+      }
+      ++numDelta_;
+    }
+  }
+
+  // Output frames, computing accelerations on the fly
+  int64_t end;
+  if (deltaWindow_ <= 0) {
+    end = numBase_;
+  } else if (accWindow_ <= 0) {
+    end = numDelta_;
+  } else {
+    end = finished_ ? numDelta_ : numDelta_ - accWindow_;
+  }
+  int outFeat = nFeat * (1 + (deltaWindow_ > 0) + (accWindow_ > 0));
+  std::vector<float> output(std::max(end - numOutput_, int64_t(0)) * outFeat);
+  float accDenominator = derivativeDenominator(accWindow_);
+  for (int64_t t = numOutput_; t < end; ++t) {
+    float* out = output.data() + (t - numOutput_) * outFeat;
+    const float* base = baseFrame(t);
+    std::copy(base, base + nFeat, out);
+    if (deltaWindow_ > 0) {
+      const float* delta = deltaFrame(t);
+      std::copy(delta, delta + nFeat, out + nFeat);
+    }
+    if (accWindow_ > 0) {
+      float* acc = out + 2 * nFeat;
+      std::fill(acc, acc + nFeat, 0.0);
+      for (int d = 1; d <= accWindow_; ++d) {
+        const float* next = deltaFrame(clampFrame(t + d));
+        const float* prev = deltaFrame(clampFrame(t - d));
+        for (int j = 0; j < nFeat; ++j) {
+          acc[j] += d * (next[j] - prev[j]);
+        }
+      }
+      for (int j = 0; j < nFeat; ++j) {
+        acc[j] /= accDenominator;
+      }
+    }
+  }
+  numOutput_ = std::max(numOutput_, end);
+
+  // Drop context which is no longer needed
+  int64_t keepBase = numOutput_;
+  if (deltaWindow_ > 0) {
+    keepBase = std::max(
+        std::min(numOutput_, numDelta_ - deltaWindow_), int64_t(0));
+  }
+  if (keepBase > baseStart_) {
+    base_.erase(
+        base_.begin(), base_.begin() + (keepBase - baseStart_) * nFeat);
+    baseStart_ = keepBase;
+  }
+  int64_t keepDelta = std::max(numOutput_ - accWindow_, int64_t(0));
+  if (deltaWindow_ > 0 && keepDelta > deltaStart_) {
+    deltas_.erase(
+        deltas_.begin(), deltas_.begin() + (keepDelta - deltaStart_) * nFeat);
+    deltaStart_ = keepDelta;
+  }
+  return output;
+}
+
+template <class Featurizer>
+int StreamingFeaturizer<Featurizer>::numFeatures() const {
+  return numBaseFeat_ * (1 + (deltaWindow_ > 0) + (accWindow_ > 0));
+}
+
+template <class Featurizer>
+int64_t StreamingFeaturizer<Featurizer>::numFramesEmitted() const {
+  return numOutput_;
+}
+
+template class StreamingFeaturizer<PowerSpectrum>;
+template class StreamingFeaturizer<Mfsc>;
+template class StreamingFeaturizer<Mfcc>;
+} // namespace fl
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "flashlight/pkg/speech/audio/feature/FeatureParams.h"
+#include "flashlight/pkg/speech/audio/feature/Mfcc.h"
+#include "flashlight/pkg/speech/audio/feature/Mfsc.h"
+#include "flashlight/pkg/speech/audio/feature/PowerSpectrum.h"
+
+namespace fl {
+namespace lib {
+namespace audio {
+
+// Computes features incrementally over a stream of audio chunks of arbitrary
+// size, e.g. for online recognition. `Featurizer` is one of PowerSpectrum,
+// Mfsc or Mfcc.
+//
+// Samples which don't complete a frame are carried over to the next chunk, as
+// is the frame context needed for derivatives, so the cost of each call only
+// depends on the size of the chunk. Frames are featurized independently
+// (pre-emphasis and windowing are applied within each frame), so no other
+// signal state needs to be carried over.
+//
+// Concatenating the outputs of all accept() calls and of finish() gives the
+// same features as `Featurizer::apply` on the concatenated stream. Since
+// derivatives need `deltaWindow + accWindow` frames of right context, frames
+// are emitted with that delay; finish() flushes them at the end of the stream.
+//
+// Example usage:
+//   StreamingFeaturizer<Mfsc> featurizer(params);
+//   while (...) {
+//     auto feat = featurizer.accept(chunk); // FEAT X NEWFRAMES
+//   }
+//   auto lastFeat = featurizer.finish();
+template <class Featurizer>
+class StreamingFeaturizer {
+ public:
+  explicit StreamingFeaturizer(const FeatureParams& params);
+
+  // chunk - next samples of the speech signal (T)
+  // Returns - features of newly available frames (Col Major : FEAT X FRAMES)
+  std::vector<float> accept(const std::vector<float>& chunk);
+
+  // Ends the stream and returns the frames held back for derivatives context
+  // (Col Major : FEAT X FRAMES). reset() must be called before accepting more
+  // input.
+  std::vector<float> finish();
+
+  // Clears all stream state to start a new utterance
+  void reset();
+
+  // Number of features of each output frame
+  int numFeatures() const;
+
+  // Number of frames returned since the start of the stream
+  int64_t numFramesEmitted() const;
+
+ private:
+  FeatureParams featParams_;
+  // Computes per-frame features; derivatives are computed here instead
+  Featurizer featurizer_;
+  int deltaWindow_;
+  int accWindow_;
+  int numBaseFeat_;
+
+  // Samples starting at the next frame which haven't been featurized yet
+  std::vector<float> pending_;
+  // Base features (numBaseFeat_ per frame) of frames [baseStart_, numBase_)
+  std::vector<float> base_;
+  int64_t baseStart_;
+  int64_t numBase_;
+  // Deltas of frames [deltaStart_, numDelta_)
+  std::vector<float> deltas_;
+  int64_t deltaStart_;
+  int64_t numDelta_;
+  int64_t numOutput_;
+  bool finished_;
+
+  // Computes deltas, accelerations and output frames which have enough right
+  // context (all of them if the stream is finished) and drops context which is
+  // no longer needed
+  std::vector<float> emit();
+
+  const float* baseFrame(int64_t t) const;
+  const float* deltaFrame(int64_t t) const;
+};
+} // namespace audio
+} // namespace lib
+} // namespace fl
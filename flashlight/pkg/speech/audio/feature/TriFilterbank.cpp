@@ -49,17 +49,50 @@ TriFilterbank::TriFilterbank(
       H_[i * numFilters_ + j] = std::max(std::min(hislope, loslope), minH);
     }
   }
+
+  bandStart_.resize(numFilters_);
+  bandOffset_.resize(numFilters_ + 1, 0);
+  for (int j = 0; j < numFilters_; ++j) {
+    int lo = 0;
+    while (lo < filterLen_ && H_[lo * numFilters_ + j] == 0) {
+      ++lo;
+    }
+    int hi = filterLen_;
+    while (hi > lo && H_[(hi - 1) * numFilters_ + j] == 0) {
+      --hi;
+    }
+    bandStart_[j] = lo;
+    bandOffset_[j + 1] = bandOffset_[j] + (hi - lo);
+    for (int i = lo; i < hi; ++i) {
+      bandWeights_.push_back(H_[i * numFilters_ + j]);
+    }
+  }
 }
 
 std::vector<float> TriFilterbank::apply(
     const std::vector<float>& input,
     float melfloor /* = 0.0 */) const {
-  std::vector<float> output = cblasGemm(input, H_, numFilters_, filterLen_);
-  std::transform(
-      output.begin(),
-      output.end(),
-      output.begin(),
-      [melfloor](float n) -> float { return std::max(n, melfloor); });
+  if (input.empty() || input.size() % filterLen_ != 0) {
+    throw std::invalid_argument("TriFilterbank: invalid input size");
+  }
+  size_t nframes = input.size() / filterLen_;
+  std::vector<float> output(nframes * numFilters_);
+  const float* weights = bandWeights_.data();
+  for (size_t f = 0; f < nframes; ++f) {
+    const float* in = input.data() + f * filterLen_;
+    float* out = output.data() + f * numFilters_;
+    for (int j = 0; j < numFilters_; ++j) {
+      const float* w = weights + bandOffset_[j];
+      const float* x = in + bandStart_[j];
+      int len = bandOffset_[j + 1] - bandOffset_[j];
+      float sum = 0.0;
+#pragma omp simd reduction(+ : sum)
+      for (int i = 0; i < len; ++i) {
+        sum += w[i] * x[i];
+      }
+      out[j] = std::max(sum, melfloor);
+    }
+  }
   return output;
 }
 
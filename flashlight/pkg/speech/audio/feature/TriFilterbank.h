@@ -43,6 +43,15 @@ class TriFilterbank {
   std::vector<float>
       H_; // (numFilters_ x filterLen_) triangular filterbank matrix
 
+  // Each triangular filter only covers a narrow band of the spectrum, so
+  // apply() only multiplies by the nonzero coefficients of each filter
+  // rather than by all of H_. Input bin bandStart_[j] + i has weight
+  // bandWeights_[bandOffset_[j] + i] in filter j, for i in
+  // [0, bandOffset_[j + 1] - bandOffset_[j]).
+  std::vector<int> bandStart_;
+  std::vector<int> bandOffset_; // numFilters_ + 1 entries
+  std::vector<float> bandWeights_;
+
   float hertzToWarpedScale(float hz, FrequencyScale freqscale) const;
   float warpedToHertzScale(float wrp, FrequencyScale freqscale) const;
 };
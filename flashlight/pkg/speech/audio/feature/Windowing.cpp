@@ -47,11 +47,13 @@ void Windowing::applyInPlace(std::vector<float>& input) const {
     throw std::invalid_argument(
         "Windowing: input size is not divisible by windowLength");
   }
-  size_t n = 0;
-  for (auto& in : input) {
-    in *= coefs_[n++];
-    if (n == windowLength_) {
-      n = 0;
+  size_t nframes = input.size() / windowLength_;
+  const float* coefs = coefs_.data();
+  for (size_t f = 0; f < nframes; ++f) {
+    float* frame = input.data() + f * windowLength_;
+#pragma omp simd
+    for (size_t i = 0; i < windowLength_; ++i) {
+      frame[i] *= coefs[i];
     }
   }
 }
@@ -14,7 +14,6 @@
 
 #include "flashlight/fl/common/Logging.h"
 #include "flashlight/pkg/speech/augmentation/SoundEffectUtil.h"
-#include "flashlight/pkg/speech/data/Sound.h"
 
 namespace fl::pkg::speech::sfx {
 
@@ -66,27 +65,48 @@ void AdditiveNoise::apply(std::vector<float>& signal) {
   if (nClips == 0) {
     return;
   }
-  int augStart = rng_.randInt(0, signal.size() - 1);
+  const int signalLen = signal.size();
+  int augStart = rng_.randInt(0, signalLen - 1);
   // overflow implies we start at the beginning again.
-  int augEnd = augStart + conf_.ratio_ * signal.size();
+  int augEnd = augStart + conf_.ratio_ * signalLen;
 
-  std::vector<float> mixedNoise(signal.size(), 0.0f);
+  // Reuse the mixing buffer across calls
+  mixedNoise_.assign(signalLen, 0.0f);
+  float* mixed = mixedNoise_.data();
   for (int i = 0; i < nClips; ++i) {
     auto curNoiseFileIdx = rng_.randInt(0, noiseFiles_.size() - 1);
-    auto curNoise = loadSound<float>(noiseFiles_[curNoiseFileIdx]);
-    int shift = rng_.randInt(0, curNoise.size() - 1);
-    for (int j = augStart; j < augEnd; ++j) {
-      mixedNoise[j % mixedNoise.size()] +=
-          curNoise[(shift + j) % curNoise.size()];
+    // Noise clips are decoded once and then shared from memory
+    auto curNoisePtr = SoundCache::global().get(noiseFiles_[curNoiseFileIdx]);
+    const std::vector<float>& curNoise = *curNoisePtr;
+    const int noiseLen = curNoise.size();
+    int shift = rng_.randInt(0, noiseLen - 1);
+    // Add contiguous runs where neither the signal nor the noise wrap around
+    int j = augStart;
+    int signalIdx = augStart % signalLen;
+    int noiseIdx = (shift + augStart) % noiseLen;
+    while (j < augEnd) {
+      const int run = std::min(
+          {augEnd - j, signalLen - signalIdx, noiseLen - noiseIdx});
+      const float* noise = curNoise.data() + noiseIdx;
+      float* dst = mixed + signalIdx;
+#pragma omp simd
+      for (int k = 0; k < run; ++k) {
+        dst[k] += noise[k];
+      }
+      j += run;
+      signalIdx = (signalIdx + run) % signalLen;
+      noiseIdx = (noiseIdx + run) % noiseLen;
     }
   }
 
-  const float noiseRms = rootMeanSquare(mixedNoise);
+  const float noiseRms = rootMeanSquare(mixedNoise_);
   if (noiseRms > 0) {
     // https://en.wikipedia.org/wiki/Signal-to-noise_ratio
     const float noiseMult = (signalRms / (noiseRms * std::pow(10, snr / 20.0)));
-    for (int i = 0; i < signal.size(); ++i) {
-      signal[i] += mixedNoise[i] * noiseMult;
+    float* sig = signal.data();
+#pragma omp simd
+    for (int i = 0; i < signalLen; ++i) {
+      sig[i] += mixed[i] * noiseMult;
     }
   } else {
     FL_LOG(fl::LogLevel::WARNING)
@@ -35,6 +35,10 @@ namespace sfx {
  * rms(signal)/rms(noise) / snrDB. rms(signal) is calculated only on the
  * augmented interval. rms(noise) is calculated on the sum of all noise clipse
  * over the augmented interval.
+ *
+ * Decoded noise files are kept in SoundCache::global(), so each file is only
+ * read from disk once per process. Instances are not thread-safe; use one per
+ * worker thread.
  */
 class AdditiveNoise : public SoundEffect {
  public:
@@ -63,6 +67,7 @@ class AdditiveNoise : public SoundEffect {
   const AdditiveNoise::Config conf_;
   std::vector<std::string> noiseFiles_;
   RandomNumberGenerator rng_;
+  std::vector<float> mixedNoise_;
 };
 
 } // namespace sfx
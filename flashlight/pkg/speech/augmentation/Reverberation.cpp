@@ -24,15 +24,15 @@ void ReverbEcho::applyReverb(
     float firstDelay,
     float rt60) {
   size_t length = source.size();
-  std::vector<float> reverb(length, 0);
+  if (length < 2) {
+    return;
+  }
+  // Accumulate the echo trains into a room impulse response. Echo delays of
+  // each train are cumulative jittered copies of firstDelay.
+  rir_.assign(length, 0.0f);
+  size_t numTaps = 0;
   for (int i = 0; i < conf_.repeat_; ++i) {
     float frac = 1;
-    // echo = initial * source
-    std::vector<float> echo = source;
-    std::transform(
-        echo.begin(), echo.end(), echo.begin(), [initial](float x) -> float {
-          return x * initial;
-        });
     while (frac > 1e-3) {
       // Add jitter noise for the delay
       float jitter = 1 + rng_.uniform(-conf_.jitter_, conf_.jitter_);
@@ -40,9 +40,10 @@ void ReverbEcho::applyReverb(
       if (delay > length - 1) {
         break;
       }
-      for (int j = 0; j < length - delay - 1; ++j) {
-        reverb[delay + j] += echo[j] * frac;
+      if (rir_[delay] == 0 && initial * frac != 0) {
+        ++numTaps;
       }
+      rir_[delay] += initial * frac;
 
       // Add jitter noise for the attenuation
       jitter = 1 + rng_.uniform(-conf_.jitter_, conf_.jitter_);
@@ -51,7 +52,35 @@ void ReverbEcho::applyReverb(
       frac *= attenuation;
     }
   }
-  for (int i = 0; i < length; ++i) {
+  if (numTaps == 0) {
+    return;
+  }
+
+  // Convolve the source with the RIR: directly if it only has a few distinct
+  // taps, otherwise through FFTs
+  const float* src = source.data();
+  float* reverb;
+  if (numTaps <= kMaxDirectTaps) {
+    reverb_.assign(length, 0.0f);
+    reverb = reverb_.data();
+    for (size_t delay = 1; delay < length; ++delay) {
+      const float gain = rir_[delay];
+      if (gain == 0) {
+        continue;
+      }
+      float* dst = reverb + delay;
+      const size_t n = length - delay;
+#pragma omp simd
+      for (size_t j = 0; j < n; ++j) {
+        dst[j] += src[j] * gain;
+      }
+    }
+  } else {
+    fftConvolve(source, rir_, reverb_);
+    reverb = reverb_.data();
+  }
+  // The last sample is never reverberated
+  for (size_t i = 0; i < length - 1; ++i) {
     source[i] += reverb[i];
   }
 }
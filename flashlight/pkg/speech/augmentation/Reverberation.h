@@ -25,6 +25,10 @@ namespace sfx {
  * absorption coefficient, room size, and jitter.
  * This a c++ port of:
  * https://github.com/facebookresearch/denoiser/blob/master/denoiser/augment.py
+ *
+ * Echo trains are accumulated into a room impulse response which is applied
+ * with an FFT convolution, reusing buffers across calls. Instances are not
+ * thread-safe; use one per worker thread.
  */
 class ReverbEcho : public SoundEffect {
  public:
@@ -91,8 +95,13 @@ class ReverbEcho : public SoundEffect {
       float firstDelay,
       float rt60);
 
+  // Below this many distinct echo delays, convolve in the time domain
+  static constexpr size_t kMaxDirectTaps = 32;
+
   const ReverbEcho::Config conf_;
   RandomNumberGenerator rng_;
+  std::vector<float> rir_;
+  std::vector<float> reverb_;
 };
 
 } // namespace sfx
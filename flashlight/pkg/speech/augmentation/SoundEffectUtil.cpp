@@ -9,8 +9,14 @@
 
 #include <algorithm>
 #include <cmath>
+#include <map>
 #include <sstream>
 
+#include <fftw3.h>
+
+#include "flashlight/pkg/speech/audio/feature/SpeechUtils.h"
+#include "flashlight/pkg/speech/data/Sound.h"
+
 namespace fl::pkg::speech::sfx {
 
 RandomNumberGenerator::RandomNumberGenerator(int seed /* = 0 */)
@@ -51,6 +57,153 @@ float signalToNoiseRatio(
   return 20 * std::log10(singalRms / noiseRms);
 }
 
+namespace {
+
+// Real-to-complex and complex-to-real plans of a given size. Plans are created
+// once per size and never destroyed; sizes are powers of two so there are few
+// of them. Execution uses fftw_malloc'd per-thread buffers which have the
+// alignment plans were created with.
+struct ConvolutionPlans {
+  fftw_plan forward;
+  fftw_plan backward;
+};
+
+const ConvolutionPlans& convolutionPlans(int n) {
+  static std::map<int, ConvolutionPlans> plans;
+  std::lock_guard<std::mutex> lock(fl::lib::audio::fftwPlanMutex());
+  auto it = plans.find(n);
+  if (it == plans.end()) {
+    auto* real = static_cast<double*>(fftw_malloc(sizeof(double) * n));
+    auto* cplx = static_cast<fftw_complex*>(
+        fftw_malloc(sizeof(fftw_complex) * (n / 2 + 1)));
+    ConvolutionPlans p{
+        fftw_plan_dft_r2c_1d(n, real, cplx, FFTW_ESTIMATE),
+        fftw_plan_dft_c2r_1d(n, cplx, real, FFTW_ESTIMATE)};
+    fftw_free(real);
+    fftw_free(cplx);
+    it = plans.emplace(n, p).first;
+  }
+  return it->second;
+}
+
+struct ConvolutionWorkspace {
+  double* signal{nullptr};
+  double* kernel{nullptr};
+  fftw_complex* signalSpec{nullptr};
+  fftw_complex* kernelSpec{nullptr};
+  int size{0};
+
+  void reserve(int n) {
+    if (n <= size) {
+      return;
+    }
+    release();
+    signal = static_cast<double*>(fftw_malloc(sizeof(double) * n));
+    kernel = static_cast<double*>(fftw_malloc(sizeof(double) * n));
+    signalSpec = static_cast<fftw_complex*>(
+        fftw_malloc(sizeof(fftw_complex) * (n / 2 + 1)));
+    kernelSpec = static_cast<fftw_complex*>(
+        fftw_malloc(sizeof(fftw_complex) * (n / 2 + 1)));
+    size = n;
+  }
+
+  void release() {
+    fftw_free(signal);
+    fftw_free(kernel);
+    fftw_free(signalSpec);
+    fftw_free(kernelSpec);
+  }
+
+  ~ConvolutionWorkspace() {
+    release();
+  }
+};
+
+} // namespace
+
+void fftConvolve(
+    const std::vector<float>& signal,
+    const std::vector<float>& kernel,
+    std::vector<float>& output) {
+  const int len = signal.size();
+  // Only the first len outputs are needed, so the circular convolution only
+  // has to be long enough for the kernel not to wrap around onto them
+  const int kernelLen = std::min<int>(kernel.size(), len);
+  output.resize(len);
+  if (len == 0 || kernelLen == 0) {
+    std::fill(output.begin(), output.end(), 0.0f);
+    return;
+  }
+  int n = 1;
+  while (n < len + kernelLen - 1) {
+    n <<= 1;
+  }
+  const auto& plans = convolutionPlans(n);
+  thread_local ConvolutionWorkspace ws;
+  ws.reserve(n);
+
+  std::copy(signal.begin(), signal.end(), ws.signal);
+  std::fill(ws.signal + len, ws.signal + n, 0.0);
+  std::copy(kernel.begin(), kernel.begin() + kernelLen, ws.kernel);
+  std::fill(ws.kernel + kernelLen, ws.kernel + n, 0.0);
+  fftw_execute_dft_r2c(plans.forward, ws.signal, ws.signalSpec);
+  fftw_execute_dft_r2c(plans.forward, ws.kernel, ws.kernelSpec);
+
+  // Pointwise complex product, scaled for FFTW's unnormalized inverse
+  const double scale = 1.0 / n;
+  double* x = reinterpret_cast<double*>(ws.signalSpec);
+  const double* h = reinterpret_cast<const double*>(ws.kernelSpec);
+  const int nBins = n / 2 + 1;
+#pragma omp simd
+  for (int i = 0; i < nBins; ++i) {
+    const double re = x[2 * i] * h[2 * i] - x[2 * i + 1] * h[2 * i + 1];
+    const double im = x[2 * i] * h[2 * i + 1] + x[2 * i + 1] * h[2 * i];
+    x[2 * i] = re * scale;
+    x[2 * i + 1] = im * scale;
+  }
+  fftw_execute_dft_c2r(plans.backward, ws.signalSpec, ws.signal);
+  std::copy(ws.signal, ws.signal + len, output.begin());
+}
+
+SoundCache::SoundCache(size_t maxBytes) : maxBytes_(maxBytes) {}
+
+std::shared_ptr<const std::vector<float>> SoundCache::get(
+    const std::string& filename) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = sounds_.find(filename);
+    if (it != sounds_.end()) {
+      return it->second;
+    }
+  }
+  // Decode without holding the lock; concurrent misses on the same file may
+  // decode it more than once but only one copy is kept
+  auto sound =
+      std::make_shared<const std::vector<float>>(loadSound<float>(filename));
+  const size_t bytes = sound->size() * sizeof(float);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = sounds_.find(filename);
+  if (it != sounds_.end()) {
+    return it->second;
+  }
+  if (sizeBytes_ + bytes <= maxBytes_) {
+    sounds_.emplace(filename, sound);
+    sizeBytes_ += bytes;
+  }
+  return sound;
+}
+
+size_t SoundCache::sizeBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return sizeBytes_;
+}
+
+SoundCache& SoundCache::global() {
+  // 2 GiB: enough for thousands of noise clips
+  static SoundCache cache(size_t(2) << 30);
+  return cache;
+}
+
 std::vector<float>
 genTestSinWave(size_t numSamples, size_t freq, size_t sampleRate, float amplitude) {
   std::vector<float> output(numSamples, 0);
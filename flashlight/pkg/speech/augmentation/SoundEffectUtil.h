@@ -8,9 +8,11 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <random>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace fl {
@@ -47,6 +49,43 @@ float signalToNoiseRatio(
     const std::vector<float>& signal,
     const std::vector<float>& noise);
 
+/**
+ * Computes the linear convolution of signal with kernel, truncated to the
+ * length of signal, i.e. output[n] = sum_k kernel[k] * signal[n - k] for n in
+ * [0, signal.size()). Uses FFTs, so the cost is O(N log N) rather than
+ * O(signal.size() * kernel.size()). output is resized and may not alias
+ * signal or kernel.
+ */
+void fftConvolve(
+    const std::vector<float>& signal,
+    const std::vector<float>& kernel,
+    std::vector<float>& output);
+
+/**
+ * Thread-safe in-memory cache of decoded single channel sound files, such as
+ * noise clips or room impulse responses, which are read over and over again
+ * during augmentation. Files are decoded once and shared read-only. Once
+ * maxBytes is reached new files are still loaded but no longer cached.
+ */
+class SoundCache {
+ public:
+  explicit SoundCache(size_t maxBytes);
+
+  std::shared_ptr<const std::vector<float>> get(const std::string& filename);
+
+  size_t sizeBytes() const;
+
+  /// Process-wide cache shared by sound effects
+  static SoundCache& global();
+
+ private:
+  const size_t maxBytes_;
+  size_t sizeBytes_{0};
+  std::unordered_map<std::string, std::shared_ptr<const std::vector<float>>>
+      sounds_;
+  mutable std::mutex mutex_;
+};
+
 std::vector<float> genTestSinWave(
     size_t numSamples,
     size_t freq,
@@ -129,6 +129,11 @@ DEFINE_int64(
     std::numeric_limits<int64_t>::max(),
     "[train] Total number of updates for training");
 DEFINE_bool(itersave, false, "Save model or not at each update");
+DEFINE_bool(
+    save_mapped,
+    false,
+    "[train] Save models in the memory-mappable format, which test, decode \
+    and continued training load without a host buffer per tensor");
 DEFINE_double(lr, 1.0, "[train] Learning rate for the network parameters");
 DEFINE_double(
     momentum,
@@ -301,6 +306,12 @@ DEFINE_double(
     pcttraineval,
     100,
     "[train] Percentage of training set (by number of utts) to use for evaluation");
+DEFINE_bool(
+    synctimers,
+    false,
+    "[train] Synchronize with the device after each phase of a training step "
+    "so that forward/backward/optimizer timers measure device time. This adds "
+    "several host-device round trips to every step");
 DEFINE_bool(
     fl_benchmark_mode,
     true,
@@ -466,6 +477,18 @@ DEFINE_int32(
     nthread_decoder_am_forward,
     1,
     "[test, decoder] Number of threads for acoustic model forward");
+DEFINE_int32(
+    am_forward_batchsize,
+    8,
+    "[decode] Number of utterances per acoustic model forward pass. "
+    "Utterances are sorted by length and padded; use 1 for models whose "
+    "outputs depend on padding, e.g. bidirectional RNNs");
+DEFINE_bool(
+    s2s_batch_beam,
+    false,
+    "[decode] Decode seq2seq criteria without an LM with the batched beam "
+    "search of the criterion, of size beamsize, on each acoustic model batch "
+    "rather than with the seq2seq decoder");
 DEFINE_int32(
     nthread_decoder,
     1,
@@ -95,6 +95,7 @@ DECLARE_bool(lrcosine);
 
 DECLARE_int64(iter);
 DECLARE_bool(itersave);
+DECLARE_bool(save_mapped);
 DECLARE_double(lr);
 DECLARE_double(momentum);
 DECLARE_double(weightdecay);
@@ -155,6 +156,7 @@ DECLARE_int64(seed);
 DECLARE_int64(memstepsize);
 DECLARE_int64(reportiters);
 DECLARE_double(pcttraineval);
+DECLARE_bool(synctimers);
 DECLARE_bool(fl_benchmark_mode);
 DECLARE_string(fl_optim_mode);
 DECLARE_string(fl_log_level);
@@ -209,6 +211,8 @@ DECLARE_int32(maxword);
 DECLARE_int32(beamsize);
 DECLARE_int32(beamsizetoken);
 DECLARE_int32(nthread_decoder_am_forward);
+DECLARE_int32(am_forward_batchsize);
+DECLARE_bool(s2s_batch_beam);
 DECLARE_int32(nthread_decoder);
 DECLARE_int32(lm_memory);
 
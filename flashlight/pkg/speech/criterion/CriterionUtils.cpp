@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <numeric>
 
 #include "flashlight/fl/tensor/Index.h"
 
@@ -96,4 +97,172 @@ fl::Variable applySeq2SeqMask(
   return fl::Variable(output, {input.withoutData()}, gradFunc);
 }
 
+std::vector<std::vector<int>> batchBeamSearch(
+    const BeamSearchStepFunc& step,
+    int batchSize,
+    int beamSize,
+    int eos,
+    int maxLen) {
+  using Hypothesis = std::pair<float, std::vector<int>>; // score, path
+  auto cmpfn = [](const Hypothesis& lhs, const Hypothesis& rhs) {
+    return lhs.first > rhs.first;
+  };
+
+  std::vector<int> active(batchSize); // utterance of each group of beamSize
+  std::iota(active.begin(), active.end(), 0);
+  std::vector<float> scores(batchSize * beamSize, NEG_INFINITY_FLT);
+  for (int b = 0; b < batchSize; ++b) {
+    scores[b * beamSize] = 0;
+  }
+  std::vector<std::vector<int>> paths(batchSize * beamSize);
+  std::vector<std::vector<Hypothesis>> complete(batchSize);
+
+  Tensor prevTokens, parents;
+  for (int l = 0; l < maxLen && !active.empty(); ++l) {
+    const int nHyps = scores.size();
+    auto logProbs = step(prevTokens, parents); // C x N
+    const int nClass = logProbs.dim(0);
+    auto scoreArr = Tensor::fromVector({1, nHyps}, scores);
+    scoreArr = fl::tile(scoreArr, {nClass}) + logProbs;
+    // Candidates of each utterance, from any of its hypotheses
+    scoreArr = fl::reshape(
+        scoreArr,
+        {nClass * beamSize, static_cast<Dim>(active.size())}); // CK x B
+    const int nCandidates = std::min(2 * beamSize, nClass * beamSize);
+    Tensor candScoreArr, candIdxArr;
+    fl::topk(candScoreArr, candIdxArr, scoreArr, nCandidates, 0);
+    auto candScores = candScoreArr.toHostVector<float>();
+    auto candIndices = candIdxArr.astype(fl::dtype::s32).toHostVector<int>();
+
+    std::vector<int> nextActive, nextTokens, nextParents;
+    std::vector<float> nextScores;
+    std::vector<std::vector<int>> nextPaths;
+    for (size_t i = 0; i < active.size(); ++i) {
+      auto& done = complete[active[i]];
+      const int first = nextTokens.size();
+      int nLive = 0;
+      for (int j = 0; j < nCandidates && nLive < beamSize; ++j) {
+        const float score = candScores[i * nCandidates + j];
+        if (score == NEG_INFINITY_FLT) {
+          break;
+        }
+        const int candidate = candIndices[i * nCandidates + j];
+        const int hyp = i * beamSize + candidate / nClass;
+        const int token = candidate % nClass;
+        if (token == eos) {
+          if (j < beamSize) {
+            done.emplace_back(score, paths[hyp]);
+          }
+          continue;
+        }
+        nextTokens.push_back(token);
+        nextParents.push_back(hyp);
+        nextScores.push_back(score);
+        nextPaths.push_back(paths[hyp]);
+        nextPaths.back().push_back(token);
+        ++nLive;
+      }
+
+      bool finished = nLive == 0 || l == maxLen - 1;
+      if (done.size() >= static_cast<size_t>(beamSize)) {
+        std::partial_sort(
+            done.begin(), done.begin() + beamSize, done.end(), cmpfn);
+        done.resize(beamSize);
+        // No live hypothesis can beat the complete ones any more
+        finished = finished || done.back().first > nextScores[first];
+      }
+      if (finished) {
+        if (done.empty() && nLive > 0) {
+          done.emplace_back(nextScores[first], nextPaths[first]);
+        }
+        nextTokens.resize(first);
+        nextParents.resize(first);
+        nextScores.resize(first);
+        nextPaths.resize(first);
+        continue;
+      }
+      // Keep beamSize hypotheses per utterance: pad with dead ones
+      for (int k = nLive; k < beamSize; ++k) {
+        nextTokens.push_back(nextTokens[first]);
+        nextParents.push_back(nextParents[first]);
+        nextScores.push_back(NEG_INFINITY_FLT);
+        nextPaths.push_back(nextPaths[first]);
+      }
+      nextActive.push_back(active[i]);
+    }
+
+    active = std::move(nextActive);
+    scores = std::move(nextScores);
+    paths = std::move(nextPaths);
+    if (!active.empty()) {
+      prevTokens = Tensor::fromVector(
+          {1, static_cast<Dim>(nextTokens.size())}, nextTokens);
+      parents = Tensor::fromVector(nextParents);
+    }
+  }
+
+  std::vector<std::vector<int>> bestPaths(batchSize);
+  for (int b = 0; b < batchSize; ++b) {
+    auto& done = complete[b];
+    if (!done.empty()) {
+      bestPaths[b] =
+          std::min_element(done.begin(), done.end(), cmpfn)->second;
+    }
+  }
+  return bestPaths;
+}
+
+std::vector<std::vector<int>> batchAttentionBeamSearch(
+    const AttentionBeamSearchStepFunc& decode,
+    const Tensor& input,
+    const Tensor& inputSizes,
+    int beamSize,
+    int eos,
+    int maxLen) {
+  const int B = input.ndim() < 3 ? 1 : input.dim(2);
+  // Utterance of each hypothesis, which it attends over
+  std::vector<int> hypUtterances(B * beamSize);
+  for (int i = 0; i < hypUtterances.size(); i++) {
+    hypUtterances[i] = i / beamSize;
+  }
+  auto utterances = Tensor::fromVector(hypUtterances);
+  fl::Variable xEncoded;
+  Tensor hypInputSizes;
+  const double maxInputSize =
+      inputSizes.isEmpty() ? 0 : fl::amax(inputSizes).asScalar<double>();
+  auto gatherInputs = [&]() {
+    if (inputSizes.isEmpty()) {
+      xEncoded = fl::Variable(input(fl::span, fl::span, utterances), false);
+      return;
+    }
+    auto sizes = inputSizes.flatten()(utterances);
+    hypInputSizes = fl::reshape(sizes, {1, utterances.elements()});
+    // Attention masks padding relative to the longest input it is given, so
+    // inputs are cut to the longest one still being decoded
+    const int T = input.dim(1);
+    const int steps = std::clamp<int>(
+        std::ceil(fl::amax(sizes).asScalar<double>() / maxInputSize * T),
+        1,
+        T);
+    xEncoded = fl::Variable(
+        input(fl::span, fl::range(0, steps), utterances), false);
+  };
+  gatherInputs();
+
+  auto step = [&](const Tensor& prevTokens, const Tensor& parents) {
+    fl::Variable y;
+    if (!parents.isEmpty()) {
+      y = fl::Variable(prevTokens, false);
+      utterances = utterances(parents);
+      // Only regather the encoder outputs when utterances finished
+      if (utterances.elements() != xEncoded.dim(2)) {
+        gatherInputs();
+      }
+    }
+    auto ox = fl::logSoftmax(decode(xEncoded, y, hypInputSizes, parents), 0);
+    return fl::reshape(ox.tensor(), {ox.dim(0), ox.dim(2)}); // C x N
+  };
+  return batchBeamSearch(step, B, beamSize, eos, maxLen);
+}
+
 } // namespace fl
@@ -9,7 +9,9 @@
 
 #include <float.h>
 #include <stdint.h>
+#include <functional>
 #include <limits>
+#include <vector>
 
 #include "flashlight/fl/flashlight.h"
 
@@ -100,6 +102,63 @@ fl::Variable applySeq2SeqMask(
     const fl::Variable& input,
     const Tensor& targetClasses,
     int padValue);
+
+/**
+ * A decoder step of `batchBeamSearch`. Given the last token of each of the N
+ * live hypotheses (s32, 1 x N) and the index of the hypothesis each one
+ * extends among the previous step's hypotheses (s32, N), reorders the decoder
+ * state, advances it by one token and returns the log-probabilities of the
+ * next token of each hypothesis (C x N). Both inputs are empty on the first
+ * step.
+ */
+using BeamSearchStepFunc =
+    std::function<Tensor(const Tensor& prevTokens, const Tensor& parents)>;
+
+/**
+ * Beam search over a batch of utterances, advancing the hypotheses of all of
+ * them with one decoder step at a time. The beamSize hypotheses of each
+ * utterance being decoded are contiguous; on the first step there are
+ * batchSize * beamSize hypotheses, of which only the first of each utterance
+ * is live. Candidates are selected on the device, and an utterance is dropped
+ * from the batch once none of its live hypotheses can beat its best beamSize
+ * complete ones, so N shrinks as utterances finish.
+ *
+ * Returns the best path of each utterance, without the final eos.
+ */
+std::vector<std::vector<int>> batchBeamSearch(
+    const BeamSearchStepFunc& step,
+    int batchSize,
+    int beamSize,
+    int eos,
+    int maxLen);
+
+/**
+ * A step of an attention decoder for `batchAttentionBeamSearch`. Given the
+ * encoder outputs each of the N live hypotheses attends over (H x T x N),
+ * their last tokens (s32, 1 x N), the input sizes (1 x N) and the parent
+ * indices as in `BeamSearchStepFunc`, reorders the decoder state, advances it
+ * by one token and returns the decoder output (C x 1 x N).
+ */
+using AttentionBeamSearchStepFunc = std::function<fl::Variable(
+    const fl::Variable& xEncoded,
+    const fl::Variable& y,
+    const Tensor& inputSizes,
+    const Tensor& parents)>;
+
+/**
+ * `batchBeamSearch` over a batch of encoded inputs (H x T x B) with an
+ * attention decoder. The encoder outputs and input sizes are gathered for each
+ * hypothesis, and only regathered when utterances finish. Padding is then cut
+ * to the longest input left, so each utterance is decoded as it would be on
+ * its own.
+ */
+std::vector<std::vector<int>> batchAttentionBeamSearch(
+    const AttentionBeamSearchStepFunc& decode,
+    const Tensor& input,
+    const Tensor& inputSizes,
+    int beamSize,
+    int eos,
+    int maxLen);
 } // namespace speech
 } // namespace pkg
 } // namespace fl
@@ -70,6 +70,19 @@ Seq2SeqState selectState(Seq2SeqState& state, int batchIdx) {
   }
   return newState;
 }
+
+Seq2SeqState reorderState(const Seq2SeqState& state, const Tensor& indices) {
+  Seq2SeqState newState(state.hidden.size());
+  newState.step = state.step;
+  newState.peakAttnPos = state.peakAttnPos;
+  newState.isValid = state.isValid;
+  newState.alpha = state.alpha(fl::span, fl::span, indices);
+  newState.summary = state.summary(fl::span, fl::span, indices);
+  for (int i = 0; i < state.hidden.size(); i++) {
+    newState.hidden[i] = state.hidden[i](fl::span, indices);
+  }
+  return newState;
+}
 } // namespace detail
 
 Seq2SeqCriterion::Seq2SeqCriterion(
@@ -211,10 +224,18 @@ std::pair<Variable, Variable> Seq2SeqCriterion::vectorizedDecoder(
     hy = concatenate({hy, yEmbed}, 1); // H x U x B
   }
 
+  // Steps past the end of each target only predict padding, so the RNN skips
+  // them
+  Tensor decoderLengths;
+  if (!targetSizes.isEmpty()) {
+    decoderLengths =
+        fl::minimum(targetSizes.flatten(), U).astype(fl::dtype::s32); // B
+  }
+
   Variable alpha, summaries;
   for (int i = 0; i < nAttnRound_; i++) {
     hy = fl::transpose(hy, {0, 2, 1}); // H x U x B -> H x B x U
-    hy = decodeRNN(i)->forward(hy);
+    hy = decodeRNN(i)->forward({hy}, decoderLengths).front();
     hy = fl::transpose(hy, {0, 2, 1}); // H x B x U ->  H x U x B
 
     Variable windowWeight;
@@ -334,11 +355,36 @@ std::vector<int> Seq2SeqCriterion::beamPath(
     const Tensor& input,
     const Tensor& inputSizes,
     int beamSize /* = 10 */) {
-  std::vector<Seq2SeqCriterion::CandidateHypo> beam;
-  beam.emplace_back();
-  auto beamPaths =
-      beamSearch(input, inputSizes, beam, beamSize, maxDecoderOutputLen_);
-  return beamPaths[0].path;
+  return batchBeamPath(input, inputSizes, beamSize).front();
+}
+
+std::vector<std::vector<int>> Seq2SeqCriterion::batchBeamPath(
+    const Tensor& input, // H x T x B
+    const Tensor& inputSizes, // 1 x B
+    int beamSize /* = 10 */) {
+  bool wasTrain = train_;
+  eval();
+
+  Seq2SeqState state(nAttnRound_);
+  auto decode = [&](const Variable& xEncoded,
+                    const Variable& y,
+                    const Tensor& hypInputSizes,
+                    const Tensor& parents) {
+    if (!parents.isEmpty()) {
+      state = detail::reorderState(state, parents);
+    }
+    Variable ox;
+    std::tie(ox, state) = decodeStep(
+        xEncoded, y, state, hypInputSizes, Tensor(), input.dim(1));
+    return ox;
+  };
+  auto paths = batchAttentionBeamSearch(
+      decode, input, inputSizes, beamSize, eos_, maxDecoderOutputLen_);
+
+  if (wasTrain) {
+    train();
+  }
+  return paths;
 }
 
 // beam are candidates that need to be extended
@@ -99,6 +99,13 @@ class Seq2SeqCriterion : public SequenceCriterion {
   std::vector<int>
   beamPath(const Tensor& input, const Tensor& inputSizes, int beamSize = 10);
 
+  /* Beam search over a batch of encoded inputs (H x T x B) at once, see
+   * batchBeamSearch. Returns the best path of each input. */
+  std::vector<std::vector<int>> batchBeamPath(
+      const Tensor& input,
+      const Tensor& inputSizes,
+      int beamSize = 10);
+
   std::string prettyString() const override;
 
   std::shared_ptr<fl::Embedding> embedding() const {
@@ -190,6 +190,37 @@ std::pair<Tensor, Variable> TransformerCriterion::viterbiPathBase(
   return std::make_pair(vPath, alpha);
 }
 
+std::vector<std::vector<int>> TransformerCriterion::batchBeamPath(
+    const Tensor& input, // H x T x B
+    const Tensor& inputSizes, // 1 x B
+    int beamSize /* = 10 */) {
+  bool wasTrain = train_;
+  eval();
+
+  TS2SState state;
+  auto decode = [&](const Variable& xEncoded,
+                    const Variable& y,
+                    const Tensor& hypInputSizes,
+                    const Tensor& parents) {
+    if (!parents.isEmpty()) {
+      // Layer inputs of the previous steps: H x U x N
+      for (auto& hidden : state.hidden) {
+        hidden = hidden(fl::span, fl::span, parents);
+      }
+    }
+    Variable ox;
+    std::tie(ox, state) = decodeStep(xEncoded, y, state, hypInputSizes);
+    return ox;
+  };
+  auto paths = batchAttentionBeamSearch(
+      decode, input, inputSizes, beamSize, eos_, maxDecoderOutputLen_);
+
+  if (wasTrain) {
+    train();
+  }
+  return paths;
+}
+
 std::pair<Variable, TS2SState> TransformerCriterion::decodeStep(
     const Variable& xEncoded,
     const Variable& y,
@@ -57,6 +57,13 @@ class TransformerCriterion : public SequenceCriterion {
   std::pair<Tensor, fl::Variable>
   viterbiPathBase(const Tensor& input, const Tensor& inputSizes, bool saveAttn);
 
+  /* Beam search over a batch of encoded inputs (H x T x B) at once, see
+   * batchBeamSearch. Returns the best path of each input. */
+  std::vector<std::vector<int>> batchBeamPath(
+      const Tensor& input,
+      const Tensor& inputSizes,
+      int beamSize = 10);
+
   std::pair<fl::Variable, fl::Variable> vectorizedDecoder(
       const fl::Variable& input,
       const fl::Variable& target,
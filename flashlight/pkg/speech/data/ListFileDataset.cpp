@@ -119,8 +119,11 @@ std::vector<Tensor> ListFileDataset::get(const int64_t idx) const {
 
 std::pair<std::vector<float>, Shape> ListFileDataset::loadAudio(
     const std::string& handle) const {
-  auto info = loadSoundInfo(handle.c_str());
-  return {loadSound<float>(handle.c_str()), {info.channels, info.frames}};
+  // Open the file once for both the header and the samples
+  SoundReader reader(handle);
+  std::vector<float> audio;
+  auto frames = reader.read(audio);
+  return {std::move(audio), {reader.info().channels, frames}};
 }
 
 float ListFileDataset::getInputSize(const int64_t idx) const {
@@ -7,12 +7,16 @@
 
 #include "flashlight/pkg/speech/data/Sound.h"
 
+#include <exception>
 #include <fstream>
+#include <future>
 #include <string>
 #include <unordered_map>
 
 #include <sndfile.h>
 
+#include "flashlight/fl/common/threadpool/ThreadPool.h"
+
 using namespace fl::pkg::speech;
 
 namespace {
@@ -231,42 +235,157 @@ std::vector<T> loadSound(const std::string& filename) {
 
 template <typename T>
 std::vector<T> loadSound(std::istream& f) {
+  SoundReader reader(f);
+  std::vector<T> in;
+  if (reader.read(in) != reader.info().frames) {
+    throw std::runtime_error("loadSound: read error");
+  }
+  return in;
+}
+
+SoundReader::SoundReader(const std::string& filename)
+    : ownedStream_(std::make_unique<std::ifstream>(filename)),
+      stream_(ownedStream_.get()) {
+  if (!static_cast<std::ifstream*>(stream_)->is_open()) {
+    throw std::runtime_error("could not open file " + filename);
+  }
+  open();
+}
+
+SoundReader::SoundReader(std::istream& f) : stream_(&f) {
+  open();
+}
+
+void SoundReader::open() {
   SF_VIRTUAL_IO vsf = {sf_vio_ro_get_filelen,
                        sf_vio_ro_seek,
                        sf_vio_ro_read,
                        sf_vio_ro_write,
                        sf_vio_ro_tell};
-  SNDFILE* file;
   SF_INFO info;
-
   info.format = 0;
 
-  if (!(file = sf_open_virtual(&vsf, SFM_READ, &info, &f))) {
+  if (!(file_ = sf_open_virtual(&vsf, SFM_READ, &info, stream_))) {
     throw std::runtime_error(
-        "loadSound: unknown format or could not open stream");
+        "SoundReader: unknown format or could not open stream");
+  }
+  info_.frames = info.frames;
+  info_.samplerate = info.samplerate;
+  info_.channels = info.channels;
+}
+
+SoundReader::~SoundReader() {
+  if (file_) {
+    sf_close(file_);
   }
+}
 
-  std::vector<T> in(info.frames * info.channels);
+const SoundInfo& SoundReader::info() const {
+  return info_;
+}
+
+int64_t SoundReader::seek(int64_t frame) {
+  if (frame < 0 || frame > info_.frames) {
+    throw std::invalid_argument(
+        "SoundReader::seek: frame " + std::to_string(frame) +
+        " out of range [0, " + std::to_string(info_.frames) + "]");
+  }
+  if (frame == position_) {
+    return position_;
+  }
+  auto pos = sf_seek(file_, frame, SEEK_SET);
+  if (pos < 0) {
+    throw std::runtime_error("SoundReader::seek: stream is not seekable");
+  }
+  position_ = pos;
+  return position_;
+}
+
+template <typename T>
+int64_t SoundReader::read(T* out, int64_t frames) {
+  if (frames <= 0) {
+    return 0;
+  }
   sf_count_t nframe;
-  if (std::is_same<T, float>::value) {
-    nframe =
-        sf_readf_float(file, reinterpret_cast<float*>(in.data()), info.frames);
-  } else if (std::is_same<T, double>::value) {
-    nframe = sf_readf_double(
-        file, reinterpret_cast<double*>(in.data()), info.frames);
-  } else if (std::is_same<T, int>::value) {
-    nframe = sf_readf_int(file, reinterpret_cast<int*>(in.data()), info.frames);
-  } else if (std::is_same<T, short>::value) {
-    nframe =
-        sf_readf_short(file, reinterpret_cast<short*>(in.data()), info.frames);
+  if constexpr (std::is_same<T, float>::value) {
+    nframe = sf_readf_float(file_, out, frames);
+  } else if constexpr (std::is_same<T, double>::value) {
+    nframe = sf_readf_double(file_, out, frames);
+  } else if constexpr (std::is_same<T, int>::value) {
+    nframe = sf_readf_int(file_, out, frames);
+  } else if constexpr (std::is_same<T, short>::value) {
+    nframe = sf_readf_short(file_, out, frames);
   } else {
-    throw std::logic_error("loadSound: called with unsupported T");
+    throw std::logic_error("SoundReader::read: called with unsupported T");
   }
-  sf_close(file);
-  if (nframe != info.frames) {
-    throw std::runtime_error("loadSound: read error");
+  position_ += nframe;
+  return nframe;
+}
+
+template <typename T>
+int64_t SoundReader::read(std::vector<T>& out, int64_t frames /* = -1 */) {
+  int64_t remaining = info_.frames - position_;
+  if (frames < 0 || frames > remaining) {
+    frames = remaining;
   }
-  return in;
+  out.resize(frames * info_.channels);
+  auto nframe = read(out.data(), frames);
+  out.resize(nframe * info_.channels);
+  return nframe;
+}
+
+template <typename T>
+SoundInfo loadSoundInto(
+    const std::string& filename,
+    std::vector<T>& out,
+    int64_t frameOffset /* = 0 */,
+    int64_t numFrames /* = -1 */) {
+  SoundReader reader(filename);
+  reader.seek(frameOffset);
+  SoundInfo info = reader.info();
+  info.frames = reader.read(out, numFrames);
+  return info;
+}
+
+SoundBatchReader::SoundBatchReader(size_t numThreads)
+    : threadPool_(std::make_unique<fl::ThreadPool>(numThreads)) {}
+
+SoundBatchReader::~SoundBatchReader() = default;
+
+template <typename T>
+std::vector<SoundInfo> SoundBatchReader::read(
+    const std::vector<SoundRange>& ranges,
+    std::vector<std::vector<T>>& buffers) {
+  if (buffers.size() < ranges.size()) {
+    buffers.resize(ranges.size());
+  }
+  std::vector<SoundInfo> infos(ranges.size());
+  std::vector<std::future<void>> futures;
+  futures.reserve(ranges.size());
+  for (size_t i = 0; i < ranges.size(); ++i) {
+    futures.push_back(threadPool_->enqueue([&, i]() {
+      infos[i] = loadSoundInto(
+          ranges[i].filename,
+          buffers[i],
+          ranges[i].frameOffset,
+          ranges[i].numFrames);
+    }));
+  }
+  // Wait for all tasks before rethrowing since they reference local state
+  std::exception_ptr error;
+  for (auto& future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  return infos;
 }
 
 template <typename T>
@@ -371,6 +490,19 @@ template std::vector<double> loadSound<double>(std::istream&);
 template std::vector<int> loadSound<int>(std::istream&);
 template std::vector<short> loadSound<short>(std::istream&);
 
+#define FL_SOUND_READER_INSTANTIATE(T)                                    \
+  template int64_t SoundReader::read<T>(T*, int64_t);                     \
+  template int64_t SoundReader::read<T>(std::vector<T>&, int64_t);        \
+  template SoundInfo loadSoundInto<T>(                                    \
+      const std::string&, std::vector<T>&, int64_t, int64_t);             \
+  template std::vector<SoundInfo> SoundBatchReader::read<T>(              \
+      const std::vector<SoundRange>&, std::vector<std::vector<T>>&);
+FL_SOUND_READER_INSTANTIATE(float)
+FL_SOUND_READER_INSTANTIATE(double)
+FL_SOUND_READER_INSTANTIATE(int)
+FL_SOUND_READER_INSTANTIATE(short)
+#undef FL_SOUND_READER_INSTANTIATE
+
 template void saveSound(
     const std::string&,
     const std::vector<float>&,
@@ -9,8 +9,17 @@
 
 #include <cstdint>
 #include <istream>
+#include <memory>
+#include <string>
 #include <vector>
 
+// Opaque libsndfile handle; see sndfile.h
+struct SNDFILE_tag;
+
+namespace fl {
+class ThreadPool;
+} // namespace fl
+
 namespace fl {
 namespace pkg {
 namespace speech {
@@ -83,6 +92,104 @@ std::vector<T> loadSound(std::istream& f);
 template <typename T>
 std::vector<T> loadSound(const std::string& filename);
 
+/**
+ * Reads frames from a sound file or stream incrementally. Frames are decoded
+ * directly into caller-provided memory and reads can start at an arbitrary
+ * frame offset, so crops of long files don't need to decode the entire file.
+ *
+ * Samples are interleaved: reading `n` frames writes `n * info().channels`
+ * values.
+ */
+class SoundReader {
+ public:
+  explicit SoundReader(const std::string& filename);
+  /**
+   * The stream must outlive the reader.
+   */
+  explicit SoundReader(std::istream& f);
+  ~SoundReader();
+
+  SoundReader(const SoundReader&) = delete;
+  SoundReader& operator=(const SoundReader&) = delete;
+
+  const SoundInfo& info() const;
+
+  /**
+   * Moves the read position to the given frame and returns it.
+   */
+  int64_t seek(int64_t frame);
+
+  /**
+   * Decodes up to `frames` frames into `out`, which must have room for
+   * `frames * info().channels` values. Returns the number of frames read,
+   * which is less than `frames` only at the end of the stream.
+   */
+  template <typename T>
+  int64_t read(T* out, int64_t frames);
+
+  /**
+   * Decodes up to `frames` frames (all remaining frames if negative) into
+   * `out`, resizing it to the data read. Existing capacity is reused.
+   */
+  template <typename T>
+  int64_t read(std::vector<T>& out, int64_t frames = -1);
+
+ private:
+  void open();
+
+  std::unique_ptr<std::istream> ownedStream_;
+  std::istream* stream_;
+  SNDFILE_tag* file_{nullptr};
+  SoundInfo info_;
+  int64_t position_{0};
+};
+
+/**
+ * Loads `numFrames` frames starting at `frameOffset` (all remaining frames if
+ * `numFrames` is negative) into `out`, reusing its capacity. Returns the info
+ * of the file with `frames` set to the number of frames actually read.
+ */
+template <typename T>
+SoundInfo loadSoundInto(
+    const std::string& filename,
+    std::vector<T>& out,
+    int64_t frameOffset = 0,
+    int64_t numFrames = -1);
+
+/**
+ * A (possibly partial) range of frames of a sound file.
+ */
+struct SoundRange {
+  std::string filename;
+  int64_t frameOffset = 0;
+  // Negative values read until the end of the file
+  int64_t numFrames = -1;
+};
+
+/**
+ * Decodes batches of sound files on a pool of worker threads. Output buffers
+ * are owned by the caller and are reused across calls, so decoding a stream of
+ * batches doesn't allocate once buffers have grown to the largest file size.
+ */
+class SoundBatchReader {
+ public:
+  explicit SoundBatchReader(size_t numThreads);
+  ~SoundBatchReader();
+
+  /**
+   * Decodes `ranges[i]` into `buffers[i]`; `buffers` is resized to the number
+   * of ranges if needed. Returns per-range infos with `frames` set to the
+   * number of frames read. Rethrows the first decoding error, if any.
+   */
+  template <typename T>
+  std::vector<SoundInfo> read(
+      const std::vector<SoundRange>& ranges,
+      std::vector<std::vector<T>>& buffers);
+
+ private:
+  std::unique_ptr<fl::ThreadPool> threadPool_;
+};
+
 template <typename T>
 void saveSound(
     std::ostream& f,
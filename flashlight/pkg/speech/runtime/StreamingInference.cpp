@@ -0,0 +1,522 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/pkg/speech/runtime/StreamingInference.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "flashlight/fl/contrib/modules/modules.h"
+
+namespace fl {
+namespace pkg {
+namespace speech {
+
+namespace {
+
+int64_t numFrames(const Variable& x, int timeAxis) {
+  return x.isEmpty() ? 0 : x.dim(timeAxis);
+}
+
+Variable
+sliceFrames(const Variable& x, int timeAxis, int64_t begin, int64_t end) {
+  std::vector<fl::Index> indices(x.ndim(), fl::span);
+  indices[timeAxis] = fl::range(begin, end);
+  return x(indices);
+}
+
+void checkTimeAxis(const Module& module, int timeAxis, int expected) {
+  if (timeAxis != expected) {
+    throw std::invalid_argument(
+        "StreamingInferenceSession - " + module.prettyString() +
+        " expects time along axis " + std::to_string(expected) +
+        " but its input has time along axis " + std::to_string(timeAxis));
+  }
+}
+
+// Padding along the first dimension, resolving 'SAME' padding
+int convPadding(const Conv2D& conv) {
+  if (conv.xPad() == static_cast<int>(PaddingMode::SAME)) {
+    if (conv.xStride() != 1) {
+      throw std::invalid_argument(
+          "StreamingInferenceSession - 'SAME' padding with stride > 1 "
+          "depends on the input size: " +
+          conv.prettyString());
+    }
+    return derivePadding(
+        /* inSz = */ 1, conv.xFilter(), 1, conv.xPad(), conv.xDilation());
+  }
+  return conv.xPad();
+}
+
+int convExtent(const Conv2D& conv) {
+  return (conv.xFilter() - 1) * conv.xDilation() + 1;
+}
+
+} // namespace
+
+namespace detail {
+
+class StreamingLayer {
+ public:
+  explicit StreamingLayer(int timeAxis) : timeAxis_(timeAxis) {}
+
+  virtual ~StreamingLayer() = default;
+
+  /**
+   * Consumes new input frames and returns the new output frames, or empty
+   * variables if there are none. `last` ends the stream.
+   */
+  virtual Variable forward(const Variable& input, bool last) = 0;
+
+  virtual void reset() {}
+
+  virtual int outputTimeAxis() const {
+    return timeAxis_;
+  }
+
+ protected:
+  const int timeAxis_;
+};
+
+namespace {
+
+/**
+ * A layer whose output frames each depend on a window of `extent` input
+ * frames, moved by `stride`, with `leftPad` and `rightPad` frames of padding
+ * at the ends of the stream.
+ *
+ * Keeps the input frames needed by the next outputs, and runs the module on
+ * them with each new chunk. The module pads its input, so the outputs using
+ * that padding at the start of the kept frames are dropped and the outputs
+ * using the padding at their end are only emitted when the stream ends.
+ */
+class TimeLocalLayer : public StreamingLayer {
+ public:
+  TimeLocalLayer(
+      std::shared_ptr<Module> module,
+      int timeAxis,
+      int extent,
+      int stride,
+      int leftPad,
+      int rightPad)
+      : StreamingLayer(timeAxis),
+        module_(std::move(module)),
+        extent_(extent),
+        stride_(stride),
+        leftPad_(leftPad),
+        rightPad_(rightPad) {}
+
+  Variable forward(const Variable& input, bool last) override {
+    if (!input.isEmpty()) {
+      buffer_ = buffer_.isEmpty()
+          ? input
+          : fl::concatenate({buffer_, input}, timeAxis_);
+    }
+    const int64_t end = bufferStart_ + numFrames(buffer_, timeAxis_);
+    const int64_t padded = end + leftPad_ + (last ? rightPad_ : 0);
+    const int64_t outputEnd =
+        padded >= extent_ ? (padded - extent_) / stride_ + 1 : 0;
+    if (outputEnd <= nextOutput_) {
+      return Variable();
+    }
+
+    // Output j of the buffer is output bufferStart_ / stride_ + j
+    auto output = module_->forward({buffer_}).front();
+    const int64_t first = nextOutput_ - bufferStart_ / stride_;
+    output = sliceFrames(
+        output, timeAxis_, first, first + outputEnd - nextOutput_);
+    nextOutput_ = outputEnd;
+
+    // Keep the frames of the next outputs, from a multiple of the stride
+    int64_t keep = std::max<int64_t>(0, nextOutput_ * stride_ - leftPad_);
+    keep = std::min(keep, end - end % stride_);
+    keep -= keep % stride_;
+    if (keep > bufferStart_) {
+      buffer_ = keep < end ? sliceFrames(
+                                 buffer_,
+                                 timeAxis_,
+                                 keep - bufferStart_,
+                                 end - bufferStart_)
+                           : Variable();
+      bufferStart_ = keep;
+    }
+    return output;
+  }
+
+  void reset() override {
+    buffer_ = Variable();
+    bufferStart_ = 0;
+    nextOutput_ = 0;
+  }
+
+ private:
+  std::shared_ptr<Module> module_;
+  const int extent_;
+  const int stride_;
+  const int leftPad_;
+  const int rightPad_;
+
+  // Input frames [bufferStart_, bufferStart_ + buffer_.dim(timeAxis_))
+  Variable buffer_;
+  int64_t bufferStart_{0};
+  int64_t nextOutput_{0};
+};
+
+/**
+ * A unidirectional RNN carrying its hidden and cell states over.
+ */
+class RnnLayer : public StreamingLayer {
+ public:
+  RnnLayer(std::shared_ptr<RNN> rnn, int timeAxis)
+      : StreamingLayer(timeAxis), rnn_(std::move(rnn)) {}
+
+  Variable forward(const Variable& input, bool /* last */) override {
+    if (input.isEmpty()) {
+      return Variable();
+    }
+    auto outputs = rnn_->forward({input, hidden_, cell_});
+    hidden_ = outputs[1];
+    cell_ = outputs[2];
+    return outputs[0];
+  }
+
+  void reset() override {
+    hidden_ = Variable();
+    cell_ = Variable();
+  }
+
+ private:
+  std::shared_ptr<RNN> rnn_;
+  Variable hidden_;
+  Variable cell_;
+};
+
+/**
+ * A transformer layer attending over its last `leftContext` input frames and
+ * the new frames.
+ */
+class AttentionLayer : public StreamingLayer {
+ public:
+  AttentionLayer(std::shared_ptr<Module> module, int timeAxis, int leftContext)
+      : StreamingLayer(timeAxis),
+        module_(std::move(module)),
+        leftContext_(leftContext) {}
+
+  Variable forward(const Variable& input, bool /* last */) override {
+    if (input.isEmpty()) {
+      return Variable();
+    }
+    auto window = context_.isEmpty()
+        ? input
+        : fl::concatenate({context_, input}, timeAxis_);
+    const auto windowSize = numFrames(window, timeAxis_);
+    // No pad mask: all frames are used
+    auto output = module_->forward({window, Variable()}).front();
+    output = sliceFrames(
+        output,
+        timeAxis_,
+        windowSize - numFrames(input, timeAxis_),
+        windowSize);
+    context_ = windowSize > leftContext_
+        ? sliceFrames(window, timeAxis_, windowSize - leftContext_, windowSize)
+        : window;
+    return output;
+  }
+
+  void reset() override {
+    context_ = Variable();
+  }
+
+ private:
+  std::shared_ptr<Module> module_;
+  const int leftContext_;
+  Variable context_;
+};
+
+/**
+ * A layer mapping each input frame to one output frame, possibly moving the
+ * time axis.
+ */
+class FrameLayer : public StreamingLayer {
+ public:
+  FrameLayer(std::shared_ptr<Module> module, int timeAxis, const Variable& x)
+      : StreamingLayer(timeAxis), module_(std::move(module)) {
+    // Find the output time axis by running one and two frames
+    auto frame = sliceFrames(x, timeAxis_, 0, 1);
+    auto out1 = module_->forward({frame}).front();
+    auto out2 =
+        module_->forward({fl::concatenate({frame, frame}, timeAxis_)}).front();
+    const int ndim = std::max(out1.ndim(), out2.ndim());
+    outputTimeAxis_ = -1;
+    for (int i = 0; i < ndim; ++i) {
+      const auto d1 = i < out1.ndim() ? out1.dim(i) : 1;
+      const auto d2 = i < out2.ndim() ? out2.dim(i) : 1;
+      if (d1 == d2) {
+        continue;
+      }
+      if (outputTimeAxis_ != -1 || d1 != 1 || d2 != 2) {
+        outputTimeAxis_ = -1;
+        break;
+      }
+      outputTimeAxis_ = i;
+    }
+    if (outputTimeAxis_ == -1) {
+      throw std::invalid_argument(
+          "StreamingInferenceSession - " + module_->prettyString() +
+          " doesn't map each input frame to an output frame");
+    }
+  }
+
+  Variable forward(const Variable& input, bool /* last */) override {
+    if (input.isEmpty()) {
+      return Variable();
+    }
+    return module_->forward({input}).front();
+  }
+
+  int outputTimeAxis() const override {
+    return outputTimeAxis_;
+  }
+
+ private:
+  std::shared_ptr<Module> module_;
+  int outputTimeAxis_;
+};
+
+std::unique_ptr<StreamingLayer> createTimeLocalLayer(
+    const std::shared_ptr<Module>& module,
+    const std::shared_ptr<Conv2D>& conv,
+    int timeAxis) {
+  checkTimeAxis(*module, timeAxis, 0);
+  const int pad = convPadding(*conv);
+  int leftPad = pad;
+  int rightPad = pad;
+  if (auto asymmetric = std::dynamic_pointer_cast<AsymmetricConv1D>(conv)) {
+    // Mirrors the padding and cropping of AsymmetricConv1D::forward
+    const float futurePart = asymmetric->futurePart();
+    const int cut = std::abs(2 * (0.5 - futurePart)) * pad;
+    const int asymmetry = pad + cut;
+    const int cropped = asymmetry - 2 * cut * conv->xStride();
+    leftPad = futurePart > 0.5 ? cropped : asymmetry;
+    rightPad = futurePart < 0.5 ? cropped : asymmetry;
+  }
+  return std::make_unique<TimeLocalLayer>(
+      module, timeAxis, convExtent(*conv), conv->xStride(), leftPad, rightPad);
+}
+
+std::unique_ptr<StreamingLayer> createTdsLayer(
+    const std::shared_ptr<TDSBlock>& tds,
+    int timeAxis) {
+  checkTimeAxis(*tds, timeAxis, 0);
+  // See the TDSBlock constructor: a convolution block, a layer norm, a fully
+  // connected block and a layer norm
+  auto tdsModules = tds->modules();
+  for (int i : {1, 3}) {
+    auto norm = std::dynamic_pointer_cast<LayerNorm>(tdsModules.at(i));
+    auto axis = norm->getAxis();
+    if (std::find(axis.begin(), axis.end(), 0) != axis.end()) {
+      throw std::invalid_argument(
+          "StreamingInferenceSession - TDSBlock normalizing over time "
+          "can't be streamed");
+    }
+  }
+  int leftPad = 0;
+  int rightPad = 0;
+  std::shared_ptr<Conv2D> conv;
+  auto convBlock = std::dynamic_pointer_cast<Sequential>(tdsModules.at(0));
+  for (const auto& module : convBlock->modules()) {
+    if (auto padding = std::dynamic_pointer_cast<Padding>(module)) {
+      leftPad += padding->getPadding().at(0).first;
+      rightPad += padding->getPadding().at(0).second;
+    } else if (auto c = std::dynamic_pointer_cast<Conv2D>(module)) {
+      conv = c;
+    }
+  }
+  const int pad = convPadding(*conv);
+  return std::make_unique<TimeLocalLayer>(
+      tds, timeAxis, convExtent(*conv), 1, leftPad + pad, rightPad + pad);
+}
+
+std::unique_ptr<StreamingLayer> createLayer(
+    const std::shared_ptr<Module>& module,
+    int timeAxis,
+    const Variable& input,
+    int attentionLeftContext) {
+  if (std::dynamic_pointer_cast<Transformer>(module) ||
+      std::dynamic_pointer_cast<Conformer>(module)) {
+    checkTimeAxis(*module, timeAxis, 1);
+    return std::make_unique<AttentionLayer>(
+        module, timeAxis, attentionLeftContext);
+  }
+  if (auto rnn = std::dynamic_pointer_cast<RNN>(module)) {
+    checkTimeAxis(*module, timeAxis, 1);
+    if (rnn->isBidirectional()) {
+      throw std::invalid_argument(
+          "StreamingInferenceSession - bidirectional RNNs can't be streamed");
+    }
+    return std::make_unique<RnnLayer>(rnn, timeAxis);
+  }
+  if (auto tds = std::dynamic_pointer_cast<TDSBlock>(module)) {
+    return createTdsLayer(tds, timeAxis);
+  }
+  auto inner = module;
+  if (auto weightNorm = std::dynamic_pointer_cast<WeightNorm>(module)) {
+    inner = weightNorm->module();
+  }
+  if (auto conv = std::dynamic_pointer_cast<Conv2D>(inner)) {
+    return createTimeLocalLayer(module, conv, timeAxis);
+  }
+  if (auto padding = std::dynamic_pointer_cast<Padding>(module)) {
+    auto pads = padding->getPadding();
+    if (timeAxis < static_cast<int>(pads.size())) {
+      return std::make_unique<TimeLocalLayer>(
+          module, timeAxis, 1, 1, pads[timeAxis].first, pads[timeAxis].second);
+    }
+    return std::make_unique<FrameLayer>(module, timeAxis, input);
+  }
+  if (auto norm = std::dynamic_pointer_cast<LayerNorm>(module)) {
+    auto axis = norm->getAxis();
+    if (std::find(axis.begin(), axis.end(), timeAxis) != axis.end()) {
+      throw std::invalid_argument(
+          "StreamingInferenceSession - LayerNorm normalizing over time "
+          "can't be streamed");
+    }
+  }
+  if (std::dynamic_pointer_cast<Pool2D>(module) ||
+      std::dynamic_pointer_cast<Container>(module)) {
+    throw std::invalid_argument(
+        "StreamingInferenceSession - unsupported module " +
+        module->prettyString());
+  }
+  return std::make_unique<FrameLayer>(module, timeAxis, input);
+}
+
+void flatten(
+    const std::shared_ptr<Module>& module,
+    std::vector<std::shared_ptr<Module>>& modules) {
+  if (auto sequential = std::dynamic_pointer_cast<Sequential>(module)) {
+    for (const auto& child : sequential->modules()) {
+      flatten(child, modules);
+    }
+  } else {
+    modules.push_back(module);
+  }
+}
+
+} // namespace
+
+} // namespace detail
+
+StreamingInferenceSession::StreamingInferenceSession(
+    std::shared_ptr<fl::Module> network,
+    int attentionLeftContext)
+    : attentionLeftContext_(attentionLeftContext) {
+  if (attentionLeftContext_ <= 0) {
+    throw std::invalid_argument(
+        "StreamingInferenceSession - attentionLeftContext must be positive");
+  }
+  detail::flatten(network, modules_);
+  layers_.resize(modules_.size());
+}
+
+StreamingInferenceSession::~StreamingInferenceSession() = default;
+
+Tensor StreamingInferenceSession::accept(const Tensor& features) {
+  return forward(features, /* last = */ false);
+}
+
+Tensor StreamingInferenceSession::accept(
+    const std::vector<float>& features,
+    int numFeatures) {
+  if (features.empty()) {
+    return Tensor();
+  }
+  const Dim frames = features.size() / numFeatures;
+  return accept(fl::transpose(
+      Tensor::fromVector({numFeatures, frames}, features), {1, 0}));
+}
+
+Tensor StreamingInferenceSession::finish(const Tensor& features) {
+  return forward(features, /* last = */ true);
+}
+
+Tensor StreamingInferenceSession::finish(
+    const std::vector<float>& features,
+    int numFeatures) {
+  if (features.empty()) {
+    return finish();
+  }
+  const Dim frames = features.size() / numFeatures;
+  return finish(fl::transpose(
+      Tensor::fromVector({numFeatures, frames}, features), {1, 0}));
+}
+
+void StreamingInferenceSession::reset() {
+  for (auto& layer : layers_) {
+    if (layer) {
+      layer->reset();
+    }
+  }
+  numFramesEmitted_ = 0;
+  finished_ = false;
+}
+
+int64_t StreamingInferenceSession::numFramesEmitted() const {
+  return numFramesEmitted_;
+}
+
+Tensor StreamingInferenceSession::forward(const Tensor& features, bool last) {
+  if (finished_) {
+    throw std::logic_error(
+        "StreamingInferenceSession - the stream has ended; call reset() "
+        "before accepting more features");
+  }
+  finished_ = last;
+
+  Variable x;
+  if (!features.isEmpty() && features.dim(0) > 0) {
+    const Dim frames = features.dim(0);
+    x = Variable(
+        fl::reshape(features, {frames, features.elements() / frames, 1, 1}),
+        false);
+  }
+  int timeAxis = 0;
+  for (size_t i = 0; i < modules_.size(); ++i) {
+    auto& layer = layers_[i];
+    if (!layer) {
+      if (x.isEmpty()) {
+        // No frame has reached this layer yet
+        return Tensor();
+      }
+      layer =
+          detail::createLayer(modules_[i], timeAxis, x, attentionLeftContext_);
+    }
+    x = layer->forward(x, last);
+    timeAxis = layer->outputTimeAxis();
+    if (x.isEmpty() && !last) {
+      return Tensor();
+    }
+  }
+  if (x.isEmpty()) {
+    return Tensor();
+  }
+  if (timeAxis != 1) {
+    throw std::invalid_argument(
+        "StreamingInferenceSession - expects N x T emissions but the network "
+        "outputs time along axis " +
+        std::to_string(timeAxis));
+  }
+  numFramesEmitted_ += x.dim(1);
+  return fl::reshape(x.tensor(), {x.dim(0), x.dim(1)});
+}
+
+} // namespace speech
+} // namespace pkg
+} // namespace fl
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "flashlight/fl/flashlight.h"
+
+namespace fl {
+namespace pkg {
+namespace speech {
+
+namespace detail {
+
+/**
+ * The state of one layer of a `StreamingInferenceSession`.
+ */
+class StreamingLayer;
+
+} // namespace detail
+
+/**
+ * Runs an acoustic model over a stream of feature chunks, e.g. for live
+ * transcription, and returns the emissions of new frames as soon as they can
+ * be computed.
+ *
+ * The network is a `fl::Sequential` (nested ones are flattened) of the
+ * following layers, each of which keeps its own state between chunks:
+ * - time-local layers: `Conv2D`, `AsymmetricConv1D`, `TDSBlock` (normalizing
+ *   over [W, C] only), `Padding` and `WeightNorm` of convolutions. They keep
+ *   the input frames needed by their next outputs, and only emit outputs
+ *   whose receptive field is complete. Emissions are thus the same as for a
+ *   whole-utterance forward pass, delayed by the right context (look-ahead)
+ *   of the layers.
+ * - unidirectional `RNN`s, which keep their hidden and cell states.
+ * - `Transformer` and `Conformer` layers, which attend over a window of the
+ *   last `attentionLeftContext` input frames of the layer and the new frames.
+ *   Emissions match a whole-utterance forward pass for causal transformers
+ *   whose history fits in the window; otherwise, the window bounds the
+ *   context.
+ * - layers acting on each frame independently, like `Linear`, activations,
+ *   `Dropout`, `BatchNorm` or `LayerNorm` not normalizing over time, and
+ *   `View` and `Reorder`, which may move the time axis.
+ *
+ * The compute of each chunk only depends on the size of the chunk and on the
+ * context of the layers, not on the length of the stream. The network should
+ * be in eval mode.
+ *
+ * Features are T x C, normalized as for the whole-utterance network input;
+ * emissions are N x T'. With a `fl::lib::audio::StreamingFeaturizer`:
+ * \code
+   StreamingInferenceSession session(network);
+   while (...) {
+     auto feat = featurizer.accept(audioChunk);
+     auto emissions = session.accept(feat, featurizer.numFeatures());
+     // decode emissions
+   }
+   auto emissions =
+       session.finish(featurizer.finish(), featurizer.numFeatures());
+ * \endcode
+ */
+class StreamingInferenceSession {
+ public:
+  static constexpr int kDefaultAttentionLeftContext = 128;
+
+  /**
+   * @param[in] network the acoustic model
+   * @param[in] attentionLeftContext the number of past input frames
+   * `Transformer` and `Conformer` layers attend to
+   */
+  explicit StreamingInferenceSession(
+      std::shared_ptr<fl::Module> network,
+      int attentionLeftContext = kDefaultAttentionLeftContext);
+
+  ~StreamingInferenceSession();
+
+  /**
+   * Processes the features of new frames.
+   *
+   * @param[in] features T x C features
+   * @return the N x T' emissions of the frames which became available, or an
+   * empty tensor if there are none
+   */
+  Tensor accept(const Tensor& features);
+
+  /**
+   * Processes column-major C x T features, as returned by
+   * `fl::lib::audio::StreamingFeaturizer`.
+   */
+  Tensor accept(const std::vector<float>& features, int numFeatures);
+
+  /**
+   * Ends the stream and returns the emissions of the remaining frames.
+   * `reset` must be called before accepting more features.
+   *
+   * @param[in] features T x C features of the last frames, if any
+   */
+  Tensor finish(const Tensor& features = Tensor());
+
+  /**
+   * Processes the last column-major C x T features and ends the stream.
+   */
+  Tensor finish(const std::vector<float>& features, int numFeatures);
+
+  /**
+   * Clears the state of all layers to start a new stream.
+   */
+  void reset();
+
+  /**
+   * @return the number of emission frames returned since the start of the
+   * stream
+   */
+  int64_t numFramesEmitted() const;
+
+ private:
+  Tensor forward(const Tensor& features, bool last);
+
+  std::vector<std::shared_ptr<fl::Module>> modules_;
+  // Created on the first frames reaching each module, when the shape of its
+  // input is known
+  std::vector<std::unique_ptr<detail::StreamingLayer>> layers_;
+  int attentionLeftContext_;
+  int64_t numFramesEmitted_{0};
+  bool finished_{false};
+};
+
+} // namespace speech
+} // namespace pkg
+} // namespace fl
@@ -12,3 +12,4 @@
 #include "flashlight/pkg/speech/runtime/Logger.h"
 #include "flashlight/pkg/speech/runtime/Optimizer.h"
 #include "flashlight/pkg/speech/runtime/SpeechStatMeter.h"
+#include "flashlight/pkg/speech/runtime/StreamingInference.h"
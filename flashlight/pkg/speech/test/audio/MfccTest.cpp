@@ -11,6 +11,7 @@
 #include <iostream>
 #include <iterator>
 #include <sstream>
+#include <thread>
 
 #include "flashlight/fl/common/Filesystem.h"
 #include "flashlight/pkg/speech/audio/feature/FeatureParams.h"
@@ -173,6 +174,35 @@ TEST(MfccTest, BatchingTest2) {
   }
 }
 
+TEST(MfccTest, ConcurrentApplyTest) {
+  // Long enough to use both the batched and the single-frame FFT paths
+  int T = 16000 * 2 + 1234;
+  int nThreads = 8;
+  FeatureParams featparams;
+  Mfcc mfcc(featparams);
+  std::vector<std::vector<float>> inputs, expected;
+  for (int i = 0; i < nThreads; ++i) {
+    inputs.push_back(randVec<float>(T));
+    expected.push_back(mfcc.apply(inputs.back()));
+  }
+
+  std::vector<std::vector<float>> outputs(nThreads);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < nThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      for (int rep = 0; rep < 5; ++rep) {
+        outputs[i] = mfcc.apply(inputs[i]);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (int i = 0; i < nThreads; ++i) {
+    ASSERT_TRUE(compareVec<float>(outputs[i], expected[i], 1E-4));
+  }
+}
+
 TEST(MfccTest, EmptyTest) {
   std::vector<float> input;
   FeatureParams featparams;
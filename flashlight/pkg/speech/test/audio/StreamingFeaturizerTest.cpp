@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <gtest/gtest.h>
+
+#include "flashlight/pkg/speech/audio/feature/FeatureParams.h"
+#include "flashlight/pkg/speech/audio/feature/StreamingFeaturizer.h"
+#include "flashlight/pkg/speech/test/audio/TestUtils.h"
+
+using namespace fl::lib::audio;
+
+namespace {
+
+// Feeds input in chunks of the given sizes (cycled) and concatenates outputs
+template <class Featurizer>
+std::vector<float> streamingApply(
+    StreamingFeaturizer<Featurizer>& featurizer,
+    const std::vector<float>& input,
+    const std::vector<int>& chunkSizes) {
+  std::vector<float> output;
+  size_t pos = 0;
+  for (size_t i = 0; pos < input.size(); ++i) {
+    size_t size = std::min<size_t>(
+        chunkSizes[i % chunkSizes.size()], input.size() - pos);
+    auto feat = featurizer.accept(std::vector<float>(
+        input.begin() + pos, input.begin() + pos + size));
+    EXPECT_EQ(feat.size() % featurizer.numFeatures(), 0);
+    output.insert(output.end(), feat.begin(), feat.end());
+    pos += size;
+  }
+  auto feat = featurizer.finish();
+  output.insert(output.end(), feat.begin(), feat.end());
+  return output;
+}
+
+template <class Featurizer>
+void checkMatchesFullUtterance(const FeatureParams& params) {
+  auto input = randVec<float>(16000);
+  Featurizer full(params);
+  auto expected = full.apply(input);
+
+  StreamingFeaturizer<Featurizer> featurizer(params);
+  for (const auto& chunkSizes : std::vector<std::vector<int>>{
+           {160}, {1, 7, 300, 1000}, {3000}, {16000}}) {
+    featurizer.reset();
+    auto output = streamingApply(featurizer, input, chunkSizes);
+    ASSERT_EQ(featurizer.numFramesEmitted(), params.numFrames(input.size()));
+    ASSERT_TRUE(compareVec<float>(output, expected, 1E-4));
+  }
+}
+
+} // namespace
+
+TEST(StreamingFeaturizerTest, PowerSpectrum) {
+  FeatureParams params;
+  checkMatchesFullUtterance<PowerSpectrum>(params);
+}
+
+TEST(StreamingFeaturizerTest, Mfsc) {
+  FeatureParams params;
+  params.numFilterbankChans = 40;
+  checkMatchesFullUtterance<Mfsc>(params);
+
+  params.accWindow = 0;
+  checkMatchesFullUtterance<Mfsc>(params);
+
+  params.deltaWindow = 0;
+  checkMatchesFullUtterance<Mfsc>(params);
+}
+
+TEST(StreamingFeaturizerTest, Mfcc) {
+  FeatureParams params;
+  params.deltaWindow = 9;
+  params.accWindow = 3;
+  checkMatchesFullUtterance<Mfcc>(params);
+}
+
+TEST(StreamingFeaturizerTest, Latency) {
+  FeatureParams params;
+  StreamingFeaturizer<Mfsc> featurizer(params);
+  int stride = params.numFrameStrideSamples();
+  int delay = params.deltaWindow + params.accWindow;
+
+  // Nothing is emitted until the derivatives have enough right context
+  auto feat = featurizer.accept(randVec<float>(
+      params.numFrameSizeSamples() + (delay - 1) * stride));
+  ASSERT_TRUE(feat.empty());
+  feat = featurizer.accept(randVec<float>(stride));
+  ASSERT_EQ(feat.size(), featurizer.numFeatures());
+
+  // Then one frame is emitted per stride of samples
+  for (int i = 0; i < 100; ++i) {
+    feat = featurizer.accept(randVec<float>(stride));
+    ASSERT_EQ(feat.size(), featurizer.numFeatures());
+  }
+  feat = featurizer.finish();
+  ASSERT_EQ(feat.size(), delay * featurizer.numFeatures());
+  ASSERT_THROW(featurizer.accept(randVec<float>(stride)), std::logic_error);
+}
+
+TEST(StreamingFeaturizerTest, ShortStream) {
+  FeatureParams params;
+  StreamingFeaturizer<Mfcc> featurizer(params);
+  ASSERT_TRUE(featurizer.accept(randVec<float>(10)).empty());
+  ASSERT_TRUE(featurizer.finish().empty());
+
+  // A single frame still gets (zero) derivatives
+  featurizer.reset();
+  featurizer.accept(randVec<float>(params.numFrameSizeSamples()));
+  auto feat = featurizer.finish();
+  ASSERT_EQ(feat.size(), featurizer.numFeatures());
+  Mfcc full(params);
+  ASSERT_EQ(
+      featurizer.numFeatures(),
+      full.outputSize(params.numFrameSizeSamples()));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -115,6 +115,50 @@ TEST(ReverbEcho, SinWaveReverb) {
   EXPECT_THAT(noiseMain, Pointwise(FloatNearPointwise(0.1), noiseSrc));
 }
 
+/**
+ * Test that the reverberation matches a time-domain implementation which adds
+ * every echo separately, with the same random echo delays and attenuations.
+ */
+TEST(ReverbEcho, MatchesEchoSum) {
+  ReverbEcho::Config conf;
+  conf.proba_ = 1.0f;
+  const unsigned int seed = 1234;
+  const size_t length = 16000;
+
+  RandomNumberGenerator rng(seed);
+  std::vector<float> signal(length);
+  for (auto& x : signal) {
+    x = rng.uniform(-1, 1);
+  }
+
+  // Reference: replay the random draws of ReverbEcho::apply()
+  RandomNumberGenerator refRng(seed);
+  refRng.random();
+  float initial = refRng.uniform(conf.initialMin_, conf.initialMax_);
+  float firstDelay = refRng.uniform(conf.firstDelayMin_, conf.firstDelayMax_);
+  float rt60 = refRng.uniform(conf.rt60Min_, conf.rt60Max_);
+  std::vector<float> expected = signal;
+  for (int r = 0; r < conf.repeat_; ++r) {
+    float frac = 1;
+    while (frac > 1e-3) {
+      float jitter = 1 + refRng.uniform(-conf.jitter_, conf.jitter_);
+      size_t delay = 1 + int(jitter * firstDelay * conf.sampleRate_);
+      if (delay > length - 1) {
+        break;
+      }
+      for (int j = 0; j < length - delay - 1; ++j) {
+        expected[delay + j] += signal[j] * initial * frac;
+      }
+      jitter = 1 + refRng.uniform(-conf.jitter_, conf.jitter_);
+      frac *= std::pow(10, -3 * jitter * firstDelay / rt60);
+    }
+  }
+
+  ReverbEcho sfx(conf, seed);
+  sfx.apply(signal);
+  EXPECT_THAT(signal, Pointwise(FloatNearPointwise(1e-3), expected));
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   fl::init();
@@ -144,6 +144,31 @@ TEST(SoundEffect, SfxChain) {
   EXPECT_THAT(signal, Each(AllOf(Ge(-amplitude), Le(amplitude))));
 }
 
+TEST(SoundEffectUtil, FftConvolve) {
+  RandomNumberGenerator rng;
+  for (int len : {1, 7, 100, 1000}) {
+    for (int kernelLen : {1, 5, len, 2 * len}) {
+      std::vector<float> signal(len), kernel(kernelLen);
+      for (auto& x : signal) {
+        x = rng.uniform(-1, 1);
+      }
+      for (auto& x : kernel) {
+        x = rng.uniform(-1, 1);
+      }
+      std::vector<float> output;
+      fftConvolve(signal, kernel, output);
+      ASSERT_EQ(output.size(), len);
+      for (int n = 0; n < len; ++n) {
+        float expected = 0;
+        for (int k = 0; k <= n && k < kernelLen; ++k) {
+          expected += kernel[k] * signal[n - k];
+        }
+        ASSERT_NEAR(output[n], expected, 1e-4);
+      }
+    }
+  }
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   fl::init();
@@ -5,6 +5,8 @@
  * LICENSE file in the root directory of this source tree.
  */
 
+#include <algorithm>
+
 #include <gtest/gtest.h>
 
 #include "flashlight/fl/flashlight.h"
@@ -141,6 +143,99 @@ TEST(Seq2SeqTest, Seq2SeqBeamSearchViterbi) {
   }
 }
 
+TEST(Seq2SeqTest, Seq2SeqBatchBeamSearch) {
+  int nclass = 40;
+  int hiddendim = 64;
+  int inputsteps = 64;
+  int batchsize = 3;
+  int beamsize = 4;
+  int maxoutputlen = 30;
+  int eos = nclass - 2;
+
+  fl::setSeed(1);
+  Seq2SeqCriterion seq2seq(
+      nclass,
+      hiddendim,
+      eos /* eos token index */,
+      nclass - 1 /* pad token index */,
+      maxoutputlen,
+      {std::make_shared<ContentAttention>()});
+  // Make eos likely, so that hypotheses complete and the search stops early
+  auto bias = seq2seq.linearOut()->param(1).tensor().copy();
+  bias(eos) = bias(eos) + 2;
+  seq2seq.linearOut()->setParams(fl::Variable(bias, true), 1);
+
+  // Padded inputs of different lengths
+  std::vector<int> lengths = {inputsteps, inputsteps / 2, inputsteps * 3 / 4};
+  auto input =
+      fl::randn({hiddendim, inputsteps, batchsize}, fl::dtype::f32);
+  for (int b = 0; b < batchsize; b++) {
+    if (lengths[b] < inputsteps) {
+      input(fl::span, fl::range(lengths[b], inputsteps), b) = 0;
+    }
+  }
+  auto inputSizes = Tensor::fromVector({1, batchsize}, lengths);
+  auto paths = seq2seq.batchBeamPath(input, inputSizes, beamsize);
+  ASSERT_EQ(paths.size(), batchsize);
+
+  // Matches the best hypothesis of the per-utterance beam search
+  for (int b = 0; b < batchsize; b++) {
+    std::vector<Seq2SeqCriterion::CandidateHypo> beam(1);
+    auto hypos = seq2seq.beamSearch(
+        input(fl::span, fl::range(0, lengths[b]), fl::range(b, b + 1)),
+        Tensor::fromVector({1, 1}, std::vector<int>{lengths[b]}),
+        beam,
+        beamsize,
+        maxoutputlen);
+    auto best = std::max_element(
+        hypos.begin(),
+        hypos.end(),
+        [](const auto& lhs, const auto& rhs) { return lhs.score < rhs.score; });
+    ASSERT_EQ(paths[b], best->path);
+    // Reached eos before the maximum length
+    ASSERT_LT(paths[b].size(), maxoutputlen);
+  }
+}
+
+TEST(Seq2SeqTest, TransformerBatchBeamSearch) {
+  int nclass = 40;
+  int hiddendim = 64;
+  int inputsteps = 50;
+  int batchsize = 3;
+  int maxoutputlen = 30;
+
+  TransformerCriterion transformer(
+      nclass,
+      hiddendim,
+      nclass - 2 /* eos token index */,
+      nclass - 1 /* pad token index */,
+      maxoutputlen,
+      2 /* nLayer */,
+      std::make_shared<ContentAttention>(),
+      nullptr /* window */,
+      false /* trainWithWindow */,
+      0.0 /* labelSmooth */,
+      1.0 /* pctTeacherForcing */,
+      0.0 /* pDropout */,
+      0.0 /* pLayerDrop */);
+
+  auto input =
+      fl::randn({hiddendim, inputsteps, batchsize}, fl::dtype::f32);
+  auto inputSizes = fl::full({1, batchsize}, inputsteps, fl::dtype::s32);
+  // A beam of one is the per-utterance greedy decoding
+  auto paths = transformer.batchBeamPath(input, inputSizes, 1);
+  ASSERT_EQ(paths.size(), batchsize);
+  for (int b = 0; b < batchsize; b++) {
+    auto viterbipath = transformer.viterbiPath(
+        input(fl::span, fl::span, fl::range(b, b + 1)),
+        inputSizes(fl::span, fl::range(b, b + 1)));
+    ASSERT_EQ(paths[b].size(), viterbipath.elements());
+    for (int idx = 0; idx < paths[b].size(); idx++) {
+      ASSERT_EQ(paths[b][idx], viterbipath(idx).scalar<int>());
+    }
+  }
+}
+
 TEST(Seq2SeqTest, Seq2SeqMedianWindow) {
   int nclass = 40;
   int hiddendim = 256;
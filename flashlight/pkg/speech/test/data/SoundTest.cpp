@@ -158,6 +158,65 @@ TEST(SoundTest, StreamReadWrite) {
   }
 }
 
+TEST(SoundTest, ReaderRange) {
+  auto audiopath = loadPath / "test_stereo.wav";
+  auto full = loadSound<float>(audiopath);
+
+  SoundReader reader(audiopath);
+  ASSERT_EQ(reader.info().channels, 2);
+  ASSERT_EQ(reader.info().frames, 24576);
+
+  const int64_t offset = 1000;
+  const int64_t frames = 512;
+  reader.seek(offset);
+  std::vector<float> buf(frames * reader.info().channels);
+  ASSERT_EQ(reader.read(buf.data(), frames), frames);
+  for (int64_t i = 0; i < buf.size(); ++i) {
+    ASSERT_EQ(buf[i], full[offset * 2 + i]);
+  }
+
+  // Reads past the end are truncated
+  reader.seek(reader.info().frames - 10);
+  ASSERT_EQ(reader.read(buf), 10);
+  ASSERT_EQ(buf.size(), 20);
+  ASSERT_THROW(reader.seek(reader.info().frames + 1), std::invalid_argument);
+
+  // Buffers are reused rather than reallocated
+  std::vector<float> out;
+  out.reserve(full.size());
+  auto* data = out.data();
+  auto info = loadSoundInto(audiopath, out, offset, frames);
+  ASSERT_EQ(info.frames, frames);
+  ASSERT_EQ(out.size(), frames * 2);
+  ASSERT_EQ(out.data(), data);
+  ASSERT_EQ(out[0], full[offset * 2]);
+}
+
+TEST(SoundTest, BatchReader) {
+  auto monopath = loadPath / "test_mono.wav";
+  auto stereopath = loadPath / "test_stereo.wav";
+  auto mono = loadSound<short>(monopath);
+  auto stereo = loadSound<short>(stereopath);
+
+  SoundBatchReader batchReader(2);
+  std::vector<std::vector<short>> buffers;
+  auto infos = batchReader.read(
+      {{monopath, 0, -1}, {stereopath, 100, 50}, {monopath, 24000, 1000}},
+      buffers);
+  ASSERT_EQ(buffers.size(), 3);
+  ASSERT_EQ(infos[0].frames, 24576);
+  ASSERT_EQ(buffers[0], mono);
+  ASSERT_EQ(infos[1].frames, 50);
+  ASSERT_EQ(infos[1].channels, 2);
+  ASSERT_TRUE(std::equal(
+      buffers[1].begin(), buffers[1].end(), stereo.begin() + 200));
+  ASSERT_EQ(infos[2].frames, 576);
+
+  ASSERT_THROW(
+      batchReader.read({{monopath, 0, -1}, {"/does/not/exist"}}, buffers),
+      std::runtime_error);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   fl::init();
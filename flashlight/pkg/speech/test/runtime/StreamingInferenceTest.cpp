@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "flashlight/fl/contrib/modules/modules.h"
+#include "flashlight/fl/flashlight.h"
+#include "flashlight/pkg/speech/runtime/StreamingInference.h"
+
+using namespace fl;
+using fl::pkg::speech::StreamingInferenceSession;
+
+namespace {
+
+constexpr int kNumFeatures = 6;
+constexpr int kNumFrames = 37;
+
+// Streams the features in chunks of the given sizes and concatenates the
+// emissions
+Tensor stream(
+    StreamingInferenceSession& session,
+    const Tensor& features,
+    const std::vector<int>& chunkSizes) {
+  std::vector<Tensor> emissions;
+  int start = 0;
+  for (size_t i = 0; start < features.dim(0); ++i) {
+    int end = std::min<int>(
+        start + chunkSizes[i % chunkSizes.size()], features.dim(0));
+    auto emission = session.accept(features(fl::range(start, end)));
+    if (!emission.isEmpty()) {
+      emissions.push_back(emission);
+    }
+    start = end;
+  }
+  auto emission = session.finish();
+  if (!emission.isEmpty()) {
+    emissions.push_back(emission);
+  }
+  return fl::concatenate(emissions, 1);
+}
+
+void checkStreaming(
+    const std::shared_ptr<Module>& network,
+    const Tensor& expected,
+    const Tensor& features) {
+  StreamingInferenceSession session(network, /* attentionLeftContext = */ 64);
+  for (const auto& chunkSizes :
+       std::vector<std::vector<int>>{{1}, {4}, {3, 7, 1}, {kNumFrames}}) {
+    session.reset();
+    auto emissions = stream(session, features, chunkSizes);
+    ASSERT_EQ(emissions.shape(), expected.shape());
+    ASSERT_TRUE(allClose(emissions, expected, 1e-4));
+    ASSERT_EQ(session.numFramesEmitted(), expected.dim(1));
+  }
+}
+
+} // namespace
+
+TEST(StreamingInferenceTest, TimeLocalAndRecurrentLayers) {
+  auto network = std::make_shared<Sequential>();
+  // T x C x 1 x B -> T x 1 x C x B
+  network->add(View({-1, 1, kNumFeatures, 0}));
+  network->add(Conv2D(kNumFeatures, 8, 5, 1, 1, 1, PaddingMode::SAME, 0));
+  network->add(ReLU());
+  network->add(WeightNorm(Conv2D(8, 8, 3, 1, 2, 1, 1, 0), 3));
+  network->add(AsymmetricConv1D(8, 8, 5, 1, PaddingMode::SAME, 0.25));
+  network->add(TDSBlock(8, 3, 1, 0, 0, /* rightPadding = */ 1, false));
+  network->add(TDSBlock(8, 5, 1, 0, 0, /* rightPadding = */ -1, false));
+  // T x 1 x C x B -> C x T x B
+  network->add(Reorder({2, 0, 3, 1}));
+  network->add(RNN(8, 8, 1, RnnMode::LSTM));
+  network->add(Linear(8, 10));
+  network->eval();
+
+  auto features = fl::rand({kNumFrames, kNumFeatures});
+  auto input = Variable(
+      fl::reshape(features, {kNumFrames, kNumFeatures, 1, 1}), false);
+  auto expected = network->forward({input}).front().tensor();
+  expected = fl::reshape(expected, {expected.dim(0), expected.dim(1)});
+  checkStreaming(network, expected, features);
+}
+
+TEST(StreamingInferenceTest, CausalTransformer) {
+  auto network = std::make_shared<Sequential>();
+  // T x C x 1 x B -> C x T x B
+  network->add(Reorder({1, 0, 2, 3}));
+  network->add(View({kNumFeatures, -1, 1}));
+  network->add(Transformer(kNumFeatures, 4, 16, 2, 0, 0, 0, true));
+  network->add(Linear(kNumFeatures, 10));
+  network->eval();
+
+  auto features = fl::rand({kNumFrames, kNumFeatures});
+  auto x = Variable(
+      fl::reshape(features, {kNumFrames, kNumFeatures, 1, 1}), false);
+  for (const auto& module : network->modules()) {
+    if (std::dynamic_pointer_cast<Transformer>(module)) {
+      x = module->forward({x, Variable()}).front();
+    } else {
+      x = module->forward({x}).front();
+    }
+  }
+  auto expected = fl::reshape(x.tensor(), {x.dim(0), x.dim(1)});
+  checkStreaming(network, expected, features);
+}
+
+TEST(StreamingInferenceTest, UnsupportedLayers) {
+  auto network = std::make_shared<Sequential>();
+  network->add(Reorder({1, 0, 2, 3}));
+  network->add(View({kNumFeatures, -1, 1}));
+  network->add(RNN(kNumFeatures, 8, 1, RnnMode::LSTM, true));
+  network->eval();
+
+  StreamingInferenceSession session(network);
+  ASSERT_THROW(
+      session.accept(fl::rand({4, kNumFeatures})), std::invalid_argument);
+  ASSERT_THROW(
+      StreamingInferenceSession(network, /* attentionLeftContext = */ 0),
+      std::invalid_argument);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  fl::init();
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include "flashlight/pkg/vision/dataset/FusedTransforms.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "flashlight/pkg/vision/dataset/LoaderDataset.h"
+
+namespace {
+
+float randomFloat(float a, float b) {
+  float r = static_cast<float>(std::rand()) / static_cast<float>(RAND_MAX);
+  return a + (b - a) * r;
+}
+
+fl::pkg::vision::CropBox squareCenterBox(int w, int h, int side) {
+  side = std::max(1, std::min(side, std::min(w, h)));
+  const int x = std::round((static_cast<float>(w) - side) / 2.);
+  const int y = std::round((static_cast<float>(h) - side) / 2.);
+  return {x, y, side, side};
+}
+
+// Bilinear sampling positions along one axis, using the half-pixel
+// convention so that an identity resize samples every source pixel exactly.
+void bilinearTable(
+    int srcSize,
+    int dstSize,
+    bool reverse,
+    std::vector<int>& idx0,
+    std::vector<int>& idx1,
+    std::vector<float>& frac) {
+  idx0.resize(dstSize);
+  idx1.resize(dstSize);
+  frac.resize(dstSize);
+  const float scale = static_cast<float>(srcSize) / dstSize;
+  for (int i = 0; i < dstSize; ++i) {
+    float pos = (i + 0.5f) * scale - 0.5f;
+    pos = std::min(std::max(pos, 0.f), static_cast<float>(srcSize - 1));
+    const int i0 = static_cast<int>(pos);
+    const int o = reverse ? dstSize - 1 - i : i;
+    idx0[o] = i0;
+    idx1[o] = std::min(i0 + 1, srcSize - 1);
+    frac[o] = pos - i0;
+  }
+}
+
+} // namespace
+
+namespace fl {
+namespace pkg {
+namespace vision {
+
+CropSampler centerCropSampler(const int resize, const int size) {
+  return [resize, size](int w, int h) {
+    const float scale = static_cast<float>(std::min(w, h)) / resize;
+    return squareCenterBox(w, h, std::round(size * scale));
+  };
+}
+
+CropSampler
+randomResizeCropSampler(const int low, const int high, const int size) {
+  return [low, high, size](int w, int h) {
+    const int resize = low + (high - low) * randomFloat(0, 1);
+    const float scale = static_cast<float>(std::min(w, h)) / resize;
+    const int side = std::max(
+        1, std::min<int>(std::round(size * scale), std::min(w, h)));
+    const int x = std::rand() % (w - side + 1);
+    const int y = std::rand() % (h - side + 1);
+    return CropBox{x, y, side, side};
+  };
+}
+
+CropSampler randomResizedCropSampler(
+    const float scaleLow,
+    const float scaleHigh,
+    const float ratioLow,
+    const float ratioHigh) {
+  return [=](int w, int h) {
+    const float area = w * h;
+    for (int i = 0; i < 10; i++) {
+      const float scale = randomFloat(scaleLow, scaleHigh);
+      const float logRatio =
+          randomFloat(std::log(ratioLow), std::log(ratioHigh));
+      const float targetArea = scale * area;
+      const float targetRatio = std::exp(logRatio);
+      const int tw = std::round(std::sqrt(targetArea * targetRatio));
+      const int th = std::round(std::sqrt(targetArea / targetRatio));
+      if (0 < tw && tw <= w && 0 < th && th <= h) {
+        const int x = std::rand() % (w - tw + 1);
+        const int y = std::rand() % (h - th + 1);
+        return CropBox{x, y, tw, th};
+      }
+    }
+    return squareCenterBox(w, h, std::min(w, h));
+  };
+}
+
+void cropResizeNormalize(
+    const uint8_t* img,
+    const int w,
+    const int h,
+    const int c,
+    const CropBox& box,
+    const int outW,
+    const int outH,
+    const bool flip,
+    const std::vector<float>& mean,
+    const std::vector<float>& std,
+    float* out) {
+  if (box.x < 0 || box.y < 0 || box.w <= 0 || box.h <= 0 ||
+      box.x + box.w > w || box.y + box.h > h) {
+    throw std::invalid_argument(
+        "cropResizeNormalize: crop box is outside of the image");
+  }
+  if (outW <= 0 || outH <= 0) {
+    throw std::invalid_argument("cropResizeNormalize: invalid output size");
+  }
+  if (mean.size() != std.size() ||
+      (!mean.empty() && mean.size() != static_cast<size_t>(c))) {
+    throw std::invalid_argument(
+        "cropResizeNormalize: mean and std must have one value per channel");
+  }
+
+  // Shrink by a power of two with a box filter while the crop stays at least
+  // as large as the output; the bilinear pass then only ever interpolates
+  // between neighbouring pixels of a similarly sized image.
+  int k = 1;
+  while (box.w / (2 * k) >= outW && box.h / (2 * k) >= outH) {
+    k *= 2;
+  }
+  const int sw = box.w / k;
+  const int sh = box.h / k;
+  const float boxScale = 1.f / (k * k);
+
+  // Planar float copy of the (reduced) crop
+  thread_local std::vector<float> src;
+  thread_local std::vector<float> accum;
+  src.resize(static_cast<size_t>(sw) * sh * c);
+  accum.resize(static_cast<size_t>(sw) * c);
+  const int rowLen = sw * c;
+  for (int y = 0; y < sh; ++y) {
+    std::fill(accum.begin(), accum.end(), 0.f);
+    for (int dy = 0; dy < k; ++dy) {
+      const uint8_t* row =
+          img + (static_cast<size_t>(box.y + y * k + dy) * w + box.x) * c;
+      for (int dx = 0; dx < k; ++dx) {
+        const uint8_t* p = row + dx * c;
+        if (k == 1) {
+          for (int i = 0; i < rowLen; ++i) {
+            accum[i] += p[i];
+          }
+        } else {
+          for (int x = 0; x < sw; ++x) {
+            for (int ch = 0; ch < c; ++ch) {
+              accum[x * c + ch] += p[x * k * c + ch];
+            }
+          }
+        }
+      }
+    }
+    for (int ch = 0; ch < c; ++ch) {
+      float* dst = src.data() + (static_cast<size_t>(ch) * sh + y) * sw;
+      for (int x = 0; x < sw; ++x) {
+        dst[x] = accum[x * c + ch] * boxScale;
+      }
+    }
+  }
+
+  thread_local std::vector<int> x0, x1, y0, y1;
+  thread_local std::vector<float> wx, wy;
+  bilinearTable(sw, outW, flip, x0, x1, wx);
+  bilinearTable(sh, outH, /* reverse = */ false, y0, y1, wy);
+
+  // Interpolate, then apply (v / 255 - mean) / std as a single affine map
+  for (int ch = 0; ch < c; ++ch) {
+    float a = 1.f;
+    float b = 0.f;
+    if (!mean.empty()) {
+      a = 1.f / (255.f * std[ch]);
+      b = -mean[ch] / std[ch];
+    }
+    const float* plane = src.data() + static_cast<size_t>(ch) * sh * sw;
+    for (int oy = 0; oy < outH; ++oy) {
+      const float* r0 = plane + static_cast<size_t>(y0[oy]) * sw;
+      const float* r1 = plane + static_cast<size_t>(y1[oy]) * sw;
+      const float fy = wy[oy];
+      float* dst = out + (static_cast<size_t>(ch) * outH + oy) * outW;
+      for (int ox = 0; ox < outW; ++ox) {
+        const float top = r0[x0[ox]] + wx[ox] * (r0[x1[ox]] - r0[x0[ox]]);
+        const float bot = r1[x0[ox]] + wx[ox] * (r1[x1[ox]] - r1[x0[ox]]);
+        dst[ox] = (top + fy * (bot - top)) * a + b;
+      }
+    }
+  }
+}
+
+Tensor loadJpegFused(const std::string& fp, const FusedImageOptions& options) {
+  const HostImage img = loadJpegHost(fp);
+  const CropBox box = options.cropSampler
+      ? options.cropSampler(img.width, img.height)
+      : CropBox{0, 0, img.width, img.height};
+  const bool flip =
+      options.flipProb > 0 && randomFloat(0, 1) < options.flipProb;
+  const int size = options.outputSize;
+  std::vector<float> buffer(static_cast<size_t>(size) * size * img.channels);
+  cropResizeNormalize(
+      img.data.get(),
+      img.width,
+      img.height,
+      img.channels,
+      box,
+      size,
+      size,
+      flip,
+      options.mean,
+      options.std,
+      buffer.data());
+  return Tensor::fromVector({size, size, img.channels}, buffer);
+}
+
+std::shared_ptr<Dataset> fusedJpegLoader(
+    std::vector<std::string> fps,
+    FusedImageOptions options) {
+  return std::make_shared<LoaderDataset<std::string>>(
+      fps, [options](const std::string& fp) {
+        std::vector<Tensor> result = {loadJpegFused(fp, options)};
+        return result;
+      });
+}
+
+} // namespace vision
+} // namespace pkg
+} // namespace fl
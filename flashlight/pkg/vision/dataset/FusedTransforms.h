@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flashlight/fl/dataset/datasets.h"
+#include "flashlight/pkg/vision/dataset/Jpeg.h"
+
+namespace fl {
+namespace pkg {
+namespace vision {
+
+/*
+ * A rectangular region of a source image in source pixel coordinates.
+ */
+struct CropBox {
+  int x;
+  int y;
+  int w;
+  int h;
+};
+
+/*
+ * Given the width and height of a decoded image, picks the region of it which
+ * is resized to the output size.
+ */
+using CropSampler = std::function<CropBox(int, int)>;
+
+/*
+ * Region equivalent to resizing the shortest edge of the image to
+ * @param resize, then taking a center crop of size @param size, i.e.
+ * compose({resizeTransform(resize), centerCropTransform(size)})
+ */
+CropSampler centerCropSampler(const int resize, const int size);
+
+/*
+ * Region equivalent to randomly resizing the shortest edge of the image
+ * between @param low and @param high, then taking a random crop of size
+ * @param size, i.e.
+ * compose({randomResizeTransform(low, high), randomCropTransform(size, size)})
+ */
+CropSampler
+randomResizeCropSampler(const int low, const int high, const int size);
+
+/*
+ * Region picked by randomResizeCropTransform for the same parameters.
+ */
+CropSampler randomResizedCropSampler(
+    const float scaleLow,
+    const float scaleHigh,
+    const float ratioLow,
+    const float ratioHigh);
+
+struct FusedImageOptions {
+  // Side length of the (square) output image
+  int outputSize;
+  CropSampler cropSampler;
+  // Probability to flip the output horizontally
+  float flipProb{0.};
+  // Per-channel mean and std as in normalizeImage. When empty, the output keeps
+  // the [0, 255] range of the input.
+  std::vector<float> mean;
+  std::vector<float> std;
+};
+
+/*
+ * Crops @param box from an interleaved 8-bit image, resizes it bilinearly to
+ * @param outW x @param outH, optionally flips it horizontally and normalizes
+ * it, writing W x H x C floats to @param out in a single pass over the output.
+ *
+ * When the crop is at least twice as large as the output, it is first
+ * box-filtered down by the largest power of two which keeps it larger than the
+ * output. This bounds the cost of the bilinear pass and avoids aliasing when
+ * shrinking large images.
+ */
+void cropResizeNormalize(
+    const uint8_t* img,
+    const int w,
+    const int h,
+    const int c,
+    const CropBox& box,
+    const int outW,
+    const int outH,
+    const bool flip,
+    const std::vector<float>& mean,
+    const std::vector<float>& std,
+    float* out);
+
+/*
+ * Decodes a jpeg and applies crop, resize, flip and normalization on the host
+ * in one step. Returns a W x H x C float tensor.
+ */
+Tensor loadJpegFused(const std::string& fp, const FusedImageOptions& options);
+
+/*
+ * Same as jpegLoader, but every sample goes through loadJpegFused.
+ */
+std::shared_ptr<Dataset> fusedJpegLoader(
+    std::vector<std::string> fps,
+    FusedImageOptions options);
+
+} // namespace vision
+} // namespace pkg
+} // namespace fl
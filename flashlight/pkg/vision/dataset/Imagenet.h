@@ -12,6 +12,7 @@
 
 #include "flashlight/fl/common/Filesystem.h"
 #include "flashlight/fl/dataset/datasets.h"
+#include "flashlight/pkg/vision/dataset/FusedTransforms.h"
 
 /**
  * Utilities for creating an ImageDataset with imagenet data
@@ -70,6 +71,26 @@ std::shared_ptr<Dataset> imagenetDataset(
     const std::unordered_map<std::string, uint64_t>& labelMap,
     std::vector<Dataset::TransformFunction> transformfns);
 
+/*
+ * Same as `imagenetDataset`, but images are decoded, cropped, resized, flipped
+ * and normalized on the host in a single pass as described by
+ * @param[fusedOptions]. @param[transformfns] are applied afterwards, for
+ * augmentations which have no fused equivalent.
+ * \code{.cpp}
+ * FusedImageOptions options;
+ * options.outputSize = 224;
+ * options.cropSampler = randomResizedCropSampler(0.08, 1.0, 3. / 4., 4. / 3.);
+ * options.flipProb = 0.5;
+ * options.mean = {0.485, 0.456, 0.406};
+ * options.std = {0.229, 0.224, 0.225};
+ * ds = fusedImagenetDataset(imagenetBase + "train", labels, options);
+ */
+std::shared_ptr<Dataset> fusedImagenetDataset(
+    const fs::path& imgDir,
+    const std::unordered_map<std::string, uint64_t>& labelMap,
+    const FusedImageOptions& fusedOptions,
+    std::vector<Dataset::TransformFunction> transformfns = {});
+
 constexpr uint64_t kImagenetInputIdx = 0;
 constexpr uint64_t kImagenetTargetIdx = 1;
 
@@ -8,6 +8,7 @@
 #include "flashlight/pkg/vision/dataset/Jpeg.h"
 
 #include <memory>
+#include <stdexcept>
 
 #include "flashlight/fl/dataset/datasets.h"
 #include "flashlight/pkg/vision/dataset/LoaderDataset.h"
@@ -42,6 +43,24 @@ Tensor loadJpeg(const std::string& fp, int desiredNumberOfChannels /* = 3 */) {
   }
 }
 
+HostImage loadJpegHost(
+    const std::string& fp,
+    int desiredNumberOfChannels /* = 3 */) {
+  int w, h, c;
+  unsigned char* img =
+      stbi_load(fp.c_str(), &w, &h, &c, desiredNumberOfChannels);
+  if (!img) {
+    throw std::invalid_argument("Could not load from filepath" + fp);
+  }
+  HostImage result;
+  result.width = w;
+  result.height = h;
+  result.channels = desiredNumberOfChannels;
+  result.data = std::shared_ptr<const uint8_t>(
+      img, [](const uint8_t* p) { stbi_image_free(const_cast<uint8_t*>(p)); });
+  return result;
+}
+
 std::shared_ptr<Dataset> jpegLoader(std::vector<std::string> fps) {
   return std::make_shared<LoaderDataset<std::string>>(
       fps, [](const std::string& fp) {
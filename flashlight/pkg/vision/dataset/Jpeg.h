@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
 #include "flashlight/fl/dataset/datasets.h"
@@ -15,8 +16,26 @@ namespace fl {
 namespace pkg {
 namespace vision {
 
+/*
+ * A decoded 8-bit image living in host memory. Channels are interleaved and
+ * rows are stored top to bottom, i.e. pixel (x, y) channel c is at
+ * data[(y * width + x) * channels + c].
+ */
+struct HostImage {
+  int width{0};
+  int height{0};
+  int channels{0};
+  std::shared_ptr<const uint8_t> data;
+};
+
 Tensor loadJpeg(const std::string& fp, int desiredNumberOfChannels = 3);
 
+/*
+ * Decodes a jpeg from filepath fp without creating a Tensor, so that host-side
+ * transforms can consume the pixels directly.
+ */
+HostImage loadJpegHost(const std::string& fp, int desiredNumberOfChannels = 3);
+
 std::shared_ptr<Dataset> jpegLoader(std::vector<std::string> fps);
 
 } // namespace vision
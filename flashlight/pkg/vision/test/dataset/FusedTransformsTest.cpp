@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) Meta Platforms, Inc. and affiliates.
+ *
+ * This source code is licensed under the MIT license found in the
+ * LICENSE file in the root directory of this source tree.
+ */
+
+#include <cstdint>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "flashlight/fl/tensor/Init.h"
+#include "flashlight/pkg/vision/dataset/FusedTransforms.h"
+
+using namespace fl::pkg::vision;
+
+namespace {
+
+// Interleaved w x h x c image where pixel (x, y) channel ch has value
+// x + 10 * y + 100 * ch
+std::vector<uint8_t> makeImage(int w, int h, int c) {
+  std::vector<uint8_t> img(w * h * c);
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      for (int ch = 0; ch < c; ++ch) {
+        img[(y * w + x) * c + ch] = x + 10 * y + 100 * ch;
+      }
+    }
+  }
+  return img;
+}
+
+} // namespace
+
+TEST(FusedTransforms, CropIdentity) {
+  const int w = 8, h = 6, c = 2;
+  auto img = makeImage(w, h, c);
+  const CropBox box{2, 1, 5, 4};
+  std::vector<float> out(box.w * box.h * c);
+  cropResizeNormalize(
+      img.data(), w, h, c, box, box.w, box.h, false, {}, {}, out.data());
+  for (int ch = 0; ch < c; ++ch) {
+    for (int y = 0; y < box.h; ++y) {
+      for (int x = 0; x < box.w; ++x) {
+        ASSERT_FLOAT_EQ(
+            out[(ch * box.h + y) * box.w + x],
+            (box.x + x) + 10 * (box.y + y) + 100 * ch);
+      }
+    }
+  }
+}
+
+TEST(FusedTransforms, FlipAndNormalize) {
+  const int w = 4, h = 3, c = 3;
+  auto img = makeImage(w, h, c);
+  const std::vector<float> mean = {0.5, 0.25, 0.};
+  const std::vector<float> std = {0.5, 2., 1.};
+  std::vector<float> out(w * h * c);
+  cropResizeNormalize(
+      img.data(), w, h, c, {0, 0, w, h}, w, h, true, mean, std, out.data());
+  for (int ch = 0; ch < c; ++ch) {
+    for (int y = 0; y < h; ++y) {
+      for (int x = 0; x < w; ++x) {
+        const float v = (w - 1 - x) + 10 * y + 100 * ch;
+        ASSERT_NEAR(
+            out[(ch * h + y) * w + x], (v / 255. - mean[ch]) / std[ch], 1e-5);
+      }
+    }
+  }
+}
+
+TEST(FusedTransforms, ShrinkAveragesBlocks) {
+  // Shrinking by exactly a power of two is a plain box filter
+  const int w = 8, h = 8, c = 1;
+  auto img = makeImage(w, h, c);
+  std::vector<float> out(2 * 2);
+  cropResizeNormalize(
+      img.data(), w, h, c, {0, 0, w, h}, 2, 2, false, {}, {}, out.data());
+  for (int y = 0; y < 2; ++y) {
+    for (int x = 0; x < 2; ++x) {
+      // mean of x over [4x, 4x + 4) is 4x + 1.5, same for y
+      ASSERT_FLOAT_EQ(out[y * 2 + x], (4 * x + 1.5) + 10 * (4 * y + 1.5));
+    }
+  }
+
+  // Arbitrary downscale of a constant image stays constant
+  std::vector<uint8_t> flat(37 * 23 * 3, 200);
+  std::vector<float> small(5 * 7 * 3);
+  cropResizeNormalize(
+      flat.data(), 37, 23, 3, {3, 2, 30, 20}, 5, 7, true, {}, {}, small.data());
+  for (auto v : small) {
+    ASSERT_FLOAT_EQ(v, 200.);
+  }
+}
+
+TEST(FusedTransforms, InvalidArguments) {
+  auto img = makeImage(4, 4, 3);
+  std::vector<float> out(4 * 4 * 3);
+  EXPECT_THROW(
+      cropResizeNormalize(
+          img.data(), 4, 4, 3, {1, 0, 4, 4}, 4, 4, false, {}, {}, out.data()),
+      std::invalid_argument);
+  EXPECT_THROW(
+      cropResizeNormalize(
+          img.data(),
+          4,
+          4,
+          3,
+          {0, 0, 4, 4},
+          4,
+          4,
+          false,
+          {0.5},
+          {1.},
+          out.data()),
+      std::invalid_argument);
+}
+
+TEST(FusedTransforms, CropSamplers) {
+  // Resize shortest edge 400 -> 256 then center crop 224
+  auto center = centerCropSampler(256, 224)(600, 400);
+  EXPECT_EQ(center.w, 350);
+  EXPECT_EQ(center.h, 350);
+  EXPECT_EQ(center.x, 125);
+  EXPECT_EQ(center.y, 25);
+
+  auto randomResize = randomResizeCropSampler(256, 480, 224);
+  auto randomResized = randomResizedCropSampler(0.08, 1.0, 3. / 4., 4. / 3.);
+  for (int i = 0; i < 100; ++i) {
+    for (const auto& box : {randomResize(500, 300), randomResized(500, 300)}) {
+      ASSERT_GE(box.x, 0);
+      ASSERT_GE(box.y, 0);
+      ASSERT_GT(box.w, 0);
+      ASSERT_GT(box.h, 0);
+      ASSERT_LE(box.x + box.w, 500);
+      ASSERT_LE(box.y + box.h, 300);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  fl::init();
+  return RUN_ALL_TESTS();
+}